@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// ====================================================
+// Arena Allocator
+// ====================================================
+
+// Bump allocator for short-lived allocations. Memory is only reclaimed all at
+// once by arena_reset; after the first reset the arena settles into a single
+// block sized to its high-water mark, so steady-state use does no heap traffic.
+typedef struct Arena Arena;
+
+#define ARENA_ALIGNMENT 64
+
+Arena* arena_create(size_t block_size);
+void arena_free(Arena *arena);
+
+void* arena_alloc(Arena *arena, size_t size);
+void arena_reset(Arena *arena);
+
+size_t arena_used(Arena *arena);
+size_t arena_capacity(Arena *arena);
+
+// ====================================================
+// Active Arena
+// ====================================================
+
+// While an arena is active, tensor_create and the autograd bookkeeping of every
+// op allocate from it, and tensor_free on those tensors is a no-op. Call
+// tensor_tape_clear after resetting an arena that held recorded tensors.
+// Returns the previously active arena so scopes can be nested.
+Arena* arena_activate(Arena *arena);
+Arena* arena_get_active(void);
+
+#endif
@@ -3,6 +3,10 @@
 
 #include "tensor.h"
 #include "ops.h"
+#include "gemm.h"
+#include "arena.h"
+#include "threadpool.h"
+#include "fastmath.h"
 #include "registry.h"
 #include "layer.h"
 #include "network.h"
@@ -18,6 +22,8 @@ static inline void basednn_init() {
 // Call this at the end of your program
 static inline void basednn_cleanup() {
     registry_cleanup();
+    gemm_cleanup();
+    tensor_tape_free();
 }
 
 #endif
\ No newline at end of file
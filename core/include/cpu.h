@@ -0,0 +1,21 @@
+#ifndef CPU_H
+#define CPU_H
+
+// ====================================================
+// CPU Feature Detection
+// ====================================================
+
+typedef struct CpuFeatures {
+    int avx2;
+    int fma;
+    int avx512f;
+    int neon;
+} CpuFeatures;
+
+// Probes the host CPU (cpuid/xgetbv on x86; NEON is assumed on AArch64, where
+// it is mandatory). Called by registry_init.
+// Setting BASEDNN_CPU=scalar|avx2|avx512|neon caps the features reported.
+void cpu_detect(void);
+const CpuFeatures* cpu_get_features(void);
+
+#endif
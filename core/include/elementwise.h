@@ -0,0 +1,50 @@
+#ifndef ELEMENTWISE_H
+#define ELEMENTWISE_H
+
+#include <stddef.h>
+
+// ====================================================
+// Elementwise Kernel Templates
+// ====================================================
+
+// Each macro defines a static kernel whose loop body is the expression itself,
+// so the op is inlined and the loop compiles to straight vector code instead
+// of a call per element. The expressions see the current elements by name:
+//
+//   ELEMENTWISE_BINARY(fn, expr)  c[i] = expr(a, b)
+//   ELEMENTWISE_UNARY(fn, expr)   y[i] = expr(x)
+//   ELEMENTWISE_GRAD(fn, expr)    dx[i] += dy[i] * expr(x, y), y the forward output
+//
+// Outputs may alias inputs element for element (in-place ops), so the buffers
+// are not restrict-qualified; the compiler checks for partial overlap once
+// per call instead.
+//
+//   ELEMENTWISE_UNARY(square_kernel, x * x)
+//   ELEMENTWISE_GRAD(square_grad_kernel, 2.0f * x)
+
+#define ELEMENTWISE_BINARY(fn, expr) \
+    static void fn(const float *a_, const float *b_, float *c_, size_t n_) { \
+        for (size_t i_ = 0; i_ < n_; i_++) { \
+            const float a = a_[i_], b = b_[i_]; \
+            c_[i_] = (expr); \
+        } \
+    }
+
+#define ELEMENTWISE_UNARY(fn, expr) \
+    static void fn(const float *x_, float *y_, size_t n_) { \
+        for (size_t i_ = 0; i_ < n_; i_++) { \
+            const float x = x_[i_]; \
+            y_[i_] = (expr); \
+        } \
+    }
+
+#define ELEMENTWISE_GRAD(fn, expr) \
+    static void fn(const float *x_, const float *y_, const float *dy_, float *dx_, size_t n_) { \
+        for (size_t i_ = 0; i_ < n_; i_++) { \
+            const float x = x_[i_], y = y_[i_]; \
+            (void)x; (void)y; \
+            dx_[i_] += dy_[i_] * (expr); \
+        } \
+    }
+
+#endif
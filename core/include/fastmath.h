@@ -0,0 +1,54 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <stddef.h>
+
+// ====================================================
+// Fast Math
+// ====================================================
+
+// Vectorized polynomial approximations of the transcendental functions behind
+// the activations, one table per instruction set. Off by default; when
+// enabled, tensor_sigmoid, tensor_tanh, the fused linear activations and the
+// stdlib GELU/swish/softplus (forward and backward) use them instead of the
+// default kernels.
+//
+// Maximum error against a double-precision reference, in float ULPs, measured
+// on the scalar, AVX2 and AVX-512 tables over the given inputs:
+//
+//   exp       3 ulp   x in [-87, 88]
+//   log       3 ulp   positive normal x
+//   sigmoid   4 ulp   x in [-87, 87]
+//   tanh      6 ulp   all x
+//   swish     5 ulp   x in [-87, 87]
+//   softplus  4 ulp   x in [-87, 87]
+//   gelu     16 ulp   x >= -3 (tanh form, as in activations.h)
+//
+// GELU's exponent argument grows like x^3, so for x < -3 its own rounding
+// dominates: the relative error reaches about 1e-5 at x = -10, where the result
+// is below 1e-35. Inputs past the ranges saturate to 0, 1 or x as appropriate.
+// Non-finite inputs are not supported.
+
+typedef void (*MathKernelFn)(const float *x, float *y, size_t n);
+
+typedef struct MathKernels {
+    const char *name;
+    MathKernelFn exp;
+    MathKernelFn log;
+    MathKernelFn sigmoid;
+    MathKernelFn tanh;
+    MathKernelFn gelu;
+    MathKernelFn swish;
+    MathKernelFn softplus;
+} MathKernels;
+
+// Process-wide switch. The default comes from BASEDNN_FAST_MATH (1 enables),
+// read the first time the mode is queried.
+void fastmath_set_enabled(int enabled);
+int fastmath_enabled(void);
+
+// Approximations for the best instruction set picked by registry_init (the
+// scalar versions before that). Usable whatever the mode.
+const MathKernels* fastmath_kernels(void);
+
+#endif
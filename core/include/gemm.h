@@ -0,0 +1,139 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <stddef.h>
+
+// ====================================================
+// Blocking Parameters
+// ====================================================
+
+// Register tile computed by one microkernel call (MR rows x NR columns of C)
+#define GEMM_MR 6
+#define GEMM_NR 16
+
+// Cache blocking: a KC x NR panel of B stays in L1, an MC x KC block of A
+// stays in L2 and a KC x NC block of B stays in L3
+#define GEMM_MC 144
+#define GEMM_KC 256
+#define GEMM_NC 4096
+
+// Microkernel: C[MR x NR] (+)= packed A panel [kc x MR] * packed B panel [kc x NR]
+typedef void (*GemmMicroKernelFn)(size_t kc, const float *a, const float *b, float *c, size_t ldc, int accumulate);
+
+// Products with at most this many rows in C (one to a few requests at a time)
+// take the small-M path: nothing is packed, each row of B is read once for
+// every row of A, and the work is split across output columns
+#define GEMM_SMALL_M 8
+
+// Small-M kernel: C[m x NR] (+)= A[m x kc] * B[kc x NR] for m <= GEMM_SMALL_M,
+// read in place through A's strides and B's row stride. Each element is
+// summed over k in order from zero, then stored or added to C, exactly as the
+// microkernel does, so both paths give the same bits
+typedef void (*GemmSmallMKernelFn)(size_t m, size_t kc, const float *a, size_t rsa, size_t csa,
+                                   const float *b, size_t rsb, float *c, size_t ldc, int accumulate);
+
+// ====================================================
+// GEMM
+// ====================================================
+
+// C[M x N] = A[M x K] * B[K x N], all row-major with leading dimensions lda, ldb, ldc
+void sgemm(size_t M, size_t N, size_t K,
+           const float *A, size_t lda,
+           const float *B, size_t ldb,
+           float *C, size_t ldc);
+
+// Same as sgemm, using the given microkernel instead of the active one
+void sgemm_with(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                const float *A, size_t lda,
+                const float *B, size_t ldb,
+                float *C, size_t ldc);
+
+// Same as sgemm_with, with A and B addressed through separate row and column
+// strides, so transposed or otherwise strided operands are packed without a copy
+void sgemm_strided(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                   const float *A, size_t rsa, size_t csa,
+                   const float *B, size_t rsb, size_t csb,
+                   float *C, size_t ldc);
+
+// BLAS-style C[M x N] = alpha * op(A) * op(B) + beta * C, where op(X) is X or
+// Xᵀ. A is stored M x K (K x M when transposed) with leading dimension lda,
+// likewise B; transposed operands are packed straight from their storage.
+// beta = 1 accumulates into C (as gradients do) and beta = 0 ignores C's
+// contents, so C need not be initialized
+typedef enum {
+    GEMM_NO_TRANS = 0,
+    GEMM_TRANS = 1
+} GemmTranspose;
+
+void sgemm_ex(GemmMicroKernelFn kernel, GemmTranspose trans_a, GemmTranspose trans_b,
+              size_t M, size_t N, size_t K, float alpha,
+              const float *A, size_t lda,
+              const float *B, size_t ldb, float beta,
+              float *C, size_t ldc);
+
+// sgemm_strided with alpha and beta as in sgemm_ex. When b_sums is set, the
+// column sums of B are also added to it (length N), taken from B's packed
+// panels so B is read once for both: given a layer's output gradient as B, one
+// call accumulates its weight gradient and its bias gradient
+void sgemm_strided_ex(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K, float alpha,
+                      const float *A, size_t rsa, size_t csa,
+                      const float *B, size_t rsb, size_t csb, float beta,
+                      float *C, size_t ldc, float *b_sums);
+
+// Epilogue applied to each finished tile of C while it is still in cache:
+// C[i][j] = activation(C[i][j] + bias[j]). bias (length N) and activation may
+// each be NULL; activation may be called in place with x == y
+typedef void (*GemmActivationFn)(const float *x, float *y, size_t n);
+
+typedef struct {
+    const float *bias;
+    GemmActivationFn activation;
+} GemmEpilogue;
+
+// Same as sgemm_strided, finishing C with the epilogue
+void sgemm_fused(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                 const float *A, size_t rsa, size_t csa,
+                 const float *B, size_t rsb, size_t csb,
+                 float *C, size_t ldc, const GemmEpilogue *epilogue);
+
+// B packed ahead of time for reuse across products (e.g. a layer's static
+// weights): gemm_pack_b writes the panels every product with this K and N
+// would pack, into gemm_packed_b_size(K, N) floats, and sgemm_prepacked is
+// sgemm_fused reading them instead of B. The layout depends only on the
+// blocking parameters, so any microkernel can consume it
+size_t gemm_packed_b_size(size_t K, size_t N);
+void gemm_pack_b(size_t K, size_t N, const float *B, size_t rsb, size_t csb, float *packed);
+void sgemm_prepacked(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                     const float *A, size_t rsa, size_t csa, const float *packed_b,
+                     float *C, size_t ldc, const GemmEpilogue *epilogue);
+
+// sgemm_fused for M <= GEMM_SMALL_M (GEMV when M = 1) on the small-M kernel
+// (the portable one when NULL), with the same result bits. B's rows must be
+// contiguous (or N = 1); with packed_b set (gemm_pack_b's layout) B is not read
+// and the panels are streamed instead. Runs in parallel over column panels
+void sgemm_small_m(GemmSmallMKernelFn kernel, size_t M, size_t N, size_t K,
+                   const float *A, size_t rsa, size_t csa,
+                   const float *B, size_t rsb, const float *packed_b,
+                   float *C, size_t ldc, const GemmEpilogue *epilogue);
+
+// batch independent products C_i[M x N] = alpha * A_i[M x K] * B_i[K x N] + beta * C_i,
+// with A_i at A + a_offsets[i], B_i at B + b_offsets[i] and C_i at C + i * c_stride.
+// Operands shared between products (broadcasting) simply repeat an offset. Products
+// run in parallel across the thread pool, each on the same blocked kernel as sgemm
+void sgemm_batched(GemmMicroKernelFn kernel, size_t batch, size_t M, size_t N, size_t K, float alpha,
+                   const float *A, const size_t *a_offsets, size_t rsa, size_t csa,
+                   const float *B, const size_t *b_offsets, size_t rsb, size_t csb, float beta,
+                   float *C, size_t ldc, size_t c_stride);
+
+// Microkernel used by sgemm (defaults to the portable C microkernel, replaced by
+// the best SIMD microkernel for the host in registry_init)
+void gemm_set_microkernel(GemmMicroKernelFn kernel);
+GemmMicroKernelFn gemm_get_microkernel(void);
+void gemm_microkernel_scalar(size_t kc, const float *a, const float *b, float *c, size_t ldc, int accumulate);
+void gemm_small_m_scalar(size_t m, size_t kc, const float *a, size_t rsa, size_t csa,
+                         const float *b, size_t rsb, float *c, size_t ldc, int accumulate);
+
+// Release packing buffers
+void gemm_cleanup(void);
+
+#endif
@@ -7,6 +7,7 @@
 typedef struct LayerConfig {
     const char *name;
     void *params;
+    int no_init;    // Parameters are about to be overwritten (e.g. by a loader): leave them uninitialized
 } LayerConfig;
 
 typedef struct LinearParams {
@@ -32,6 +33,12 @@ struct Layer {
     Tensor* (*forward)(Layer *self, Tensor *input);
     void *config_data;  // Store layer-specific configuration
     size_t config_data_size;
+
+    // Linear only: the weights packed into GEMM panels (gemm_pack_b) for the
+    // forward pass, or NULL. Repacked on the next forward whenever
+    // weights->version has moved past packed_version
+    float *packed_weights;
+    size_t packed_version;
 }; 
 
 // Layer constructors/destructor
@@ -41,6 +48,23 @@ void layer_free(Layer *layer);
 // Layer operations
 Tensor* layer_forward(Layer *layer, Tensor *input);
 
+// Runs layer, or layer and next together when they form LINEAR followed by
+// RELU/SIGMOID/TANH, through the fused linear op. *consumed receives the
+// number of layers run (1 or 2); next may be NULL
+Tensor* layer_forward_fused(Layer *layer, Layer *next, Tensor *input, size_t *consumed);
+
+// layer_forward_fused for an input nothing reads afterwards: RELU, SIGMOID and
+// TANH layers then overwrite it in place instead of allocating their output,
+// when autograd allows (see tensor_inplace_safe)
+Tensor* layer_forward_reusing(Layer *layer, Layer *next, Tensor *input, size_t *consumed);
+
+// Keeps (enabled = 1) or drops (0) a pre-packed copy of a Linear layer's
+// weights, so its forward GEMM skips packing them on every call. Optimizer
+// steps and in-place ops bump the weights' version, which invalidates the copy;
+// code writing weights->data directly must bump it too. Returns 1 on success,
+// 0 for other layers or if out of memory
+int layer_prepack_weights(Layer *layer, int enabled);
+
 // Utilities
 void layer_zero_grad(Layer *layer);
 Tensor** layer_get_parameters(Layer *layer, size_t *num_params);
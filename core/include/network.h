@@ -4,6 +4,8 @@
 #include "tensor.h"
 #include "layer.h"
 #include "optimizer.h"
+#include "arena.h"
+#include <stdint.h>
 
 typedef struct Network {
     Layer **layers;
@@ -11,8 +13,34 @@ typedef struct Network {
     size_t num_layers;
     size_t num_parameters;
     size_t capacity;
+    Arena *arena;           // Scratch for per-step intermediates, reset after each optimizer step
+
+    // Flat parameter storage: every parameter lives in param_data, in
+    // parameters order, as a tensor viewing its slice, and its gradient in the
+    // same slice of grad_data. Both are 64-byte aligned and rebuilt by
+    // network_add_layer; gradients exist (zeroed) from the start, so backward
+    // passes never allocate them. NULL if a parameter is not contiguous
+    float *param_data;
+    float *grad_data;
+    size_t param_size;      // Floats in each buffer
+
+    // File mapping the parameters view after network_load of a v2 checkpoint,
+    // unmapped by network_free. Private: updates never reach the file
+    void *mapping;
+    size_t mapping_size;
 } Network; 
 
+// Where a training loop stands, saved with a training checkpoint. The library
+// keeps no random state between calls (tensor_randn seeds per call), so
+// rng_state holds whatever generator state the caller's loop uses for
+// shuffling or dropout and is restored untouched
+typedef struct TrainingCursor {
+    uint64_t epoch;
+    uint64_t batch;
+    uint64_t step;
+    uint64_t rng_state[4];
+} TrainingCursor;
+
 // Network management
 Network* network_create();
 void network_add_layer(Network *net, Layer *layer);
@@ -21,18 +49,63 @@ void network_free(Network *net);
 // Forward pass 
 Tensor* network_forward(Network *net, Tensor *input);
 
+// Forward pass for evaluation/serving: no autograd graph is built and each
+// intermediate is freed once the next layer has consumed it
+Tensor* network_infer(Network *net, Tensor *input);
+
 // Training
 void network_train(Network *net, Optimizer *opt, Tensor *inputs, Tensor *targets, size_t epochs, size_t batch_size, const char *loss_name, int verbose);
 float network_train_step(Network *net, Tensor *input, Tensor *target, Optimizer *opt, const char *loss_name);
+// One memset over grad_data
 void network_zero_grad(Network *net);
 
+// Serving: keeps every Linear layer's weights pre-packed for the GEMM
+// microkernels (see layer_prepack_weights), e.g. once after network_load, so
+// forward passes spend no time repacking them. Training keeps working: each
+// optimizer step invalidates the copies and the next forward repacks them.
+// Returns the number of layers packed
+size_t network_prepack_weights(Network *net, int enabled);
+
 // Utilities
 void network_print(Network *net);
 Tensor** network_get_parameters(Network *net, size_t *num_params);
+// targets: one-hot [N, C] rows or [N] class indices
 float network_accuracy(Tensor *predictions, Tensor *targets);
 
-// Save/load network
+// Save/load network. network_save writes format v2: fixed-width
+// little-endian fields, an index of every parameter and 64-byte aligned
+// float32 payloads (layout in network.c). Every save goes to its own
+// temporary next to path, which is fsynced and renamed over path, so a crash
+// mid-save leaves the previous file intact and overlapping saves each commit
+// a complete file. network_load reads v1 and v2 files.
+// On little-endian hosts a v2 file is mapped rather than read: each parameter
+// views its payload in place (owns_data = 0) and is never initialized, so
+// loading costs page faults on first use instead of a copy. Such networks keep
+// no flat parameter buffers
 void network_save(Network *net, const char *file_path);
 Network* network_load(const char *file_path);
 
+// Training checkpoint: parameters, optimizer state (optimizer_write) and the
+// cursor in one file. Loading overwrites the parameters and optimizer state of
+// a network and optimizer built the same way as the saved ones and fills
+// cursor, so the resumed run continues bit for bit. Returns 1 on success, 0 on
+// an I/O error or mismatch, leaving the network and optimizer as they were
+int network_save_checkpoint(Network *net, Optimizer *opt, const TrainingCursor *cursor, const char *file_path);
+int network_load_checkpoint(Network *net, Optimizer *opt, TrainingCursor *cursor, const char *file_path);
+
+// Background saves: the file contents are copied into a staging buffer on the
+// calling thread, which then returns while a writer thread does the write,
+// fsync and rename. The network and optimizer may change or be freed as soon
+// as the call returns. NULL (nothing written) if staging fails
+typedef struct CheckpointHandle CheckpointHandle;
+
+CheckpointHandle* network_save_async(Network *net, const char *file_path);
+CheckpointHandle* network_save_checkpoint_async(Network *net, Optimizer *opt, const TrainingCursor *cursor,
+                                                const char *file_path);
+// 1 once the write has finished (or for NULL), without blocking
+int checkpoint_done(CheckpointHandle *handle);
+// Blocks until the write finishes and frees handle; 1 if the file was committed.
+// Every handle must be waited on
+int checkpoint_wait(CheckpointHandle *handle);
+
 #endif
\ No newline at end of file
@@ -7,6 +7,9 @@
 // Elementwise Operations
 // ====================================================
 
+// NumPy-style broadcasting: shapes align from the right and each dimension
+// must match or be 1. Gradients are summed back to each input's shape.
+// NULL if the shapes do not broadcast
 Tensor* tensor_add(Tensor *A, Tensor *B);
 void backward_add(Tensor *C);
 
@@ -16,16 +19,66 @@ void backward_sub(Tensor *C);
 Tensor* tensor_mul(Tensor *A, Tensor *B);
 void backward_mul(Tensor *C);
 
+Tensor* tensor_div(Tensor *A, Tensor *B);
+void backward_div(Tensor *C);
+
+// ====================================================
+// Views
+// ====================================================
+
+// Zero-copy view of A. View element (i_0, ..., i_n) is element
+// start + sum(i_d * steps[d]) of A counted in A's row-major order, so views
+// compose regardless of how A itself is laid out. Returns NULL if the view
+// cannot be expressed over A's storage (use tensor_contiguous first).
+Tensor* tensor_view(Tensor *A, size_t *shape, size_t ndim, size_t *steps, size_t start);
+void backward_view(Tensor *V);
+
+// Row-major copy of A, or A itself if it is already contiguous
+Tensor* tensor_contiguous(Tensor *A);
+void backward_contiguous(Tensor *C);
+
 // ====================================================
 // Linear Algebra
 // ====================================================
 
+// The last two dims are multiplied as matrices and the leading dims broadcast,
+// so [B, H, S, D]·[B, H, D, T] gives [B, H, S, T] and [B, S, D]·[D, E] applies
+// one matrix to every batch entry. A 1D left operand is a row vector and a 1D
+// right operand a column vector, whose dim is dropped from the result. The
+// products run in parallel across the batch. NULL if the shapes do not match
 Tensor* tensor_matmul(Tensor *A, Tensor *B);
 void backward_matmul(Tensor *C);
 
+// alpha * op(A)·op(B), where op swaps the last two dims of an operand whose
+// trans flag is set (1D operands are never transposed). Transposed operands are
+// read in place, so Q·Kᵀ costs no copy of K, and backward accumulates dA and dB
+// straight into the grads
+Tensor* tensor_matmul_ex(Tensor *A, Tensor *B, int trans_a, int trans_b, float alpha);
+
+// O(1): returns a view with swapped strides
 Tensor* tensor_transpose2d(Tensor *A);
 void backward_transpose2d(Tensor *C);
 
+typedef enum {
+    LINEAR_ACT_NONE,
+    LINEAR_ACT_RELU,
+    LINEAR_ACT_SIGMOID,
+    LINEAR_ACT_TANH
+} LinearActivation;
+
+// activation(X·W + b) in one GEMM pass, with the bias and activation applied in
+// the GEMM epilogue. X is [batch, in] or [in], W is [in, out] and b is [out]
+Tensor* tensor_linear(Tensor *X, Tensor *W, Tensor *b, LinearActivation activation);
+void backward_linear(Tensor *Y);
+void backward_linear_relu(Tensor *Y);
+void backward_linear_sigmoid(Tensor *Y);
+void backward_linear_tanh(Tensor *Y);
+
+// tensor_linear with the forward GEMM reading W from packed_w, W's panels as
+// gemm_pack_b(in, out, W) left them, so no per-call packing happens. packed_w
+// must match W's current values; W is still recorded for backward
+Tensor* tensor_linear_prepacked(Tensor *X, Tensor *W, const float *packed_w, Tensor *b, LinearActivation activation);
+
 // ====================================================
 // Activation Functions
 // ====================================================
@@ -42,6 +95,23 @@ void backward_tanh(Tensor *A);
 Tensor* tensor_softmax(Tensor *Z);
 void backward_softmax(Tensor *A);
 
+// ====================================================
+// In-Place Operations
+// ====================================================
+
+// Overwrite their first operand and return it, reusing the backward passes of
+// the out-of-place ops; see tensor.h for how autograd stays correct. The
+// operand must be contiguous, and for the binary ops B must broadcast to A's
+// shape without changing it. NULL (leaving A untouched) otherwise, or if
+// autograd forbids modifying A
+Tensor* tensor_add_(Tensor *A, Tensor *B);
+Tensor* tensor_sub_(Tensor *A, Tensor *B);
+Tensor* tensor_mul_(Tensor *A, Tensor *B);
+Tensor* tensor_div_(Tensor *A, Tensor *B);
+Tensor* tensor_relu_(Tensor *Z);
+Tensor* tensor_sigmoid_(Tensor *Z);
+Tensor* tensor_tanh_(Tensor *Z);
+
 // ====================================================
 // Loss Functions
 // ====================================================
@@ -55,11 +125,28 @@ void backward_cross_entropy(Tensor *L);
 Tensor* tensor_binary_cross_entropy(Tensor *predictions, Tensor *targets);
 void backward_binary_cross_entropy(Tensor *L);
 
+// cross_entropy(softmax(logits), targets) computed from the logits through
+// log-sum-exp, with the same loss value and logit gradients as the unfused
+// pair. Backward is p - t per row, O(C) instead of the O(C^2) softmax
+// Jacobian. Rows as in tensor_softmax
+Tensor* tensor_softmax_cross_entropy(Tensor *logits, Tensor *targets);
+void backward_softmax_cross_entropy(Tensor *L);
+
+// Sparse targets: labels is a [batch] tensor of class indices (integral
+// floats, exact up to 2^24) instead of [batch, C] one-hot rows, so targets cost
+// O(batch) to store and read. Same loss values and prediction gradients as the
+// dense losses with one-hot targets; NULL if any label is out of range
+Tensor* tensor_sparse_cross_entropy(Tensor *predictions, Tensor *labels);
+void backward_sparse_cross_entropy(Tensor *L);
+
+Tensor* tensor_sparse_softmax_cross_entropy(Tensor *logits, Tensor *labels);
+void backward_sparse_softmax_cross_entropy(Tensor *L);
+
 // ====================================================
 // Slice
 // ====================================================
 
-// Slice
+// Rows [start, end) of input as a view
 Tensor* tensor_slice(Tensor *input, size_t start, size_t end);
 
 // Registration
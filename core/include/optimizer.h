@@ -3,6 +3,7 @@
 
 #include "tensor.h"
 #include "ops.h"
+#include <stdio.h>
 
 typedef struct OptimizerConfig {
     const char *name;
@@ -21,8 +22,27 @@ typedef struct AdamParams {
     float epsilon;
 } AdamParams;
 
+// Adam with decoupled weight decay: each step also scales the parameters by
+// 1 - learning_rate * weight_decay, independently of the gradient moments
+typedef struct AdamWParams {
+    float learning_rate;
+    float beta1;
+    float beta2;
+    float epsilon;
+    float weight_decay;
+} AdamWParams;
+
 #define SGD(lr, momentum) (OptimizerConfig){ .name = "sgd", .params = &(SGDParams){ lr, momentum } }
 #define ADAM(lr, beta1, beta2, epsilon) (OptimizerConfig){ .name = "adam", .params = &(AdamParams){ lr, beta1, beta2, epsilon } }
+#define ADAMW(lr, beta1, beta2, epsilon, weight_decay) (OptimizerConfig){ .name = "adamw", .params = &(AdamWParams){ lr, beta1, beta2, epsilon, weight_decay } }
+
+// Adam and AdamW keeping the moment estimates in less memory: bf16 halves
+// them, and 8-bit blockwise storage (one byte per element plus a float scale
+// per 256) cuts them to about a quarter. The update itself runs in float
+#define ADAM_BF16(lr, beta1, beta2, epsilon) (OptimizerConfig){ .name = "adam_bf16", .params = &(AdamParams){ lr, beta1, beta2, epsilon } }
+#define ADAMW_BF16(lr, beta1, beta2, epsilon, weight_decay) (OptimizerConfig){ .name = "adamw_bf16", .params = &(AdamWParams){ lr, beta1, beta2, epsilon, weight_decay } }
+#define ADAM_8BIT(lr, beta1, beta2, epsilon) (OptimizerConfig){ .name = "adam_8bit", .params = &(AdamParams){ lr, beta1, beta2, epsilon } }
+#define ADAMW_8BIT(lr, beta1, beta2, epsilon, weight_decay) (OptimizerConfig){ .name = "adamw_8bit", .params = &(AdamWParams){ lr, beta1, beta2, epsilon, weight_decay } }
 
 typedef struct Optimizer Optimizer;
 
@@ -33,6 +53,8 @@ struct Optimizer {
     void (*step)(Optimizer *self);
     void (*zero_grad)(Optimizer *self);
     void (*free_state)(void *state, size_t num_parameters);
+    int (*save_state)(void *state, size_t num_parameters, FILE *file);
+    int (*load_state)(void *state, size_t num_parameters, FILE *file);
     void *state;
 };
 
@@ -44,6 +66,17 @@ void optimizer_step(Optimizer *opt);
 void optimizer_zero_grad(Optimizer *opt);
 void optimizer_free(Optimizer *opt); 
 
+// Optimizer state (moments, velocities, step count) for resuming training.
+// Loading needs an optimizer of the same kind created over parameters of the
+// same sizes; hyperparameters are not saved and come from its config. Returns
+// 1 on success, 0 on an I/O error or mismatch. optimizer_save replaces path
+// atomically, like network_save. The stream forms read and write at the
+// current file position, for embedding in a larger file
+int optimizer_save(Optimizer *opt, const char *path);
+int optimizer_load(Optimizer *opt, const char *path);
+int optimizer_write(Optimizer *opt, FILE *file);
+int optimizer_read(Optimizer *opt, FILE *file);
+
 // Registration
 void optimizer_register_builtins(void);
 
@@ -2,6 +2,8 @@
 #define REGISTRY_H
 
 #include "tensor.h"
+#include "threadpool.h"
+#include <stdio.h>
 
 struct Layer;
 struct LayerConfig;
@@ -26,6 +28,14 @@ LayerForwardFn get_layer_forward_fn(const char *name);
 
 typedef Tensor* (*OpFn)(Tensor *a, Tensor *b);
 
+// Backend priorities: the highest-priority registration of a name wins.
+// register_operation uses BACKEND_PRIORITY_USER so plugins override built-in kernels.
+#define BACKEND_PRIORITY_SCALAR 0
+#define BACKEND_PRIORITY_NEON 20
+#define BACKEND_PRIORITY_AVX2 20
+#define BACKEND_PRIORITY_AVX512 30
+#define BACKEND_PRIORITY_USER 100
+
 void register_operation(const char *name, OpFn op_fn);
 void register_operation_backend(const char *name, OpFn op_fn, int priority);
 OpFn get_operation_fn(const char *name);
@@ -55,10 +65,25 @@ OptimizerInitStateFn get_optimizer_init_state_fn(const char *name);
 OptimizerStepFn get_optimizer_step_fn(const char *name);
 OptimizerFreeStateFn get_optimizer_free_state_fn(const char *name);
 
+// Optional hooks for checkpointing: save writes the state to file and load
+// reads it back into a state init_state created for the same parameters. Each
+// returns 1 on success and 0 on a write, read or mismatch error. Registered
+// after register_optimizer for the same name
+typedef int (*OptimizerSaveStateFn)(void *state, size_t num_parameters, FILE *file);
+typedef int (*OptimizerLoadStateFn)(void *state, size_t num_parameters, FILE *file);
+
+void register_optimizer_serializer(const char *name,
+                                   OptimizerSaveStateFn save_state_fn,
+                                   OptimizerLoadStateFn load_state_fn);
+OptimizerSaveStateFn get_optimizer_save_state_fn(const char *name);
+OptimizerLoadStateFn get_optimizer_load_state_fn(const char *name);
+
 // ====================================================
 // Registry Initialization
 // ====================================================
 
+// registry_init also starts the shared thread pool (see threadpool.h);
+// registry_cleanup stops it
 void registry_init();
 void registry_cleanup();
 
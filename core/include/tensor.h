@@ -4,11 +4,13 @@
 #include <stddef.h>
 
 typedef struct Tensor Tensor;
+struct Arena;
 
 struct Tensor {
     float *data;
     float *grad;
     size_t *shape;
+    size_t *strides;      // Element strides into data (row-major unless T is a view)
     size_t ndim;
     size_t size;
     
@@ -19,6 +21,13 @@ struct Tensor {
     size_t num_inputs;
     void (*backward_fn)(Tensor *self);
     void *extra_data;
+    struct Arena *arena;  // Owning arena, NULL for heap tensors
+    size_t tape_index;    // Position on the gradient tape, if recorded
+    size_t backward_mark;
+
+    size_t version;         // Bumped by every in-place op on T
+    size_t *saved_versions; // Input versions when recorded, then T's own if saved
+    Tensor *replaced;       // T's history before its last in-place op, freed with T
 };
 
 // ====================================================
@@ -29,6 +38,7 @@ Tensor* tensor_create(size_t *shape, size_t ndim);
 Tensor* tensor_zeroes(size_t *shape, size_t ndim);
 Tensor* tensor_ones(size_t *shape, size_t ndim);
 Tensor* tensor_randn(size_t *shape, size_t ndim, int seed);
+Tensor* tensor_wrap(size_t *shape, size_t ndim, float *data);
 void tensor_free(Tensor *T);
 
 // ====================================================
@@ -39,6 +49,70 @@ void tensor_set_requires_grad(Tensor *T, int requires_grad);
 void tensor_zero_grad(Tensor *T);
 void tensor_backward(Tensor *T);
 
+// With grad disabled, ops record nothing: outputs never require grad and no
+// graph is kept alive. Returns the previous setting so scopes can be nested.
+int tensor_set_grad_enabled(int enabled);
+int tensor_is_grad_enabled(void);
+
+// Allocates a zeroed gradient buffer on first use (from T's arena, if any)
+float* tensor_ensure_grad(Tensor *T);
+
+// Marks T as the output of op_name applied to inputs, if any input requires grad,
+// and appends it to the gradient tape
+void tensor_record_op(Tensor *T, Tensor **inputs, size_t num_inputs, const char *op_name, void (*backward_fn)(Tensor *));
+
+// The tape lists recorded tensors in creation order; tensor_backward walks it in
+// reverse. Clear it whenever recorded tensors are released without tensor_free
+// (e.g. after arena_reset); the buffer is kept for the next step.
+void tensor_tape_clear(void);
+size_t tensor_tape_size(void);
+void tensor_tape_free(void);
+
+// ====================================================
+// In-Place Operations
+// ====================================================
+
+// In-place ops overwrite their first operand instead of allocating an output.
+// Every one bumps the operand's version. tensor_record_op remembers the version
+// of each input and of the output itself; tensor_backward refuses to run (with
+// a message on stderr) if any value a backward pass needs has been overwritten
+// since. Views share storage but not versions, so in-place ops on views that
+// require grad are rejected.
+//
+// An op whose backward pass does not read its own output calls
+// tensor_release_output after tensor_record_op, which lets the output be
+// overwritten (and its storage reused, see tensor_inplace_safe).
+// tensor_save_output records the output's current version again, for ops that
+// release it in a shared helper and then find they need it after all.
+void tensor_save_output(Tensor *T);
+void tensor_release_output(Tensor *T);
+
+// Called by in-place ops before overwriting T, with other the op's second
+// operand (or NULL). Bumps T's version and returns what to record as the op's
+// input in T's place: when grad is enabled and T or other requires grad, a new
+// node that takes over T's history (and a copy of its current values if
+// keep_value is set, for backward passes that read them), otherwise T itself.
+// NULL if T is a leaf that requires grad or a view that does
+Tensor* tensor_begin_inplace(Tensor *T, Tensor *other, int keep_value);
+
+// 1 if T can be overwritten in place without breaking a pending backward pass
+// through its own history: T owns its storage, is not a leaf that requires grad
+// and, if it has a backward function, its op released it. Other ops that saved
+// T are not tracked here
+int tensor_inplace_safe(Tensor *T);
+
+// ====================================================
+// Memory Layout
+// ====================================================
+
+// Views share storage with the tensor they were created from: data points at
+// the view's first element and strides say how to step through the rest.
+// grad is always dense, in row-major order of the view's own shape.
+int tensor_is_contiguous(Tensor *T);
+
+// Copies T's elements into out (T->size floats) in row-major order
+void tensor_gather(Tensor *T, float *out);
+
 // ====================================================
 // Utilities
 // ====================================================
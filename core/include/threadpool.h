@@ -0,0 +1,54 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stddef.h>
+
+// ====================================================
+// Thread Pool
+// ====================================================
+
+// One process-wide pool of workers, each with its own work-stealing deque.
+// Built-in kernels and plugins submit work here instead of creating threads,
+// so nested parallel regions share the same workers without oversubscription.
+// Without a running pool (or with one thread) everything runs inline.
+
+// num_threads counts the calling thread. 0 picks the count set through
+// threadpool_set_num_threads, else BASEDNN_NUM_THREADS, else the online CPUs.
+int threadpool_init(size_t num_threads);
+void threadpool_shutdown(void);
+
+// Restarts the pool with num_threads threads (0 restores the default)
+void threadpool_set_num_threads(size_t num_threads);
+size_t threadpool_num_threads(void);
+
+// 0 for threads outside the pool, 1..n-1 for workers
+size_t threadpool_thread_index(void);
+
+// ====================================================
+// Tasks
+// ====================================================
+
+typedef void (*TaskFn)(void *arg);
+typedef struct TaskGroup TaskGroup;
+
+TaskGroup* task_group_create(void);
+void task_group_run(TaskGroup *group, TaskFn fn, void *arg);
+
+// Runs queued tasks (this group's or others') until the group is done
+void task_group_wait(TaskGroup *group);
+void task_group_free(TaskGroup *group);
+
+// ====================================================
+// Parallel For
+// ====================================================
+
+// Calls fn(chunk_begin, chunk_end, arg) for consecutive chunks of grain
+// elements covering [begin, end), the last one possibly shorter. Chunks only
+// depend on the range and grain, never on the thread count, so per-chunk
+// partial results combine the same way on any machine.
+typedef void (*ParallelForFn)(size_t begin, size_t end, void *arg);
+
+void parallel_for(size_t begin, size_t end, size_t grain, ParallelForFn fn, void *arg);
+size_t parallel_num_chunks(size_t begin, size_t end, size_t grain);
+
+#endif
@@ -0,0 +1,149 @@
+#include "../include/arena.h"
+#include <stdlib.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (1 << 20)
+
+// ====================================================
+// Arena Structures
+// ====================================================
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t capacity;
+    size_t used;
+    unsigned char *data;
+} ArenaBlock;
+
+struct Arena {
+    ArenaBlock *head;
+    size_t block_size;
+};
+
+static Arena *active_arena = NULL;
+
+static ArenaBlock* arena_block_create(size_t capacity) {
+    ArenaBlock *block = (ArenaBlock *)malloc(sizeof(ArenaBlock));
+    if (!block) return NULL;
+
+    void *data = NULL;
+    if (posix_memalign(&data, ARENA_ALIGNMENT, capacity) != 0) {
+        free(block);
+        return NULL;
+    }
+
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    block->data = (unsigned char *)data;
+    return block;
+}
+
+static void arena_block_free_all(ArenaBlock *block) {
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block->data);
+        free(block);
+        block = next;
+    }
+}
+
+// ====================================================
+// Arena Management
+// ====================================================
+
+Arena* arena_create(size_t block_size) {
+    Arena *arena = (Arena *)malloc(sizeof(Arena));
+    if (!arena) return NULL;
+
+    arena->block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->head = arena_block_create(arena->block_size);
+    if (!arena->head) {
+        free(arena);
+        return NULL;
+    }
+    return arena;
+}
+
+void arena_free(Arena *arena) {
+    if (!arena) return;
+    if (active_arena == arena) active_arena = NULL;
+    arena_block_free_all(arena->head);
+    free(arena);
+}
+
+void* arena_alloc(Arena *arena, size_t size) {
+    if (!arena) return NULL;
+    if (size == 0) size = 1;
+
+    size_t aligned_size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    ArenaBlock *block = arena->head;
+
+    if (!block || block->used + aligned_size > block->capacity) {
+        size_t capacity = aligned_size > arena->block_size ? aligned_size : arena->block_size;
+        ArenaBlock *fresh = arena_block_create(capacity);
+        if (!fresh) return NULL;
+        fresh->next = block;
+        arena->head = fresh;
+        block = fresh;
+    }
+
+    void *ptr = block->data + block->used;
+    block->used += aligned_size;
+    return ptr;
+}
+
+void arena_reset(Arena *arena) {
+    if (!arena || !arena->head) return;
+
+    if (!arena->head->next) {
+        arena->head->used = 0;
+        return;
+    }
+
+    // Spilled into several blocks: replace them with one block covering the high-water mark
+    size_t total = 0;
+    for (ArenaBlock *block = arena->head; block; block = block->next) {
+        total += block->used;
+    }
+
+    ArenaBlock *merged = arena_block_create(total > arena->block_size ? total : arena->block_size);
+    if (!merged) {
+        for (ArenaBlock *block = arena->head; block; block = block->next) block->used = 0;
+        return;
+    }
+
+    arena_block_free_all(arena->head);
+    arena->head = merged;
+}
+
+size_t arena_used(Arena *arena) {
+    if (!arena) return 0;
+    size_t total = 0;
+    for (ArenaBlock *block = arena->head; block; block = block->next) {
+        total += block->used;
+    }
+    return total;
+}
+
+size_t arena_capacity(Arena *arena) {
+    if (!arena) return 0;
+    size_t total = 0;
+    for (ArenaBlock *block = arena->head; block; block = block->next) {
+        total += block->capacity;
+    }
+    return total;
+}
+
+// ====================================================
+// Active Arena
+// ====================================================
+
+Arena* arena_activate(Arena *arena) {
+    Arena *previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+Arena* arena_get_active(void) {
+    return active_arena;
+}
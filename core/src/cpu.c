@@ -0,0 +1,80 @@
+#include "../include/cpu.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+static CpuFeatures features = {0, 0, 0, 0};
+
+// ====================================================
+// x86
+// ====================================================
+
+#if defined(__x86_64__) || defined(__i386__)
+
+static unsigned long long read_xcr0(void) {
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+}
+
+static void detect_x86(CpuFeatures *f) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return;
+
+    int has_osxsave = (ecx >> 27) & 1;
+    int has_avx = (ecx >> 28) & 1;
+    int has_fma = (ecx >> 12) & 1;
+    if (!has_osxsave || !has_avx) return;
+
+    // The OS must save YMM state (XCR0 bits 1-2), and ZMM/opmask state (bits 5-7) for AVX-512
+    unsigned long long xcr0 = read_xcr0();
+    int os_ymm = (xcr0 & 0x6) == 0x6;
+    int os_zmm = (xcr0 & 0xE6) == 0xE6;
+    if (!os_ymm) return;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return;
+    f->fma = has_fma;
+    f->avx2 = ((ebx >> 5) & 1) && has_fma;
+    f->avx512f = os_zmm && ((ebx >> 16) & 1) && f->avx2;
+}
+
+#endif
+
+// ====================================================
+// Detection
+// ====================================================
+
+static void apply_override(CpuFeatures *f) {
+    const char *cap = getenv("BASEDNN_CPU");
+    if (!cap) return;
+
+    if (strcmp(cap, "scalar") == 0) {
+        memset(f, 0, sizeof(*f));
+    } else if (strcmp(cap, "avx2") == 0) {
+        f->avx512f = 0;
+    } else if (strcmp(cap, "neon") == 0) {
+        f->avx2 = 0;
+        f->fma = 0;
+        f->avx512f = 0;
+    }
+}
+
+void cpu_detect(void) {
+    memset(&features, 0, sizeof(features));
+
+#if defined(__x86_64__) || defined(__i386__)
+    detect_x86(&features);
+#elif defined(__aarch64__)
+    // Advanced SIMD is mandatory on AArch64
+    features.neon = 1;
+#endif
+
+    apply_override(&features);
+}
+
+const CpuFeatures* cpu_get_features(void) {
+    return &features;
+}
@@ -0,0 +1,151 @@
+#include "../include/fastmath.h"
+#include "../include/elementwise.h"
+#include "fastmath_coeffs.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// ====================================================
+// Scalar Approximations
+// ====================================================
+
+// The same algorithms as the SIMD tables, one element at a time. Without
+// guaranteed FMA hardware, multiply-adds are left to the compiler to contract
+#define MADD(a, b, c) ((a) * (b) + (c))
+
+static inline float bits_to_float(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline uint32_t float_to_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline float exp_approx(float x) {
+    x = fminf(fmaxf(x, FASTMATH_EXP_MIN), FASTMATH_EXP_MAX);
+
+    float n = rintf(x * FASTMATH_LOG2E);
+    float t = MADD(n, -FASTMATH_LN2_HI, x);
+    t = MADD(n, -FASTMATH_LN2_LO, t);
+
+    float p = FASTMATH_EXP_C5;
+    p = MADD(p, t, FASTMATH_EXP_C4);
+    p = MADD(p, t, FASTMATH_EXP_C3);
+    p = MADD(p, t, FASTMATH_EXP_C2);
+    p = MADD(p, t, FASTMATH_EXP_C1);
+    p = MADD(p, t, 1.0f);
+
+    return p * bits_to_float((uint32_t)((int32_t)n + 127) << 23);
+}
+
+static inline float log_approx(float x) {
+    uint32_t bits = float_to_bits(x);
+    float e = (float)((int32_t)(bits >> 23) - 127);
+    float m = bits_to_float((bits & 0x007FFFFF) | 0x3F800000);
+    if (m > FASTMATH_SQRT2) {
+        m *= 0.5f;
+        e += 1.0f;
+    }
+
+    float f = m - 1.0f;
+    float q = FASTMATH_LOG_C6;
+    q = MADD(q, f, FASTMATH_LOG_C5);
+    q = MADD(q, f, FASTMATH_LOG_C4);
+    q = MADD(q, f, FASTMATH_LOG_C3);
+    q = MADD(q, f, FASTMATH_LOG_C2);
+    q = MADD(q, f, FASTMATH_LOG_C1);
+    q = MADD(q, f, FASTMATH_LOG_C0);
+
+    float f2 = f * f;
+    float r = MADD(f2 * f, q, MADD(f2, -0.5f, f));
+    return MADD(e, FASTMATH_LN2, r);
+}
+
+static inline float sigmoid_approx(float x) {
+    return 1.0f / (1.0f + exp_approx(-x));
+}
+
+static inline float tanh_approx(float x) {
+    float c = fminf(fmaxf(x, -FASTMATH_TANH_CLAMP), FASTMATH_TANH_CLAMP);
+    float x2 = c * c;
+
+    float p = FASTMATH_TANH_A13;
+    p = MADD(p, x2, FASTMATH_TANH_A11);
+    p = MADD(p, x2, FASTMATH_TANH_A9);
+    p = MADD(p, x2, FASTMATH_TANH_A7);
+    p = MADD(p, x2, FASTMATH_TANH_A5);
+    p = MADD(p, x2, FASTMATH_TANH_A3);
+    p = MADD(p, x2, FASTMATH_TANH_A1);
+
+    float q = FASTMATH_TANH_B6;
+    q = MADD(q, x2, FASTMATH_TANH_B4);
+    q = MADD(q, x2, FASTMATH_TANH_B2);
+    q = MADD(q, x2, FASTMATH_TANH_B0);
+
+    return fabsf(x) < FASTMATH_TANH_TINY ? x : c * p / q;
+}
+
+// log(1 + u) for u in (0, 1], with the rounding of 1 + u added back
+static inline float softplus_approx(float x) {
+    float u = exp_approx(-fabsf(x));
+    float w = 1.0f + u;
+    return fmaxf(x, 0.0f) + log_approx(w) + (u - (w - 1.0f)) / w;
+}
+
+// 0.5 (1 + tanh(z)) = sigmoid(2z)
+static inline float gelu_approx(float x) {
+    return x * sigmoid_approx(FASTMATH_GELU_2K * MADD(FASTMATH_GELU_CUBIC * x * x, x, x));
+}
+
+ELEMENTWISE_UNARY(exp_scalar, exp_approx(x))
+ELEMENTWISE_UNARY(log_scalar, log_approx(x))
+ELEMENTWISE_UNARY(sigmoid_scalar, sigmoid_approx(x))
+ELEMENTWISE_UNARY(tanh_scalar, tanh_approx(x))
+ELEMENTWISE_UNARY(gelu_scalar, gelu_approx(x))
+ELEMENTWISE_UNARY(swish_scalar, x * sigmoid_approx(x))
+ELEMENTWISE_UNARY(softplus_scalar, softplus_approx(x))
+
+const MathKernels fastmath_scalar = {
+    .name = "scalar",
+    .exp = exp_scalar,
+    .log = log_scalar,
+    .sigmoid = sigmoid_scalar,
+    .tanh = tanh_scalar,
+    .gelu = gelu_scalar,
+    .swish = swish_scalar,
+    .softplus = softplus_scalar,
+};
+
+// ====================================================
+// Mode
+// ====================================================
+
+static int fast_math_mode = -1;     // -1 until set or read from the environment
+static const MathKernels *active = &fastmath_scalar;
+
+void fastmath_set_enabled(int enabled) {
+    __atomic_store_n(&fast_math_mode, enabled ? 1 : 0, __ATOMIC_RELAXED);
+}
+
+int fastmath_enabled(void) {
+    int mode = __atomic_load_n(&fast_math_mode, __ATOMIC_RELAXED);
+    if (mode < 0) {
+        const char *env = getenv("BASEDNN_FAST_MATH");
+        mode = (env && strtol(env, NULL, 10) > 0) ? 1 : 0;
+        __atomic_store_n(&fast_math_mode, mode, __ATOMIC_RELAXED);
+    }
+    return mode;
+}
+
+const MathKernels* fastmath_kernels(void) {
+    return active;
+}
+
+void fastmath_use(const MathKernels *kernels) {
+    active = kernels ? kernels : &fastmath_scalar;
+}
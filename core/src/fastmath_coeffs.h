@@ -0,0 +1,55 @@
+#ifndef FASTMATH_COEFFS_H
+#define FASTMATH_COEFFS_H
+
+// ====================================================
+// Fast Math Constants
+// ====================================================
+
+// Shared by every backend's fast-math kernels (see fastmath.h for the error bounds)
+
+// exp(x) = 2^n * p(t), n = round(x / ln2), t = x - n ln2 in [-ln2/2, ln2/2].
+// ln2 is split so n * LN2_HI is exact; p is a degree-5 minimax polynomial
+#define FASTMATH_EXP_MIN   -87.33654475f
+#define FASTMATH_EXP_MAX    88.37626266f
+#define FASTMATH_LOG2E      1.44269504f
+#define FASTMATH_LN2_HI     0x1.62E400p-1f
+#define FASTMATH_LN2_LO     0x1.7F7D1Cp-20f
+#define FASTMATH_EXP_C5     0x1.0F9F9Cp-7f
+#define FASTMATH_EXP_C4     0x1.573A1Ap-5f
+#define FASTMATH_EXP_C3     0x1.555A80p-3f
+#define FASTMATH_EXP_C2     0x1.FFFDC6p-2f
+#define FASTMATH_EXP_C1     0x1.FFFFF6p-1f
+
+// log(x) = e ln2 + log(1 + f), mantissa m = 1 + f in [sqrt(1/2), sqrt(2)),
+// log(1 + f) = f - f^2/2 + f^3 q(f) with q fitted at Chebyshev nodes (degree 6)
+#define FASTMATH_LN2        0.693147181f
+#define FASTMATH_SQRT2      1.41421356f
+#define FASTMATH_LOG_C6     0.09048784419f
+#define FASTMATH_LOG_C5    -0.140308922f
+#define FASTMATH_LOG_C4     0.1470389917f
+#define FASTMATH_LOG_C3    -0.1660271885f
+#define FASTMATH_LOG_C2     0.1998422325f
+#define FASTMATH_LOG_C1    -0.2500070255f
+#define FASTMATH_LOG_C0     0.333334154f
+
+// tanh(x) = x p(x^2) / q(x^2), a 13/6 rational approximation; beyond the
+// clamp tanh rounds to +-1, and below TINY it rounds to x
+#define FASTMATH_TANH_CLAMP 7.90531110763549805f
+#define FASTMATH_TANH_TINY  0.0004f
+#define FASTMATH_TANH_A13  -2.76076847742355e-16f
+#define FASTMATH_TANH_A11   2.00018790482477e-13f
+#define FASTMATH_TANH_A9   -8.60467152213735e-11f
+#define FASTMATH_TANH_A7    5.12229709037114e-08f
+#define FASTMATH_TANH_A5    1.48572235717979e-05f
+#define FASTMATH_TANH_A3    6.37261928875436e-04f
+#define FASTMATH_TANH_A1    4.89352455891786e-03f
+#define FASTMATH_TANH_B6    1.19825839466702e-06f
+#define FASTMATH_TANH_B4    1.18534705686654e-04f
+#define FASTMATH_TANH_B2    2.26843463243900e-03f
+#define FASTMATH_TANH_B0    4.89352518554385e-03f
+
+// gelu(x) = x sigmoid(2 sqrt(2/pi) (x + 0.044715 x^3))
+#define FASTMATH_GELU_2K    1.5957691216f
+#define FASTMATH_GELU_CUBIC 0.044715f
+
+#endif
@@ -0,0 +1,611 @@
+#include "../include/gemm.h"
+#include "../include/threadpool.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ====================================================
+// Packing Buffers
+// ====================================================
+
+// Buffers come from free lists rather than fixed globals, so concurrent GEMMs,
+// nested GEMMs and the parallel tasks of one GEMM never share a buffer
+#define GEMM_MAX_FREE_BUFFERS 64
+
+typedef struct {
+    float *free[GEMM_MAX_FREE_BUFFERS];
+    size_t num_free;
+    size_t count;
+} GemmBufferList;
+
+static GemmBufferList buffers_a = {{NULL}, 0, GEMM_MC * GEMM_KC};
+static GemmBufferList buffers_b = {{NULL}, 0, GEMM_KC * GEMM_NC};
+static pthread_mutex_t buffer_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static float* gemm_alloc(size_t count) {
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, 64, count * sizeof(float)) != 0) return NULL;
+    return (float *)ptr;
+}
+
+static float* gemm_acquire(GemmBufferList *list) {
+    float *buf = NULL;
+    pthread_mutex_lock(&buffer_lock);
+    if (list->num_free > 0) buf = list->free[--list->num_free];
+    pthread_mutex_unlock(&buffer_lock);
+    return buf ? buf : gemm_alloc(list->count);
+}
+
+static void gemm_release(GemmBufferList *list, float *buf) {
+    if (!buf) return;
+    pthread_mutex_lock(&buffer_lock);
+    if (list->num_free < GEMM_MAX_FREE_BUFFERS) {
+        list->free[list->num_free++] = buf;
+        buf = NULL;
+    }
+    pthread_mutex_unlock(&buffer_lock);
+    free(buf);
+}
+
+void gemm_cleanup(void) {
+    pthread_mutex_lock(&buffer_lock);
+    for (size_t i = 0; i < buffers_a.num_free; i++) free(buffers_a.free[i]);
+    for (size_t i = 0; i < buffers_b.num_free; i++) free(buffers_b.free[i]);
+    buffers_a.num_free = 0;
+    buffers_b.num_free = 0;
+    pthread_mutex_unlock(&buffer_lock);
+}
+
+// ====================================================
+// Packing
+// ====================================================
+
+// Packs an mc x kc block of alpha * A into MR-row panels, each stored k-major and zero-padded to MR rows
+static void pack_a(size_t mc, size_t kc, float alpha, const float *A, size_t rsa, size_t csa, float *dst) {
+    for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR) {
+        size_t mr = (mc - i0 < GEMM_MR) ? mc - i0 : GEMM_MR;
+        for (size_t p = 0; p < kc; p++) {
+            const float *src = A + i0 * rsa + p * csa;
+            size_t i = 0;
+            if (alpha == 1.0f) {
+                for (; i < mr; i++) dst[i] = src[i * rsa];
+            } else {
+                for (; i < mr; i++) dst[i] = alpha * src[i * rsa];
+            }
+            for (; i < GEMM_MR; i++) dst[i] = 0.0f;
+            dst += GEMM_MR;
+        }
+    }
+}
+
+// Packs a kc x nc block of B into NR-column panels, each stored k-major and zero-padded to NR columns
+static void pack_b(size_t kc, size_t nc, const float *B, size_t rsb, size_t csb, float *dst) {
+    for (size_t j0 = 0; j0 < nc; j0 += GEMM_NR) {
+        size_t nr = (nc - j0 < GEMM_NR) ? nc - j0 : GEMM_NR;
+        for (size_t p = 0; p < kc; p++) {
+            const float *src = B + p * rsb + j0 * csb;
+            size_t j = 0;
+            if (csb == 1) {
+                memcpy(dst, src, nr * sizeof(float));
+                j = nr;
+            } else {
+                for (; j < nr; j++) dst[j] = src[j * csb];
+            }
+            for (; j < GEMM_NR; j++) dst[j] = 0.0f;
+            dst += GEMM_NR;
+        }
+    }
+}
+
+// ====================================================
+// Microkernel
+// ====================================================
+
+void gemm_microkernel_scalar(size_t kc, const float *a, const float *b, float *c, size_t ldc, int accumulate) {
+    float acc[GEMM_MR][GEMM_NR];
+    memset(acc, 0, sizeof(acc));
+
+    for (size_t p = 0; p < kc; p++) {
+        for (int i = 0; i < GEMM_MR; i++) {
+            float ai = a[i];
+            for (int j = 0; j < GEMM_NR; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    for (int i = 0; i < GEMM_MR; i++) {
+        float *row = c + i * ldc;
+        if (accumulate) {
+            for (int j = 0; j < GEMM_NR; j++) row[j] += acc[i][j];
+        } else {
+            for (int j = 0; j < GEMM_NR; j++) row[j] = acc[i][j];
+        }
+    }
+}
+
+void gemm_small_m_scalar(size_t m, size_t kc, const float *a, size_t rsa, size_t csa,
+                         const float *b, size_t rsb, float *c, size_t ldc, int accumulate) {
+    float acc[GEMM_SMALL_M][GEMM_NR];
+    memset(acc, 0, sizeof(acc));
+
+    for (size_t p = 0; p < kc; p++) {
+        for (size_t i = 0; i < m; i++) {
+            float ai = a[i * rsa + p * csa];
+            for (int j = 0; j < GEMM_NR; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        b += rsb;
+    }
+
+    for (size_t i = 0; i < m; i++) {
+        float *row = c + i * ldc;
+        if (accumulate) {
+            for (int j = 0; j < GEMM_NR; j++) row[j] += acc[i][j];
+        } else {
+            for (int j = 0; j < GEMM_NR; j++) row[j] = acc[i][j];
+        }
+    }
+}
+
+static GemmMicroKernelFn active_microkernel = gemm_microkernel_scalar;
+
+void gemm_set_microkernel(GemmMicroKernelFn kernel) {
+    active_microkernel = kernel ? kernel : gemm_microkernel_scalar;
+}
+
+GemmMicroKernelFn gemm_get_microkernel(void) {
+    return active_microkernel;
+}
+
+// ====================================================
+// Macrokernel
+// ====================================================
+
+// row[j] = activation(row[j] + bias[j]) over an mr x nr tile of C
+static void gemm_epilogue_tile(const GemmEpilogue *ep, const float *bias, float *c, size_t ldc, size_t mr, size_t nr) {
+    for (size_t i = 0; i < mr; i++) {
+        float *row = c + i * ldc;
+        if (bias) {
+            for (size_t j = 0; j < nr; j++) row[j] += bias[j];
+        }
+        if (ep->activation) ep->activation(row, row, nr);
+    }
+}
+
+// Multiplies a packed mc x kc block of A by a packed kc x nc block of B into C.
+// With an epilogue (final K block only), each tile is finished right after the
+// microkernel stores it, while it is still in L1; bias starts at C's first column
+static void gemm_macrokernel(GemmMicroKernelFn ukr, size_t mc, size_t nc, size_t kc,
+                             const float *pa, const float *pb, float *C, size_t ldc, int accumulate,
+                             const GemmEpilogue *ep, const float *bias) {
+    float edge[GEMM_MR * GEMM_NR];
+
+    for (size_t j0 = 0; j0 < nc; j0 += GEMM_NR) {
+        size_t nr = (nc - j0 < GEMM_NR) ? nc - j0 : GEMM_NR;
+        const float *b_panel = pb + j0 * kc;
+
+        for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR) {
+            size_t mr = (mc - i0 < GEMM_MR) ? mc - i0 : GEMM_MR;
+            const float *a_panel = pa + i0 * kc;
+            float *c_tile = C + i0 * ldc + j0;
+
+            if (mr == GEMM_MR && nr == GEMM_NR) {
+                ukr(kc, a_panel, b_panel, c_tile, ldc, accumulate);
+                if (ep) gemm_epilogue_tile(ep, bias ? bias + j0 : NULL, c_tile, ldc, mr, nr);
+                continue;
+            }
+
+            // Partial tile at the matrix edge: compute the full tile, then copy the valid part
+            ukr(kc, a_panel, b_panel, edge, GEMM_NR, 0);
+            for (size_t i = 0; i < mr; i++) {
+                float *row = c_tile + i * ldc;
+                const float *src = edge + i * GEMM_NR;
+                if (accumulate) {
+                    for (size_t j = 0; j < nr; j++) row[j] += src[j];
+                } else {
+                    for (size_t j = 0; j < nr; j++) row[j] = src[j];
+                }
+            }
+            if (ep) gemm_epilogue_tile(ep, bias ? bias + j0 : NULL, c_tile, ldc, mr, nr);
+        }
+    }
+}
+
+// ====================================================
+// GEMM
+// ====================================================
+
+// Panels of B packed per task, so packing B runs in parallel too
+#define GEMM_PACK_B_PANELS 16
+
+typedef struct {
+    GemmMicroKernelFn ukr;
+    size_t M, nc, kc;
+    float alpha;
+    const float *A;
+    size_t rsa, csa;
+    const float *B;
+    size_t rsb, csb;
+    float *C;
+    size_t ldc;
+    float *packed_b;
+    float *b_sums;          // Column sums of B at this block's first column, or NULL
+    size_t chunk_width;     // Columns per task, a multiple of NR
+    size_t num_chunks;
+    int accumulate;
+    const GemmEpilogue *epilogue;   // Set on the final K block only
+    const float *bias;              // Epilogue bias at this block's first column
+} GemmBlock;
+
+// Each task owns its panels' columns, so it can also add up their sums
+static void gemm_pack_b_task(size_t begin, size_t end, void *arg) {
+    GemmBlock *g = (GemmBlock *)arg;
+    size_t j0 = begin * GEMM_NR;
+    size_t j1 = (end * GEMM_NR < g->nc) ? end * GEMM_NR : g->nc;
+    pack_b(g->kc, j1 - j0, g->B + j0 * g->csb, g->rsb, g->csb, g->packed_b + j0 * g->kc);
+    if (!g->b_sums) return;
+
+    for (size_t j = j0; j < j1; j += GEMM_NR) {
+        size_t nr = (j1 - j < GEMM_NR) ? j1 - j : GEMM_NR;
+        const float *panel = g->packed_b + j * g->kc;
+        float *sums = g->b_sums + j;
+        for (size_t p = 0; p < g->kc; p++) {
+            for (size_t c = 0; c < nr; c++) sums[c] += panel[p * GEMM_NR + c];
+        }
+    }
+}
+
+// One task per (MC row block, column chunk) of C; each packs its own block of
+// A. Without a buffer for the block, each MR-row panel is packed on the stack
+// and run alone, which gives the same results
+static void gemm_tile_task(size_t begin, size_t end, void *arg) {
+    GemmBlock *g = (GemmBlock *)arg;
+    float *packed_a = gemm_acquire(&buffers_a);
+    float panel_a[GEMM_MR * GEMM_KC];
+    size_t step = packed_a ? GEMM_MC : GEMM_MR;
+
+    for (size_t t = begin; t < end; t++) {
+        size_t ic = (t / g->num_chunks) * GEMM_MC;
+        size_t j0 = (t % g->num_chunks) * g->chunk_width;
+        size_t mc = (g->M - ic < GEMM_MC) ? g->M - ic : GEMM_MC;
+        size_t nc = (g->nc - j0 < g->chunk_width) ? g->nc - j0 : g->chunk_width;
+
+        for (size_t i0 = 0; i0 < mc; i0 += step) {
+            size_t rows = (mc - i0 < step) ? mc - i0 : step;
+            float *pa = packed_a ? packed_a : panel_a;
+            pack_a(rows, g->kc, g->alpha, g->A + (ic + i0) * g->rsa, g->rsa, g->csa, pa);
+            gemm_macrokernel(g->ukr, rows, nc, g->kc, pa, g->packed_b + j0 * g->kc,
+                             g->C + (ic + i0) * g->ldc + j0, g->ldc, g->accumulate,
+                             g->epilogue, g->bias ? g->bias + j0 : NULL);
+        }
+    }
+
+    gemm_release(&buffers_a, packed_a);
+}
+
+// C[M x N] *= beta, where beta = 0 clears C whatever it held
+static void gemm_scale_c(float beta, float *C, size_t ldc, size_t M, size_t N) {
+    for (size_t i = 0; i < M; i++) {
+        float *row = C + i * ldc;
+        if (beta == 0.0f) {
+            memset(row, 0, N * sizeof(float));
+        } else {
+            for (size_t j = 0; j < N; j++) row[j] *= beta;
+        }
+    }
+}
+
+// b_sums[j] += sum_k B[k][j] without packing B
+static void gemm_sum_b(const float *B, size_t rsb, size_t csb, size_t K, size_t N, float *b_sums) {
+    for (size_t k = 0; k < K; k++) {
+        for (size_t j = 0; j < N; j++) b_sums[j] += B[k * rsb + j * csb];
+    }
+}
+
+// Offset of the packed kc x nc block of B at (jc, pc) in gemm_pack_b's layout:
+// column blocks in order, each holding its K blocks in order. Every column
+// block before jc is a full NC wide, a multiple of NR
+static size_t packed_b_offset(size_t K, size_t N, size_t jc, size_t pc) {
+    size_t nc = (N - jc < GEMM_NC) ? N - jc : GEMM_NC;
+    size_t padded = (nc + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+    return jc * K + pc * padded;
+}
+
+// C = alpha * A * B + beta * C. alpha scales A as it is packed; beta = 0 has the
+// first K block overwrite C, any other beta scales C up front and every block
+// accumulates. With b_sums set, B's column sums are added to it from the packed
+// panels. With prepacked set, B's panels are read from it (gemm_pack_b's
+// layout) instead of being packed, and B itself is not read. threads: workers
+// this product may keep busy, which sets how finely C is split
+static void gemm_driver(GemmMicroKernelFn ukr, size_t M, size_t N, size_t K, float alpha,
+                        const float *A, size_t rsa, size_t csa,
+                        const float *B, size_t rsb, size_t csb, const float *prepacked, float beta,
+                        float *C, size_t ldc, const GemmEpilogue *ep, float *b_sums, size_t threads) {
+    if (ep && !ep->bias && !ep->activation) ep = NULL;
+
+    if (K == 0 || alpha == 0.0f) {
+        if (beta != 1.0f) gemm_scale_c(beta, C, ldc, M, N);
+        if (ep) gemm_epilogue_tile(ep, ep->bias, C, ldc, M, N);
+        if (b_sums) gemm_sum_b(B, rsb, csb, K, N, b_sums);
+        return;
+    }
+    if (beta != 0.0f && beta != 1.0f) gemm_scale_c(beta, C, ldc, M, N);
+
+    // Without a buffer for a KC x NC block, B is packed one NR-wide panel at a
+    // time on the stack; blocking C's columns more finely gives the same results
+    float *packed_b = prepacked ? NULL : gemm_acquire(&buffers_b);
+    float panel_b[GEMM_KC * GEMM_NR];
+    size_t nc_step = (prepacked || packed_b) ? GEMM_NC : GEMM_NR;
+    float *b_block = packed_b ? packed_b : panel_b;
+
+    size_t m_blocks = (M + GEMM_MC - 1) / GEMM_MC;
+
+    for (size_t jc = 0; jc < N; jc += nc_step) {
+        size_t nc = (N - jc < nc_step) ? N - jc : nc_step;
+        size_t panels = (nc + GEMM_NR - 1) / GEMM_NR;
+
+        // Split columns only when there are too few row blocks to go around
+        size_t num_chunks = (threads + m_blocks - 1) / m_blocks;
+        if (num_chunks > panels) num_chunks = panels;
+        size_t chunk_width = ((panels + num_chunks - 1) / num_chunks) * GEMM_NR;
+        num_chunks = (nc + chunk_width - 1) / chunk_width;
+
+        for (size_t pc = 0; pc < K; pc += GEMM_KC) {
+            size_t kc = (K - pc < GEMM_KC) ? K - pc : GEMM_KC;
+            int last = pc + kc == K;
+            GemmBlock g = {
+                ukr, M, nc, kc, alpha,
+                A + pc * csa, rsa, csa,
+                prepacked ? NULL : B + pc * rsb + jc * csb, rsb, csb,
+                C + jc, ldc,
+                prepacked ? (float *)prepacked + packed_b_offset(K, N, jc, pc) : b_block,
+                b_sums ? b_sums + jc : NULL, chunk_width, num_chunks, pc > 0 || beta != 0.0f,
+                last ? ep : NULL, (last && ep && ep->bias) ? ep->bias + jc : NULL
+            };
+
+            if (!prepacked) parallel_for(0, panels, GEMM_PACK_B_PANELS, gemm_pack_b_task, &g);
+            parallel_for(0, m_blocks * num_chunks, 1, gemm_tile_task, &g);
+        }
+    }
+
+    if (packed_b) gemm_release(&buffers_b, packed_b);
+}
+
+void sgemm_with(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                const float *A, size_t lda,
+                const float *B, size_t ldb,
+                float *C, size_t ldc) {
+    if (M == 0 || N == 0) return;
+    gemm_driver(kernel ? kernel : active_microkernel, M, N, K, 1.0f, A, lda, 1, B, ldb, 1, NULL, 0.0f, C, ldc, NULL, NULL, threadpool_num_threads());
+}
+
+void sgemm_strided(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                   const float *A, size_t rsa, size_t csa,
+                   const float *B, size_t rsb, size_t csb,
+                   float *C, size_t ldc) {
+    if (M == 0 || N == 0) return;
+    gemm_driver(kernel ? kernel : active_microkernel, M, N, K, 1.0f, A, rsa, csa, B, rsb, csb, NULL, 0.0f, C, ldc, NULL, NULL, threadpool_num_threads());
+}
+
+void sgemm_fused(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                 const float *A, size_t rsa, size_t csa,
+                 const float *B, size_t rsb, size_t csb,
+                 float *C, size_t ldc, const GemmEpilogue *epilogue) {
+    if (M == 0 || N == 0) return;
+    gemm_driver(kernel ? kernel : active_microkernel, M, N, K, 1.0f, A, rsa, csa, B, rsb, csb, NULL, 0.0f, C, ldc, epilogue, NULL, threadpool_num_threads());
+}
+
+void sgemm_ex(GemmMicroKernelFn kernel, GemmTranspose trans_a, GemmTranspose trans_b,
+              size_t M, size_t N, size_t K, float alpha,
+              const float *A, size_t lda,
+              const float *B, size_t ldb, float beta,
+              float *C, size_t ldc) {
+    if (M == 0 || N == 0) return;
+
+    // A transposed operand is the same matrix read with its strides swapped
+    size_t rsa = (trans_a == GEMM_TRANS) ? 1 : lda, csa = (trans_a == GEMM_TRANS) ? lda : 1;
+    size_t rsb = (trans_b == GEMM_TRANS) ? 1 : ldb, csb = (trans_b == GEMM_TRANS) ? ldb : 1;
+    gemm_driver(kernel ? kernel : active_microkernel, M, N, K, alpha, A, rsa, csa, B, rsb, csb, NULL, beta, C, ldc, NULL, NULL, threadpool_num_threads());
+}
+
+void sgemm_strided_ex(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K, float alpha,
+                      const float *A, size_t rsa, size_t csa,
+                      const float *B, size_t rsb, size_t csb, float beta,
+                      float *C, size_t ldc, float *b_sums) {
+    if (M == 0 || N == 0) return;
+    gemm_driver(kernel ? kernel : active_microkernel, M, N, K, alpha, A, rsa, csa, B, rsb, csb, NULL, beta, C, ldc, NULL, b_sums, threadpool_num_threads());
+}
+
+size_t gemm_packed_b_size(size_t K, size_t N) {
+    return K * ((N + GEMM_NR - 1) / GEMM_NR * GEMM_NR);
+}
+
+void gemm_pack_b(size_t K, size_t N, const float *B, size_t rsb, size_t csb, float *packed) {
+    for (size_t jc = 0; jc < N; jc += GEMM_NC) {
+        size_t nc = (N - jc < GEMM_NC) ? N - jc : GEMM_NC;
+        size_t panels = (nc + GEMM_NR - 1) / GEMM_NR;
+        for (size_t pc = 0; pc < K; pc += GEMM_KC) {
+            GemmBlock g = {0};
+            g.nc = nc;
+            g.kc = (K - pc < GEMM_KC) ? K - pc : GEMM_KC;
+            g.B = B + pc * rsb + jc * csb;
+            g.rsb = rsb;
+            g.csb = csb;
+            g.packed_b = packed + packed_b_offset(K, N, jc, pc);
+            parallel_for(0, panels, GEMM_PACK_B_PANELS, gemm_pack_b_task, &g);
+        }
+    }
+}
+
+void sgemm_prepacked(GemmMicroKernelFn kernel, size_t M, size_t N, size_t K,
+                     const float *A, size_t rsa, size_t csa, const float *packed_b,
+                     float *C, size_t ldc, const GemmEpilogue *epilogue) {
+    if (M == 0 || N == 0) return;
+    gemm_driver(kernel ? kernel : active_microkernel, M, N, K, 1.0f, A, rsa, csa, NULL, 0, 0, packed_b, 0.0f, C, ldc, epilogue, NULL, threadpool_num_threads());
+}
+
+// ====================================================
+// Small-M GEMM
+// ====================================================
+
+// Multiply-adds per task: enough to cover a dispatch, few enough that a wide
+// layer's columns spread over every worker
+#define GEMM_SMALL_M_TASK_FLOPS (1u << 15)
+
+typedef struct {
+    GemmSmallMKernelFn kernel;
+    size_t M, N, K;
+    const float *A;
+    size_t rsa, csa;
+    const float *B;
+    size_t rsb;
+    const float *packed_b;
+    float *C;
+    size_t ldc;
+    const GemmEpilogue *epilogue;
+} GemmSmallM;
+
+// One task per run of NR-column panels of C, each finished over all of K (in
+// KC blocks, as sgemm sums them) and then through the epilogue
+static void gemm_small_m_task(size_t begin, size_t end, void *arg) {
+    GemmSmallM *g = (GemmSmallM *)arg;
+    float panel[GEMM_KC * GEMM_NR];
+    float tile[GEMM_SMALL_M * GEMM_NR];
+
+    for (size_t q = begin; q < end; q++) {
+        size_t j0 = q * GEMM_NR;
+        size_t nr = (g->N - j0 < GEMM_NR) ? g->N - j0 : GEMM_NR;
+        float *c = g->C + j0;
+
+        for (size_t pc = 0; pc < g->K; pc += GEMM_KC) {
+            size_t kc = (g->K - pc < GEMM_KC) ? g->K - pc : GEMM_KC;
+            const float *a = g->A + pc * g->csa;
+            const float *b;
+            size_t rsb;
+            if (g->packed_b) {
+                size_t jc = j0 / GEMM_NC * GEMM_NC;
+                b = g->packed_b + packed_b_offset(g->K, g->N, jc, pc) + (j0 - jc) * kc;
+                rsb = GEMM_NR;
+            } else {
+                b = g->B + pc * g->rsb + j0;
+                rsb = g->rsb;
+            }
+
+            if (nr == GEMM_NR) {
+                g->kernel(g->M, kc, a, g->rsa, g->csa, b, rsb, c, g->ldc, pc > 0);
+                continue;
+            }
+
+            // Edge panel: zero-padded to NR columns like a packed panel, through a tile
+            if (!g->packed_b) {
+                for (size_t p = 0; p < kc; p++) {
+                    size_t j = 0;
+                    for (; j < nr; j++) panel[p * GEMM_NR + j] = b[p * rsb + j];
+                    for (; j < GEMM_NR; j++) panel[p * GEMM_NR + j] = 0.0f;
+                }
+                b = panel;
+                rsb = GEMM_NR;
+            }
+            g->kernel(g->M, kc, a, g->rsa, g->csa, b, rsb, tile, GEMM_NR, 0);
+            for (size_t i = 0; i < g->M; i++) {
+                float *row = c + i * g->ldc;
+                for (size_t j = 0; j < nr; j++) row[j] = pc > 0 ? row[j] + tile[i * GEMM_NR + j] : tile[i * GEMM_NR + j];
+            }
+        }
+
+        if (g->epilogue) {
+            const float *bias = g->epilogue->bias ? g->epilogue->bias + j0 : NULL;
+            gemm_epilogue_tile(g->epilogue, bias, c, g->ldc, g->M, nr);
+        }
+    }
+}
+
+void sgemm_small_m(GemmSmallMKernelFn kernel, size_t M, size_t N, size_t K,
+                   const float *A, size_t rsa, size_t csa,
+                   const float *B, size_t rsb, const float *packed_b,
+                   float *C, size_t ldc, const GemmEpilogue *epilogue) {
+    if (M == 0 || N == 0 || M > GEMM_SMALL_M) return;
+    if (epilogue && !epilogue->bias && !epilogue->activation) epilogue = NULL;
+
+    if (K == 0) {
+        gemm_scale_c(0.0f, C, ldc, M, N);
+        if (epilogue) gemm_epilogue_tile(epilogue, epilogue->bias, C, ldc, M, N);
+        return;
+    }
+
+    GemmSmallM g = {
+        kernel ? kernel : gemm_small_m_scalar, M, N, K,
+        A, rsa, csa, B, rsb, packed_b, C, ldc, epilogue
+    };
+    size_t panels = (N + GEMM_NR - 1) / GEMM_NR;
+    size_t flops = M * K * GEMM_NR;
+    size_t grain = (flops < GEMM_SMALL_M_TASK_FLOPS) ? GEMM_SMALL_M_TASK_FLOPS / flops : 1;
+    parallel_for(0, panels, grain, gemm_small_m_task, &g);
+}
+
+void sgemm(size_t M, size_t N, size_t K,
+           const float *A, size_t lda,
+           const float *B, size_t ldb,
+           float *C, size_t ldc) {
+    sgemm_with(active_microkernel, M, N, K, A, lda, B, ldb, C, ldc);
+}
+
+// ====================================================
+// Batched GEMM
+// ====================================================
+
+// Multiply-adds per task; smaller products are grouped so tiny matrices (one
+// attention head at a short sequence length) do not each pay for a task
+#define GEMM_BATCH_GRAIN_FLOPS (1u << 18)
+
+typedef struct {
+    GemmMicroKernelFn ukr;
+    size_t M, N, K;
+    float alpha, beta;
+    const float *A;
+    const size_t *a_offsets;
+    size_t rsa, csa;
+    const float *B;
+    const size_t *b_offsets;
+    size_t rsb, csb;
+    float *C;
+    size_t ldc, c_stride;
+    size_t threads;         // Per product
+} GemmBatch;
+
+static void gemm_batch_task(size_t begin, size_t end, void *arg) {
+    GemmBatch *g = (GemmBatch *)arg;
+    for (size_t i = begin; i < end; i++) {
+        gemm_driver(g->ukr, g->M, g->N, g->K, g->alpha,
+                    g->A + g->a_offsets[i], g->rsa, g->csa,
+                    g->B + g->b_offsets[i], g->rsb, g->csb, NULL, g->beta,
+                    g->C + i * g->c_stride, g->ldc, NULL, NULL, g->threads);
+    }
+}
+
+void sgemm_batched(GemmMicroKernelFn kernel, size_t batch, size_t M, size_t N, size_t K, float alpha,
+                   const float *A, const size_t *a_offsets, size_t rsa, size_t csa,
+                   const float *B, const size_t *b_offsets, size_t rsb, size_t csb, float beta,
+                   float *C, size_t ldc, size_t c_stride) {
+    if (batch == 0 || M == 0 || N == 0) return;
+
+    // Whole products go to the workers first; only threads left over once
+    // every product has one split individual products
+    size_t threads = threadpool_num_threads();
+    size_t per_product = (threads > batch) ? threads / batch : 1;
+    size_t flops = M * N * (K ? K : 1);
+    size_t grain = (flops < GEMM_BATCH_GRAIN_FLOPS) ? GEMM_BATCH_GRAIN_FLOPS / flops : 1;
+    if (grain > 1 && (batch + grain - 1) / grain < threads) grain = (batch + threads - 1) / threads;
+
+    GemmBatch g = {
+        kernel ? kernel : active_microkernel, M, N, K, alpha, beta,
+        A, a_offsets, rsa, csa,
+        B, b_offsets, rsb, csb,
+        C, ldc, c_stride, per_product
+    };
+    parallel_for(0, batch, grain, gemm_batch_task, &g);
+}
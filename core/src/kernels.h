@@ -0,0 +1,163 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "../include/tensor.h"
+#include "../include/gemm.h"
+#include "../include/fastmath.h"
+#include <math.h>
+
+// ====================================================
+// Optimizer Kernels
+// ====================================================
+
+// Step-invariant factors of one Adam/AdamW update, computed once per step:
+//
+//   m = beta1 * m + (1 - beta1) * g
+//   v = beta2 * v + (1 - beta2) * g^2
+//   p = decay * p - step_size * m / (sqrt(v) * inv_sqrt_bc2 + epsilon)
+//
+// step_size = lr / (1 - beta1^t), inv_sqrt_bc2 = 1 / sqrt(1 - beta2^t) and
+// decay = 1 - lr * weight_decay (1 for plain Adam)
+typedef struct AdamCoeffs {
+    float beta1;
+    float beta2;
+    float one_minus_beta1;
+    float one_minus_beta2;
+    float step_size;
+    float inv_sqrt_bc2;
+    float epsilon;
+    float decay;
+} AdamCoeffs;
+
+// Per-element updates, used by the scalar table and the SIMD tails
+static inline void adam_element(float *p, float g, float *m, float *v, const AdamCoeffs *c) {
+    *m = c->beta1 * *m + c->one_minus_beta1 * g;
+    *v = c->beta2 * *v + c->one_minus_beta2 * g * g;
+    *p = c->decay * *p - c->step_size * *m / (sqrtf(*v) * c->inv_sqrt_bc2 + c->epsilon);
+}
+
+static inline void sgd_element(float *p, float g, float *velocity, float lr, float momentum) {
+    if (velocity) {
+        *velocity = momentum * *velocity - lr * g;
+        *p += *velocity;
+    } else {
+        *p -= lr * g;
+    }
+}
+
+// Fully unrolls a loop over the rows of a small-M kernel, so its accumulator
+// array stays in registers
+#define SMALL_M_UNROLL _Pragma("GCC unroll 8")
+
+// ====================================================
+// Kernel Tables
+// ====================================================
+
+// Raw float kernels for one instruction set. ops.c wraps each table into
+// tensor-level operations and registers them with register_operation_backend.
+typedef struct OpKernels {
+    const char *name;
+    int priority;
+
+    GemmMicroKernelFn gemm;
+    GemmSmallMKernelFn small_m;
+
+    void (*add)(const float *a, const float *b, float *c, size_t n);
+    void (*sub)(const float *a, const float *b, float *c, size_t n);
+    void (*mul)(const float *a, const float *b, float *c, size_t n);
+    void (*div)(const float *a, const float *b, float *c, size_t n);
+
+    void (*relu)(const float *x, float *y, size_t n);
+    void (*sigmoid)(const float *x, float *y, size_t n);
+    void (*tanh)(const float *x, float *y, size_t n);
+    void (*softmax)(const float *x, float *y, size_t n);
+
+    // Loss kernels return the unnormalized sum over n elements
+    float (*mse)(const float *pred, const float *target, size_t n);
+    float (*cross_entropy)(const float *pred, const float *target, size_t n);
+    float (*binary_cross_entropy)(const float *pred, const float *target, size_t n);
+
+    // Optimizer updates over n elements of one parameter. sgd skips the
+    // velocity when it is NULL
+    void (*adam)(float *p, const float *g, float *m, float *v, size_t n, const AdamCoeffs *c);
+    void (*sgd)(float *p, const float *g, float *velocity, size_t n, float lr, float momentum);
+
+    // Approximations used for sigmoid/tanh when fast math is enabled
+    const MathKernels *fast_math;
+} OpKernels;
+
+extern const OpKernels kernels_scalar;
+extern const MathKernels fastmath_scalar;
+
+// Makes kernels (NULL: the scalar ones) what fastmath_kernels() returns
+void fastmath_use(const MathKernels *kernels);
+
+// Makes kernels (NULL: the scalar ones) the table optimizer steps run on
+void optimizer_use(const OpKernels *kernels);
+
+// Each returns NULL when the instruction set is not compiled in or not supported by the host
+const OpKernels* kernels_avx2(void);
+const OpKernels* kernels_avx512(void);
+const OpKernels* kernels_neon(void);
+
+// ====================================================
+// Tensor-Level Operations
+// ====================================================
+
+Tensor* ops_add_with(const OpKernels *k, Tensor *A, Tensor *B);
+Tensor* ops_sub_with(const OpKernels *k, Tensor *A, Tensor *B);
+Tensor* ops_mul_with(const OpKernels *k, Tensor *A, Tensor *B);
+Tensor* ops_div_with(const OpKernels *k, Tensor *A, Tensor *B);
+Tensor* ops_matmul_with(const OpKernels *k, Tensor *A, Tensor *B);
+Tensor* ops_relu_with(const OpKernels *k, Tensor *Z);
+Tensor* ops_sigmoid_with(const OpKernels *k, Tensor *Z);
+Tensor* ops_tanh_with(const OpKernels *k, Tensor *Z);
+Tensor* ops_softmax_with(const OpKernels *k, Tensor *Z);
+Tensor* ops_mse_with(const OpKernels *k, Tensor *predictions, Tensor *targets);
+Tensor* ops_cross_entropy_with(const OpKernels *k, Tensor *predictions, Tensor *targets);
+Tensor* ops_binary_cross_entropy_with(const OpKernels *k, Tensor *predictions, Tensor *targets);
+Tensor* ops_softmax_cross_entropy_with(const OpKernels *k, Tensor *logits, Tensor *targets);
+Tensor* ops_sparse_cross_entropy_with(const OpKernels *k, Tensor *predictions, Tensor *labels);
+Tensor* ops_sparse_softmax_cross_entropy_with(const OpKernels *k, Tensor *logits, Tensor *labels);
+
+// Defines OpFn wrappers bound to one kernel table and a function registering them
+#define OPS_DEFINE_BACKEND(isa, table) \
+    static Tensor* isa##_add(Tensor *a, Tensor *b) { return ops_add_with(&table, a, b); } \
+    static Tensor* isa##_sub(Tensor *a, Tensor *b) { return ops_sub_with(&table, a, b); } \
+    static Tensor* isa##_mul(Tensor *a, Tensor *b) { return ops_mul_with(&table, a, b); } \
+    static Tensor* isa##_div(Tensor *a, Tensor *b) { return ops_div_with(&table, a, b); } \
+    static Tensor* isa##_matmul(Tensor *a, Tensor *b) { return ops_matmul_with(&table, a, b); } \
+    static Tensor* isa##_relu(Tensor *a, Tensor *b) { (void)b; return ops_relu_with(&table, a); } \
+    static Tensor* isa##_sigmoid(Tensor *a, Tensor *b) { (void)b; return ops_sigmoid_with(&table, a); } \
+    static Tensor* isa##_tanh(Tensor *a, Tensor *b) { (void)b; return ops_tanh_with(&table, a); } \
+    static Tensor* isa##_softmax(Tensor *a, Tensor *b) { (void)b; return ops_softmax_with(&table, a); } \
+    static Tensor* isa##_mse(Tensor *a, Tensor *b) { return ops_mse_with(&table, a, b); } \
+    static Tensor* isa##_cross_entropy(Tensor *a, Tensor *b) { return ops_cross_entropy_with(&table, a, b); } \
+    static Tensor* isa##_binary_cross_entropy(Tensor *a, Tensor *b) { return ops_binary_cross_entropy_with(&table, a, b); } \
+    static Tensor* isa##_softmax_cross_entropy(Tensor *a, Tensor *b) { return ops_softmax_cross_entropy_with(&table, a, b); } \
+    static Tensor* isa##_sparse_cross_entropy(Tensor *a, Tensor *b) { return ops_sparse_cross_entropy_with(&table, a, b); } \
+    static Tensor* isa##_sparse_softmax_cross_entropy(Tensor *a, Tensor *b) { return ops_sparse_softmax_cross_entropy_with(&table, a, b); } \
+    void ops_register_##isa(void) { \
+        register_operation_backend("add", isa##_add, table.priority); \
+        register_operation_backend("sub", isa##_sub, table.priority); \
+        register_operation_backend("mul", isa##_mul, table.priority); \
+        register_operation_backend("div", isa##_div, table.priority); \
+        register_operation_backend("matmul", isa##_matmul, table.priority); \
+        register_operation_backend("relu", isa##_relu, table.priority); \
+        register_operation_backend("sigmoid", isa##_sigmoid, table.priority); \
+        register_operation_backend("tanh", isa##_tanh, table.priority); \
+        register_operation_backend("softmax", isa##_softmax, table.priority); \
+        register_operation_backend("mse", isa##_mse, table.priority); \
+        register_operation_backend("cross_entropy", isa##_cross_entropy, table.priority); \
+        register_operation_backend("binary_cross_entropy", isa##_binary_cross_entropy, table.priority); \
+        register_operation_backend("softmax_cross_entropy", isa##_softmax_cross_entropy, table.priority); \
+        register_operation_backend("sparse_cross_entropy", isa##_sparse_cross_entropy, table.priority); \
+        register_operation_backend("sparse_softmax_cross_entropy", isa##_sparse_softmax_cross_entropy, table.priority); \
+    }
+
+void ops_register_scalar(void);
+void ops_register_avx2(void);
+void ops_register_avx512(void);
+void ops_register_neon(void);
+
+#endif
@@ -0,0 +1,553 @@
+#include "kernels.h"
+#include "fastmath_coeffs.h"
+#include "../include/registry.h"
+#include "../include/cpu.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// Compiled for AVX2+FMA regardless of the global -march; only reached after cpu_detect
+#define AVX2_FN __attribute__((target("avx2,fma")))
+
+// ====================================================
+// Math Helpers
+// ====================================================
+
+// Cephes-style expf: range reduction by ln2, degree-6 polynomial, 2^n by exponent bits
+AVX2_FN static inline __m256 exp256(__m256 x) {
+    x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+    x = _mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f));
+
+    __m256 fx = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(0.693359375f), x);
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(-2.12194440e-4f), x);
+
+    __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894e-2f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201e-1f));
+    y = _mm256_fmadd_ps(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+
+    __m256i n = _mm256_add_epi32(_mm256_cvtps_epi32(fx), _mm256_set1_epi32(127));
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(n, 23)));
+}
+
+// Cephes-style logf for positive normal inputs
+AVX2_FN static inline __m256 log256(__m256 x) {
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    x = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                            _mm256_set1_epi32(0x3F000000)));
+
+    __m256 small = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+    x = _mm256_add_ps(_mm256_sub_ps(x, _mm256_set1_ps(1.0f)), _mm256_and_ps(small, x));
+
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    x = _mm256_add_ps(x, y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), x);
+}
+
+AVX2_FN static inline float hsum256(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+AVX2_FN static inline float hmax256(__m256 v) {
+    __m128 s = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_max_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+// ====================================================
+// GEMM Microkernel
+// ====================================================
+
+AVX2_FN static void gemm_avx2(size_t kc, const float *a, const float *b, float *c, size_t ldc, int accumulate) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (size_t p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+        __m256 ai;
+
+        ai = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+        ai = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+        ai = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+        ai = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+        ai = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+        ai = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    __m256 rows[GEMM_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (int i = 0; i < GEMM_MR; i++) {
+        float *row = c + i * ldc;
+        if (accumulate) {
+            rows[i][0] = _mm256_add_ps(rows[i][0], _mm256_loadu_ps(row));
+            rows[i][1] = _mm256_add_ps(rows[i][1], _mm256_loadu_ps(row + 8));
+        }
+        _mm256_storeu_ps(row, rows[i][0]);
+        _mm256_storeu_ps(row + 8, rows[i][1]);
+    }
+}
+
+// Small-M rows [0, ROWS): each B row is loaded once and feeds every row from
+// registers, with the microkernel's summation order
+#define AVX2_SMALL_M_ROWS(ROWS) \
+    AVX2_FN static void small_m_rows##ROWS##_avx2(size_t kc, const float *a, size_t rsa, size_t csa, \
+                                                  const float *b, size_t rsb, float *c, size_t ldc, int accumulate) { \
+        __m256 acc[ROWS][2]; \
+        SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) acc[i][0] = acc[i][1] = _mm256_setzero_ps(); \
+        for (size_t p = 0; p < kc; p++) { \
+            __m256 b0 = _mm256_loadu_ps(b); \
+            __m256 b1 = _mm256_loadu_ps(b + 8); \
+            SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) { \
+                __m256 ai = _mm256_broadcast_ss(a + i * rsa + p * csa); \
+                acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]); \
+                acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]); \
+            } \
+            b += rsb; \
+        } \
+        SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) { \
+            float *row = c + i * ldc; \
+            if (accumulate) { \
+                acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(row)); \
+                acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(row + 8)); \
+            } \
+            _mm256_storeu_ps(row, acc[i][0]); \
+            _mm256_storeu_ps(row + 8, acc[i][1]); \
+        } \
+    }
+
+AVX2_SMALL_M_ROWS(1)
+AVX2_SMALL_M_ROWS(2)
+AVX2_SMALL_M_ROWS(3)
+AVX2_SMALL_M_ROWS(4)
+
+// Four rows at a time: eight accumulators plus the B row fit the 16 registers
+AVX2_FN static void small_m_avx2(size_t m, size_t kc, const float *a, size_t rsa, size_t csa,
+                                 const float *b, size_t rsb, float *c, size_t ldc, int accumulate) {
+    for (size_t i = 0; i < m; i += 4) {
+        const float *ai = a + i * rsa;
+        float *ci = c + i * ldc;
+        switch (m - i) {
+            case 1: small_m_rows1_avx2(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+            case 2: small_m_rows2_avx2(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+            case 3: small_m_rows3_avx2(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+            default: small_m_rows4_avx2(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+        }
+    }
+}
+
+// ====================================================
+// Elementwise Kernels
+// ====================================================
+
+AVX2_FN static void add_avx2(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+AVX2_FN static void sub_avx2(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; i++) c[i] = a[i] - b[i];
+}
+
+AVX2_FN static void mul_avx2(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; i++) c[i] = a[i] * b[i];
+}
+
+AVX2_FN static void div_avx2(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, _mm256_div_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; i++) c[i] = a[i] / b[i];
+}
+
+// ====================================================
+// Activation Kernels
+// ====================================================
+
+AVX2_FN static void relu_avx2(const float *x, float *y, size_t n) {
+    __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(y + i, _mm256_max_ps(_mm256_loadu_ps(x + i), zero));
+    for (; i < n; i++) y[i] = x[i] > 0.0f ? x[i] : 0.0f;
+}
+
+AVX2_FN static void sigmoid_avx2(const float *x, float *y, size_t n) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 e = exp256(_mm256_xor_ps(_mm256_loadu_ps(x + i), sign));
+        _mm256_storeu_ps(y + i, _mm256_div_ps(one, _mm256_add_ps(one, e)));
+    }
+    for (; i < n; i++) y[i] = 1.0f / (1.0f + expf(-x[i]));
+}
+
+AVX2_FN static void tanh_avx2(const float *x, float *y, size_t n) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 two = _mm256_set1_ps(2.0f);
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 s = _mm256_and_ps(v, sign);
+        __m256 ax = _mm256_andnot_ps(sign, v);
+
+        // |x| >= 0.625: 1 - 2 / (exp(2|x|) + 1), sign restored afterwards
+        __m256 e = exp256(_mm256_mul_ps(ax, two));
+        __m256 large = _mm256_sub_ps(one, _mm256_div_ps(two, _mm256_add_ps(e, one)));
+        large = _mm256_or_ps(large, s);
+
+        // |x| < 0.625: odd polynomial, accurate near zero
+        __m256 z = _mm256_mul_ps(v, v);
+        __m256 p = _mm256_set1_ps(-5.70498872745e-3f);
+        p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(2.06390887954e-2f));
+        p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(-5.37397155531e-2f));
+        p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.33314422036e-1f));
+        p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(-3.33332819422e-1f));
+        __m256 small = _mm256_fmadd_ps(_mm256_mul_ps(p, z), v, v);
+
+        __m256 use_small = _mm256_cmp_ps(ax, _mm256_set1_ps(0.625f), _CMP_LT_OQ);
+        _mm256_storeu_ps(y + i, _mm256_blendv_ps(large, small, use_small));
+    }
+    for (; i < n; i++) y[i] = tanhf(x[i]);
+}
+
+AVX2_FN static void softmax_avx2(const float *x, float *y, size_t n) {
+    size_t i = 0;
+    float max_val = x[0];
+    if (n >= 8) {
+        __m256 vmax = _mm256_loadu_ps(x);
+        for (i = 8; i + 8 <= n; i += 8) vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(x + i));
+        max_val = hmax256(vmax);
+    }
+    for (; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+
+    __m256 vshift = _mm256_set1_ps(max_val);
+    __m256 vsum = _mm256_setzero_ps();
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256 e = exp256(_mm256_sub_ps(_mm256_loadu_ps(x + i), vshift));
+        _mm256_storeu_ps(y + i, e);
+        vsum = _mm256_add_ps(vsum, e);
+    }
+    float sum = hsum256(vsum);
+    for (; i < n; i++) {
+        y[i] = expf(x[i] - max_val);
+        sum += y[i];
+    }
+
+    __m256 vsum_all = _mm256_set1_ps(sum);
+    for (i = 0; i + 8 <= n; i += 8) _mm256_storeu_ps(y + i, _mm256_div_ps(_mm256_loadu_ps(y + i), vsum_all));
+    for (; i < n; i++) y[i] /= sum;
+}
+
+// ====================================================
+// Loss Kernels
+// ====================================================
+
+AVX2_FN static float mse_avx2(const float *pred, const float *target, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(pred + i), _mm256_loadu_ps(target + i));
+        acc = _mm256_fmadd_ps(d, d, acc);
+    }
+    float sum = hsum256(acc);
+    for (; i < n; i++) {
+        float d = pred[i] - target[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+AVX2_FN static float cross_entropy_avx2(const float *pred, const float *target, size_t n) {
+    float epsilon = 1e-7f;
+    __m256 lo = _mm256_set1_ps(epsilon);
+    __m256 hi = _mm256_set1_ps(1.0f - epsilon);
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(pred + i), lo), hi);
+        acc = _mm256_fnmadd_ps(_mm256_loadu_ps(target + i), log256(p), acc);
+    }
+    float sum = hsum256(acc);
+    for (; i < n; i++) {
+        float p = pred[i];
+        p = p < epsilon ? epsilon : (p > 1.0f - epsilon ? 1.0f - epsilon : p);
+        sum += -target[i] * logf(p);
+    }
+    return sum;
+}
+
+AVX2_FN static float binary_cross_entropy_avx2(const float *pred, const float *target, size_t n) {
+    float epsilon = 1e-7f;
+    __m256 lo = _mm256_set1_ps(epsilon);
+    __m256 hi = _mm256_set1_ps(1.0f - epsilon);
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(pred + i), lo), hi);
+        __m256 t = _mm256_loadu_ps(target + i);
+        acc = _mm256_fnmadd_ps(t, log256(p), acc);
+        acc = _mm256_fnmadd_ps(_mm256_sub_ps(one, t), log256(_mm256_sub_ps(one, p)), acc);
+    }
+    float sum = hsum256(acc);
+    for (; i < n; i++) {
+        float p = pred[i];
+        p = p < epsilon ? epsilon : (p > 1.0f - epsilon ? 1.0f - epsilon : p);
+        sum += -target[i] * logf(p) - (1.0f - target[i]) * logf(1.0f - p);
+    }
+    return sum;
+}
+
+// ====================================================
+// Fast Math Kernels
+// ====================================================
+
+#define FM256(c) _mm256_set1_ps(c)
+
+// 1/d from the 12-bit estimate and one Newton step
+AVX2_FN static inline __m256 rcp256(__m256 d) {
+    __m256 r = _mm256_rcp_ps(d);
+    return _mm256_mul_ps(r, _mm256_fnmadd_ps(d, r, FM256(2.0f)));
+}
+
+AVX2_FN static inline __m256 abs256(__m256 x) {
+    return _mm256_andnot_ps(FM256(-0.0f), x);
+}
+
+AVX2_FN static inline __m256 exp256_fast(__m256 x) {
+    x = _mm256_max_ps(_mm256_min_ps(x, FM256(FASTMATH_EXP_MAX)), FM256(FASTMATH_EXP_MIN));
+
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, FM256(FASTMATH_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 t = _mm256_fnmadd_ps(n, FM256(FASTMATH_LN2_HI), x);
+    t = _mm256_fnmadd_ps(n, FM256(FASTMATH_LN2_LO), t);
+
+    __m256 p = FM256(FASTMATH_EXP_C5);
+    p = _mm256_fmadd_ps(p, t, FM256(FASTMATH_EXP_C4));
+    p = _mm256_fmadd_ps(p, t, FM256(FASTMATH_EXP_C3));
+    p = _mm256_fmadd_ps(p, t, FM256(FASTMATH_EXP_C2));
+    p = _mm256_fmadd_ps(p, t, FM256(FASTMATH_EXP_C1));
+    p = _mm256_fmadd_ps(p, t, FM256(1.0f));
+
+    __m256i scale = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(scale));
+}
+
+AVX2_FN static inline __m256 log256_fast(__m256 x) {
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                   _mm256_set1_epi32(0x3F800000)));
+
+    __m256 high = _mm256_cmp_ps(m, FM256(FASTMATH_SQRT2), _CMP_GT_OQ);
+    m = _mm256_blendv_ps(m, _mm256_mul_ps(m, FM256(0.5f)), high);
+    e = _mm256_add_ps(e, _mm256_and_ps(high, FM256(1.0f)));
+
+    __m256 f = _mm256_sub_ps(m, FM256(1.0f));
+    __m256 q = FM256(FASTMATH_LOG_C6);
+    q = _mm256_fmadd_ps(q, f, FM256(FASTMATH_LOG_C5));
+    q = _mm256_fmadd_ps(q, f, FM256(FASTMATH_LOG_C4));
+    q = _mm256_fmadd_ps(q, f, FM256(FASTMATH_LOG_C3));
+    q = _mm256_fmadd_ps(q, f, FM256(FASTMATH_LOG_C2));
+    q = _mm256_fmadd_ps(q, f, FM256(FASTMATH_LOG_C1));
+    q = _mm256_fmadd_ps(q, f, FM256(FASTMATH_LOG_C0));
+
+    __m256 f2 = _mm256_mul_ps(f, f);
+    __m256 r = _mm256_fmadd_ps(_mm256_mul_ps(f2, f), q, _mm256_fnmadd_ps(f2, FM256(0.5f), f));
+    return _mm256_fmadd_ps(e, FM256(FASTMATH_LN2), r);
+}
+
+AVX2_FN static inline __m256 sigmoid256_fast(__m256 x) {
+    return rcp256(_mm256_add_ps(FM256(1.0f), exp256_fast(_mm256_xor_ps(x, FM256(-0.0f)))));
+}
+
+AVX2_FN static inline __m256 tanh256_fast(__m256 x) {
+    __m256 c = _mm256_max_ps(_mm256_min_ps(x, FM256(FASTMATH_TANH_CLAMP)), FM256(-FASTMATH_TANH_CLAMP));
+    __m256 x2 = _mm256_mul_ps(c, c);
+
+    __m256 p = FM256(FASTMATH_TANH_A13);
+    p = _mm256_fmadd_ps(p, x2, FM256(FASTMATH_TANH_A11));
+    p = _mm256_fmadd_ps(p, x2, FM256(FASTMATH_TANH_A9));
+    p = _mm256_fmadd_ps(p, x2, FM256(FASTMATH_TANH_A7));
+    p = _mm256_fmadd_ps(p, x2, FM256(FASTMATH_TANH_A5));
+    p = _mm256_fmadd_ps(p, x2, FM256(FASTMATH_TANH_A3));
+    p = _mm256_fmadd_ps(p, x2, FM256(FASTMATH_TANH_A1));
+
+    __m256 q = FM256(FASTMATH_TANH_B6);
+    q = _mm256_fmadd_ps(q, x2, FM256(FASTMATH_TANH_B4));
+    q = _mm256_fmadd_ps(q, x2, FM256(FASTMATH_TANH_B2));
+    q = _mm256_fmadd_ps(q, x2, FM256(FASTMATH_TANH_B0));
+
+    __m256 r = _mm256_mul_ps(_mm256_mul_ps(c, p), rcp256(q));
+    __m256 tiny = _mm256_cmp_ps(abs256(x), FM256(FASTMATH_TANH_TINY), _CMP_LT_OQ);
+    return _mm256_blendv_ps(r, x, tiny);
+}
+
+AVX2_FN static inline __m256 gelu256_fast(__m256 x) {
+    __m256 z = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_mul_ps(x, x), FM256(FASTMATH_GELU_CUBIC)), x, x);
+    return _mm256_mul_ps(x, sigmoid256_fast(_mm256_mul_ps(z, FM256(FASTMATH_GELU_2K))));
+}
+
+AVX2_FN static inline __m256 swish256_fast(__m256 x) {
+    return _mm256_mul_ps(x, sigmoid256_fast(x));
+}
+
+// max(x, 0) + log(1 + u), u = exp(-|x|), with the rounding of 1 + u added back
+AVX2_FN static inline __m256 softplus256_fast(__m256 x) {
+    __m256 u = exp256_fast(_mm256_or_ps(x, FM256(-0.0f)));
+    __m256 w = _mm256_add_ps(FM256(1.0f), u);
+    __m256 c = _mm256_sub_ps(u, _mm256_sub_ps(w, FM256(1.0f)));
+    __m256 l = _mm256_fmadd_ps(c, rcp256(w), log256_fast(w));
+    return _mm256_add_ps(_mm256_max_ps(x, _mm256_setzero_ps()), l);
+}
+
+// The tail goes through a zero-padded vector so every element sees the same approximation
+#define AVX2_UNARY_KERNEL(fn_name, vec_fn) \
+    AVX2_FN static void fn_name(const float *x, float *y, size_t n) { \
+        size_t i = 0; \
+        for (; i + 8 <= n; i += 8) _mm256_storeu_ps(y + i, vec_fn(_mm256_loadu_ps(x + i))); \
+        if (i < n) { \
+            float buf[8] = {0}; \
+            memcpy(buf, x + i, (n - i) * sizeof(float)); \
+            _mm256_storeu_ps(buf, vec_fn(_mm256_loadu_ps(buf))); \
+            memcpy(y + i, buf, (n - i) * sizeof(float)); \
+        } \
+    }
+
+AVX2_UNARY_KERNEL(exp_fast_avx2, exp256_fast)
+AVX2_UNARY_KERNEL(log_fast_avx2, log256_fast)
+AVX2_UNARY_KERNEL(sigmoid_fast_avx2, sigmoid256_fast)
+AVX2_UNARY_KERNEL(tanh_fast_avx2, tanh256_fast)
+AVX2_UNARY_KERNEL(gelu_fast_avx2, gelu256_fast)
+AVX2_UNARY_KERNEL(swish_fast_avx2, swish256_fast)
+AVX2_UNARY_KERNEL(softplus_fast_avx2, softplus256_fast)
+
+static const MathKernels avx2_fast_math = {
+    .name = "avx2",
+    .exp = exp_fast_avx2,
+    .log = log_fast_avx2,
+    .sigmoid = sigmoid_fast_avx2,
+    .tanh = tanh_fast_avx2,
+    .gelu = gelu_fast_avx2,
+    .swish = swish_fast_avx2,
+    .softplus = softplus_fast_avx2,
+};
+
+// ====================================================
+// Optimizer Kernels
+// ====================================================
+
+AVX2_FN static void adam_avx2(float *p, const float *g, float *m, float *v, size_t n, const AdamCoeffs *c) {
+    __m256 beta1 = _mm256_set1_ps(c->beta1), one_minus_beta1 = _mm256_set1_ps(c->one_minus_beta1);
+    __m256 beta2 = _mm256_set1_ps(c->beta2), one_minus_beta2 = _mm256_set1_ps(c->one_minus_beta2);
+    __m256 step_size = _mm256_set1_ps(c->step_size), inv_sqrt_bc2 = _mm256_set1_ps(c->inv_sqrt_bc2);
+    __m256 epsilon = _mm256_set1_ps(c->epsilon), decay = _mm256_set1_ps(c->decay);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 gi = _mm256_loadu_ps(g + i);
+        __m256 mi = _mm256_fmadd_ps(beta1, _mm256_loadu_ps(m + i), _mm256_mul_ps(one_minus_beta1, gi));
+        __m256 vi = _mm256_fmadd_ps(beta2, _mm256_loadu_ps(v + i), _mm256_mul_ps(_mm256_mul_ps(one_minus_beta2, gi), gi));
+        __m256 denom = _mm256_fmadd_ps(_mm256_sqrt_ps(vi), inv_sqrt_bc2, epsilon);
+        __m256 pi = _mm256_fnmadd_ps(step_size, _mm256_div_ps(mi, denom), _mm256_mul_ps(decay, _mm256_loadu_ps(p + i)));
+        _mm256_storeu_ps(m + i, mi);
+        _mm256_storeu_ps(v + i, vi);
+        _mm256_storeu_ps(p + i, pi);
+    }
+    for (; i < n; i++) adam_element(p + i, g[i], m + i, v + i, c);
+}
+
+AVX2_FN static void sgd_avx2(float *p, const float *g, float *velocity, size_t n, float lr, float momentum) {
+    __m256 vlr = _mm256_set1_ps(lr), vmomentum = _mm256_set1_ps(momentum);
+    size_t i = 0;
+    if (velocity) {
+        for (; i + 8 <= n; i += 8) {
+            __m256 vel = _mm256_fnmadd_ps(vlr, _mm256_loadu_ps(g + i), _mm256_mul_ps(vmomentum, _mm256_loadu_ps(velocity + i)));
+            _mm256_storeu_ps(velocity + i, vel);
+            _mm256_storeu_ps(p + i, _mm256_add_ps(_mm256_loadu_ps(p + i), vel));
+        }
+    } else {
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(p + i, _mm256_fnmadd_ps(vlr, _mm256_loadu_ps(g + i), _mm256_loadu_ps(p + i)));
+        }
+    }
+    for (; i < n; i++) sgd_element(p + i, g[i], velocity ? velocity + i : NULL, lr, momentum);
+}
+
+// ====================================================
+// Kernel Table
+// ====================================================
+
+static const OpKernels avx2_table = {
+    .name = "avx2",
+    .priority = BACKEND_PRIORITY_AVX2,
+    .gemm = gemm_avx2,
+    .small_m = small_m_avx2,
+    .add = add_avx2,
+    .sub = sub_avx2,
+    .mul = mul_avx2,
+    .div = div_avx2,
+    .relu = relu_avx2,
+    .sigmoid = sigmoid_avx2,
+    .tanh = tanh_avx2,
+    .softmax = softmax_avx2,
+    .mse = mse_avx2,
+    .cross_entropy = cross_entropy_avx2,
+    .binary_cross_entropy = binary_cross_entropy_avx2,
+    .adam = adam_avx2,
+    .sgd = sgd_avx2,
+    .fast_math = &avx2_fast_math,
+};
+
+OPS_DEFINE_BACKEND(avx2, avx2_table)
+
+const OpKernels* kernels_avx2(void) {
+    return cpu_get_features()->avx2 ? &avx2_table : NULL;
+}
+
+#else
+
+const OpKernels* kernels_avx2(void) { return NULL; }
+void ops_register_avx2(void) {}
+
+#endif
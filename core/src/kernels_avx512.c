@@ -0,0 +1,480 @@
+#include "kernels.h"
+#include "fastmath_coeffs.h"
+#include "../include/registry.h"
+#include "../include/cpu.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// Compiled for AVX-512F regardless of the global -march; only reached after cpu_detect
+#define AVX512_FN __attribute__((target("avx512f,avx2,fma")))
+
+// ====================================================
+// Math Helpers
+// ====================================================
+
+AVX512_FN static inline __mmask16 tail_mask(size_t remaining) {
+    return (__mmask16)((1u << remaining) - 1u);
+}
+
+// Same reduction and polynomial as the AVX2 exp256
+AVX512_FN static inline __m512 exp512(__m512 x) {
+    x = _mm512_min_ps(x, _mm512_set1_ps(88.3762626647949f));
+    x = _mm512_max_ps(x, _mm512_set1_ps(-88.3762626647949f));
+
+    __m512 fx = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504088896341f)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(0.693359375f), x);
+    x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(-2.12194440e-4f), x);
+
+    __m512 y = _mm512_set1_ps(1.9875691500e-4f);
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.3981999507e-3f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(8.3334519073e-3f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(4.1665795894e-2f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.6666665459e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(5.0000001201e-1f));
+    y = _mm512_fmadd_ps(y, _mm512_mul_ps(x, x), _mm512_add_ps(x, _mm512_set1_ps(1.0f)));
+
+    __m512i n = _mm512_add_epi32(_mm512_cvtps_epi32(fx), _mm512_set1_epi32(127));
+    return _mm512_mul_ps(y, _mm512_castsi512_ps(_mm512_slli_epi32(n, 23)));
+}
+
+// Same reduction and polynomial as the AVX2 log256
+AVX512_FN static inline __m512 log512(__m512 x) {
+    __m512i bits = _mm512_castps_si512(x);
+    __m512 e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(126)));
+    x = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)),
+                                            _mm512_set1_epi32(0x3F000000)));
+
+    __mmask16 small = _mm512_cmp_ps_mask(x, _mm512_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm512_mask_sub_ps(e, small, e, _mm512_set1_ps(1.0f));
+    x = _mm512_mask_add_ps(_mm512_sub_ps(x, _mm512_set1_ps(1.0f)), small,
+                           _mm512_sub_ps(x, _mm512_set1_ps(1.0f)), x);
+
+    __m512 z = _mm512_mul_ps(x, x);
+    __m512 y = _mm512_set1_ps(7.0376836292e-2f);
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(-1.1514610310e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.1676998740e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(-1.2420140846e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(1.4249322787e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(-1.6668057665e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(2.0000714765e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(-2.4999993993e-1f));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(3.3333331174e-1f));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, x), z);
+
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(-2.12194440e-4f), y);
+    y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+    x = _mm512_add_ps(x, y);
+    return _mm512_fmadd_ps(e, _mm512_set1_ps(0.693359375f), x);
+}
+
+AVX512_FN static inline __m512 neg512(__m512 x) {
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(x), _mm512_set1_epi32((int)0x80000000)));
+}
+
+// ====================================================
+// GEMM Microkernel
+// ====================================================
+
+AVX512_FN static void gemm_avx512(size_t kc, const float *a, const float *b, float *c, size_t ldc, int accumulate) {
+    __m512 c0 = _mm512_setzero_ps(), c1 = _mm512_setzero_ps(), c2 = _mm512_setzero_ps();
+    __m512 c3 = _mm512_setzero_ps(), c4 = _mm512_setzero_ps(), c5 = _mm512_setzero_ps();
+
+    for (size_t p = 0; p < kc; p++) {
+        __m512 bv = _mm512_loadu_ps(b);
+        c0 = _mm512_fmadd_ps(_mm512_set1_ps(a[0]), bv, c0);
+        c1 = _mm512_fmadd_ps(_mm512_set1_ps(a[1]), bv, c1);
+        c2 = _mm512_fmadd_ps(_mm512_set1_ps(a[2]), bv, c2);
+        c3 = _mm512_fmadd_ps(_mm512_set1_ps(a[3]), bv, c3);
+        c4 = _mm512_fmadd_ps(_mm512_set1_ps(a[4]), bv, c4);
+        c5 = _mm512_fmadd_ps(_mm512_set1_ps(a[5]), bv, c5);
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    __m512 rows[GEMM_MR] = {c0, c1, c2, c3, c4, c5};
+    for (int i = 0; i < GEMM_MR; i++) {
+        float *row = c + i * ldc;
+        if (accumulate) rows[i] = _mm512_add_ps(rows[i], _mm512_loadu_ps(row));
+        _mm512_storeu_ps(row, rows[i]);
+    }
+}
+
+// Small-M rows [0, ROWS): each B row is loaded once and feeds every row from
+// registers, with the microkernel's summation order
+#define AVX512_SMALL_M_ROWS(ROWS) \
+    AVX512_FN static void small_m_rows##ROWS##_avx512(size_t kc, const float *a, size_t rsa, size_t csa, \
+                                                      const float *b, size_t rsb, float *c, size_t ldc, int accumulate) { \
+        __m512 acc[ROWS]; \
+        SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) acc[i] = _mm512_setzero_ps(); \
+        for (size_t p = 0; p < kc; p++) { \
+            __m512 bv = _mm512_loadu_ps(b); \
+            SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(a[i * rsa + p * csa]), bv, acc[i]); \
+            b += rsb; \
+        } \
+        SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) { \
+            float *row = c + i * ldc; \
+            if (accumulate) acc[i] = _mm512_add_ps(acc[i], _mm512_loadu_ps(row)); \
+            _mm512_storeu_ps(row, acc[i]); \
+        } \
+    }
+
+AVX512_SMALL_M_ROWS(1)
+AVX512_SMALL_M_ROWS(2)
+AVX512_SMALL_M_ROWS(3)
+AVX512_SMALL_M_ROWS(4)
+AVX512_SMALL_M_ROWS(5)
+AVX512_SMALL_M_ROWS(6)
+AVX512_SMALL_M_ROWS(7)
+AVX512_SMALL_M_ROWS(8)
+
+// An NR-wide row is one register, so all GEMM_SMALL_M rows go in one pass
+AVX512_FN static void small_m_avx512(size_t m, size_t kc, const float *a, size_t rsa, size_t csa,
+                                     const float *b, size_t rsb, float *c, size_t ldc, int accumulate) {
+    switch (m) {
+        case 1: small_m_rows1_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 2: small_m_rows2_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 3: small_m_rows3_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 4: small_m_rows4_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 5: small_m_rows5_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 6: small_m_rows6_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 7: small_m_rows7_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        case 8: small_m_rows8_avx512(kc, a, rsa, csa, b, rsb, c, ldc, accumulate); break;
+        default: break;
+    }
+}
+
+// ====================================================
+// Elementwise Kernels
+// ====================================================
+
+#define AVX512_BINARY_KERNEL(fn_name, intrinsic) \
+    AVX512_FN static void fn_name(const float *a, const float *b, float *c, size_t n) { \
+        size_t i = 0; \
+        for (; i + 16 <= n; i += 16) _mm512_storeu_ps(c + i, intrinsic(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i))); \
+        if (i < n) { \
+            __mmask16 m = tail_mask(n - i); \
+            _mm512_mask_storeu_ps(c + i, m, intrinsic(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i))); \
+        } \
+    }
+
+AVX512_BINARY_KERNEL(add_avx512, _mm512_add_ps)
+AVX512_BINARY_KERNEL(sub_avx512, _mm512_sub_ps)
+AVX512_BINARY_KERNEL(mul_avx512, _mm512_mul_ps)
+AVX512_BINARY_KERNEL(div_avx512, _mm512_div_ps)
+
+// ====================================================
+// Activation Kernels
+// ====================================================
+
+AVX512_FN static __m512 relu512(__m512 x) {
+    return _mm512_max_ps(x, _mm512_setzero_ps());
+}
+
+AVX512_FN static __m512 sigmoid512(__m512 x) {
+    __m512 one = _mm512_set1_ps(1.0f);
+    return _mm512_div_ps(one, _mm512_add_ps(one, exp512(neg512(x))));
+}
+
+AVX512_FN static __m512 tanh512(__m512 x) {
+    __m512 one = _mm512_set1_ps(1.0f);
+    __m512 two = _mm512_set1_ps(2.0f);
+    __m512 ax = _mm512_abs_ps(x);
+
+    // |x| >= 0.625: 1 - 2 / (exp(2|x|) + 1), sign restored afterwards
+    __m512 large = _mm512_sub_ps(one, _mm512_div_ps(two, _mm512_add_ps(exp512(_mm512_mul_ps(ax, two)), one)));
+    __m512i sign = _mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32((int)0x80000000));
+    large = _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(large), sign));
+
+    // |x| < 0.625: odd polynomial, accurate near zero
+    __m512 z = _mm512_mul_ps(x, x);
+    __m512 p = _mm512_set1_ps(-5.70498872745e-3f);
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(2.06390887954e-2f));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(-5.37397155531e-2f));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(1.33314422036e-1f));
+    p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(-3.33332819422e-1f));
+    __m512 small = _mm512_fmadd_ps(_mm512_mul_ps(p, z), x, x);
+
+    __mmask16 use_small = _mm512_cmp_ps_mask(ax, _mm512_set1_ps(0.625f), _CMP_LT_OQ);
+    return _mm512_mask_blend_ps(use_small, large, small);
+}
+
+#define AVX512_UNARY_KERNEL(fn_name, vec_fn) \
+    AVX512_FN static void fn_name(const float *x, float *y, size_t n) { \
+        size_t i = 0; \
+        for (; i + 16 <= n; i += 16) _mm512_storeu_ps(y + i, vec_fn(_mm512_loadu_ps(x + i))); \
+        if (i < n) { \
+            __mmask16 m = tail_mask(n - i); \
+            _mm512_mask_storeu_ps(y + i, m, vec_fn(_mm512_maskz_loadu_ps(m, x + i))); \
+        } \
+    }
+
+AVX512_UNARY_KERNEL(relu_avx512, relu512)
+AVX512_UNARY_KERNEL(sigmoid_avx512, sigmoid512)
+AVX512_UNARY_KERNEL(tanh_avx512, tanh512)
+
+AVX512_FN static void softmax_avx512(const float *x, float *y, size_t n) {
+    __m512 neg_inf = _mm512_set1_ps(-INFINITY);
+    __m512 vmax = neg_inf;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) vmax = _mm512_max_ps(vmax, _mm512_loadu_ps(x + i));
+    if (i < n) vmax = _mm512_max_ps(vmax, _mm512_mask_loadu_ps(neg_inf, tail_mask(n - i), x + i));
+    __m512 vshift = _mm512_set1_ps(_mm512_reduce_max_ps(vmax));
+
+    __m512 vsum = _mm512_setzero_ps();
+    for (i = 0; i + 16 <= n; i += 16) {
+        __m512 e = exp512(_mm512_sub_ps(_mm512_loadu_ps(x + i), vshift));
+        _mm512_storeu_ps(y + i, e);
+        vsum = _mm512_add_ps(vsum, e);
+    }
+    if (i < n) {
+        __mmask16 m = tail_mask(n - i);
+        __m512 e = exp512(_mm512_sub_ps(_mm512_maskz_loadu_ps(m, x + i), vshift));
+        _mm512_mask_storeu_ps(y + i, m, e);
+        vsum = _mm512_mask_add_ps(vsum, m, vsum, e);
+    }
+
+    __m512 vtotal = _mm512_set1_ps(_mm512_reduce_add_ps(vsum));
+    for (i = 0; i + 16 <= n; i += 16) _mm512_storeu_ps(y + i, _mm512_div_ps(_mm512_loadu_ps(y + i), vtotal));
+    if (i < n) {
+        __mmask16 m = tail_mask(n - i);
+        _mm512_mask_storeu_ps(y + i, m, _mm512_div_ps(_mm512_maskz_loadu_ps(m, y + i), vtotal));
+    }
+}
+
+// ====================================================
+// Loss Kernels
+// ====================================================
+
+AVX512_FN static __m512 mse_term512(__m512 p, __m512 t) {
+    __m512 d = _mm512_sub_ps(p, t);
+    return _mm512_mul_ps(d, d);
+}
+
+AVX512_FN static __m512 cross_entropy_term512(__m512 p, __m512 t) {
+    p = _mm512_min_ps(_mm512_max_ps(p, _mm512_set1_ps(1e-7f)), _mm512_set1_ps(1.0f - 1e-7f));
+    return neg512(_mm512_mul_ps(t, log512(p)));
+}
+
+AVX512_FN static __m512 binary_cross_entropy_term512(__m512 p, __m512 t) {
+    __m512 one = _mm512_set1_ps(1.0f);
+    p = _mm512_min_ps(_mm512_max_ps(p, _mm512_set1_ps(1e-7f)), _mm512_set1_ps(1.0f - 1e-7f));
+    __m512 pos = _mm512_mul_ps(t, log512(p));
+    __m512 neg = _mm512_mul_ps(_mm512_sub_ps(one, t), log512(_mm512_sub_ps(one, p)));
+    return neg512(_mm512_add_ps(pos, neg));
+}
+
+#define AVX512_LOSS_KERNEL(fn_name, term_fn) \
+    AVX512_FN static float fn_name(const float *pred, const float *target, size_t n) { \
+        __m512 acc = _mm512_setzero_ps(); \
+        size_t i = 0; \
+        for (; i + 16 <= n; i += 16) acc = _mm512_add_ps(acc, term_fn(_mm512_loadu_ps(pred + i), _mm512_loadu_ps(target + i))); \
+        if (i < n) { \
+            __mmask16 m = tail_mask(n - i); \
+            __m512 term = term_fn(_mm512_maskz_loadu_ps(m, pred + i), _mm512_maskz_loadu_ps(m, target + i)); \
+            acc = _mm512_mask_add_ps(acc, m, acc, term); \
+        } \
+        return _mm512_reduce_add_ps(acc); \
+    }
+
+AVX512_LOSS_KERNEL(mse_avx512, mse_term512)
+AVX512_LOSS_KERNEL(cross_entropy_avx512, cross_entropy_term512)
+AVX512_LOSS_KERNEL(binary_cross_entropy_avx512, binary_cross_entropy_term512)
+
+// ====================================================
+// Fast Math Kernels
+// ====================================================
+
+#define FM512(c) _mm512_set1_ps(c)
+
+// 1/d from the 14-bit estimate and one Newton step
+AVX512_FN static inline __m512 rcp512(__m512 d) {
+    __m512 r = _mm512_rcp14_ps(d);
+    return _mm512_mul_ps(r, _mm512_fnmadd_ps(d, r, FM512(2.0f)));
+}
+
+AVX512_FN static inline __m512 exp512_fast(__m512 x) {
+    x = _mm512_max_ps(_mm512_min_ps(x, FM512(FASTMATH_EXP_MAX)), FM512(FASTMATH_EXP_MIN));
+
+    __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, FM512(FASTMATH_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 t = _mm512_fnmadd_ps(n, FM512(FASTMATH_LN2_HI), x);
+    t = _mm512_fnmadd_ps(n, FM512(FASTMATH_LN2_LO), t);
+
+    __m512 p = FM512(FASTMATH_EXP_C5);
+    p = _mm512_fmadd_ps(p, t, FM512(FASTMATH_EXP_C4));
+    p = _mm512_fmadd_ps(p, t, FM512(FASTMATH_EXP_C3));
+    p = _mm512_fmadd_ps(p, t, FM512(FASTMATH_EXP_C2));
+    p = _mm512_fmadd_ps(p, t, FM512(FASTMATH_EXP_C1));
+    p = _mm512_fmadd_ps(p, t, FM512(1.0f));
+
+    __m512i scale = _mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+    return _mm512_mul_ps(p, _mm512_castsi512_ps(scale));
+}
+
+AVX512_FN static inline __m512 log512_fast(__m512 x) {
+    __m512i bits = _mm512_castps_si512(x);
+    __m512 e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(127)));
+    __m512 m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)),
+                                                   _mm512_set1_epi32(0x3F800000)));
+
+    __mmask16 high = _mm512_cmp_ps_mask(m, FM512(FASTMATH_SQRT2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_ps(m, high, m, FM512(0.5f));
+    e = _mm512_mask_add_ps(e, high, e, FM512(1.0f));
+
+    __m512 f = _mm512_sub_ps(m, FM512(1.0f));
+    __m512 q = FM512(FASTMATH_LOG_C6);
+    q = _mm512_fmadd_ps(q, f, FM512(FASTMATH_LOG_C5));
+    q = _mm512_fmadd_ps(q, f, FM512(FASTMATH_LOG_C4));
+    q = _mm512_fmadd_ps(q, f, FM512(FASTMATH_LOG_C3));
+    q = _mm512_fmadd_ps(q, f, FM512(FASTMATH_LOG_C2));
+    q = _mm512_fmadd_ps(q, f, FM512(FASTMATH_LOG_C1));
+    q = _mm512_fmadd_ps(q, f, FM512(FASTMATH_LOG_C0));
+
+    __m512 f2 = _mm512_mul_ps(f, f);
+    __m512 r = _mm512_fmadd_ps(_mm512_mul_ps(f2, f), q, _mm512_fnmadd_ps(f2, FM512(0.5f), f));
+    return _mm512_fmadd_ps(e, FM512(FASTMATH_LN2), r);
+}
+
+AVX512_FN static inline __m512 sigmoid512_fast(__m512 x) {
+    return rcp512(_mm512_add_ps(FM512(1.0f), exp512_fast(neg512(x))));
+}
+
+AVX512_FN static inline __m512 tanh512_fast(__m512 x) {
+    __m512 c = _mm512_max_ps(_mm512_min_ps(x, FM512(FASTMATH_TANH_CLAMP)), FM512(-FASTMATH_TANH_CLAMP));
+    __m512 x2 = _mm512_mul_ps(c, c);
+
+    __m512 p = FM512(FASTMATH_TANH_A13);
+    p = _mm512_fmadd_ps(p, x2, FM512(FASTMATH_TANH_A11));
+    p = _mm512_fmadd_ps(p, x2, FM512(FASTMATH_TANH_A9));
+    p = _mm512_fmadd_ps(p, x2, FM512(FASTMATH_TANH_A7));
+    p = _mm512_fmadd_ps(p, x2, FM512(FASTMATH_TANH_A5));
+    p = _mm512_fmadd_ps(p, x2, FM512(FASTMATH_TANH_A3));
+    p = _mm512_fmadd_ps(p, x2, FM512(FASTMATH_TANH_A1));
+
+    __m512 q = FM512(FASTMATH_TANH_B6);
+    q = _mm512_fmadd_ps(q, x2, FM512(FASTMATH_TANH_B4));
+    q = _mm512_fmadd_ps(q, x2, FM512(FASTMATH_TANH_B2));
+    q = _mm512_fmadd_ps(q, x2, FM512(FASTMATH_TANH_B0));
+
+    __m512 r = _mm512_mul_ps(_mm512_mul_ps(c, p), rcp512(q));
+    __mmask16 tiny = _mm512_cmp_ps_mask(_mm512_abs_ps(x), FM512(FASTMATH_TANH_TINY), _CMP_LT_OQ);
+    return _mm512_mask_blend_ps(tiny, r, x);
+}
+
+AVX512_FN static inline __m512 gelu512_fast(__m512 x) {
+    __m512 z = _mm512_fmadd_ps(_mm512_mul_ps(_mm512_mul_ps(x, x), FM512(FASTMATH_GELU_CUBIC)), x, x);
+    return _mm512_mul_ps(x, sigmoid512_fast(_mm512_mul_ps(z, FM512(FASTMATH_GELU_2K))));
+}
+
+AVX512_FN static inline __m512 swish512_fast(__m512 x) {
+    return _mm512_mul_ps(x, sigmoid512_fast(x));
+}
+
+// max(x, 0) + log(1 + u), u = exp(-|x|), with the rounding of 1 + u added back
+AVX512_FN static inline __m512 softplus512_fast(__m512 x) {
+    __m512 u = exp512_fast(neg512(_mm512_abs_ps(x)));
+    __m512 w = _mm512_add_ps(FM512(1.0f), u);
+    __m512 c = _mm512_sub_ps(u, _mm512_sub_ps(w, FM512(1.0f)));
+    __m512 l = _mm512_fmadd_ps(c, rcp512(w), log512_fast(w));
+    return _mm512_add_ps(_mm512_max_ps(x, _mm512_setzero_ps()), l);
+}
+
+AVX512_UNARY_KERNEL(exp_fast_avx512, exp512_fast)
+AVX512_UNARY_KERNEL(log_fast_avx512, log512_fast)
+AVX512_UNARY_KERNEL(sigmoid_fast_avx512, sigmoid512_fast)
+AVX512_UNARY_KERNEL(tanh_fast_avx512, tanh512_fast)
+AVX512_UNARY_KERNEL(gelu_fast_avx512, gelu512_fast)
+AVX512_UNARY_KERNEL(swish_fast_avx512, swish512_fast)
+AVX512_UNARY_KERNEL(softplus_fast_avx512, softplus512_fast)
+
+static const MathKernels avx512_fast_math = {
+    .name = "avx512",
+    .exp = exp_fast_avx512,
+    .log = log_fast_avx512,
+    .sigmoid = sigmoid_fast_avx512,
+    .tanh = tanh_fast_avx512,
+    .gelu = gelu_fast_avx512,
+    .swish = swish_fast_avx512,
+    .softplus = softplus_fast_avx512,
+};
+
+// ====================================================
+// Optimizer Kernels
+// ====================================================
+
+AVX512_FN static void adam_avx512(float *p, const float *g, float *m, float *v, size_t n, const AdamCoeffs *c) {
+    __m512 beta1 = _mm512_set1_ps(c->beta1), one_minus_beta1 = _mm512_set1_ps(c->one_minus_beta1);
+    __m512 beta2 = _mm512_set1_ps(c->beta2), one_minus_beta2 = _mm512_set1_ps(c->one_minus_beta2);
+    __m512 step_size = _mm512_set1_ps(c->step_size), inv_sqrt_bc2 = _mm512_set1_ps(c->inv_sqrt_bc2);
+    __m512 epsilon = _mm512_set1_ps(c->epsilon), decay = _mm512_set1_ps(c->decay);
+
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = n - i >= 16 ? (__mmask16)0xFFFF : tail_mask(n - i);
+        __m512 gi = _mm512_maskz_loadu_ps(k, g + i);
+        __m512 mi = _mm512_fmadd_ps(beta1, _mm512_maskz_loadu_ps(k, m + i), _mm512_mul_ps(one_minus_beta1, gi));
+        __m512 vi = _mm512_fmadd_ps(beta2, _mm512_maskz_loadu_ps(k, v + i), _mm512_mul_ps(_mm512_mul_ps(one_minus_beta2, gi), gi));
+        __m512 denom = _mm512_fmadd_ps(_mm512_sqrt_ps(vi), inv_sqrt_bc2, epsilon);
+        __m512 pi = _mm512_fnmadd_ps(step_size, _mm512_div_ps(mi, denom), _mm512_mul_ps(decay, _mm512_maskz_loadu_ps(k, p + i)));
+        _mm512_mask_storeu_ps(m + i, k, mi);
+        _mm512_mask_storeu_ps(v + i, k, vi);
+        _mm512_mask_storeu_ps(p + i, k, pi);
+    }
+}
+
+AVX512_FN static void sgd_avx512(float *p, const float *g, float *velocity, size_t n, float lr, float momentum) {
+    __m512 vlr = _mm512_set1_ps(lr), vmomentum = _mm512_set1_ps(momentum);
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = n - i >= 16 ? (__mmask16)0xFFFF : tail_mask(n - i);
+        __m512 pi = _mm512_maskz_loadu_ps(k, p + i);
+        __m512 gi = _mm512_maskz_loadu_ps(k, g + i);
+        if (velocity) {
+            __m512 vel = _mm512_fnmadd_ps(vlr, gi, _mm512_mul_ps(vmomentum, _mm512_maskz_loadu_ps(k, velocity + i)));
+            _mm512_mask_storeu_ps(velocity + i, k, vel);
+            pi = _mm512_add_ps(pi, vel);
+        } else {
+            pi = _mm512_fnmadd_ps(vlr, gi, pi);
+        }
+        _mm512_mask_storeu_ps(p + i, k, pi);
+    }
+}
+
+// ====================================================
+// Kernel Table
+// ====================================================
+
+static const OpKernels avx512_table = {
+    .name = "avx512",
+    .priority = BACKEND_PRIORITY_AVX512,
+    .gemm = gemm_avx512,
+    .small_m = small_m_avx512,
+    .add = add_avx512,
+    .sub = sub_avx512,
+    .mul = mul_avx512,
+    .div = div_avx512,
+    .relu = relu_avx512,
+    .sigmoid = sigmoid_avx512,
+    .tanh = tanh_avx512,
+    .softmax = softmax_avx512,
+    .mse = mse_avx512,
+    .cross_entropy = cross_entropy_avx512,
+    .binary_cross_entropy = binary_cross_entropy_avx512,
+    .adam = adam_avx512,
+    .sgd = sgd_avx512,
+    .fast_math = &avx512_fast_math,
+};
+
+OPS_DEFINE_BACKEND(avx512, avx512_table)
+
+const OpKernels* kernels_avx512(void) {
+    return cpu_get_features()->avx512f ? &avx512_table : NULL;
+}
+
+#else
+
+const OpKernels* kernels_avx512(void) { return NULL; }
+void ops_register_avx512(void) {}
+
+#endif
@@ -0,0 +1,522 @@
+#include "kernels.h"
+#include "fastmath_coeffs.h"
+#include "../include/registry.h"
+#include "../include/cpu.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+// ====================================================
+// Math Helpers
+// ====================================================
+
+// Same reduction and polynomial as the AVX2 exp256
+static inline float32x4_t exp128(float32x4_t x) {
+    x = vminq_f32(x, vdupq_n_f32(88.3762626647949f));
+    x = vmaxq_f32(x, vdupq_n_f32(-88.3762626647949f));
+
+    float32x4_t fx = vrndnq_f32(vmulq_n_f32(x, 1.44269504088896341f));
+    x = vfmsq_f32(x, fx, vdupq_n_f32(0.693359375f));
+    x = vfmsq_f32(x, fx, vdupq_n_f32(-2.12194440e-4f));
+
+    float32x4_t y = vdupq_n_f32(1.9875691500e-4f);
+    y = vfmaq_f32(vdupq_n_f32(1.3981999507e-3f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(8.3334519073e-3f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(4.1665795894e-2f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(1.6666665459e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(5.0000001201e-1f), y, x);
+    y = vfmaq_f32(vaddq_f32(x, vdupq_n_f32(1.0f)), y, vmulq_f32(x, x));
+
+    int32x4_t n = vaddq_s32(vcvtq_s32_f32(fx), vdupq_n_s32(127));
+    return vmulq_f32(y, vreinterpretq_f32_s32(vshlq_n_s32(n, 23)));
+}
+
+// Same reduction and polynomial as the AVX2 log256
+static inline float32x4_t log128(float32x4_t x) {
+    int32x4_t bits = vreinterpretq_s32_f32(x);
+    float32x4_t e = vcvtq_f32_s32(vsubq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(126)));
+    x = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007FFFFF)), vdupq_n_s32(0x3F000000)));
+
+    uint32x4_t small = vcltq_f32(x, vdupq_n_f32(0.707106781186547524f));
+    e = vsubq_f32(e, vreinterpretq_f32_u32(vandq_u32(small, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+    x = vaddq_f32(vsubq_f32(x, vdupq_n_f32(1.0f)), vreinterpretq_f32_u32(vandq_u32(small, vreinterpretq_u32_f32(x))));
+
+    float32x4_t z = vmulq_f32(x, x);
+    float32x4_t y = vdupq_n_f32(7.0376836292e-2f);
+    y = vfmaq_f32(vdupq_n_f32(-1.1514610310e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(1.1676998740e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(-1.2420140846e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(1.4249322787e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(-1.6668057665e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(2.0000714765e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(-2.4999993993e-1f), y, x);
+    y = vfmaq_f32(vdupq_n_f32(3.3333331174e-1f), y, x);
+    y = vmulq_f32(vmulq_f32(y, x), z);
+
+    y = vfmaq_f32(y, e, vdupq_n_f32(-2.12194440e-4f));
+    y = vfmsq_f32(y, z, vdupq_n_f32(0.5f));
+    x = vaddq_f32(x, y);
+    return vfmaq_f32(x, e, vdupq_n_f32(0.693359375f));
+}
+
+// ====================================================
+// GEMM Microkernel
+// ====================================================
+
+static void gemm_neon(size_t kc, const float *a, const float *b, float *c, size_t ldc, int accumulate) {
+    float32x4_t acc[GEMM_MR][4];
+    for (int i = 0; i < GEMM_MR; i++) {
+        for (int j = 0; j < 4; j++) acc[i][j] = vdupq_n_f32(0.0f);
+    }
+
+    for (size_t p = 0; p < kc; p++) {
+        float32x4_t b0 = vld1q_f32(b);
+        float32x4_t b1 = vld1q_f32(b + 4);
+        float32x4_t b2 = vld1q_f32(b + 8);
+        float32x4_t b3 = vld1q_f32(b + 12);
+        for (int i = 0; i < GEMM_MR; i++) {
+            float32x4_t ai = vdupq_n_f32(a[i]);
+            acc[i][0] = vfmaq_f32(acc[i][0], ai, b0);
+            acc[i][1] = vfmaq_f32(acc[i][1], ai, b1);
+            acc[i][2] = vfmaq_f32(acc[i][2], ai, b2);
+            acc[i][3] = vfmaq_f32(acc[i][3], ai, b3);
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    for (int i = 0; i < GEMM_MR; i++) {
+        float *row = c + i * ldc;
+        for (int j = 0; j < 4; j++) {
+            if (accumulate) acc[i][j] = vaddq_f32(acc[i][j], vld1q_f32(row + 4 * j));
+            vst1q_f32(row + 4 * j, acc[i][j]);
+        }
+    }
+}
+
+// Small-M rows [0, ROWS): each B row is loaded once and feeds every row from
+// registers, with the microkernel's summation order
+#define NEON_SMALL_M_ROWS(ROWS) \
+    static void small_m_rows##ROWS##_neon(size_t kc, const float *a, size_t rsa, size_t csa, \
+                                          const float *b, size_t rsb, float *c, size_t ldc, int accumulate) { \
+        float32x4_t acc[ROWS][4]; \
+        SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) { \
+            for (int j = 0; j < 4; j++) acc[i][j] = vdupq_n_f32(0.0f); \
+        } \
+        for (size_t p = 0; p < kc; p++) { \
+            float32x4_t b0 = vld1q_f32(b); \
+            float32x4_t b1 = vld1q_f32(b + 4); \
+            float32x4_t b2 = vld1q_f32(b + 8); \
+            float32x4_t b3 = vld1q_f32(b + 12); \
+            SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) { \
+                float32x4_t ai = vdupq_n_f32(a[i * rsa + p * csa]); \
+                acc[i][0] = vfmaq_f32(acc[i][0], ai, b0); \
+                acc[i][1] = vfmaq_f32(acc[i][1], ai, b1); \
+                acc[i][2] = vfmaq_f32(acc[i][2], ai, b2); \
+                acc[i][3] = vfmaq_f32(acc[i][3], ai, b3); \
+            } \
+            b += rsb; \
+        } \
+        SMALL_M_UNROLL for (int i = 0; i < ROWS; i++) { \
+            float *row = c + i * ldc; \
+            for (int j = 0; j < 4; j++) { \
+                if (accumulate) acc[i][j] = vaddq_f32(acc[i][j], vld1q_f32(row + 4 * j)); \
+                vst1q_f32(row + 4 * j, acc[i][j]); \
+            } \
+        } \
+    }
+
+NEON_SMALL_M_ROWS(1)
+NEON_SMALL_M_ROWS(2)
+NEON_SMALL_M_ROWS(3)
+NEON_SMALL_M_ROWS(4)
+
+// Four rows at a time: sixteen accumulators plus the B row fit the 32 registers
+static void small_m_neon(size_t m, size_t kc, const float *a, size_t rsa, size_t csa,
+                         const float *b, size_t rsb, float *c, size_t ldc, int accumulate) {
+    for (size_t i = 0; i < m; i += 4) {
+        const float *ai = a + i * rsa;
+        float *ci = c + i * ldc;
+        switch (m - i) {
+            case 1: small_m_rows1_neon(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+            case 2: small_m_rows2_neon(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+            case 3: small_m_rows3_neon(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+            default: small_m_rows4_neon(kc, ai, rsa, csa, b, rsb, ci, ldc, accumulate); break;
+        }
+    }
+}
+
+// ====================================================
+// Elementwise Kernels
+// ====================================================
+
+static void add_neon(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(c + i, vaddq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+static void sub_neon(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(c + i, vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    for (; i < n; i++) c[i] = a[i] - b[i];
+}
+
+static void mul_neon(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(c + i, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    for (; i < n; i++) c[i] = a[i] * b[i];
+}
+
+static void div_neon(const float *a, const float *b, float *c, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(c + i, vdivq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    for (; i < n; i++) c[i] = a[i] / b[i];
+}
+
+// ====================================================
+// Activation Kernels
+// ====================================================
+
+static void relu_neon(const float *x, float *y, size_t n) {
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(y + i, vmaxq_f32(vld1q_f32(x + i), zero));
+    for (; i < n; i++) y[i] = x[i] > 0.0f ? x[i] : 0.0f;
+}
+
+static void sigmoid_neon(const float *x, float *y, size_t n) {
+    float32x4_t one = vdupq_n_f32(1.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t e = exp128(vnegq_f32(vld1q_f32(x + i)));
+        vst1q_f32(y + i, vdivq_f32(one, vaddq_f32(one, e)));
+    }
+    for (; i < n; i++) y[i] = 1.0f / (1.0f + expf(-x[i]));
+}
+
+static void tanh_neon(const float *x, float *y, size_t n) {
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t two = vdupq_n_f32(2.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(x + i);
+        float32x4_t ax = vabsq_f32(v);
+
+        // |x| >= 0.625: 1 - 2 / (exp(2|x|) + 1), sign restored afterwards
+        float32x4_t large = vsubq_f32(one, vdivq_f32(two, vaddq_f32(exp128(vmulq_f32(ax, two)), one)));
+        uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000u));
+        large = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(large), sign));
+
+        // |x| < 0.625: odd polynomial, accurate near zero
+        float32x4_t z = vmulq_f32(v, v);
+        float32x4_t p = vdupq_n_f32(-5.70498872745e-3f);
+        p = vfmaq_f32(vdupq_n_f32(2.06390887954e-2f), p, z);
+        p = vfmaq_f32(vdupq_n_f32(-5.37397155531e-2f), p, z);
+        p = vfmaq_f32(vdupq_n_f32(1.33314422036e-1f), p, z);
+        p = vfmaq_f32(vdupq_n_f32(-3.33332819422e-1f), p, z);
+        float32x4_t small = vfmaq_f32(v, vmulq_f32(p, z), v);
+
+        uint32x4_t use_small = vcltq_f32(ax, vdupq_n_f32(0.625f));
+        vst1q_f32(y + i, vbslq_f32(use_small, small, large));
+    }
+    for (; i < n; i++) y[i] = tanhf(x[i]);
+}
+
+static void softmax_neon(const float *x, float *y, size_t n) {
+    size_t i = 0;
+    float max_val = x[0];
+    if (n >= 4) {
+        float32x4_t vmax = vld1q_f32(x);
+        for (i = 4; i + 4 <= n; i += 4) vmax = vmaxq_f32(vmax, vld1q_f32(x + i));
+        max_val = vmaxvq_f32(vmax);
+    }
+    for (; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+
+    float32x4_t vshift = vdupq_n_f32(max_val);
+    float32x4_t vsum = vdupq_n_f32(0.0f);
+    for (i = 0; i + 4 <= n; i += 4) {
+        float32x4_t e = exp128(vsubq_f32(vld1q_f32(x + i), vshift));
+        vst1q_f32(y + i, e);
+        vsum = vaddq_f32(vsum, e);
+    }
+    float sum = vaddvq_f32(vsum);
+    for (; i < n; i++) {
+        y[i] = expf(x[i] - max_val);
+        sum += y[i];
+    }
+
+    float32x4_t vtotal = vdupq_n_f32(sum);
+    for (i = 0; i + 4 <= n; i += 4) vst1q_f32(y + i, vdivq_f32(vld1q_f32(y + i), vtotal));
+    for (; i < n; i++) y[i] /= sum;
+}
+
+// ====================================================
+// Loss Kernels
+// ====================================================
+
+static float mse_neon(const float *pred, const float *target, size_t n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t d = vsubq_f32(vld1q_f32(pred + i), vld1q_f32(target + i));
+        acc = vfmaq_f32(acc, d, d);
+    }
+    float sum = vaddvq_f32(acc);
+    for (; i < n; i++) {
+        float d = pred[i] - target[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+static float cross_entropy_neon(const float *pred, const float *target, size_t n) {
+    float epsilon = 1e-7f;
+    float32x4_t lo = vdupq_n_f32(epsilon);
+    float32x4_t hi = vdupq_n_f32(1.0f - epsilon);
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t p = vminq_f32(vmaxq_f32(vld1q_f32(pred + i), lo), hi);
+        acc = vfmsq_f32(acc, vld1q_f32(target + i), log128(p));
+    }
+    float sum = vaddvq_f32(acc);
+    for (; i < n; i++) {
+        float p = pred[i];
+        p = p < epsilon ? epsilon : (p > 1.0f - epsilon ? 1.0f - epsilon : p);
+        sum += -target[i] * logf(p);
+    }
+    return sum;
+}
+
+static float binary_cross_entropy_neon(const float *pred, const float *target, size_t n) {
+    float epsilon = 1e-7f;
+    float32x4_t lo = vdupq_n_f32(epsilon);
+    float32x4_t hi = vdupq_n_f32(1.0f - epsilon);
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t p = vminq_f32(vmaxq_f32(vld1q_f32(pred + i), lo), hi);
+        float32x4_t t = vld1q_f32(target + i);
+        acc = vfmsq_f32(acc, t, log128(p));
+        acc = vfmsq_f32(acc, vsubq_f32(one, t), log128(vsubq_f32(one, p)));
+    }
+    float sum = vaddvq_f32(acc);
+    for (; i < n; i++) {
+        float p = pred[i];
+        p = p < epsilon ? epsilon : (p > 1.0f - epsilon ? 1.0f - epsilon : p);
+        sum += -target[i] * logf(p) - (1.0f - target[i]) * logf(1.0f - p);
+    }
+    return sum;
+}
+
+// ====================================================
+// Fast Math Kernels
+// ====================================================
+
+// 1/d from the 8-bit estimate and two Newton steps
+static inline float32x4_t rcp128(float32x4_t d) {
+    float32x4_t r = vrecpeq_f32(d);
+    r = vmulq_f32(r, vrecpsq_f32(d, r));
+    return vmulq_f32(r, vrecpsq_f32(d, r));
+}
+
+static inline float32x4_t exp128_fast(float32x4_t x) {
+    x = vmaxq_f32(vminq_f32(x, vdupq_n_f32(FASTMATH_EXP_MAX)), vdupq_n_f32(FASTMATH_EXP_MIN));
+
+    float32x4_t n = vrndnq_f32(vmulq_n_f32(x, FASTMATH_LOG2E));
+    float32x4_t t = vfmsq_f32(x, n, vdupq_n_f32(FASTMATH_LN2_HI));
+    t = vfmsq_f32(t, n, vdupq_n_f32(FASTMATH_LN2_LO));
+
+    float32x4_t p = vdupq_n_f32(FASTMATH_EXP_C5);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_EXP_C4), p, t);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_EXP_C3), p, t);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_EXP_C2), p, t);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_EXP_C1), p, t);
+    p = vfmaq_f32(vdupq_n_f32(1.0f), p, t);
+
+    int32x4_t scale = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+    return vmulq_f32(p, vreinterpretq_f32_s32(scale));
+}
+
+static inline float32x4_t log128_fast(float32x4_t x) {
+    int32x4_t bits = vreinterpretq_s32_f32(x);
+    float32x4_t e = vcvtq_f32_s32(vsubq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(127)));
+    float32x4_t m = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007FFFFF)), vdupq_n_s32(0x3F800000)));
+
+    uint32x4_t high = vcgtq_f32(m, vdupq_n_f32(FASTMATH_SQRT2));
+    m = vbslq_f32(high, vmulq_n_f32(m, 0.5f), m);
+    e = vaddq_f32(e, vreinterpretq_f32_u32(vandq_u32(high, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+
+    float32x4_t f = vsubq_f32(m, vdupq_n_f32(1.0f));
+    float32x4_t q = vdupq_n_f32(FASTMATH_LOG_C6);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_C5), q, f);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_C4), q, f);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_C3), q, f);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_C2), q, f);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_C1), q, f);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_C0), q, f);
+
+    float32x4_t f2 = vmulq_f32(f, f);
+    float32x4_t r = vfmaq_f32(vfmsq_f32(f, f2, vdupq_n_f32(0.5f)), vmulq_f32(f2, f), q);
+    return vfmaq_f32(r, e, vdupq_n_f32(FASTMATH_LN2));
+}
+
+static inline float32x4_t sigmoid128_fast(float32x4_t x) {
+    return rcp128(vaddq_f32(vdupq_n_f32(1.0f), exp128_fast(vnegq_f32(x))));
+}
+
+static inline float32x4_t tanh128_fast(float32x4_t x) {
+    float32x4_t c = vmaxq_f32(vminq_f32(x, vdupq_n_f32(FASTMATH_TANH_CLAMP)), vdupq_n_f32(-FASTMATH_TANH_CLAMP));
+    float32x4_t x2 = vmulq_f32(c, c);
+
+    float32x4_t p = vdupq_n_f32(FASTMATH_TANH_A13);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_A11), p, x2);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_A9), p, x2);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_A7), p, x2);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_A5), p, x2);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_A3), p, x2);
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_A1), p, x2);
+
+    float32x4_t q = vdupq_n_f32(FASTMATH_TANH_B6);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_B4), q, x2);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_B2), q, x2);
+    q = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_B0), q, x2);
+
+    float32x4_t r = vmulq_f32(vmulq_f32(c, p), rcp128(q));
+    uint32x4_t tiny = vcltq_f32(vabsq_f32(x), vdupq_n_f32(FASTMATH_TANH_TINY));
+    return vbslq_f32(tiny, x, r);
+}
+
+static inline float32x4_t gelu128_fast(float32x4_t x) {
+    float32x4_t z = vfmaq_f32(x, vmulq_n_f32(vmulq_f32(x, x), FASTMATH_GELU_CUBIC), x);
+    return vmulq_f32(x, sigmoid128_fast(vmulq_n_f32(z, FASTMATH_GELU_2K)));
+}
+
+static inline float32x4_t swish128_fast(float32x4_t x) {
+    return vmulq_f32(x, sigmoid128_fast(x));
+}
+
+// max(x, 0) + log(1 + u), u = exp(-|x|), with the rounding of 1 + u added back
+static inline float32x4_t softplus128_fast(float32x4_t x) {
+    float32x4_t u = exp128_fast(vnegq_f32(vabsq_f32(x)));
+    float32x4_t w = vaddq_f32(vdupq_n_f32(1.0f), u);
+    float32x4_t c = vsubq_f32(u, vsubq_f32(w, vdupq_n_f32(1.0f)));
+    float32x4_t l = vfmaq_f32(log128_fast(w), c, rcp128(w));
+    return vaddq_f32(vmaxq_f32(x, vdupq_n_f32(0.0f)), l);
+}
+
+// The tail goes through a zero-padded vector so every element sees the same approximation
+#define NEON_UNARY_KERNEL(fn_name, vec_fn) \
+    static void fn_name(const float *x, float *y, size_t n) { \
+        size_t i = 0; \
+        for (; i + 4 <= n; i += 4) vst1q_f32(y + i, vec_fn(vld1q_f32(x + i))); \
+        if (i < n) { \
+            float buf[4] = {0}; \
+            memcpy(buf, x + i, (n - i) * sizeof(float)); \
+            vst1q_f32(buf, vec_fn(vld1q_f32(buf))); \
+            memcpy(y + i, buf, (n - i) * sizeof(float)); \
+        } \
+    }
+
+NEON_UNARY_KERNEL(exp_fast_neon, exp128_fast)
+NEON_UNARY_KERNEL(log_fast_neon, log128_fast)
+NEON_UNARY_KERNEL(sigmoid_fast_neon, sigmoid128_fast)
+NEON_UNARY_KERNEL(tanh_fast_neon, tanh128_fast)
+NEON_UNARY_KERNEL(gelu_fast_neon, gelu128_fast)
+NEON_UNARY_KERNEL(swish_fast_neon, swish128_fast)
+NEON_UNARY_KERNEL(softplus_fast_neon, softplus128_fast)
+
+static const MathKernels neon_fast_math = {
+    .name = "neon",
+    .exp = exp_fast_neon,
+    .log = log_fast_neon,
+    .sigmoid = sigmoid_fast_neon,
+    .tanh = tanh_fast_neon,
+    .gelu = gelu_fast_neon,
+    .swish = swish_fast_neon,
+    .softplus = softplus_fast_neon,
+};
+
+// ====================================================
+// Optimizer Kernels
+// ====================================================
+
+static void adam_neon(float *p, const float *g, float *m, float *v, size_t n, const AdamCoeffs *c) {
+    float32x4_t beta1 = vdupq_n_f32(c->beta1), one_minus_beta1 = vdupq_n_f32(c->one_minus_beta1);
+    float32x4_t beta2 = vdupq_n_f32(c->beta2), one_minus_beta2 = vdupq_n_f32(c->one_minus_beta2);
+    float32x4_t step_size = vdupq_n_f32(c->step_size), inv_sqrt_bc2 = vdupq_n_f32(c->inv_sqrt_bc2);
+    float32x4_t epsilon = vdupq_n_f32(c->epsilon), decay = vdupq_n_f32(c->decay);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t gi = vld1q_f32(g + i);
+        float32x4_t mi = vfmaq_f32(vmulq_f32(one_minus_beta1, gi), beta1, vld1q_f32(m + i));
+        float32x4_t vi = vfmaq_f32(vmulq_f32(vmulq_f32(one_minus_beta2, gi), gi), beta2, vld1q_f32(v + i));
+        float32x4_t denom = vfmaq_f32(epsilon, vsqrtq_f32(vi), inv_sqrt_bc2);
+        float32x4_t pi = vfmsq_f32(vmulq_f32(decay, vld1q_f32(p + i)), step_size, vdivq_f32(mi, denom));
+        vst1q_f32(m + i, mi);
+        vst1q_f32(v + i, vi);
+        vst1q_f32(p + i, pi);
+    }
+    for (; i < n; i++) adam_element(p + i, g[i], m + i, v + i, c);
+}
+
+static void sgd_neon(float *p, const float *g, float *velocity, size_t n, float lr, float momentum) {
+    float32x4_t vlr = vdupq_n_f32(lr), vmomentum = vdupq_n_f32(momentum);
+    size_t i = 0;
+    if (velocity) {
+        for (; i + 4 <= n; i += 4) {
+            float32x4_t vel = vfmsq_f32(vmulq_f32(vmomentum, vld1q_f32(velocity + i)), vlr, vld1q_f32(g + i));
+            vst1q_f32(velocity + i, vel);
+            vst1q_f32(p + i, vaddq_f32(vld1q_f32(p + i), vel));
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) vst1q_f32(p + i, vfmsq_f32(vld1q_f32(p + i), vlr, vld1q_f32(g + i)));
+    }
+    for (; i < n; i++) sgd_element(p + i, g[i], velocity ? velocity + i : NULL, lr, momentum);
+}
+
+// ====================================================
+// Kernel Table
+// ====================================================
+
+static const OpKernels neon_table = {
+    .name = "neon",
+    .priority = BACKEND_PRIORITY_NEON,
+    .gemm = gemm_neon,
+    .small_m = small_m_neon,
+    .add = add_neon,
+    .sub = sub_neon,
+    .mul = mul_neon,
+    .div = div_neon,
+    .relu = relu_neon,
+    .sigmoid = sigmoid_neon,
+    .tanh = tanh_neon,
+    .softmax = softmax_neon,
+    .mse = mse_neon,
+    .cross_entropy = cross_entropy_neon,
+    .binary_cross_entropy = binary_cross_entropy_neon,
+    .adam = adam_neon,
+    .sgd = sgd_neon,
+    .fast_math = &neon_fast_math,
+};
+
+OPS_DEFINE_BACKEND(neon, neon_table)
+
+const OpKernels* kernels_neon(void) {
+    return cpu_get_features()->neon ? &neon_table : NULL;
+}
+
+#else
+
+const OpKernels* kernels_neon(void) { return NULL; }
+void ops_register_neon(void) {}
+
+#endif
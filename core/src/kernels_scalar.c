@@ -0,0 +1,115 @@
+#include "kernels.h"
+#include "../include/registry.h"
+#include "../include/elementwise.h"
+#include <math.h>
+
+// ====================================================
+// Elementwise Kernels
+// ====================================================
+
+ELEMENTWISE_BINARY(add_scalar, a + b)
+ELEMENTWISE_BINARY(sub_scalar, a - b)
+ELEMENTWISE_BINARY(mul_scalar, a * b)
+ELEMENTWISE_BINARY(div_scalar, a / b)
+
+// ====================================================
+// Activation Kernels
+// ====================================================
+
+ELEMENTWISE_UNARY(relu_scalar, x > 0.0f ? x : 0.0f)
+ELEMENTWISE_UNARY(sigmoid_scalar, 1.0f / (1.0f + expf(-x)))
+ELEMENTWISE_UNARY(tanh_scalar, tanhf(x))
+
+static void softmax_scalar(const float *x, float *y, size_t n) {
+    float max_val = x[0];
+    for (size_t i = 1; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        y[i] = expf(x[i] - max_val);
+        sum += y[i];
+    }
+
+    for (size_t i = 0; i < n; i++) y[i] /= sum;
+}
+
+// ====================================================
+// Loss Kernels
+// ====================================================
+
+static float mse_scalar(const float *pred, const float *target, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        float diff = pred[i] - target[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+static float cross_entropy_scalar(const float *pred, const float *target, size_t n) {
+    float sum = 0.0f;
+    float epsilon = 1e-7f;
+    for (size_t i = 0; i < n; i++) {
+        float p = pred[i];
+        p = p < epsilon ? epsilon : (p > 1.0f - epsilon ? 1.0f - epsilon : p);
+        sum += -target[i] * logf(p);
+    }
+    return sum;
+}
+
+static float binary_cross_entropy_scalar(const float *pred, const float *target, size_t n) {
+    float sum = 0.0f;
+    float epsilon = 1e-7f;
+    for (size_t i = 0; i < n; i++) {
+        float p = pred[i];
+        p = p < epsilon ? epsilon : (p > 1.0f - epsilon ? 1.0f - epsilon : p);
+        sum += -target[i] * logf(p) - (1.0f - target[i]) * logf(1.0f - p);
+    }
+    return sum;
+}
+
+// ====================================================
+// Optimizer Kernels
+// ====================================================
+
+static void adam_scalar(float *p, const float *g, float *m, float *v, size_t n, const AdamCoeffs *c) {
+    for (size_t i = 0; i < n; i++) adam_element(p + i, g[i], m + i, v + i, c);
+}
+
+static void sgd_scalar(float *p, const float *g, float *velocity, size_t n, float lr, float momentum) {
+    if (velocity) {
+        for (size_t i = 0; i < n; i++) {
+            velocity[i] = momentum * velocity[i] - lr * g[i];
+            p[i] += velocity[i];
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) p[i] -= lr * g[i];
+    }
+}
+
+// ====================================================
+// Kernel Table
+// ====================================================
+
+const OpKernels kernels_scalar = {
+    .name = "scalar",
+    .priority = BACKEND_PRIORITY_SCALAR,
+    .gemm = gemm_microkernel_scalar,
+    .small_m = gemm_small_m_scalar,
+    .add = add_scalar,
+    .sub = sub_scalar,
+    .mul = mul_scalar,
+    .div = div_scalar,
+    .relu = relu_scalar,
+    .sigmoid = sigmoid_scalar,
+    .tanh = tanh_scalar,
+    .softmax = softmax_scalar,
+    .mse = mse_scalar,
+    .cross_entropy = cross_entropy_scalar,
+    .binary_cross_entropy = binary_cross_entropy_scalar,
+    .adam = adam_scalar,
+    .sgd = sgd_scalar,
+    .fast_math = &fastmath_scalar,
+};
@@ -1,5 +1,6 @@
 #include "../include/layer.h"
 #include "../include/registry.h"
+#include "../include/gemm.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -20,20 +21,27 @@ static Layer* linear_create(LayerConfig *config) {
     LinearParams *params = (LinearParams*)config->params;
     Layer *layer = malloc(sizeof(Layer));
     layer->name = strdup(config->name);
-    layer->weights = tensor_randn((size_t[]){params->in_features, params->out_features}, 2, 42);
-    
-    float scale = sqrtf(2.0f / (float)params->in_features);
-    for (size_t i = 0; i < layer->weights->size; i++) {
-        layer->weights->data[i] *= scale;
+    if (config->no_init) {
+        layer->weights = tensor_create((size_t[]){params->in_features, params->out_features}, 2);
+        layer->bias = tensor_create((size_t[]){params->out_features}, 1);
+    } else {
+        layer->weights = tensor_randn((size_t[]){params->in_features, params->out_features}, 2, 42);
+
+        float scale = sqrtf(2.0f / (float)params->in_features);
+        for (size_t i = 0; i < layer->weights->size; i++) {
+            layer->weights->data[i] *= scale;
+        }
+
+        layer->bias = tensor_zeroes((size_t[]){params->out_features}, 1);
     }
-    
-    layer->bias = tensor_zeroes((size_t[]){params->out_features}, 1);
     layer->output = NULL;
     layer->parameters = malloc(2 * sizeof(Tensor*));
     layer->parameters[0] = layer->weights;
     layer->parameters[1] = layer->bias;
     layer->num_parameters = 2;
     layer->forward = linear_forward;
+    layer->packed_weights = NULL;
+    layer->packed_version = 0;
     
     layer->config_data_size = sizeof(LinearParams);
     layer->config_data = malloc(layer->config_data_size);
@@ -54,15 +62,29 @@ static Layer* activation_create(LayerConfig *config) {
     
     layer->config_data = NULL;
     layer->config_data_size = 0;
+    layer->packed_weights = NULL;
+    layer->packed_version = 0;
     
     return layer;
 }
 
+// Packs into layer->packed_weights, which holds gemm_packed_b_size floats
+static void linear_pack(Layer *layer) {
+    Tensor *W = layer->weights;
+    gemm_pack_b(W->shape[0], W->shape[1], W->data, W->strides[0], W->strides[1], layer->packed_weights);
+    layer->packed_version = W->version;
+}
+
+static Tensor* linear_apply(Layer *layer, Tensor *input, LinearActivation activation) {
+    if (!layer->packed_weights) return tensor_linear(input, layer->weights, layer->bias, activation);
+
+    if (layer->packed_version != layer->weights->version) linear_pack(layer);
+    return tensor_linear_prepacked(input, layer->weights, layer->packed_weights, layer->bias, activation);
+}
+
 static Tensor* linear_forward(Layer *self, Tensor *input) {
     if (!self || !input || !self->weights || !self->bias) return NULL;
-    Tensor *Z_0 = tensor_matmul(input, self->weights);
-    Tensor *Z = tensor_add(Z_0, self->bias);
-    return Z;
+    return linear_apply(self, input, LINEAR_ACT_NONE);
 }
 
 static Tensor* relu_forward(Layer *self, Tensor *input) {
@@ -112,6 +134,7 @@ void layer_free(Layer *layer) {
     if (layer->output) tensor_free(layer->output);
     if (layer->parameters) free(layer->parameters);
     if (layer->config_data) free(layer->config_data);
+    if (layer->forward == linear_forward) free(layer->packed_weights);
 
     free(layer);
 }
@@ -121,6 +144,68 @@ Tensor* layer_forward(Layer *layer, Tensor *input) {
     return layer->forward(layer, input);
 }
 
+// A LINEAR followed directly by one of these activations runs as one fused op
+static LinearActivation fusable_activation(Layer *layer) {
+    if (!layer) return LINEAR_ACT_NONE;
+    if (layer->forward == relu_forward) return LINEAR_ACT_RELU;
+    if (layer->forward == sigmoid_forward) return LINEAR_ACT_SIGMOID;
+    if (layer->forward == tanh_forward) return LINEAR_ACT_TANH;
+    return LINEAR_ACT_NONE;
+}
+
+Tensor* layer_forward_fused(Layer *layer, Layer *next, Tensor *input, size_t *consumed) {
+    if (consumed) *consumed = 1;
+    if (!layer || !layer->forward) return NULL;
+
+    LinearActivation activation = fusable_activation(next);
+    if (layer->forward != linear_forward || activation == LINEAR_ACT_NONE) {
+        return layer->forward(layer, input);
+    }
+
+    Tensor *output = linear_apply(layer, input, activation);
+    if (output && consumed) *consumed = 2;
+    return output;
+}
+
+// In-place forms of the elementwise activation layers
+static Tensor* (*inplace_activation(Layer *layer))(Tensor *) {
+    if (layer->forward == relu_forward) return tensor_relu_;
+    if (layer->forward == sigmoid_forward) return tensor_sigmoid_;
+    if (layer->forward == tanh_forward) return tensor_tanh_;
+    return NULL;
+}
+
+Tensor* layer_forward_reusing(Layer *layer, Layer *next, Tensor *input, size_t *consumed) {
+    if (consumed) *consumed = 1;
+    if (!layer || !layer->forward) return NULL;
+
+    Tensor* (*inplace)(Tensor *) = inplace_activation(layer);
+    if (inplace && input && tensor_is_contiguous(input) && tensor_inplace_safe(input)) {
+        Tensor *output = inplace(input);
+        if (output) return output;
+    }
+
+    return layer_forward_fused(layer, next, input, consumed);
+}
+
+int layer_prepack_weights(Layer *layer, int enabled) {
+    if (!layer || layer->forward != linear_forward || !layer->weights || layer->weights->ndim != 2) return 0;
+
+    if (!enabled) {
+        free(layer->packed_weights);
+        layer->packed_weights = NULL;
+        return 1;
+    }
+    if (!layer->packed_weights) {
+        size_t count = gemm_packed_b_size(layer->weights->shape[0], layer->weights->shape[1]);
+        void *ptr = NULL;
+        if (posix_memalign(&ptr, 64, (count ? count : 1) * sizeof(float)) != 0) return 0;
+        layer->packed_weights = (float *)ptr;
+    }
+    linear_pack(layer);
+    return 1;
+}
+
 // ====================================================
 // Autograd Utilities
 // ====================================================
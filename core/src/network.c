@@ -1,11 +1,75 @@
 #include "../include/network.h"
 #include "../include/registry.h"
+#include "serialize.h"
 #include <stdio.h> 
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define INITIAL_CAPACITY 8
+#define FLAT_ALIGNMENT 64
+
+// ====================================================
+// Parameter Storage
+// ====================================================
+
+static int flat_contains(const float *buffer, size_t size, const float *ptr) {
+    return buffer && ptr >= buffer && ptr < buffer + size;
+}
+
+static float* flat_alloc(size_t count) {
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, FLAT_ALIGNMENT, (count ? count : 1) * sizeof(float)) != 0) return NULL;
+    return (float *)ptr;
+}
+
+// Moves every parameter and its gradient into new flat buffers, replacing the
+// previous ones. Parameters stay where they are if any is not contiguous or
+// the buffers cannot be allocated
+static void network_flatten_parameters(Network *net) {
+    size_t total = 0;
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        if (!tensor_is_contiguous(net->parameters[i])) return;
+        total += net->parameters[i]->size;
+    }
+
+    float *data = flat_alloc(total);
+    float *grad = flat_alloc(total);
+    if (!data || !grad) {
+        free(data);
+        free(grad);
+        return;
+    }
+    memset(grad, 0, total * sizeof(float));
+
+    size_t offset = 0;
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        Tensor *param = net->parameters[i];
+        if (flat_contains(data, total, param->data)) continue;    // Listed twice
+
+        memcpy(data + offset, param->data, param->size * sizeof(float));
+        if (param->owns_data && !param->arena) free(param->data);
+        param->data = data + offset;
+        param->owns_data = 0;
+
+        if (param->grad) {
+            memcpy(grad + offset, param->grad, param->size * sizeof(float));
+            if (!flat_contains(net->grad_data, net->param_size, param->grad) && !param->arena) free(param->grad);
+        }
+        param->grad = grad + offset;
+
+        offset += param->size;
+    }
+
+    free(net->param_data);
+    free(net->grad_data);
+    net->param_data = data;
+    net->grad_data = grad;
+    net->param_size = total;
+}
 
 // ====================================================
 // Network Management
@@ -20,13 +84,18 @@ Network* network_create() {
     net->num_layers = 0; 
     net->num_parameters = 0;
     net->capacity = INITIAL_CAPACITY;
+    net->arena = NULL;
+    net->param_data = NULL;
+    net->grad_data = NULL;
+    net->param_size = 0;
+    net->mapping = NULL;
+    net->mapping_size = 0;
 
     return net;
 }
 
-void network_add_layer(Network *net, Layer *layer) {
-    if (!net || !layer) return;
-
+// Appends layer without moving any parameter storage
+static void network_append_layer(Network *net, Layer *layer) {
     if (net->num_layers >= net->capacity) {
         net->capacity *= 2; 
         net->layers = (Layer **)realloc(net->layers, net->capacity * sizeof(Layer *));
@@ -46,9 +115,24 @@ void network_add_layer(Network *net, Layer *layer) {
     net->parameters = network_get_parameters(net, &net->num_parameters);
 }
 
+void network_add_layer(Network *net, Layer *layer) {
+    if (!net || !layer) return;
+
+    network_append_layer(net, layer);
+    network_flatten_parameters(net);
+}
+
 void network_free(Network *net) {
     if (!net) return; 
 
+    // Parameters only view the flat buffers; detach their gradients so the
+    // layers do not free them
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        if (flat_contains(net->grad_data, net->param_size, net->parameters[i]->grad)) {
+            net->parameters[i]->grad = NULL;
+        }
+    }
+
     for (size_t i = 0; i < net->num_layers; i++) {
         layer_free(net->layers[i]);
     }
@@ -57,6 +141,10 @@ void network_free(Network *net) {
     if (net->parameters) {
         free(net->parameters);
     }
+    arena_free(net->arena);
+    free(net->param_data);
+    free(net->grad_data);
+    if (net->mapping) munmap(net->mapping, net->mapping_size);
     free(net);
 }
 
@@ -64,16 +152,61 @@ void network_free(Network *net) {
 // Forward
 // ====================================================
 
+// Runs the first num_layers layers; LINEAR + activation pairs run as one fused
+// layer. Intermediates are read only by the next layer, so activations may
+// overwrite them; the caller's input is never modified
+static Tensor* network_forward_layers(Network *net, Tensor *input, size_t num_layers) {
+    Tensor *output = input;
+
+    for (size_t i = 0; i < num_layers && output; ) {
+        size_t consumed;
+        Layer *next = (i + 1 < num_layers) ? net->layers[i + 1] : NULL;
+        output = (output == input) ? layer_forward_fused(net->layers[i], next, output, &consumed)
+                                   : layer_forward_reusing(net->layers[i], next, output, &consumed);
+        i += consumed;
+    }
+
+    return output;
+}
+
 Tensor* network_forward(Network *net, Tensor *input) {
     if (!net || !input) return NULL; 
+    return network_forward_layers(net, input, net->num_layers);
+}
 
-    Tensor *output = input; 
+Tensor* network_infer(Network *net, Tensor *input) {
+    if (!net || !input) return NULL;
 
-    for (size_t i = 0; i < net->num_layers; i++) {
-        Tensor *new_output = layer_forward(net->layers[i], output); 
-        output = new_output;
+    int prev = tensor_set_grad_enabled(0);
+
+    // Views borrow their source's storage, so intermediates wait here until a
+    // layer produces a tensor with storage of its own
+    Tensor *pending[net->num_layers + 1];
+    size_t num_pending = 0;
+    Tensor *output = input;
+
+    for (size_t i = 0, consumed = 1; i < net->num_layers && output; i += consumed) {
+        Layer *following = (i + 1 < net->num_layers) ? net->layers[i + 1] : NULL;
+        Tensor *next = (output == input) ? layer_forward_fused(net->layers[i], following, output, &consumed)
+                                         : layer_forward_reusing(net->layers[i], following, output, &consumed);
+        if (next == output) continue;
+
+        if (output != input) pending[num_pending++] = output;
+        if (!next || next->owns_data) {
+            for (size_t j = 0; j < num_pending; j++) tensor_free(pending[j]);
+            num_pending = 0;
+        }
+        output = next;
     }
 
+    if (output && num_pending > 0) {
+        Tensor *owned = tensor_copy(output);
+        tensor_free(output);
+        for (size_t j = 0; j < num_pending; j++) tensor_free(pending[j]);
+        output = owned;
+    }
+
+    tensor_set_grad_enabled(prev);
     return output;
 }
 
@@ -81,9 +214,46 @@ Tensor* network_forward(Network *net, Tensor *input) {
 // Network Training
 // ====================================================
 
+// Every tensor created during a step (batch views, activations, loss, autograd
+// bookkeeping) comes from the network's arena and is released in one reset
+static Arena* network_step_arena(Network *net) {
+    if (!net->arena) net->arena = arena_create(0);
+    return net->arena;
+}
+
+// A trailing SOFTMAX layer feeding "cross_entropy" (or "sparse_cross_entropy")
+// is folded into the fused softmax_cross_entropy loss (or its sparse form),
+// which takes the logits: *num_layers then stops short of the softmax
+static LossFn network_resolve_loss(Network *net, const char *loss_name, size_t *num_layers) {
+    *num_layers = net->num_layers;
+    if (!loss_name) return NULL;
+
+    const char *fused_name = NULL;
+    if (strcmp(loss_name, "cross_entropy") == 0) fused_name = "softmax_cross_entropy";
+    if (strcmp(loss_name, "sparse_cross_entropy") == 0) fused_name = "sparse_softmax_cross_entropy";
+
+    if (fused_name && net->num_layers > 0) {
+        Layer *last = net->layers[net->num_layers - 1];
+        LossFn fused = get_loss_fn(fused_name);
+        if (fused && last->name && strcmp(last->name, "softmax") == 0) {
+            *num_layers -= 1;
+            return fused;
+        }
+    }
+
+    return get_loss_fn(loss_name);
+}
+
 void network_train(Network *net, Optimizer *opt,  Tensor *input, Tensor *target, size_t epochs, size_t batch_size, const char *loss_name, int verbose) {
     if (!net || !opt || !input || !target) return; 
 
+    size_t num_layers;
+    LossFn loss_fn = network_resolve_loss(net, loss_name, &num_layers);
+    if (!loss_fn) return;
+
+    Arena *arena = network_step_arena(net);
+    if (!arena) return;
+
     size_t num_samples = input->shape[0]; 
     size_t num_batches = (num_samples + batch_size - 1) / batch_size; 
 
@@ -94,31 +264,12 @@ void network_train(Network *net, Optimizer *opt,  Tensor *input, Tensor *target,
             size_t start = batch * batch_size; 
             size_t end = (start + batch_size < num_samples) ? (start + batch_size) : num_samples; 
             
+            Arena *prev = arena_activate(arena);
+
             Tensor *batch_input = tensor_slice(input, start, end); 
             Tensor *batch_target = tensor_slice(target, start, end); 
-
-            if (!batch_input || !batch_target) {
-                if (batch_input) tensor_free(batch_input);
-                if (batch_target) tensor_free(batch_target);
-                continue; 
-            }
-
-            Tensor *predictions = network_forward(net, batch_input);
-            if (!predictions) {
-                tensor_free(batch_input);
-                tensor_free(batch_target);
-                continue; 
-            }
-
-            LossFn loss_fn = get_loss_fn(loss_name);
-            if (!loss_fn) {
-                tensor_free(batch_input);
-                tensor_free(batch_target);
-                tensor_free(predictions);
-                continue;
-            }
-            
-            Tensor *loss_tensor = loss_fn(predictions, batch_target);
+            Tensor *predictions = (batch_input && batch_target) ? network_forward_layers(net, batch_input, num_layers) : NULL;
+            Tensor *loss_tensor = predictions ? loss_fn(predictions, batch_target) : NULL;
 
             if (loss_tensor) {
                 float loss = loss_tensor->data[0]; 
@@ -128,13 +279,11 @@ void network_train(Network *net, Optimizer *opt,  Tensor *input, Tensor *target,
                 tensor_backward(loss_tensor); 
 
                 optimizer_step(opt);
-
-                tensor_free(loss_tensor);
             }
 
-            tensor_free(batch_input); 
-            tensor_free(batch_target);
-            tensor_free(predictions);
+            arena_activate(prev);
+            arena_reset(arena);
+            tensor_tape_clear();
         }
 
         if (verbose) printf("Epoch %zu/%zu, Loss: %.6f\n", epoch + 1, epochs, total_loss / num_batches);
@@ -144,30 +293,30 @@ void network_train(Network *net, Optimizer *opt,  Tensor *input, Tensor *target,
 float network_train_step(Network *net, Tensor *input, Tensor *target, Optimizer *opt, const char *loss_name) {
     if (!net || !opt || !input || !target) return 0.0f;
 
-    Tensor *predictions = network_forward(net, input);
-    if (!predictions) return 0.0f;
+    size_t num_layers;
+    LossFn loss_fn = network_resolve_loss(net, loss_name, &num_layers);
+    if (!loss_fn) return 0.0f;
 
-    LossFn loss_fn = get_loss_fn(loss_name);
-    if (!loss_fn) {
-        tensor_free(predictions);
-        return 0.0f;
-    }
-    
-    Tensor *loss_tensor = loss_fn(predictions, target);
+    Arena *arena = network_step_arena(net);
+    if (!arena) return 0.0f;
 
-    if (!loss_tensor) {
-        tensor_free(predictions);
-        return 0.0f;
-    }
+    Arena *prev = arena_activate(arena);
 
-    float loss = loss_tensor->data[0];
-    
-    network_zero_grad(net);
-    tensor_backward(loss_tensor);
-    optimizer_step(opt);
+    float loss = 0.0f;
+    Tensor *predictions = network_forward_layers(net, input, num_layers);
+    Tensor *loss_tensor = predictions ? loss_fn(predictions, target) : NULL;
+
+    if (loss_tensor) {
+        loss = loss_tensor->data[0];
 
-    tensor_free(loss_tensor);
-    tensor_free(predictions);
+        network_zero_grad(net);
+        tensor_backward(loss_tensor);
+        optimizer_step(opt);
+    }
+
+    arena_activate(prev);
+    arena_reset(arena);
+    tensor_tape_clear();
 
     return loss;
 }
@@ -175,8 +324,18 @@ float network_train_step(Network *net, Tensor *input, Tensor *target, Optimizer
 void network_zero_grad(Network *net) {
     if (!net) return; 
 
-    for (size_t i = 0; i < net->num_layers; i++) {
-        layer_zero_grad(net->layers[i]);
+    if (!net->grad_data) {
+        for (size_t i = 0; i < net->num_layers; i++) {
+            layer_zero_grad(net->layers[i]);
+        }
+        return;
+    }
+
+    // Gradients replaced since flattening live elsewhere and are zeroed apart
+    memset(net->grad_data, 0, net->param_size * sizeof(float));
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        Tensor *param = net->parameters[i];
+        if (param->grad && !flat_contains(net->grad_data, net->param_size, param->grad)) tensor_zero_grad(param);
     }
 }
 
@@ -250,6 +409,9 @@ float network_accuracy(Tensor *predictions, Tensor *targets) {
     size_t num_classes = predictions->shape[1];
     size_t correct = 0;
 
+    // Class-index targets are read directly, O(1) per sample
+    int sparse = targets->ndim == 1;
+
     for (size_t i = 0; i < num_samples; i++) {
         size_t pred_class = 0; 
         float max_pred = predictions->data[i * num_classes];
@@ -260,11 +422,15 @@ float network_accuracy(Tensor *predictions, Tensor *targets) {
             }
         }
         size_t target_class = 0; 
-        float max_target = targets->data[i * num_classes];
-        for (size_t j = 1; j < num_classes; j++) {
-            if (targets->data[i * num_classes + j] > max_target) {
-                max_target = targets->data[i * num_classes + j];
-                target_class = j;
+        if (sparse) {
+            target_class = (size_t)targets->data[i];
+        } else {
+            float max_target = targets->data[i * num_classes];
+            for (size_t j = 1; j < num_classes; j++) {
+                if (targets->data[i * num_classes + j] > max_target) {
+                    max_target = targets->data[i * num_classes + j];
+                    target_class = j;
+                }
             }
         }
 
@@ -276,56 +442,154 @@ float network_accuracy(Tensor *predictions, Tensor *targets) {
     return (float)correct / num_samples;
 }
 
+// ====================================================
+// Weight Pre-Packing
+// ====================================================
+
+size_t network_prepack_weights(Network *net, int enabled) {
+    if (!net) return 0;
+
+    size_t packed = 0;
+    for (size_t i = 0; i < net->num_layers; i++) {
+        if (layer_prepack_weights(net->layers[i], enabled) && enabled) packed++;
+    }
+    return packed;
+}
+
 // ====================================================
 // Save/Load
 // ====================================================
 
-static void layer_save(Layer *layer, FILE *file) {
-    if (!layer || !file) return;
+// Format v2, every field little-endian and offsets counted from the file start:
+//
+//   header         u32 magic, u32 version = 2, u64 num_layers, u64 num_tensors,
+//                  u64 layers_offset, u64 tensors_offset, u64 data_offset,
+//                  u64 file_size (64 bytes)
+//   layer records  u32 name_len (with NUL), u32 num_tensors, u64 config_size,
+//                  name, config_data bytes, zero padding to 8 bytes
+//   tensor index   u32 layer, u32 ndim, u32 dtype (0: float32), u32 reserved,
+//                  u64 offset, u64 count, u64 shape[ndim]; one entry per
+//                  parameter, in layer order
+//   payloads       count floats at offset, a multiple of 64
+//
+// Version 1 is the same magic and version followed by native size_t fields
+// and unaligned float runs.
+#define CHECKPOINT_MAGIC 0x42444E4E     // "bDDN"
+#define CHECKPOINT_HEADER_SIZE 64
+#define CHECKPOINT_ALIGNMENT 64
+#define CHECKPOINT_DTYPE_F32 0
+
+static uint64_t layer_record_size(Layer *layer) {
+    return align_up(16 + strlen(layer->name) + 1 + layer->config_data_size, 8);
+}
 
-    size_t name_len = strlen(layer->name) + 1;
-    fwrite(&name_len, sizeof(size_t), 1, file);
-    fwrite(layer->name, sizeof(char), name_len, file);
+static uint64_t tensor_entry_size(Tensor *param) {
+    return 32 + 8 * (uint64_t)param->ndim;
+}
 
-    fwrite(&layer->config_data_size, sizeof(size_t), 1, file);
-    if (layer->config_data_size > 0 && layer->config_data) {
-        fwrite(layer->config_data, 1, layer->config_data_size, file);
+// Encodes the layer records and tensor index into meta, which starts at
+// layers_offset, and returns the end of the last payload
+static uint64_t network_encode_index(Network *net, unsigned char *meta, uint64_t tensors_offset, uint64_t data_offset) {
+    unsigned char *p = meta;
+    for (size_t i = 0; i < net->num_layers; i++) {
+        Layer *layer = net->layers[i];
+        size_t name_len = strlen(layer->name) + 1;
+        unsigned char *record = p;
+
+        le_put_u32(p, (uint32_t)name_len);
+        le_put_u32(p + 4, (uint32_t)layer->num_parameters);
+        le_put_u64(p + 8, layer->config_data_size);
+        memcpy(p + 16, layer->name, name_len);
+        if (layer->config_data_size > 0) memcpy(p + 16 + name_len, layer->config_data, layer->config_data_size);
+        p = record + layer_record_size(layer);
     }
 
-    fwrite(&layer->num_parameters, sizeof(size_t), 1, file);
-    
-    for (size_t i = 0; i < layer->num_parameters; i++) {
-        Tensor *param = layer->parameters[i];
-        fwrite(&param->ndim, sizeof(size_t), 1, file);
-        fwrite(param->shape, sizeof(size_t), param->ndim, file);
-        fwrite(param->data, sizeof(float), param->size, file);
+    p = meta + (tensors_offset - CHECKPOINT_HEADER_SIZE);
+    uint64_t offset = data_offset, end = data_offset;
+    for (size_t i = 0; i < net->num_layers; i++) {
+        for (size_t j = 0; j < net->layers[i]->num_parameters; j++) {
+            Tensor *param = net->layers[i]->parameters[j];
+
+            le_put_u32(p, (uint32_t)i);
+            le_put_u32(p + 4, (uint32_t)param->ndim);
+            le_put_u32(p + 8, CHECKPOINT_DTYPE_F32);
+            le_put_u64(p + 16, offset);
+            le_put_u64(p + 24, param->size);
+            for (size_t d = 0; d < param->ndim; d++) le_put_u64(p + 32 + 8 * d, param->shape[d]);
+            p += tensor_entry_size(param);
+
+            end = offset + param->size * sizeof(float);
+            offset = align_up(end, CHECKPOINT_ALIGNMENT);
+        }
+    }
+    return end;
+}
+
+// Header, layer records and tensor index in one zeroed buffer of *data_offset
+// bytes; *file_size is where the last payload ends. NULL if out of memory
+static unsigned char* network_encode_meta(Network *net, uint64_t *data_offset, uint64_t *file_size) {
+    uint64_t num_tensors = 0, layers_size = 0, index_size = 0;
+    for (size_t i = 0; i < net->num_layers; i++) {
+        Layer *layer = net->layers[i];
+        layers_size += layer_record_size(layer);
+        for (size_t j = 0; j < layer->num_parameters; j++) index_size += tensor_entry_size(layer->parameters[j]);
+        num_tensors += layer->num_parameters;
     }
+
+    uint64_t tensors_offset = CHECKPOINT_HEADER_SIZE + layers_size;
+    *data_offset = align_up(tensors_offset + index_size, CHECKPOINT_ALIGNMENT);
+
+    unsigned char *meta = calloc(*data_offset, 1);
+    if (!meta) return NULL;
+    *file_size = network_encode_index(net, meta + CHECKPOINT_HEADER_SIZE, tensors_offset, *data_offset);
+
+    le_put_u32(meta, CHECKPOINT_MAGIC);
+    le_put_u32(meta + 4, 2);
+    le_put_u64(meta + 8, net->num_layers);
+    le_put_u64(meta + 16, num_tensors);
+    le_put_u64(meta + 24, CHECKPOINT_HEADER_SIZE);
+    le_put_u64(meta + 32, tensors_offset);
+    le_put_u64(meta + 40, *data_offset);
+    le_put_u64(meta + 48, *file_size);
+    return meta;
 }
 
 void network_save(Network *net, const char *file_path) {
     if (!net || !file_path) return; 
 
-    FILE *file = fopen(file_path, "wb"); 
+    uint64_t data_offset, file_size;
+    unsigned char *meta = network_encode_meta(net, &data_offset, &file_size);
+    if (!meta) {
+        fprintf(stderr, "Error: Out of memory saving %s\n", file_path);
+        return;
+    }
+
+    char *tmp_path;
+    FILE *file = atomic_file_open(file_path, &tmp_path);
     if (!file) {
         fprintf(stderr, "Error: Could not open file %s for writing\n", file_path);
+        free(meta);
         return;
     }
 
-    uint32_t magic_number = 0x42444E4E; // "bDDN"
-    uint32_t version = 1;
-    fwrite(&magic_number, sizeof(uint32_t), 1, file);
-    fwrite(&version, sizeof(uint32_t), 1, file);
-
-    fwrite(&net->num_layers, sizeof(size_t), 1, file);
-    for (size_t i = 0; i < net->num_layers; i++) {
-        layer_save(net->layers[i], file);
+    int ok = fwrite(meta, 1, data_offset, file) == data_offset;
+    for (size_t i = 0; i < net->num_layers && ok; i++) {
+        for (size_t j = 0; j < net->layers[i]->num_parameters && ok; j++) {
+            Tensor *param = net->layers[i]->parameters[j];
+            ok = write_padding(file, CHECKPOINT_ALIGNMENT) && le_write_floats(file, param->data, param->size);
+        }
     }
+    ok = atomic_file_commit(file, tmp_path, file_path, ok);
 
-    fclose(file);
-    printf("Network saved to %s\n", file_path);
+    free(meta);
+    if (!ok) fprintf(stderr, "Error: Could not write %s\n", file_path);
 }
 
-static Layer* layer_load(FILE *file) {
+// ====================================================
+// Version 1
+// ====================================================
+
+static Layer* layer_load_v1(FILE *file) {
     if (!file) return NULL; 
 
     size_t name_len;
@@ -354,7 +618,7 @@ static Layer* layer_load(FILE *file) {
         }
     }
 
-    LayerConfig config = {.name = name, .params = config_data};
+    LayerConfig config = {.name = name, .params = config_data, .no_init = 1};
     Layer *layer = layer_create(config);
     if (!layer) {
         if (config_data) free(config_data);
@@ -403,7 +667,7 @@ static Layer* layer_load(FILE *file) {
         }
         free(shape);
         
-        if (fread(param->data, sizeof(float), size, file) != size) {
+        if (size != param->size || fread(param->data, sizeof(float), size, file) != size) {
             layer_free(layer);
             if (config_data) free(config_data);
             free(name);
@@ -416,6 +680,166 @@ static Layer* layer_load(FILE *file) {
     return layer;
 }
 
+static Network* network_load_v1(FILE *file, const char *file_path) {
+    size_t num_layers;
+    if (fread(&num_layers, sizeof(size_t), 1, file) != 1) {
+        fprintf(stderr, "Error: Could not read number of layers from %s\n", file_path);
+        return NULL;
+    }
+
+    Network *net = network_create();
+    if (!net) return NULL;
+
+    for (size_t i = 0; i < num_layers; i++) {
+        Layer *layer = layer_load_v1(file); 
+        if (!layer) {
+            fprintf(stderr, "Error: Could not load layer %zu from %s\n", i, file_path);
+            network_free(net);
+            return NULL;
+        }
+        network_add_layer(net, layer); 
+    }
+
+    return net;
+}
+
+// ====================================================
+// Version 2
+// ====================================================
+
+// Bounds-checked reads from the metadata block
+typedef struct {
+    const unsigned char *data;
+    uint64_t size;
+    uint64_t pos;
+} MetaCursor;
+
+static const unsigned char* meta_take(MetaCursor *c, uint64_t n) {
+    if (n > c->size - c->pos) return NULL;
+    const unsigned char *p = c->data + c->pos;
+    c->pos += n;
+    return p;
+}
+
+// Points param at its payload in mapping, or reads it in when there is none
+static int tensor_attach_payload(Tensor *param, FILE *file, unsigned char *mapping, uint64_t offset) {
+    if (mapping) {
+        if (param->owns_data) free(param->data);
+        param->data = (float *)(mapping + offset);
+        param->owns_data = 0;
+        return 1;
+    }
+    return fseek(file, (long)offset, SEEK_SET) == 0 && le_read_floats(file, param->data, param->size);
+}
+
+// Creates the layer of the next record, skipping parameter init, and attaches
+// each parameter to the payload of its index entry once checked against it
+static Layer* layer_load_v2(MetaCursor *records, MetaCursor *index, uint32_t layer_index,
+                            FILE *file, unsigned char *mapping, uint64_t file_size) {
+    const unsigned char *head = meta_take(records, 16);
+    if (!head) return NULL;
+    uint32_t name_len = le_get_u32(head);
+    uint32_t num_tensors = le_get_u32(head + 4);
+    uint64_t config_size = le_get_u64(head + 8);
+
+    const unsigned char *name = meta_take(records, name_len);
+    const unsigned char *config = meta_take(records, config_size);
+    if (!name || !config || name_len == 0 || name[name_len - 1] != '\0') return NULL;
+    if (!meta_take(records, align_up(records->pos, 8) - records->pos)) return NULL;
+
+    // Copied so the layer reads its config at the alignment of its own struct
+    void *config_data = config_size > 0 ? malloc(config_size) : NULL;
+    if (config_size > 0 && !config_data) return NULL;
+    if (config_data) memcpy(config_data, config, config_size);
+
+    LayerConfig layer_config = {.name = (const char *)name, .params = config_data, .no_init = 1};
+    Layer *layer = layer_create(layer_config);
+    free(config_data);
+    if (!layer) return NULL;
+
+    if (layer->num_parameters != num_tensors) {
+        fprintf(stderr, "Error: Parameter count mismatch for layer %s\n", layer->name);
+        layer_free(layer);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < num_tensors; i++) {
+        Tensor *param = layer->parameters[i];
+        const unsigned char *entry = meta_take(index, 32);
+        const unsigned char *shape = entry ? meta_take(index, 8 * (uint64_t)le_get_u32(entry + 4)) : NULL;
+        int ok = shape && le_get_u32(entry) == layer_index && le_get_u32(entry + 8) == CHECKPOINT_DTYPE_F32 &&
+                 le_get_u32(entry + 4) == param->ndim && le_get_u64(entry + 24) == param->size;
+        for (size_t d = 0; ok && d < param->ndim; d++) ok = le_get_u64(shape + 8 * d) == param->shape[d];
+
+        uint64_t offset = ok ? le_get_u64(entry + 16) : 0;
+        ok = ok && offset % CHECKPOINT_ALIGNMENT == 0 && offset <= file_size &&
+             param->size <= (file_size - offset) / sizeof(float);
+        if (!ok || !tensor_attach_payload(param, file, mapping, offset)) {
+            fprintf(stderr, "Error: Bad tensor entry %zu for layer %s\n", i, layer->name);
+            layer_free(layer);
+            return NULL;
+        }
+    }
+
+    return layer;
+}
+
+static Network* network_load_v2(FILE *file, const char *file_path, const unsigned char *header) {
+    uint64_t num_layers = le_get_u64(header + 8);
+    uint64_t layers_offset = le_get_u64(header + 24);
+    uint64_t tensors_offset = le_get_u64(header + 32);
+    uint64_t data_offset = le_get_u64(header + 40);
+    uint64_t file_size = le_get_u64(header + 48);
+
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0 || (uint64_t)st.st_size < file_size || data_offset > file_size ||
+        layers_offset < CHECKPOINT_HEADER_SIZE || layers_offset > tensors_offset || tensors_offset > data_offset) {
+        fprintf(stderr, "Error: Truncated or corrupt checkpoint %s\n", file_path);
+        return NULL;
+    }
+
+    unsigned char *meta = malloc(data_offset);
+    if (!meta || fseek(file, 0, SEEK_SET) != 0 || fread(meta, 1, data_offset, file) != data_offset) {
+        fprintf(stderr, "Error: Could not read index of %s\n", file_path);
+        free(meta);
+        return NULL;
+    }
+
+    // Private and writable, so training a loaded network updates its own copy of the pages
+    unsigned char *mapping = NULL;
+    if (host_is_little_endian() && file_size > 0) {
+        void *map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+        if (map != MAP_FAILED) mapping = map;
+    }
+
+    MetaCursor records = {meta, tensors_offset, layers_offset};
+    MetaCursor index = {meta, data_offset, tensors_offset};
+    Network *net = network_create();
+    int ok = net != NULL;
+
+    for (uint64_t i = 0; i < num_layers && ok; i++) {
+        Layer *layer = layer_load_v2(&records, &index, (uint32_t)i, file, mapping, file_size);
+        if (!layer) {
+            fprintf(stderr, "Error: Could not load layer %llu from %s\n", (unsigned long long)i, file_path);
+            ok = 0;
+        } else if (mapping) {
+            network_append_layer(net, layer);
+        } else {
+            network_add_layer(net, layer);
+        }
+    }
+    free(meta);
+
+    if (!ok) {
+        network_free(net);
+        if (mapping) munmap(mapping, file_size);
+        return NULL;
+    }
+    net->mapping = mapping;
+    net->mapping_size = mapping ? file_size : 0;
+    return net;
+}
+
 Network* network_load(const char *file_path) {
     if (!file_path) return NULL; 
 
@@ -425,45 +849,262 @@ Network* network_load(const char *file_path) {
         return NULL;
     }
 
-    uint32_t magic_number;
-    if (fread(&magic_number, sizeof(uint32_t), 1, file) != 1 || magic_number != 0x42444E4E) { // "bDDN"
+    // v1 headers are 8 bytes in host byte order, v2 headers 64 little-endian ones
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    uint32_t magic = 0, version = 0;
+    if (fread(header, 1, 8, file) == 8) {
+        memcpy(&magic, header, sizeof(magic));
+        memcpy(&version, header + 4, sizeof(version));
+    }
+    if (magic != CHECKPOINT_MAGIC && le_get_u32(header) != CHECKPOINT_MAGIC) {
         fprintf(stderr, "Error: Invalid file format for %s\n", file_path);
         fclose(file);
         return NULL;
     }
 
-    uint32_t version; 
-    if (fread(&version, sizeof(uint32_t), 1, file) != 1 || version != 1) {
-        fprintf(stderr, "Error: Unsupported version %u in file %s\n", version, file_path);
-        fclose(file);
-        return NULL;
+    Network *net = NULL;
+    if (magic == CHECKPOINT_MAGIC && version == 1) {
+        net = network_load_v1(file, file_path);
+    } else if (le_get_u32(header + 4) == 2 &&
+               fread(header + 8, 1, CHECKPOINT_HEADER_SIZE - 8, file) == CHECKPOINT_HEADER_SIZE - 8) {
+        net = network_load_v2(file, file_path, header);
+    } else {
+        fprintf(stderr, "Error: Unsupported version %u in file %s\n", le_get_u32(header + 4), file_path);
     }
 
-    size_t num_layers;
-    if (fread(&num_layers, sizeof(size_t), 1, file) != 1) {
-        fprintf(stderr, "Error: Could not read number of layers from %s\n", file_path);
+    fclose(file);
+    return net;
+}
+
+// ====================================================
+// Training Checkpoints
+// ====================================================
+
+// Little-endian throughout:
+//
+//   header      u32 magic, u32 version = 1, u64 epoch, u64 batch, u64 step,
+//               u64 rng_state[4] (64 bytes)
+//   parameters  u64 num_parameters, then per parameter u64 count and count
+//               floats, in network_get_parameters order
+//   optimizer   optimizer_write stream
+#define TRAINING_MAGIC 0x4B434462       // "bDCK"
+#define TRAINING_VERSION 1
+
+static int training_checkpoint_write(Network *net, Optimizer *opt, const TrainingCursor *cursor, FILE *file) {
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    le_put_u32(header, TRAINING_MAGIC);
+    le_put_u32(header + 4, TRAINING_VERSION);
+    le_put_u64(header + 8, cursor->epoch);
+    le_put_u64(header + 16, cursor->batch);
+    le_put_u64(header + 24, cursor->step);
+    for (int i = 0; i < 4; i++) le_put_u64(header + 32 + 8 * i, cursor->rng_state[i]);
+
+    int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) && le_write_u64(file, net->num_parameters);
+    for (size_t i = 0; i < net->num_parameters && ok; i++) {
+        Tensor *param = net->parameters[i];
+        ok = le_write_u64(file, param->size) && le_write_floats(file, param->data, param->size);
+    }
+    return ok && optimizer_write(opt, file);
+}
+
+int network_save_checkpoint(Network *net, Optimizer *opt, const TrainingCursor *cursor, const char *file_path) {
+    if (!net || !opt || !cursor || !file_path) return 0;
+
+    char *tmp_path;
+    FILE *file = atomic_file_open(file_path, &tmp_path);
+    if (!file) {
+        fprintf(stderr, "Error: Could not open file %s for writing\n", file_path);
+        return 0;
+    }
+    int ok = training_checkpoint_write(net, opt, cursor, file);
+    ok = atomic_file_commit(file, tmp_path, file_path, ok);
+
+    if (!ok) fprintf(stderr, "Error: Could not write %s\n", file_path);
+    return ok;
+}
+
+int network_load_checkpoint(Network *net, Optimizer *opt, TrainingCursor *cursor, const char *file_path) {
+    if (!net || !opt || !cursor || !file_path) return 0;
+
+    FILE *file = fopen(file_path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Could not open file %s for reading\n", file_path);
+        return 0;
+    }
+
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    uint64_t num_parameters = 0;
+    int ok = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+             le_get_u32(header) == TRAINING_MAGIC && le_get_u32(header + 4) == TRAINING_VERSION &&
+             le_read_u64(file, &num_parameters) && num_parameters == net->num_parameters;
+    if (!ok) {
+        fprintf(stderr, "Error: %s is not a training checkpoint for this network\n", file_path);
         fclose(file);
+        return 0;
+    }
+
+    // Parameters are staged and the optimizer state backed up first, so a
+    // truncated or mismatched file leaves both as they were
+    size_t total = 0;
+    for (size_t i = 0; i < net->num_parameters; i++) total += net->parameters[i]->size;
+    float *staged = malloc((total ? total : 1) * sizeof(float));
+    char *backup = NULL;
+    size_t backup_size = 0;
+    FILE *backup_stream = open_memstream(&backup, &backup_size);
+    ok = staged && backup_stream && optimizer_write(opt, backup_stream);
+    if (backup_stream) ok = (fclose(backup_stream) == 0) && ok;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < net->num_parameters && ok; i++) {
+        Tensor *param = net->parameters[i];
+        uint64_t count;
+        ok = le_read_u64(file, &count);
+        if (ok && count != param->size) {
+            fprintf(stderr, "Error: Parameter %zu in %s has %llu elements, expected %zu\n",
+                    i, file_path, (unsigned long long)count, param->size);
+            ok = 0;
+        }
+        ok = ok && le_read_floats(file, staged + offset, param->size);
+        offset += param->size;
+    }
+    if (ok && !optimizer_read(opt, file)) {
+        FILE *restore = fmemopen(backup, backup_size, "rb");
+        if (!restore || !optimizer_read(opt, restore)) {
+            fprintf(stderr, "Error: Could not restore optimizer state after failing to load %s\n", file_path);
+        }
+        if (restore) fclose(restore);
+        ok = 0;
+    }
+    fclose(file);
+    free(backup);
+
+    if (!ok) {
+        fprintf(stderr, "Error: Could not load training checkpoint %s\n", file_path);
+        free(staged);
+        return 0;
+    }
+    offset = 0;
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        Tensor *param = net->parameters[i];
+        memcpy(param->data, staged + offset, param->size * sizeof(float));
+        offset += param->size;
+        param->version++;
+    }
+    free(staged);
+
+    cursor->epoch = le_get_u64(header + 8);
+    cursor->batch = le_get_u64(header + 16);
+    cursor->step = le_get_u64(header + 24);
+    for (int i = 0; i < 4; i++) cursor->rng_state[i] = le_get_u64(header + 32 + 8 * i);
+    return 1;
+}
+
+// ====================================================
+// Asynchronous Saves
+// ====================================================
+
+// The complete file image is staged in memory, so the writer thread shares
+// nothing with the network and training may continue (or free it) at once
+struct CheckpointHandle {
+    pthread_t thread;
+    unsigned char *image;
+    size_t size;
+    char *path;
+    int done;
+    int ok;
+};
+
+static void* checkpoint_writer(void *arg) {
+    CheckpointHandle *handle = (CheckpointHandle *)arg;
+
+    int ok = 0;
+    char *tmp_path;
+    FILE *file = atomic_file_open(handle->path, &tmp_path);
+    if (file) {
+        ok = fwrite(handle->image, 1, handle->size, file) == handle->size;
+        ok = atomic_file_commit(file, tmp_path, handle->path, ok);
+    }
+    if (!ok) fprintf(stderr, "Error: Could not write %s\n", handle->path);
+
+    // Staging memory goes back before the caller gets around to waiting
+    free(handle->image);
+    handle->image = NULL;
+    handle->ok = ok;
+    __atomic_store_n(&handle->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Takes ownership of image
+static CheckpointHandle* checkpoint_start(unsigned char *image, size_t size, const char *file_path) {
+    CheckpointHandle *handle = calloc(1, sizeof(CheckpointHandle));
+    if (handle) {
+        handle->image = image;
+        handle->size = size;
+        handle->path = strdup(file_path);
+    }
+    if (!handle || !handle->path || pthread_create(&handle->thread, NULL, checkpoint_writer, handle) != 0) {
+        fprintf(stderr, "Error: Could not start writing %s\n", file_path);
+        if (handle) free(handle->path);
+        free(handle);
+        free(image);
         return NULL;
     }
+    return handle;
+}
 
-    Network *net = network_create();
-    if (!net) {
-        fclose(file);
+CheckpointHandle* network_save_async(Network *net, const char *file_path) {
+    if (!net || !file_path) return NULL;
+
+    uint64_t data_offset, file_size;
+    unsigned char *meta = network_encode_meta(net, &data_offset, &file_size);
+    unsigned char *image = meta ? realloc(meta, file_size) : NULL;
+    if (!image) {
+        fprintf(stderr, "Error: Out of memory saving %s\n", file_path);
+        free(meta);
         return NULL;
     }
 
-    for (size_t i = 0; i < num_layers; i++) {
-        Layer *layer = layer_load(file); 
-        if (!layer) {
-            fprintf(stderr, "Error: Could not load layer %zu from %s\n", i, file_path);
-            network_free(net);
-            fclose(file);
-            return NULL;
+    // Payloads in network_encode_index's layout, zeroing only the padding
+    uint64_t offset = data_offset;
+    for (size_t i = 0; i < net->num_layers; i++) {
+        for (size_t j = 0; j < net->layers[i]->num_parameters; j++) {
+            Tensor *param = net->layers[i]->parameters[j];
+            uint64_t start = align_up(offset, CHECKPOINT_ALIGNMENT);
+            memset(image + offset, 0, start - offset);
+            le_store_floats(image + start, param->data, param->size);
+            offset = start + param->size * sizeof(float);
         }
-        network_add_layer(net, layer); 
     }
+    return checkpoint_start(image, file_size, file_path);
+}
 
-    fclose(file);
-    printf("Network loaded from %s\n", file_path);
-    return net;
-}
\ No newline at end of file
+CheckpointHandle* network_save_checkpoint_async(Network *net, Optimizer *opt, const TrainingCursor *cursor,
+                                                const char *file_path) {
+    if (!net || !opt || !cursor || !file_path) return NULL;
+
+    char *image = NULL;
+    size_t size = 0;
+    FILE *stream = open_memstream(&image, &size);
+    int ok = stream && training_checkpoint_write(net, opt, cursor, stream);
+    if (stream && fclose(stream) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Error: Could not stage %s\n", file_path);
+        free(image);
+        return NULL;
+    }
+    return checkpoint_start((unsigned char *)image, size, file_path);
+}
+
+int checkpoint_done(CheckpointHandle *handle) {
+    return !handle || __atomic_load_n(&handle->done, __ATOMIC_ACQUIRE);
+}
+
+int checkpoint_wait(CheckpointHandle *handle) {
+    if (!handle) return 0;
+
+    pthread_join(handle->thread, NULL);
+    int ok = handle->ok;
+    free(handle->path);
+    free(handle);
+    return ok;
+}
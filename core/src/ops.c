@@ -1,5 +1,11 @@
 #include "../include/ops.h"
 #include "../include/registry.h"
+#include "../include/gemm.h"
+#include "../include/cpu.h"
+#include "kernels.h"
+#include "../include/arena.h"
+#include "../include/threadpool.h"
+#include "../include/elementwise.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -8,349 +14,882 @@
 // Gradient Update Helpers
 // ====================================================
 
-static void grad_update_three_vars(Tensor *W, Tensor *X, Tensor *b, Tensor *Z, float (*func)(float, float), const char *op_name, void (*backward_fn)(Tensor *)) {
-    if (W->requires_grad || X->requires_grad || b->requires_grad) {
-        Z->requires_grad = 1;
-        Z->op_name = op_name ? strdup(op_name) : NULL;
-        Z->num_inputs = 3;
-        Z->inputs = (Tensor **)malloc(3 * sizeof(Tensor *));
-        Z->inputs[0] = W;
-        Z->inputs[1] = X;
-        Z->inputs[2] = b;
-        Z->backward_fn = backward_fn;
-    }
+// Record the op with its output released; ops whose backward pass reads the
+// output call tensor_save_output afterwards
+static void grad_update_three_vars(Tensor *W, Tensor *X, Tensor *b, Tensor *Z, const char *op_name, void (*backward_fn)(Tensor *)) {
+    tensor_record_op(Z, (Tensor *[]){W, X, b}, 3, op_name, backward_fn);
+    tensor_release_output(Z);
 }
 
-static void grad_update_two_vars(Tensor *A, Tensor *B, Tensor *C, float (*func)(float, float), const char *op_name, void (*backward_fn)(Tensor *)) {
-    if (A->requires_grad || B->requires_grad) {
-        C->requires_grad = 1;
-        C->op_name = op_name ? strdup(op_name) : NULL;
-        C->num_inputs = 2;
-        C->inputs = (Tensor **)malloc(2 * sizeof(Tensor *));
-        C->inputs[0] = A;
-        C->inputs[1] = B;
-        C->backward_fn = backward_fn;
-    }
+static void grad_update_two_vars(Tensor *A, Tensor *B, Tensor *C, const char *op_name, void (*backward_fn)(Tensor *)) {
+    tensor_record_op(C, (Tensor *[]){A, B}, 2, op_name, backward_fn);
+    tensor_release_output(C);
 }
 
-static void grad_update_one_var(Tensor *A, Tensor *C, float (*func)(float, float), const char *op_name, void (*backward_fn)(Tensor *)) {
-    if (A->requires_grad) {
-        C->requires_grad = 1;
-        C->op_name = op_name ? strdup(op_name) : NULL;
-        C->num_inputs = 1;
-        C->inputs = (Tensor **)malloc(1 * sizeof(Tensor *));
-        C->inputs[0] = A;
-        C->backward_fn = backward_fn;
-    }
+static void grad_update_one_var(Tensor *A, Tensor *C, const char *op_name, void (*backward_fn)(Tensor *)) {
+    tensor_record_op(C, (Tensor *[]){A}, 1, op_name, backward_fn);
+    tensor_release_output(C);
 }
 
 // ====================================================
-// Elementwise Operations
+// Scratch Buffers
 // ====================================================
 
-static void tensor_ewise(Tensor *A, Tensor *B, Tensor *C, float (*func)(float, float), const char *op_name, void (*backward_fn)(Tensor *)) {
-    if (!A || !B || !C) return; 
-    if (A->ndim != B->ndim || A->ndim != C->ndim) return; 
-    for (size_t i = 0; i < A->ndim; i++) {
-        if (A->shape[i] != B->shape[i] || A->shape[i] != C->shape[i]) return;
+// Temporaries of an op come from the arena of owner, one of its tensors, when
+// it has one, so training steps under an arena do no heap traffic and
+// arena_reset reclaims them with the step. Otherwise they are heap buffers,
+// released by ops_scratch_free
+static void* ops_scratch(Tensor *owner, size_t size) {
+    return owner->arena ? arena_alloc(owner->arena, size) : malloc(size);
+}
+
+static void ops_scratch_free(Tensor *owner, void *ptr) {
+    if (!owner->arena) free(ptr);
+}
+
+// ====================================================
+// Strided Inputs
+// ====================================================
+
+// Kernels work on row-major buffers. Contiguous tensors are used in place;
+// views are gathered into a scratch buffer of T. *scratch is set to it when it
+// is on the heap, for the caller to free
+static const float* ops_dense(Tensor *T, float **scratch) {
+    *scratch = NULL;
+    if (tensor_is_contiguous(T)) return T->data;
+
+    float *dense = (float *)ops_scratch(T, T->size * sizeof(float));
+    if (!dense) return NULL;
+    tensor_gather(T, dense);
+    if (!T->arena) *scratch = dense;
+    return dense;
+}
+
+// Kernel table of the best backend, used by the public ops, fused ops and
+// backward passes
+static const OpKernels *active_kernels = &kernels_scalar;
+
+// Sigmoid and tanh of table k, or its fast-math approximations when enabled
+static MathKernelFn ops_sigmoid_kernel(const OpKernels *k) {
+    return fastmath_enabled() ? k->fast_math->sigmoid : k->sigmoid;
+}
+
+static MathKernelFn ops_tanh_kernel(const OpKernels *k) {
+    return fastmath_enabled() ? k->fast_math->tanh : k->tanh;
+}
+
+// ====================================================
+// Parallel Kernels
+// ====================================================
+
+// Elements per task; below this, handing work to the pool costs more than it saves
+#define OPS_PARALLEL_GRAIN 16384
+
+typedef void (*BinaryKernelFn)(const float *, const float *, float *, size_t);
+typedef void (*UnaryKernelFn)(const float *, float *, size_t);
+typedef float (*ReduceKernelFn)(const float *, const float *, size_t);
+typedef void (*RowKernelFn)(const float *, float *, size_t);
+typedef void (*GradKernelFn)(const float *, const float *, const float *, float *, size_t);
+
+typedef struct {
+    BinaryKernelFn binary;
+    UnaryKernelFn unary;
+    ReduceKernelFn reduce;
+    const float *a;
+    const float *b;
+    float *out;
+    size_t row_size;        // Row-wise tasks: elements per row
+    GradKernelFn grad;
+    const float *dy;
+    size_t grain;           // Column-sum tasks: rows per chunk
+} OpsTask;
+
+static void ops_binary_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    t->binary(t->a + begin, t->b + begin, t->out + begin, end - begin);
+}
+
+static void ops_unary_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    t->unary(t->a + begin, t->out + begin, end - begin);
+}
+
+// out holds one partial per chunk
+static void ops_reduce_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    t->out[begin / OPS_PARALLEL_GRAIN] = t->reduce(t->a + begin, t->b + begin, end - begin);
+}
+
+// Rows [begin, end) of out = a (+ b, the same row for every row, when binary)
+static void ops_rows_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    for (size_t r = begin; r < end; r++) {
+        size_t offset = r * t->row_size;
+        if (t->binary) t->binary(t->a + offset, t->b, t->out + offset, t->row_size);
+        else t->unary(t->a + offset, t->out + offset, t->row_size);
     }
+}
 
-    for (size_t i = 0; i < A->size; i++) {
-        C->data[i] = func(A->data[i], B->data[i]); 
+static void ops_grad_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    t->grad(t->a + begin, t->b + begin, t->dy + begin, t->out + begin, end - begin);
+}
+
+// Clears the chunk first, so the accumulating kernel overwrites it
+static void ops_grad_into_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    memset(t->out + begin, 0, (end - begin) * sizeof(float));
+    t->grad(t->a + begin, t->b + begin, t->dy + begin, t->out + begin, end - begin);
+}
+
+// out holds one row of column partials per chunk: rows [begin, end) of a,
+// summed in row order
+static void ops_column_sums_task(size_t begin, size_t end, void *arg) {
+    OpsTask *t = (OpsTask *)arg;
+    float *partial = t->out + (begin / t->grain) * t->row_size;
+    memset(partial, 0, t->row_size * sizeof(float));
+    for (size_t r = begin; r < end; r++) {
+        const float *row = t->a + r * t->row_size;
+        for (size_t j = 0; j < t->row_size; j++) partial[j] += row[j];
     }
+}
 
-    grad_update_two_vars(A, B, C, func, op_name, backward_fn);
+static void ops_parallel_binary(BinaryKernelFn kernel, const float *a, const float *b, float *out, size_t n) {
+    OpsTask t = {kernel, NULL, NULL, a, b, out, 0, NULL, NULL, 0};
+    parallel_for(0, n, OPS_PARALLEL_GRAIN, ops_binary_task, &t);
 }
 
-static float add_func(float x, float y) { return x + y; }
-static float sub_func(float x, float y) { return x - y; }
-static float mul_func(float x, float y) { return x * y; }
+static void ops_parallel_unary(UnaryKernelFn kernel, const float *a, float *out, size_t n) {
+    OpsTask t = {NULL, kernel, NULL, a, NULL, out, 0, NULL, NULL, 0};
+    parallel_for(0, n, OPS_PARALLEL_GRAIN, ops_unary_task, &t);
+}
 
-Tensor* tensor_add(Tensor *A, Tensor *B) {
-    if (!A || !B) return NULL;
-    
-    Tensor *C = tensor_create(A->shape, A->ndim);
-    if (!C) return NULL;
+// dx += dy * f'(x, y) for activations with output y
+static void ops_parallel_grad(GradKernelFn kernel, const float *x, const float *y, const float *dy, float *dx, size_t n) {
+    OpsTask t = {NULL, NULL, NULL, x, y, dx, 0, kernel, dy, 0};
+    parallel_for(0, n, OPS_PARALLEL_GRAIN, ops_grad_task, &t);
+}
 
-    if (A->ndim == 2 && B->ndim == 1 && A->shape[1] == B->shape[0]) {
-        Tensor *C = tensor_create(A->shape, A->ndim);
-        if (!C) return NULL;
-        
-        for (size_t i = 0; i < A->shape[0]; i++) {
-            for (size_t j = 0; j < A->shape[1]; j++) {
-                C->data[i * A->shape[1] + j] = A->data[i * A->shape[1] + j] + B->data[j];
-            }
+// dx = dy * f'(x, y), with dx uninitialized
+static void ops_parallel_grad_into(GradKernelFn kernel, const float *x, const float *y, const float *dy, float *dx, size_t n) {
+    OpsTask t = {NULL, NULL, NULL, x, y, dx, 0, kernel, dy, 0};
+    parallel_for(0, n, OPS_PARALLEL_GRAIN, ops_grad_into_task, &t);
+}
+
+// out[j] += sum of a[r][j] over the rows of the [rows, cols] matrix a. Tasks
+// take contiguous row ranges; their partials are summed in chunk order, so the
+// result does not depend on the thread count. They are scratch of owner
+static void ops_parallel_column_sums(Tensor *owner, const float *a, size_t rows, size_t cols, float *out) {
+    if (rows == 0 || cols == 0) return;
+    size_t grain = cols < OPS_PARALLEL_GRAIN ? OPS_PARALLEL_GRAIN / cols : 1;
+    size_t chunks = parallel_num_chunks(0, rows, grain);
+
+    float *partials = chunks > 1 ? (float *)ops_scratch(owner, chunks * cols * sizeof(float)) : NULL;
+    if (!partials) {
+        for (size_t r = 0; r < rows; r++) {
+            for (size_t j = 0; j < cols; j++) out[j] += a[r * cols + j];
         }
-        
-        grad_update_two_vars(A, B, C, NULL, "add", backward_add);
-        return C;
+        return;
     }
 
-    tensor_ewise(A, B, C, add_func, "add", backward_add);
-    return C;
+    OpsTask t = {NULL, NULL, NULL, a, NULL, partials, cols, NULL, NULL, grain};
+    parallel_for(0, rows, grain, ops_column_sums_task, &t);
+
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t j = 0; j < cols; j++) out[j] += partials[c * cols + j];
+    }
+    ops_scratch_free(owner, partials);
 }
 
-void backward_add(Tensor *C) {
-    if (!C || !C->inputs || C->num_inputs < 2) return;
-    
-    Tensor *A = C->inputs[0];
-    Tensor *B = C->inputs[1];
-    
-    if (A->requires_grad) {
-        if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-        for (size_t i = 0; i < A->size; i++) {
-            A->grad[i] += C->grad[i];
+// Partials are summed in chunk order, so the result does not depend on the
+// thread count. They are scratch of owner
+static float ops_parallel_reduce(Tensor *owner, ReduceKernelFn kernel, const float *a, const float *b, size_t n) {
+    size_t chunks = parallel_num_chunks(0, n, OPS_PARALLEL_GRAIN);
+    if (chunks <= 1) return n ? kernel(a, b, n) : 0.0f;
+
+    float *partials = (float *)ops_scratch(owner, chunks * sizeof(float));
+    if (!partials) return kernel(a, b, n);
+
+    OpsTask t = {NULL, NULL, kernel, a, b, partials, 0, NULL, NULL, 0};
+    parallel_for(0, n, OPS_PARALLEL_GRAIN, ops_reduce_task, &t);
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < chunks; i++) sum += partials[i];
+    ops_scratch_free(owner, partials);
+    return sum;
+}
+
+static void ops_parallel_rows(BinaryKernelFn binary, UnaryKernelFn unary, const float *a, const float *b, float *out, size_t rows, size_t row_size) {
+    if (row_size == 0) return;
+    size_t grain = row_size < OPS_PARALLEL_GRAIN ? OPS_PARALLEL_GRAIN / row_size : 1;
+    OpsTask t = {binary, unary, NULL, a, b, out, row_size, NULL, NULL, 0};
+    parallel_for(0, rows, grain, ops_rows_task, &t);
+}
+
+// ====================================================
+// Broadcasting
+// ====================================================
+
+#define OPS_MAX_BROADCAST_DIMS 16
+
+// Broadcast scalars are expanded into a buffer this long, so the vector kernels
+// still run over contiguous memory
+#define OPS_BROADCAST_FILL 256
+
+// Element layout of a broadcast binary op. Shapes align from the right; each
+// dimension of A and B must equal the output's or be 1, and broadcast
+// dimensions get stride 0. Size-1 dimensions are dropped and runs contiguous in
+// both operands merged, so same-shape, row-vector, column-vector and scalar
+// operands come out as one or two dimensions
+typedef struct {
+    size_t ndim;
+    size_t shape[OPS_MAX_BROADCAST_DIMS];
+    size_t a_strides[OPS_MAX_BROADCAST_DIMS];
+    size_t b_strides[OPS_MAX_BROADCAST_DIMS];
+} BroadcastPlan;
+
+// Fills out_shape (if given, with max(a_ndim, b_ndim) dims); 0 if the shapes do not broadcast
+static int broadcast_plan(const size_t *a_shape, size_t a_ndim, const size_t *b_shape, size_t b_ndim,
+                          BroadcastPlan *plan, size_t *out_shape) {
+    size_t ndim = (a_ndim > b_ndim) ? a_ndim : b_ndim;
+    if (ndim > OPS_MAX_BROADCAST_DIMS) return 0;
+
+    size_t shape[OPS_MAX_BROADCAST_DIMS], as[OPS_MAX_BROADCAST_DIMS], bs[OPS_MAX_BROADCAST_DIMS];
+    size_t a_stride = 1, b_stride = 1;
+    for (size_t i = ndim; i > 0; i--) {
+        size_t d = i - 1;
+        size_t ad = (d >= ndim - a_ndim) ? a_shape[d - (ndim - a_ndim)] : 1;
+        size_t bd = (d >= ndim - b_ndim) ? b_shape[d - (ndim - b_ndim)] : 1;
+        if (ad != bd && ad != 1 && bd != 1) return 0;
+
+        shape[d] = (ad == 1) ? bd : ad;
+        as[d] = (ad == 1) ? 0 : a_stride;
+        bs[d] = (bd == 1) ? 0 : b_stride;
+        a_stride *= ad;
+        b_stride *= bd;
+    }
+    if (out_shape) memcpy(out_shape, shape, ndim * sizeof(size_t));
+
+    size_t n = 0;
+    for (size_t d = 0; d < ndim; d++) {
+        if (shape[d] == 1) continue;
+        if (n > 0 && plan->a_strides[n - 1] == as[d] * shape[d] && plan->b_strides[n - 1] == bs[d] * shape[d]) {
+            plan->shape[n - 1] *= shape[d];
+            plan->a_strides[n - 1] = as[d];
+            plan->b_strides[n - 1] = bs[d];
+        } else {
+            plan->shape[n] = shape[d];
+            plan->a_strides[n] = as[d];
+            plan->b_strides[n] = bs[d];
+            n++;
         }
     }
-    
-    if (B->requires_grad) {
-        if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
+    if (n == 0) {
+        plan->shape[0] = 1;
+        plan->a_strides[0] = 0;
+        plan->b_strides[0] = 0;
+        n = 1;
+    }
+    plan->ndim = n;
 
-        if (A->ndim == 2 && B->ndim == 1 && A->shape[1] == B->shape[0]) {
-            // also a temporary fix, should add broadcasting support properly
-            for (size_t i = 0; i < A->shape[0]; i++) {
-                for (size_t j = 0; j < B->shape[0]; j++) {
-                    B->grad[j] += C->grad[i * A->shape[1] + j];
-                }
-            }
+    return 1;
+}
+
+// Offsets into A and B of the first element of output row `row` (all dims but the last)
+static void broadcast_row_offsets(const BroadcastPlan *plan, size_t row, size_t *a_offset, size_t *b_offset) {
+    size_t oa = 0, ob = 0;
+    for (size_t d = plan->ndim - 1; d > 0; d--) {
+        size_t idx = row % plan->shape[d - 1];
+        row /= plan->shape[d - 1];
+        oa += idx * plan->a_strides[d - 1];
+        ob += idx * plan->b_strides[d - 1];
+    }
+    *a_offset = oa;
+    *b_offset = ob;
+}
+
+// c = a op b over n elements, where a or b may be a single value repeated (step 0)
+static void broadcast_segment(BinaryKernelFn kernel, const float *a, size_t a_step,
+                              const float *b, size_t b_step, float *c, size_t n) {
+    if (a_step && b_step) {
+        kernel(a, b, c, n);
+        return;
+    }
+
+    float a_fill[OPS_BROADCAST_FILL], b_fill[OPS_BROADCAST_FILL];
+    size_t fill = (n < OPS_BROADCAST_FILL) ? n : OPS_BROADCAST_FILL;
+    for (size_t i = 0; !a_step && i < fill; i++) a_fill[i] = a[0];
+    for (size_t i = 0; !b_step && i < fill; i++) b_fill[i] = b[0];
+
+    for (size_t i = 0; i < n; i += fill) {
+        size_t m = (n - i < fill) ? n - i : fill;
+        kernel(a_step ? a + i : a_fill, b_step ? b + i : b_fill, c + i, m);
+    }
+}
+
+typedef struct {
+    const BroadcastPlan *plan;
+    BinaryKernelFn kernel;
+    const float *a;
+    const float *b;
+    float *out;
+    size_t segment;         // Work unit: up to this many elements of one row
+    size_t segments;        // Units per row
+} BroadcastTask;
+
+static void broadcast_task(size_t begin, size_t end, void *arg) {
+    BroadcastTask *t = (BroadcastTask *)arg;
+    const BroadcastPlan *plan = t->plan;
+    size_t inner = plan->shape[plan->ndim - 1];
+    size_t a_step = plan->a_strides[plan->ndim - 1];
+    size_t b_step = plan->b_strides[plan->ndim - 1];
+
+    for (size_t u = begin; u < end; u++) {
+        size_t row = u / t->segments;
+        size_t j0 = (u % t->segments) * t->segment;
+        size_t n = (inner - j0 < t->segment) ? inner - j0 : t->segment;
+
+        size_t oa, ob;
+        broadcast_row_offsets(plan, row, &oa, &ob);
+        broadcast_segment(t->kernel, t->a + oa + j0 * a_step, a_step, t->b + ob + j0 * b_step, b_step,
+                          t->out + row * inner + j0, n);
+    }
+}
+
+// out (dense, in the plan's output shape) = a op b, split across the thread pool
+static void broadcast_exec(const BroadcastPlan *plan, BinaryKernelFn kernel, const float *a, const float *b, float *out) {
+    size_t inner = plan->shape[plan->ndim - 1];
+    size_t total = 1;
+    for (size_t d = 0; d < plan->ndim; d++) total *= plan->shape[d];
+    if (total == 0) return;
+
+    size_t segment = (inner < OPS_PARALLEL_GRAIN) ? inner : OPS_PARALLEL_GRAIN;
+    size_t segments = (inner + segment - 1) / segment;
+    size_t grain = (segment < OPS_PARALLEL_GRAIN) ? OPS_PARALLEL_GRAIN / segment : 1;
+
+    BroadcastTask task = {plan, kernel, a, b, out, segment, segments};
+    parallel_for(0, (total / inner) * segments, grain, broadcast_task, &task);
+}
+
+// grad (X's shape) += sign * term (the output's shape) summed over the dims X
+// was broadcast along; the plan maps the output (A side) to X (B side)
+static void broadcast_accumulate(const BroadcastPlan *plan, const float *term, float *grad, float sign) {
+    size_t inner = plan->shape[plan->ndim - 1];
+    size_t step = plan->b_strides[plan->ndim - 1];
+    size_t total = 1;
+    for (size_t d = 0; d < plan->ndim; d++) total *= plan->shape[d];
+
+    for (size_t row = 0; inner && row < total / inner; row++) {
+        size_t oa, ob;
+        broadcast_row_offsets(plan, row, &oa, &ob);
+        const float *src = term + row * inner;
+        float *dst = grad + ob;
+
+        if (step) {
+            for (size_t j = 0; j < inner; j++) dst[j] += sign * src[j];
         } else {
-            for (size_t i = 0; i < B->size; i++) {
-                B->grad[i] += C->grad[i];
-            }
+            float sum = 0.0f;
+            for (size_t j = 0; j < inner; j++) sum += src[j];
+            dst[0] += sign * sum;
         }
     }
 }
 
-Tensor* tensor_sub(Tensor *A, Tensor *B) {
+// X->grad += sign * term reduced to X's shape, for an input X of output C
+static void broadcast_grad(Tensor *C, Tensor *X, const float *term, float sign) {
+    if (!X->requires_grad || !term) return;
+
+    BroadcastPlan plan;
+    if (!broadcast_plan(C->shape, C->ndim, X->shape, X->ndim, &plan, NULL)) return;
+
+    tensor_ensure_grad(X);
+    broadcast_accumulate(&plan, term, X->grad, sign);
+}
+
+// term = a op b with a in C's shape and b broadcast from X's shape to it, as
+// scratch of C
+static float* broadcast_term(Tensor *C, const float *a, Tensor *X, BinaryKernelFn kernel) {
+    BroadcastPlan plan;
+    if (!broadcast_plan(C->shape, C->ndim, X->shape, X->ndim, &plan, NULL)) return NULL;
+
+    float *x_scratch;
+    const float *x = ops_dense(X, &x_scratch);
+    float *term = (float *)ops_scratch(C, C->size * sizeof(float));
+    if (x && term) broadcast_exec(&plan, kernel, a, x, term);
+    free(x_scratch);
+
+    if (!x) {
+        ops_scratch_free(C, term);
+        return NULL;
+    }
+    return term;
+}
+
+// ====================================================
+// Elementwise Operations
+// ====================================================
+
+// C = A op B with broadcasting; NULL if the shapes do not broadcast
+static Tensor* tensor_ewise(Tensor *A, Tensor *B, BinaryKernelFn kernel, const char *op_name, void (*backward_fn)(Tensor *)) {
     if (!A || !B) return NULL;
-    
-    Tensor *C = tensor_create(A->shape, A->ndim);
+
+    BroadcastPlan plan;
+    size_t C_shape[OPS_MAX_BROADCAST_DIMS];
+    if (!broadcast_plan(A->shape, A->ndim, B->shape, B->ndim, &plan, C_shape)) return NULL;
+
+    size_t ndim = (A->ndim > B->ndim) ? A->ndim : B->ndim;
+    Tensor *C = tensor_create(C_shape, ndim);
     if (!C) return NULL;
 
-    tensor_ewise(A, B, C, sub_func, "sub", backward_sub);
+    float *a_scratch, *b_scratch;
+    const float *a = ops_dense(A, &a_scratch);
+    const float *b = ops_dense(B, &b_scratch);
+    if (a && b) broadcast_exec(&plan, kernel, a, b, C->data);
+    free(a_scratch);
+    free(b_scratch);
+
+    grad_update_two_vars(A, B, C, op_name, backward_fn);
+
     return C;
 }
 
+Tensor* ops_add_with(const OpKernels *k, Tensor *A, Tensor *B) {
+    return tensor_ewise(A, B, k->add, "add", backward_add);
+}
+
+void backward_add(Tensor *C) {
+    if (!C || !C->inputs || C->num_inputs < 2) return;
+
+    broadcast_grad(C, C->inputs[0], C->grad, 1.0f);
+    broadcast_grad(C, C->inputs[1], C->grad, 1.0f);
+}
+
+Tensor* ops_sub_with(const OpKernels *k, Tensor *A, Tensor *B) {
+    return tensor_ewise(A, B, k->sub, "sub", backward_sub);
+}
 
 void backward_sub(Tensor *C) {
     if (!C || !C->inputs || C->num_inputs < 2) return;
-    
+
+    broadcast_grad(C, C->inputs[0], C->grad, 1.0f);
+    broadcast_grad(C, C->inputs[1], C->grad, -1.0f);
+}
+
+Tensor* ops_mul_with(const OpKernels *k, Tensor *A, Tensor *B) {
+    return tensor_ewise(A, B, k->mul, "mul", backward_mul);
+}
+
+void backward_mul(Tensor *C) {
+    if (!C || !C->inputs || C->num_inputs < 2) return;
+
     Tensor *A = C->inputs[0];
     Tensor *B = C->inputs[1];
-    
+
+    // dA = dC * B, dB = dC * A, each reduced to its input's shape
     if (A->requires_grad) {
-        if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-        for (size_t i = 0; i < A->size; i++) {
-            A->grad[i] += C->grad[i];
-        }
+        float *term = broadcast_term(C, C->grad, B, active_kernels->mul);
+        broadcast_grad(C, A, term, 1.0f);
+        ops_scratch_free(C, term);
     }
-    
+
     if (B->requires_grad) {
-        if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
-        for (size_t i = 0; i < B->size; i++) {
-            B->grad[i] -= C->grad[i];
-        }
+        float *term = broadcast_term(C, C->grad, A, active_kernels->mul);
+        broadcast_grad(C, B, term, 1.0f);
+        ops_scratch_free(C, term);
     }
 }
 
-Tensor* tensor_mul(Tensor *A, Tensor *B) {
-    if (!A || !B) return NULL;
-    
-    Tensor *C = tensor_create(A->shape, A->ndim);
-    if (!C) return NULL;
-
-    tensor_ewise(A, B, C, mul_func, "mul", backward_mul);
+Tensor* ops_div_with(const OpKernels *k, Tensor *A, Tensor *B) {
+    Tensor *C = tensor_ewise(A, B, k->div, "div", backward_div);
+    tensor_save_output(C);
     return C;
 }
 
-void backward_mul(Tensor *C) {
+void backward_div(Tensor *C) {
     if (!C || !C->inputs || C->num_inputs < 2) return;
-    
+
     Tensor *A = C->inputs[0];
     Tensor *B = C->inputs[1];
-    
+
+    // dA = dC / B
     if (A->requires_grad) {
-        if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-        for (size_t i = 0; i < A->size; i++) {
-            A->grad[i] += C->grad[i] * B->data[i];
-        }
+        float *term = broadcast_term(C, C->grad, B, active_kernels->div);
+        broadcast_grad(C, A, term, 1.0f);
+        ops_scratch_free(C, term);
     }
-    
+
+    // dB = -dC * A / B^2 = -(dC * C) / B
     if (B->requires_grad) {
-        if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
-        for (size_t i = 0; i < B->size; i++) {
-            B->grad[i] += C->grad[i] * A->data[i];
+        float *dc_c = (float *)ops_scratch(C, C->size * sizeof(float));
+        if (dc_c) {
+            ops_parallel_binary(active_kernels->mul, C->grad, C->data, dc_c, C->size);
+            float *term = broadcast_term(C, dc_c, B, active_kernels->div);
+            broadcast_grad(C, B, term, -1.0f);
+            ops_scratch_free(C, term);
+            ops_scratch_free(C, dc_c);
         }
     }
 }
 
 // ====================================================
-// Linear Algebra
+// Views
 // ====================================================
 
-Tensor* tensor_matmul(Tensor *A, Tensor *B) {
-    if (!A || !B) return NULL;
-    
-    if (A->ndim == 1 && B->ndim == 1) {
-        if (A->shape[0] != B->shape[0]) return NULL;
-        
-        Tensor *C = tensor_create((size_t[]){1}, 1);
-        if (!C) return NULL;
-        
-        float acc = 0.0f;
-        for (size_t i = 0; i < A->shape[0]; i++) {
-            acc += A->data[i] * B->data[i];
-        }
-        C->data[0] = acc;
-        
-        grad_update_two_vars(A, B, C, NULL, "matmul", backward_matmul);
-        return C;
-    } else if (A->ndim == 2 && B->ndim == 1) {
-        if (A->shape[1] != B->shape[0]) return NULL;
-        
-        Tensor *C = tensor_create((size_t[]){A->shape[0]}, 1);
-        if (!C) return NULL;
-        
-        for (size_t i = 0; i < A->shape[0]; i++) {
-            float acc = 0.0f;
-            for (size_t k = 0; k < A->shape[1]; k++) {
-                acc += A->data[i * A->shape[1] + k] * B->data[k];
-            }
-            C->data[i] = acc;
-        }
-        
-        grad_update_two_vars(A, B, C, NULL, "matmul", backward_matmul);
-        return C;
-    } else if (A->ndim == 1 && B->ndim == 2) {
-        if (A->shape[0] != B->shape[0]) return NULL;
-        
-        Tensor *C = tensor_create((size_t[]){B->shape[1]}, 1);
-        if (!C) return NULL;
-        
-        for (size_t j = 0; j < B->shape[1]; j++) {
-            float acc = 0.0f;
-            for (size_t k = 0; k < A->shape[0]; k++) {
-                acc += A->data[k] * B->data[k * B->shape[1] + j];
-            }
-            C->data[j] = acc;
+// Maps a view onto its source: view element (i_0, ..., i_n) is element
+// start + sum(i_d * steps[d]) of the source in row-major order
+typedef struct ViewInfo {
+    size_t start;
+    size_t steps[];
+} ViewInfo;
+
+// Data strides for a view described in the source's row-major order. Always
+// possible for contiguous sources; otherwise each step must move along exactly
+// one source dimension without running past its end.
+static int view_strides(Tensor *A, size_t *shape, size_t *steps, size_t ndim, size_t start, size_t *strides, size_t *offset) {
+    if (tensor_is_contiguous(A)) {
+        for (size_t d = 0; d < ndim; d++) strides[d] = steps[d];
+        *offset = start;
+        return 1;
+    }
+
+    size_t coord[A->ndim];
+    size_t dense = A->size;
+    size_t rem = start;
+    *offset = 0;
+    for (size_t a = 0; a < A->ndim; a++) {
+        dense /= A->shape[a];
+        coord[a] = rem / dense;
+        rem %= dense;
+        *offset += coord[a] * A->strides[a];
+    }
+
+    for (size_t d = 0; d < ndim; d++) {
+        strides[d] = 0;
+        if (shape[d] == 1) continue;
+
+        int found = 0;
+        dense = A->size;
+        for (size_t a = 0; a < A->ndim && !found; a++) {
+            dense /= A->shape[a];
+            if (A->shape[a] == 1 || steps[d] != dense) continue;
+            coord[a] += shape[d] - 1;
+            if (coord[a] >= A->shape[a]) return 0;
+            strides[d] = A->strides[a];
+            found = 1;
         }
-        
-        grad_update_two_vars(A, B, C, NULL, "matmul", backward_matmul);
-        return C;
-    } else if (A->ndim == 2 && B->ndim == 2) {
-        if (A->shape[1] != B->shape[0]) return NULL;
-
-        size_t C_shape[2] = {A->shape[0], B->shape[1]}; 
-        Tensor *C = tensor_create(C_shape, 2);
-        if (!C) return NULL; 
-
-        for (size_t i = 0; i < A->shape[0]; i++) {
-            for (size_t j = 0; j < B->shape[1]; j++) {
-                float acc = 0.0f;
-                for (size_t k = 0; k < A->shape[1]; k++) {
-                    acc += A->data[i * A->shape[1] + k] * B->data[k * B->shape[1] + j];
-                }
-                C->data[i * C->shape[1] + j] = acc; 
-            }
+        if (!found) return 0;
+    }
+    return 1;
+}
+
+static Tensor* view_create(Tensor *A, size_t *shape, size_t *steps, size_t ndim, size_t start, const char *op_name, void (*backward_fn)(Tensor *)) {
+    size_t strides[ndim];
+    size_t offset;
+    if (!view_strides(A, shape, steps, ndim, start, strides, &offset)) return NULL;
+
+    Tensor *V = tensor_wrap(shape, ndim, A->data + offset);
+    if (!V) return NULL;
+    memcpy(V->strides, strides, ndim * sizeof(size_t));
+
+    tensor_record_op(V, &A, 1, op_name, backward_fn);
+    tensor_release_output(V);
+    if (V->requires_grad) {
+        size_t info_size = sizeof(ViewInfo) + ndim * sizeof(size_t);
+        ViewInfo *info = (ViewInfo *)(V->arena ? arena_alloc(V->arena, info_size) : malloc(info_size));
+        if (info) {
+            info->start = start;
+            memcpy(info->steps, steps, ndim * sizeof(size_t));
         }
+        V->extra_data = info;
+    }
 
-        grad_update_two_vars(A, B, C, NULL, "matmul", backward_matmul);
+    return V;
+}
 
-        return C; 
-    } else {
-        return NULL; 
+Tensor* tensor_view(Tensor *A, size_t *shape, size_t ndim, size_t *steps, size_t start) {
+    if (!A || !shape || !steps) return NULL;
+
+    // Bounds: the last element of the view must exist in A
+    size_t last = start;
+    for (size_t d = 0; d < ndim; d++) {
+        if (shape[d] == 0) return NULL;
+        last += (shape[d] - 1) * steps[d];
     }
+    if (last >= A->size) return NULL;
+
+    return view_create(A, shape, steps, ndim, start, "view", backward_view);
 }
 
-void backward_matmul(Tensor *output) {
-    if (!output || output->num_inputs != 2) return;
-    
-    Tensor *A = output->inputs[0];
-    Tensor *B = output->inputs[1];
-    
-    if (A->ndim == 1 && B->ndim == 1) {
-        if (A->requires_grad) {
-            if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-            for (size_t i = 0; i < A->size; i++) {
-                A->grad[i] += output->grad[0] * B->data[i];
-            }
-        }
-        if (B->requires_grad) {
-            if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
-            for (size_t i = 0; i < B->size; i++) {
-                B->grad[i] += output->grad[0] * A->data[i];
-            }
+void backward_view(Tensor *V) {
+    if (!V || !V->inputs || !V->extra_data) return;
+
+    Tensor *A = V->inputs[0];
+    ViewInfo *info = (ViewInfo *)V->extra_data;
+    if (!A->requires_grad || V->size == 0) return;
+    tensor_ensure_grad(A);
+
+    size_t ndim = V->ndim;
+    size_t index[ndim];
+    memset(index, 0, sizeof(index));
+
+    size_t pos = info->start;
+    for (size_t n = 0; n < V->size; n++) {
+        A->grad[pos] += V->grad[n];
+
+        for (size_t d = ndim; d > 0; d--) {
+            pos += info->steps[d - 1];
+            if (++index[d - 1] < V->shape[d - 1]) break;
+            pos -= index[d - 1] * info->steps[d - 1];
+            index[d - 1] = 0;
         }
     }
-    
-    else if (A->ndim == 2 && B->ndim == 1) {
-        if (A->requires_grad) {
-            if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-            for (size_t i = 0; i < A->shape[0]; i++) {
-                for (size_t j = 0; j < A->shape[1]; j++) {
-                    A->grad[i * A->shape[1] + j] += output->grad[i] * B->data[j];
-                }
-            }
-        }
-        if (B->requires_grad) {
-            if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
-            for (size_t j = 0; j < B->shape[0]; j++) {
-                float acc = 0.0f;
-                for (size_t i = 0; i < A->shape[0]; i++) {
-                    acc += A->data[i * A->shape[1] + j] * output->grad[i];
-                }
-                B->grad[j] += acc;
-            }
+}
+
+Tensor* tensor_contiguous(Tensor *A) {
+    if (!A) return NULL;
+    if (tensor_is_contiguous(A)) return A;
+
+    Tensor *C = tensor_create(A->shape, A->ndim);
+    if (!C) return NULL;
+
+    tensor_gather(A, C->data);
+    grad_update_one_var(A, C, "contiguous", backward_contiguous);
+
+    return C;
+}
+
+void backward_contiguous(Tensor *C) {
+    Tensor *A = C->inputs[0];
+
+    if (A->requires_grad) {
+        tensor_ensure_grad(A);
+        for (size_t i = 0; i < A->size; i++) {
+            A->grad[i] += C->grad[i];
         }
     }
-    
-    else if (A->ndim == 1 && B->ndim == 2) {
-        if (A->requires_grad) {
-            if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-            for (size_t i = 0; i < A->shape[0]; i++) {
-                float acc = 0.0f;
-                for (size_t j = 0; j < B->shape[1]; j++) {
-                    acc += output->grad[j] * B->data[i * B->shape[1] + j];
-                }
-                A->grad[i] += acc;
-            }
-        }
-        if (B->requires_grad) {
-            if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
-            for (size_t i = 0; i < B->shape[0]; i++) {
-                for (size_t j = 0; j < B->shape[1]; j++) {
-                    B->grad[i * B->shape[1] + j] += A->data[i] * output->grad[j];
-                }
-            }
+}
+
+// ====================================================
+// Linear Algebra
+// ====================================================
+
+// Matmul: C = alpha * op(A)·op(B), with op swapping the last two dims when the
+// operand is marked transposed. Matrices sit in the last two dims and leading
+// dims broadcast like the elementwise ops; a 1D left operand is a row vector
+// and a 1D right operand a column vector, whose dim C drops. Products read
+// operands through their strides and are written to C back to back
+typedef struct {
+    int trans_a, trans_b;
+    float alpha;
+} MatmulInfo;
+
+static const MatmulInfo matmul_plain = {0, 0, 1.0f};
+
+typedef struct {
+    size_t batch;
+    size_t M, N, K;
+    size_t rsa, csa, rsb, csb;              // Row and column strides of op(A) and op(B)
+    size_t lead;                            // Leading (batch) dims of C
+    size_t ndim;                            // C's dims
+    size_t shape[OPS_MAX_BROADCAST_DIMS];   // C's shape
+} MatmulBatch;
+
+static size_t matmul_lead_dims(Tensor *T) {
+    return (T->ndim > 2) ? T->ndim - 2 : 0;
+}
+
+// Rows and columns of op(T) and their strides
+static void matmul_operand(Tensor *T, int trans, int right, size_t *rows, size_t *cols, size_t *rs, size_t *cs) {
+    if (T->ndim == 1) {
+        *rows = right ? T->shape[0] : 1;
+        *cols = right ? 1 : T->shape[0];
+        *rs = right ? T->strides[0] : 0;
+        *cs = right ? 0 : T->strides[0];
+        return;
+    }
+
+    size_t d = T->ndim - 2;
+    *rows = T->shape[trans ? d + 1 : d];
+    *cols = T->shape[trans ? d : d + 1];
+    *rs = T->strides[trans ? d + 1 : d];
+    *cs = T->strides[trans ? d : d + 1];
+}
+
+static int matmul_batch_plan(Tensor *A, Tensor *B, const MatmulInfo *info, MatmulBatch *mb) {
+    if (A->ndim == 0 || B->ndim == 0) return 0;
+
+    BroadcastPlan plan;
+    size_t a_lead = matmul_lead_dims(A), b_lead = matmul_lead_dims(B);
+    if (!broadcast_plan(A->shape, a_lead, B->shape, b_lead, &plan, mb->shape)) return 0;
+
+    size_t kb;
+    matmul_operand(A, info->trans_a, 0, &mb->M, &mb->K, &mb->rsa, &mb->csa);
+    matmul_operand(B, info->trans_b, 1, &kb, &mb->N, &mb->rsb, &mb->csb);
+    if (kb != mb->K) return 0;
+
+    mb->lead = (a_lead > b_lead) ? a_lead : b_lead;
+    if (mb->lead + 2 > OPS_MAX_BROADCAST_DIMS) return 0;
+    mb->ndim = mb->lead;
+    if (A->ndim > 1) mb->shape[mb->ndim++] = mb->M;
+    if (B->ndim > 1) mb->shape[mb->ndim++] = mb->N;
+    if (mb->ndim == 0) mb->shape[mb->ndim++] = 1;
+
+    mb->batch = 1;
+    for (size_t d = 0; d < mb->lead; d++) mb->batch *= mb->shape[d];
+    return 1;
+}
+
+// Offset of T's matrix for each of C's products, through T's strides or, with
+// dense set, into T's dense row-major layout (its grad)
+static void matmul_batch_offsets(Tensor *T, const MatmulBatch *mb, int dense, size_t *offsets) {
+    size_t t_lead = matmul_lead_dims(T);
+    size_t skip = mb->lead - t_lead;
+    size_t steps[OPS_MAX_BROADCAST_DIMS];
+
+    size_t stride = (t_lead > 0) ? T->shape[t_lead] * T->shape[t_lead + 1] : 0;
+    for (size_t d = t_lead; d > 0; d--) {
+        size_t step = dense ? stride : T->strides[d - 1];
+        steps[d - 1] = (T->shape[d - 1] == 1) ? 0 : step;
+        stride *= T->shape[d - 1];
+    }
+
+    for (size_t i = 0; i < mb->batch; i++) {
+        size_t rem = i, offset = 0;
+        for (size_t d = mb->lead; d > skip; d--) {
+            offset += (rem % mb->shape[d - 1]) * steps[d - 1 - skip];
+            rem /= mb->shape[d - 1];
         }
+        offsets[i] = offset;
     }
-    
-    else if (A->ndim == 2 && B->ndim == 2) {
-        if (A->requires_grad) {
-            if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-            for (size_t i = 0; i < A->shape[0]; i++) {
-                for (size_t j = 0; j < A->shape[1]; j++) {
-                    float acc = 0.0f;
-                    for (size_t k = 0; k < B->shape[1]; k++) {
-                        acc += output->grad[i * output->shape[1] + k] * B->data[j * B->shape[1] + k];
-                    }
-                    A->grad[i * A->shape[1] + j] += acc;
-                }
-            }
+}
+
+static Tensor* matmul_forward(const OpKernels *k, Tensor *A, Tensor *B, const MatmulInfo *info) {
+    if (!A || !B) return NULL;
+
+    MatmulBatch mb;
+    if (!matmul_batch_plan(A, B, info, &mb)) return NULL;
+
+    Tensor *C = tensor_create(mb.shape, mb.ndim);
+    if (!C) return NULL;
+
+    size_t *offsets = (size_t *)ops_scratch(C, 2 * mb.batch * sizeof(size_t));
+    if (!offsets) {
+        tensor_free(C);
+        return NULL;
+    }
+    matmul_batch_offsets(A, &mb, 0, offsets);
+    matmul_batch_offsets(B, &mb, 0, offsets + mb.batch);
+
+    if (mb.batch == 1 && mb.M <= GEMM_SMALL_M && info->alpha == 1.0f && (mb.csb == 1 || mb.N == 1)) {
+        sgemm_small_m(k->small_m, mb.M, mb.N, mb.K,
+                      A->data + offsets[0], mb.rsa, mb.csa,
+                      B->data + offsets[1], mb.rsb, NULL,
+                      C->data, mb.N, NULL);
+    } else {
+        sgemm_batched(k->gemm, mb.batch, mb.M, mb.N, mb.K, info->alpha,
+                      A->data, offsets, mb.rsa, mb.csa,
+                      B->data, offsets + mb.batch, mb.rsb, mb.csb, 0.0f,
+                      C->data, mb.N, mb.M * mb.N);
+    }
+    ops_scratch_free(C, offsets);
+
+    grad_update_two_vars(A, B, C, "matmul", backward_matmul);
+
+    // Backward needs the transposes and alpha, unless they are the defaults
+    if (C->requires_grad && info != &matmul_plain) {
+        MatmulInfo *saved = (MatmulInfo *)(C->arena ? arena_alloc(C->arena, sizeof(MatmulInfo)) : malloc(sizeof(MatmulInfo)));
+        if (saved) *saved = *info;
+        C->extra_data = saved;
+    }
+
+    return C;
+}
+
+Tensor* ops_matmul_with(const OpKernels *k, Tensor *A, Tensor *B) {
+    return matmul_forward(k, A, B, &matmul_plain);
+}
+
+Tensor* tensor_matmul_ex(Tensor *A, Tensor *B, int trans_a, int trans_b, float alpha) {
+    MatmulInfo info = {trans_a != 0, trans_b != 0, alpha};
+    return matmul_forward(active_kernels, A, B, &info);
+}
+
+// G_i (+)= alpha * X_i·Y_i for each product, G_i at grad + g_offsets[i]. Each
+// product owns its block of the grad unless the operand was broadcast; then the
+// products are computed apart, in scratch of C, and summed in order
+static void matmul_grad(Tensor *C, size_t batch, size_t M, size_t N, size_t K, float alpha,
+                        const float *X, const size_t *x_offsets, size_t rsx, size_t csx,
+                        const float *Y, const size_t *y_offsets, size_t rsy, size_t csy,
+                        float *grad, const size_t *g_offsets) {
+    size_t size = M * N;
+    int owned = 1;
+    for (size_t i = 0; i < batch && owned; i++) owned = g_offsets[i] == i * size;
+
+    if (owned) {
+        sgemm_batched(NULL, batch, M, N, K, alpha, X, x_offsets, rsx, csx, Y, y_offsets, rsy, csy, 1.0f, grad, N, size);
+        return;
+    }
+
+    float *tmp = (float *)ops_scratch(C, batch * size * sizeof(float));
+    if (!tmp) return;
+    sgemm_batched(NULL, batch, M, N, K, alpha, X, x_offsets, rsx, csx, Y, y_offsets, rsy, csy, 0.0f, tmp, N, size);
+    for (size_t i = 0; i < batch; i++) {
+        float *dst = grad + g_offsets[i];
+        const float *src = tmp + i * size;
+        for (size_t j = 0; j < size; j++) dst[j] += src[j];
+    }
+    ops_scratch_free(C, tmp);
+}
+
+// With C = alpha * op(A)·op(B): d op(A) = alpha * dC·op(B)ᵀ and d op(B) =
+// alpha * op(A)ᵀ·dC. A transposed operand's grad is the transpose of that,
+// computed directly as alpha * op(B)·dCᵀ (or alpha * dCᵀ·op(A)). Transposes are
+// read through the strides, and gradients accumulate straight into grad
+void backward_matmul(Tensor *C) {
+    if (!C || C->num_inputs != 2) return;
+
+    Tensor *A = C->inputs[0];
+    Tensor *B = C->inputs[1];
+    const MatmulInfo *info = C->extra_data ? (const MatmulInfo *)C->extra_data : &matmul_plain;
+
+    MatmulBatch mb;
+    if (!matmul_batch_plan(A, B, info, &mb)) return;
+
+    size_t M = mb.M, N = mb.N, K = mb.K, batch = mb.batch;
+    size_t *offsets = (size_t *)ops_scratch(C, 5 * batch * sizeof(size_t));
+    if (!offsets) return;
+
+    size_t *a_data = offsets, *b_data = offsets + batch, *c_dense = offsets + 2 * batch;
+    size_t *a_grad = offsets + 3 * batch, *b_grad = offsets + 4 * batch;
+    matmul_batch_offsets(A, &mb, 0, a_data);
+    matmul_batch_offsets(B, &mb, 0, b_data);
+    matmul_batch_offsets(A, &mb, 1, a_grad);
+    matmul_batch_offsets(B, &mb, 1, b_grad);
+    for (size_t i = 0; i < batch; i++) c_dense[i] = i * M * N;
+
+    if (A->requires_grad) {
+        tensor_ensure_grad(A);
+        if (info->trans_a && A->ndim > 1) {
+            matmul_grad(C, batch, K, M, N, info->alpha, B->data, b_data, mb.rsb, mb.csb,
+                        C->grad, c_dense, 1, N, A->grad, a_grad);
+        } else {
+            matmul_grad(C, batch, M, K, N, info->alpha, C->grad, c_dense, N, 1,
+                        B->data, b_data, mb.csb, mb.rsb, A->grad, a_grad);
         }
-        if (B->requires_grad) {
-            if (!B->grad) B->grad = (float *)calloc(B->size, sizeof(float));
-            for (size_t i = 0; i < B->shape[0]; i++) {
-                for (size_t j = 0; j < B->shape[1]; j++) {
-                    float acc = 0.0f;
-                    for (size_t k = 0; k < A->shape[0]; k++) {
-                        acc += A->data[k * A->shape[1] + i] * output->grad[k * output->shape[1] + j];
-                    }
-                    B->grad[i * B->shape[1] + j] += acc;
-                }
-            }
+    }
+
+    if (B->requires_grad) {
+        tensor_ensure_grad(B);
+        if (info->trans_b && B->ndim > 1) {
+            matmul_grad(C, batch, N, K, M, info->alpha, C->grad, c_dense, 1, N,
+                        A->data, a_data, mb.rsa, mb.csa, B->grad, b_grad);
+        } else {
+            matmul_grad(C, batch, K, N, M, info->alpha, A->data, a_data, mb.csa, mb.rsa,
+                        C->grad, c_dense, N, 1, B->grad, b_grad);
         }
     }
+
+    ops_scratch_free(C, offsets);
 }
 
 Tensor* tensor_transpose2d(Tensor *A) {
@@ -358,63 +897,167 @@ Tensor* tensor_transpose2d(Tensor *A) {
     if (A->ndim != 2) return NULL; 
 
     size_t C_shape[2] = {A->shape[1], A->shape[0]}; 
-    Tensor *C = tensor_create(C_shape, 2);
-    if (!C) return NULL;
+    size_t C_steps[2] = {1, A->shape[1]};
+    return view_create(A, C_shape, C_steps, 2, 0, "transpose2d", backward_transpose2d);
+}
 
-    for (size_t i = 0; i < A->shape[0]; i++) {
-        for (size_t j = 0; j < A->shape[1]; j++) {
-            C->data[j * C->shape[1] + i] = A->data[i * A->shape[1] + j]; 
-        }
+void backward_transpose2d(Tensor *C) {
+    backward_view(C);
+}
+
+// Derivatives in terms of the output y; backward passes hand y in as x too
+ELEMENTWISE_GRAD(relu_grad, y > 0.0f ? 1.0f : 0.0f)
+ELEMENTWISE_GRAD(sigmoid_grad, y * (1.0f - y))
+ELEMENTWISE_GRAD(tanh_grad, 1.0f - y * y)
+
+static const char *linear_op_names[] = {"linear", "linear_relu", "linear_sigmoid", "linear_tanh"};
+static void (*linear_backward_fns[])(Tensor *) = {
+    backward_linear, backward_linear_relu, backward_linear_sigmoid, backward_linear_tanh
+};
+static GradKernelFn linear_grad_kernels[] = {NULL, relu_grad, sigmoid_grad, tanh_grad};
+
+static Tensor* linear_with(Tensor *X, Tensor *W, const float *packed_w, Tensor *b, LinearActivation activation) {
+    if (!X || !W || !b || W->ndim != 2 || b->ndim != 1) return NULL;
+    if (X->ndim != 1 && X->ndim != 2) return NULL;
+    if (activation < LINEAR_ACT_NONE || activation > LINEAR_ACT_TANH) return NULL;
+
+    size_t in = W->shape[0];
+    size_t out = W->shape[1];
+    size_t batch = (X->ndim == 2) ? X->shape[0] : 1;
+    if (X->shape[X->ndim - 1] != in || b->shape[0] != out) return NULL;
+
+    size_t Y_shape[2] = {batch, out};
+    Tensor *Y = (X->ndim == 2) ? tensor_create(Y_shape, 2) : tensor_create(Y_shape + 1, 1);
+    if (!Y) return NULL;
+
+    float *b_scratch;
+    const float *bias = ops_dense(b, &b_scratch);
+    if (!bias) {
+        tensor_free(Y);
+        return NULL;
+    }
+
+    const OpKernels *k = active_kernels;
+    GemmActivationFn activations[] = {NULL, k->relu, ops_sigmoid_kernel(k), ops_tanh_kernel(k)};
+    GemmEpilogue epilogue = {bias, activations[activation]};
+    size_t rsx = (X->ndim == 2) ? X->strides[0] : 0;
+
+    // One to a few rows (online inference) skip the blocked GEMM's packing
+    if (batch <= GEMM_SMALL_M && (packed_w || W->strides[1] == 1)) {
+        sgemm_small_m(k->small_m, batch, out, in,
+                      X->data, rsx, X->strides[X->ndim - 1],
+                      W->data, W->strides[0], packed_w,
+                      Y->data, out, &epilogue);
+    } else if (packed_w) {
+        sgemm_prepacked(k->gemm, batch, out, in,
+                        X->data, rsx, X->strides[X->ndim - 1], packed_w,
+                        Y->data, out, &epilogue);
+    } else {
+        sgemm_fused(k->gemm, batch, out, in,
+                    X->data, rsx, X->strides[X->ndim - 1],
+                    W->data, W->strides[0], W->strides[1],
+                    Y->data, out, &epilogue);
     }
+    free(b_scratch);
 
-    grad_update_one_var(A, C, NULL, "transpose2d", backward_transpose2d);
+    // The activation gradients read the output
+    tensor_record_op(Y, (Tensor *[]){X, W, b}, 3, linear_op_names[activation], linear_backward_fns[activation]);
+    if (activation == LINEAR_ACT_NONE) tensor_release_output(Y);
 
-    return C; 
+    return Y;
 }
 
-void backward_transpose2d(Tensor *C) {
-    Tensor *A = C->inputs[0];
-    
-    if (A->requires_grad) {
-        if (!A->grad) A->grad = (float *)calloc(A->size, sizeof(float));
-        for (size_t i = 0; i < A->shape[0]; i++) {
-            for (size_t j = 0; j < A->shape[1]; j++) {
-                A->grad[i * A->shape[1] + j] += C->grad[j * A->shape[0] + i];
-            }
-        }
+Tensor* tensor_linear(Tensor *X, Tensor *W, Tensor *b, LinearActivation activation) {
+    return linear_with(X, W, NULL, b, activation);
+}
+
+Tensor* tensor_linear_prepacked(Tensor *X, Tensor *W, const float *packed_w, Tensor *b, LinearActivation activation) {
+    if (!packed_w) return NULL;
+    return linear_with(X, W, packed_w, b, activation);
+}
+
+// With dZ = dY * activation'(Y): dX += dZ·Wᵀ, and one GEMM gives both
+// dW += Xᵀ·dZ and db += column sums of dZ, summed from dZ's packed panels
+// rather than in a separate pass. Both GEMMs accumulate straight into grad
+static void backward_linear_with(Tensor *Y, LinearActivation activation) {
+    Tensor *X = Y->inputs[0];
+    Tensor *W = Y->inputs[1];
+    Tensor *b = Y->inputs[2];
+    size_t in = W->shape[0];
+    size_t out = W->shape[1];
+    size_t batch = Y->size / out;
+
+    const float *dZ = Y->grad;
+    float *dz_scratch = NULL;
+    if (activation != LINEAR_ACT_NONE) {
+        dz_scratch = (float *)ops_scratch(Y, Y->size * sizeof(float));
+        if (!dz_scratch) return;
+        ops_parallel_grad_into(linear_grad_kernels[activation], Y->data, Y->data, Y->grad, dz_scratch, Y->size);
+        dZ = dz_scratch;
     }
+
+    size_t rsx = (X->ndim == 2) ? X->strides[0] : 0;
+    size_t csx = X->strides[X->ndim - 1];
+
+    if (X->requires_grad) {
+        tensor_ensure_grad(X);
+        sgemm_strided_ex(NULL, batch, in, out, 1.0f, dZ, out, 1,
+                         W->data, W->strides[1], W->strides[0], 1.0f, X->grad, in, NULL);
+    }
+
+    if (b->requires_grad) tensor_ensure_grad(b);
+    float *db = b->requires_grad ? b->grad : NULL;
+
+    if (W->requires_grad) {
+        tensor_ensure_grad(W);
+        sgemm_strided_ex(NULL, in, out, batch, 1.0f, X->data, csx, rsx,
+                         dZ, out, 1, 1.0f, W->grad, out, db);
+    } else if (db) {
+        ops_parallel_column_sums(Y, dZ, batch, out, db);
+    }
+
+    ops_scratch_free(Y, dz_scratch);
 }
 
+void backward_linear(Tensor *Y) { backward_linear_with(Y, LINEAR_ACT_NONE); }
+void backward_linear_relu(Tensor *Y) { backward_linear_with(Y, LINEAR_ACT_RELU); }
+void backward_linear_sigmoid(Tensor *Y) { backward_linear_with(Y, LINEAR_ACT_SIGMOID); }
+void backward_linear_tanh(Tensor *Y) { backward_linear_with(Y, LINEAR_ACT_TANH); }
+
 // ====================================================
 // Activation Functions
 // ====================================================
 
-Tensor* tensor_relu(Tensor *Z) {
+Tensor* ops_relu_with(const OpKernels *k, Tensor *Z) {
     if (!Z) return NULL;
 
     Tensor *A = tensor_create(Z->shape, Z->ndim); 
     if (!A) return NULL; 
 
-    for (size_t i = 0; i < Z->size; i++) {
-        A->data[i] = Z->data[i] > 0.0f ? Z->data[i] : 0.0f; 
-    }
+    float *scratch;
+    const float *z = ops_dense(Z, &scratch);
+    if (z) ops_parallel_unary(k->relu, z, A->data, Z->size);
+    free(scratch);
 
-    grad_update_one_var(Z, A, NULL, "relu", backward_relu);
+    grad_update_one_var(Z, A, "relu", backward_relu);
+    tensor_save_output(A);
 
     return A; 
 }
 
-Tensor* tensor_sigmoid(Tensor *Z) {
+Tensor* ops_sigmoid_with(const OpKernels *k, Tensor *Z) {
     if (!Z) return NULL;
 
     Tensor *A = tensor_create(Z->shape, Z->ndim);
     if (!A) return NULL;
 
-    for (size_t i = 0; i < Z->size; i++) {
-        A->data[i] = 1.0f / (1.0f + expf(-Z->data[i])); 
-    }
+    float *scratch;
+    const float *z = ops_dense(Z, &scratch);
+    if (z) ops_parallel_unary(ops_sigmoid_kernel(k), z, A->data, Z->size);
+    free(scratch);
 
-    grad_update_one_var(Z, A, NULL, "sigmoid", backward_sigmoid);
+    grad_update_one_var(Z, A, "sigmoid", backward_sigmoid);
+    tensor_save_output(A);
 
     return A;
 }
@@ -423,24 +1066,24 @@ void backward_relu(Tensor *A) {
     Tensor *Z = A->inputs[0];
     
     if (Z->requires_grad) {
-        if (!Z->grad) Z->grad = (float *)calloc(Z->size, sizeof(float));
-        for (size_t i = 0; i < Z->size; i++) {
-            Z->grad[i] += A->grad[i] * (Z->data[i] > 0 ? 1.0f : 0.0f);
-        }
+        tensor_ensure_grad(Z);
+        ops_parallel_grad(relu_grad, A->data, A->data, A->grad, Z->grad, Z->size);
     }
 }
 
-Tensor* tensor_tanh(Tensor *Z) {
+Tensor* ops_tanh_with(const OpKernels *k, Tensor *Z) {
     if (!Z) return NULL;
 
     Tensor *A = tensor_create(Z->shape, Z->ndim);
     if (!A) return NULL;
 
-    for (size_t i = 0; i < Z->size; i++) {
-        A->data[i] = tanhf(Z->data[i]); 
-    }
+    float *scratch;
+    const float *z = ops_dense(Z, &scratch);
+    if (z) ops_parallel_unary(ops_tanh_kernel(k), z, A->data, Z->size);
+    free(scratch);
 
-    grad_update_one_var(Z, A, NULL, "tanh", backward_tanh);
+    grad_update_one_var(Z, A, "tanh", backward_tanh);
+    tensor_save_output(A);
 
     return A;
 }
@@ -449,11 +1092,8 @@ void backward_tanh(Tensor *A) {
     Tensor *Z = A->inputs[0];
     
     if (Z->requires_grad) {
-        if (!Z->grad) Z->grad = (float *)calloc(Z->size, sizeof(float));
-        for (size_t i = 0; i < Z->size; i++) {
-            float t = A->data[i];
-            Z->grad[i] += A->grad[i] * (1.0f - t * t);
-        }
+        tensor_ensure_grad(Z);
+        ops_parallel_grad(tanh_grad, A->data, A->data, A->grad, Z->grad, Z->size);
     }
 }
 
@@ -461,15 +1101,12 @@ void backward_sigmoid(Tensor *A) {
     Tensor *Z = A->inputs[0];
     
     if (Z->requires_grad) {
-        if (!Z->grad) Z->grad = (float *)calloc(Z->size, sizeof(float));
-        for (size_t i = 0; i < Z->size; i++) {
-            float sig = A->data[i];
-            Z->grad[i] += A->grad[i] * sig * (1.0f - sig);
-        }
+        tensor_ensure_grad(Z);
+        ops_parallel_grad(sigmoid_grad, A->data, A->data, A->grad, Z->grad, Z->size);
     }
 }
 
-Tensor* tensor_softmax(Tensor *Z) {
+Tensor* ops_softmax_with(const OpKernels *k, Tensor *Z) {
     if (!Z) return NULL;
 
     Tensor *A = tensor_create(Z->shape, Z->ndim);
@@ -478,26 +1115,13 @@ Tensor* tensor_softmax(Tensor *Z) {
     size_t batch_size = (Z->ndim == 2) ? Z->shape[0] : 1;
     size_t num_classes = (Z->ndim == 2) ? Z->shape[1] : Z->size;
 
-    for (size_t b = 0; b < batch_size; b++) {
-        size_t offset = b * num_classes;
-        
-        float max_val = Z->data[offset];
-        for (size_t i = 1; i < num_classes; i++) {
-            if (Z->data[offset + i] > max_val) max_val = Z->data[offset + i];
-        }
-
-        float sum = 0.0f;
-        for (size_t i = 0; i < num_classes; i++) {
-            A->data[offset + i] = expf(Z->data[offset + i] - max_val);
-            sum += A->data[offset + i];
-        }
+    float *scratch;
+    const float *z = ops_dense(Z, &scratch);
+    if (z) ops_parallel_rows(NULL, k->softmax, z, NULL, A->data, batch_size, num_classes);
+    free(scratch);
 
-        for (size_t i = 0; i < num_classes; i++) {
-            A->data[offset + i] /= sum;
-        }
-    }
-
-    grad_update_one_var(Z, A, NULL, "softmax", backward_softmax);
+    grad_update_one_var(Z, A, "softmax", backward_softmax);
+    tensor_save_output(A);
 
     return A;
 }
@@ -506,7 +1130,7 @@ void backward_softmax(Tensor *A) {
     Tensor *Z = A->inputs[0];
     
     if (Z->requires_grad) {
-        if (!Z->grad) Z->grad = (float *)calloc(Z->size, sizeof(float));
+        tensor_ensure_grad(Z);
         
         size_t batch_size = (Z->ndim == 2) ? Z->shape[0] : 1;
         size_t num_classes = (Z->ndim == 2) ? Z->shape[1] : Z->size;
@@ -523,6 +1147,83 @@ void backward_softmax(Tensor *A) {
     }
 }
 
+// ====================================================
+// In-Place Operations
+// ====================================================
+
+// Z = f(Z) over Z's own storage
+static Tensor* ops_unary_inplace(Tensor *Z, UnaryKernelFn kernel, const char *op_name, void (*backward_fn)(Tensor *)) {
+    if (!Z || !tensor_is_contiguous(Z)) return NULL;
+
+    Tensor *prev = tensor_begin_inplace(Z, NULL, 0);
+    if (!prev) return NULL;
+
+    ops_parallel_unary(kernel, Z->data, Z->data, Z->size);
+
+    // The backward passes read only the output, which is Z itself
+    if (prev != Z) {
+        grad_update_one_var(prev, Z, op_name, backward_fn);
+        tensor_save_output(Z);
+    }
+
+    return Z;
+}
+
+// A = A op B with B broadcast to A's shape. keep_value: B's gradient needs A's old values
+static Tensor* ops_binary_inplace(Tensor *A, Tensor *B, BinaryKernelFn kernel, int keep_value, int saves_output,
+                                  const char *op_name, void (*backward_fn)(Tensor *)) {
+    if (!A || !B || !tensor_is_contiguous(A) || B->ndim > A->ndim) return NULL;
+
+    BroadcastPlan plan;
+    size_t shape[OPS_MAX_BROADCAST_DIMS];
+    if (!broadcast_plan(A->shape, A->ndim, B->shape, B->ndim, &plan, shape)) return NULL;
+    if (memcmp(shape, A->shape, A->ndim * sizeof(size_t)) != 0) return NULL;
+
+    float *b_scratch;
+    const float *b = ops_dense(B, &b_scratch);
+    if (!b) return NULL;
+
+    Tensor *prev = tensor_begin_inplace(A, B, keep_value && B->requires_grad);
+    if (prev) {
+        broadcast_exec(&plan, kernel, A->data, b, A->data);
+        if (prev != A) {
+            grad_update_two_vars(prev, B, A, op_name, backward_fn);
+            if (saves_output) tensor_save_output(A);
+        }
+    }
+    free(b_scratch);
+
+    return prev ? A : NULL;
+}
+
+Tensor* tensor_add_(Tensor *A, Tensor *B) {
+    return ops_binary_inplace(A, B, active_kernels->add, 0, 0, "add", backward_add);
+}
+
+Tensor* tensor_sub_(Tensor *A, Tensor *B) {
+    return ops_binary_inplace(A, B, active_kernels->sub, 0, 0, "sub", backward_sub);
+}
+
+Tensor* tensor_mul_(Tensor *A, Tensor *B) {
+    return ops_binary_inplace(A, B, active_kernels->mul, 1, 0, "mul", backward_mul);
+}
+
+Tensor* tensor_div_(Tensor *A, Tensor *B) {
+    return ops_binary_inplace(A, B, active_kernels->div, 0, 1, "div", backward_div);
+}
+
+Tensor* tensor_relu_(Tensor *Z) {
+    return ops_unary_inplace(Z, active_kernels->relu, "relu", backward_relu);
+}
+
+Tensor* tensor_sigmoid_(Tensor *Z) {
+    return ops_unary_inplace(Z, ops_sigmoid_kernel(active_kernels), "sigmoid", backward_sigmoid);
+}
+
+Tensor* tensor_tanh_(Tensor *Z) {
+    return ops_unary_inplace(Z, ops_tanh_kernel(active_kernels), "tanh", backward_tanh);
+}
+
 // ====================================================
 // Loss Functions
 // ====================================================
@@ -536,28 +1237,21 @@ static int check_pred_target(Tensor *predictions, Tensor *targets) {
     return 1; 
 }
 
-Tensor* tensor_mse(Tensor *predictions, Tensor *targets) {
+Tensor* ops_mse_with(const OpKernels *k, Tensor *predictions, Tensor *targets) {
     if (!check_pred_target(predictions, targets)) return NULL;
 
     Tensor *loss = tensor_create((size_t[]){1}, 1);
     if (!loss) return NULL; 
 
-    float sum_sq_error = 0.0f; 
-    for (size_t i = 0; i < predictions->size; i++) {
-        float diff = predictions->data[i] - targets->data[i];
-        sum_sq_error += diff * diff;
-    }
+    float *p_scratch, *t_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *t = ops_dense(targets, &t_scratch);
+    float sum_sq_error = (p && t) ? ops_parallel_reduce(loss, k->mse, p, t, predictions->size) : 0.0f;
+    free(p_scratch);
+    free(t_scratch);
     loss->data[0] = sum_sq_error / predictions->size;
     
-    if (predictions->requires_grad || targets->requires_grad) {
-        loss->requires_grad = 1;
-        loss->op_name = strdup("mse");
-        loss->num_inputs = 2;
-        loss->inputs = (Tensor **)malloc(2 * sizeof(Tensor *));
-        loss->inputs[0] = predictions;
-        loss->inputs[1] = targets;
-        loss->backward_fn = backward_mse;
-    }
+    grad_update_two_vars(predictions, targets, loss, "mse", backward_mse);
     
     return loss;
 }
@@ -565,51 +1259,50 @@ Tensor* tensor_mse(Tensor *predictions, Tensor *targets) {
 void backward_mse(Tensor *L) {
     Tensor *predictions = L->inputs[0];
     Tensor *targets = L->inputs[1]; 
+    float *p_scratch, *t_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *t = ops_dense(targets, &t_scratch);
+    if (!p || !t) {
+        free(p_scratch);
+        free(t_scratch);
+        return;
+    }
 
     if (predictions->requires_grad) {
-        if (!predictions->grad) 
-            predictions->grad = (float *)calloc(predictions->size, sizeof(float));
+        tensor_ensure_grad(predictions);
         for (size_t i = 0; i < predictions->size; i++) {
             predictions->grad[i] += 
-                (2.0f / predictions->size) * (predictions->data[i] - targets->data[i]) * L->grad[0];
+                (2.0f / predictions->size) * (p[i] - t[i]) * L->grad[0];
         }
     }
 
     if (targets->requires_grad) {
-        if (!targets->grad) 
-            targets->grad = (float *)calloc(targets->size, sizeof(float));
+        tensor_ensure_grad(targets);
         for (size_t i = 0; i < targets->size; i++) {
             targets->grad[i] -= 
-                (2.0f / targets->size) * (predictions->data[i] - targets->data[i]) * L->grad[0];
+                (2.0f / targets->size) * (p[i] - t[i]) * L->grad[0];
         }
     }
+
+    free(p_scratch);
+    free(t_scratch);
 }
 
-Tensor* tensor_cross_entropy(Tensor *predictions, Tensor *targets) {
+Tensor* ops_cross_entropy_with(const OpKernels *k, Tensor *predictions, Tensor *targets) {
     if (!check_pred_target(predictions, targets)) return NULL; 
     
     Tensor *loss = tensor_create((size_t[]){1}, 1);
     if (!loss) return NULL;
 
-    float sum_ce_loss = 0.0f;
-    float epsilon = 1e-7f;
-    for (size_t i = 0; i < predictions->size; i++) {
-        float pred = predictions->data[i];
-        float target = targets->data[i];
-        pred = pred < epsilon ? epsilon : (pred > 1.0f - epsilon ? 1.0f - epsilon : pred);
-        sum_ce_loss += -target * logf(pred);
-    }
+    float *p_scratch, *t_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *t = ops_dense(targets, &t_scratch);
+    float sum_ce_loss = (p && t) ? ops_parallel_reduce(loss, k->cross_entropy, p, t, predictions->size) : 0.0f;
+    free(p_scratch);
+    free(t_scratch);
     loss->data[0] = sum_ce_loss / predictions->size;
     
-    if (predictions->requires_grad || targets->requires_grad) {
-        loss->requires_grad = 1;
-        loss->op_name = strdup("cross_entropy");
-        loss->num_inputs = 2;
-        loss->inputs = (Tensor **)malloc(2 * sizeof(Tensor *));
-        loss->inputs[0] = predictions;
-        loss->inputs[1] = targets;
-        loss->backward_fn = backward_cross_entropy;
-    }
+    grad_update_two_vars(predictions, targets, loss, "cross_entropy", backward_cross_entropy);
     
     return loss;
 }
@@ -617,56 +1310,55 @@ Tensor* tensor_cross_entropy(Tensor *predictions, Tensor *targets) {
 void backward_cross_entropy(Tensor *L) {
     Tensor *predictions = L->inputs[0];
     Tensor *targets = L->inputs[1]; 
+    float *p_scratch, *t_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *t = ops_dense(targets, &t_scratch);
+    if (!p || !t) {
+        free(p_scratch);
+        free(t_scratch);
+        return;
+    }
     float epsilon = 1e-7f;
 
     if (predictions->requires_grad) {
-        if (!predictions->grad) 
-            predictions->grad = (float *)calloc(predictions->size, sizeof(float));
+        tensor_ensure_grad(predictions);
         for (size_t i = 0; i < predictions->size; i++) {
-            float pred = predictions->data[i];
+            float pred = p[i];
             pred = pred < epsilon ? epsilon : (pred > 1.0f - epsilon ? 1.0f - epsilon : pred);
             predictions->grad[i] += 
-                (-targets->data[i] / pred) * L->grad[0];
+                (-t[i] / pred) * L->grad[0];
         }
     }
 
     if (targets->requires_grad) {
-        if (!targets->grad) 
-            targets->grad = (float *)calloc(targets->size, sizeof(float));
+        tensor_ensure_grad(targets);
         for (size_t i = 0; i < targets->size; i++) {
-            float pred = predictions->data[i];
+            float pred = p[i];
             pred = pred < epsilon ? epsilon : pred;
             targets->grad[i] -= 
                 ( -logf(pred) ) * L->grad[0];
         }
     }
+
+    free(p_scratch);
+    free(t_scratch);
 }
 
-Tensor* tensor_binary_cross_entropy(Tensor *predictions, Tensor *targets) {
+Tensor* ops_binary_cross_entropy_with(const OpKernels *k, Tensor *predictions, Tensor *targets) {
     if (!check_pred_target(predictions, targets)) return NULL;
     
     Tensor *loss = tensor_create((size_t[]){1}, 1);
     if (!loss) return NULL;
 
-    float sum_bce_loss = 0.0f;
-    float epsilon = 1e-7f;
-    for (size_t i = 0; i < predictions->size; i++) {
-        float pred = predictions->data[i];
-        float target = targets->data[i];
-        pred = pred < epsilon ? epsilon : (pred > 1.0f - epsilon ? 1.0f - epsilon : pred);
-        sum_bce_loss += -target * logf(pred) - (1.0f - target) * logf(1.0f - pred);
-    }
+    float *p_scratch, *t_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *t = ops_dense(targets, &t_scratch);
+    float sum_bce_loss = (p && t) ? ops_parallel_reduce(loss, k->binary_cross_entropy, p, t, predictions->size) : 0.0f;
+    free(p_scratch);
+    free(t_scratch);
     loss->data[0] = sum_bce_loss / predictions->size;
     
-    if (predictions->requires_grad || targets->requires_grad) {
-        loss->requires_grad = 1;
-        loss->op_name = strdup("binary_cross_entropy");
-        loss->num_inputs = 2;
-        loss->inputs = (Tensor **)malloc(2 * sizeof(Tensor *));
-        loss->inputs[0] = predictions;
-        loss->inputs[1] = targets;
-        loss->backward_fn = backward_binary_cross_entropy;
-    }
+    grad_update_two_vars(predictions, targets, loss, "binary_cross_entropy", backward_binary_cross_entropy);
     
     return loss;
 }
@@ -674,91 +1366,389 @@ Tensor* tensor_binary_cross_entropy(Tensor *predictions, Tensor *targets) {
 void backward_binary_cross_entropy(Tensor *L) {
     Tensor *predictions = L->inputs[0];
     Tensor *targets = L->inputs[1]; 
+    float *p_scratch, *t_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *t = ops_dense(targets, &t_scratch);
+    if (!p || !t) {
+        free(p_scratch);
+        free(t_scratch);
+        return;
+    }
     float epsilon = 1e-7f;
 
     if (predictions->requires_grad) {
-        if (!predictions->grad) 
-            predictions->grad = (float *)calloc(predictions->size, sizeof(float));
+        tensor_ensure_grad(predictions);
         for (size_t i = 0; i < predictions->size; i++) {
-            float pred = predictions->data[i];
+            float pred = p[i];
             pred = pred < epsilon ? epsilon : (pred > 1.0f - epsilon ? 1.0f - epsilon : pred);
             predictions->grad[i] += 
-                (-(targets->data[i] / pred) + 
-                 (1.0f - targets->data[i]) / (1.0f - pred)) * L->grad[0];
+                (-(t[i] / pred) + 
+                 (1.0f - t[i]) / (1.0f - pred)) * L->grad[0];
         }
     }
 
     if (targets->requires_grad) {
-        if (!targets->grad) 
-            targets->grad = (float *)calloc(targets->size, sizeof(float));
+        tensor_ensure_grad(targets);
         for (size_t i = 0; i < targets->size; i++) {
-            float pred = predictions->data[i];
+            float pred = p[i];
             pred = pred < epsilon ? epsilon : (pred > 1.0f - epsilon ? 1.0f - epsilon : pred);
             targets->grad[i] -= 
                 (-logf(pred) + -logf(1.0f - pred)) * L->grad[0];
         }
     }
+
+    free(p_scratch);
+    free(t_scratch);
+}
+
+typedef struct {
+    const OpKernels *k;
+    const float *z;
+    const float *t;         // Dense targets, or NULL for class indices
+    const float *labels;
+    float *p;
+    float *row_loss;
+    size_t num_classes;
+} SoftmaxCrossEntropyTask;
+
+// -sum_c t_c log p_c per row, with log p_c = z_c - z_max + log p_max. p_max is
+// at least 1/C, so unlike the p_c of unlikely classes it never underflows
+static void softmax_cross_entropy_rows(size_t begin, size_t end, void *arg) {
+    SoftmaxCrossEntropyTask *task = (SoftmaxCrossEntropyTask *)arg;
+    size_t C = task->num_classes;
+
+    for (size_t r = begin; r < end; r++) {
+        const float *z = task->z + r * C;
+        const float *t = task->t ? task->t + r * C : NULL;
+        float *p = task->p + r * C;
+        task->k->softmax(z, p, C);
+
+        size_t top = 0;
+        for (size_t c = 1; c < C; c++) {
+            if (z[c] > z[top]) top = c;
+        }
+        float shift = logf(p[top]) - z[top];
+
+        float loss = 0.0f;
+        if (task->labels) {
+            loss = -(z[(size_t)task->labels[r]] + shift);
+        } else {
+            for (size_t c = 0; c < C; c++) {
+                if (t[c] != 0.0f) loss -= t[c] * (z[c] + shift);
+            }
+        }
+        task->row_loss[r] = loss;
+    }
+}
+
+// Shared by the dense and sparse forms: exactly one of targets and labels is dense
+static Tensor* softmax_cross_entropy_forward(const OpKernels *k, Tensor *logits, Tensor *targets,
+                                             const float *t, const float *labels,
+                                             const char *op_name, void (*backward_fn)(Tensor *)) {
+    Tensor *loss = tensor_create((size_t[]){1}, 1);
+    if (!loss) return NULL;
+
+    size_t batch_size = (logits->ndim == 2) ? logits->shape[0] : 1;
+    size_t num_classes = (logits->ndim == 2) ? logits->shape[1] : logits->size;
+
+    grad_update_two_vars(logits, targets, loss, op_name, backward_fn);
+
+    // Backward reuses the probabilities, kept in extra_data
+    size_t p_size = logits->size * sizeof(float);
+    float *p = (float *)((loss->requires_grad && loss->arena) ? arena_alloc(loss->arena, p_size) : malloc(p_size));
+    float *row_loss = (float *)ops_scratch(loss, batch_size * sizeof(float));
+
+    float *z_scratch;
+    const float *z = ops_dense(logits, &z_scratch);
+
+    float sum_ce_loss = 0.0f;
+    if (p && row_loss && z) {
+        SoftmaxCrossEntropyTask task = {k, z, t, labels, p, row_loss, num_classes};
+        size_t grain = (num_classes < OPS_PARALLEL_GRAIN) ? OPS_PARALLEL_GRAIN / num_classes : 1;
+        parallel_for(0, batch_size, grain, softmax_cross_entropy_rows, &task);
+        for (size_t r = 0; r < batch_size; r++) sum_ce_loss += row_loss[r];
+    }
+    free(z_scratch);
+    ops_scratch_free(loss, row_loss);
+    loss->data[0] = sum_ce_loss / logits->size;
+
+    if (loss->requires_grad) {
+        loss->extra_data = p;
+    } else {
+        free(p);
+    }
+
+    return loss;
+}
+
+Tensor* ops_softmax_cross_entropy_with(const OpKernels *k, Tensor *logits, Tensor *targets) {
+    if (!check_pred_target(logits, targets) || logits->size == 0) return NULL;
+
+    float *t_scratch;
+    const float *t = ops_dense(targets, &t_scratch);
+    if (!t) return NULL;
+
+    Tensor *loss = softmax_cross_entropy_forward(k, logits, targets, t, NULL,
+                                                 "softmax_cross_entropy", backward_softmax_cross_entropy);
+    free(t_scratch);
+    return loss;
+}
+
+void backward_softmax_cross_entropy(Tensor *L) {
+    Tensor *logits = L->inputs[0];
+    Tensor *targets = L->inputs[1];
+    const float *p = (const float *)L->extra_data;
+    if (!p) return;
+
+    float *t_scratch;
+    const float *t = ops_dense(targets, &t_scratch);
+    if (!t) return;
+
+    size_t num_classes = (logits->ndim == 2) ? logits->shape[1] : logits->size;
+    size_t batch_size = logits->size / num_classes;
+    float scale = L->grad[0];
+
+    // d/dz_c = p_c * sum(t) - t_c, which is p - t for one-hot rows. Scaled like
+    // backward_cross_entropy, so routing through the fused loss leaves training unchanged
+    if (logits->requires_grad) {
+        tensor_ensure_grad(logits);
+        for (size_t r = 0; r < batch_size; r++) {
+            const float *pr = p + r * num_classes;
+            const float *tr = t + r * num_classes;
+            float *gr = logits->grad + r * num_classes;
+
+            float t_sum = 0.0f;
+            for (size_t c = 0; c < num_classes; c++) t_sum += tr[c];
+            for (size_t c = 0; c < num_classes; c++) {
+                gr[c] += scale * (pr[c] * t_sum - tr[c]);
+            }
+        }
+    }
+
+    if (targets->requires_grad) {
+        float *z_scratch;
+        const float *z = ops_dense(logits, &z_scratch);
+        tensor_ensure_grad(targets);
+        for (size_t r = 0; z && r < batch_size; r++) {
+            const float *pr = p + r * num_classes;
+            const float *zr = z + r * num_classes;
+
+            size_t top = 0;
+            for (size_t c = 1; c < num_classes; c++) {
+                if (zr[c] > zr[top]) top = c;
+            }
+            float shift = logf(pr[top]) - zr[top];
+            for (size_t c = 0; c < num_classes; c++) {
+                targets->grad[r * num_classes + c] -= scale * (zr[c] + shift);
+            }
+        }
+        free(z_scratch);
+    }
+
+    free(t_scratch);
 }
 
 // ====================================================
-// Slice
+// Sparse Targets
 // ====================================================
 
-Tensor* tensor_slice(Tensor *input, size_t start, size_t end) {
-    if (!input || start >= end || end > input->size) return NULL; 
+// Labels as dense class indices, or NULL (with *scratch freed) unless labels
+// holds one integral index in [0, num_classes) per row of predictions
+static const float* sparse_labels(Tensor *predictions, Tensor *labels, float **scratch) {
+    *scratch = NULL;
+    if (!predictions || !labels || labels->ndim != 1 || predictions->size == 0) return NULL;
+
+    size_t batch_size = (predictions->ndim == 2) ? predictions->shape[0] : 1;
+    size_t num_classes = (predictions->ndim == 2) ? predictions->shape[1] : predictions->size;
+    if (predictions->ndim > 2 || labels->shape[0] != batch_size) return NULL;
+
+    const float *l = ops_dense(labels, scratch);
+    for (size_t r = 0; l && r < batch_size; r++) {
+        if (!(l[r] >= 0.0f && l[r] < (float)num_classes) || l[r] != floorf(l[r])) {
+            free(*scratch);
+            *scratch = NULL;
+            return NULL;
+        }
+    }
+    return l;
+}
 
-    Tensor *slice = (Tensor*)malloc(sizeof(Tensor));
-    if (!slice) return NULL;
+Tensor* ops_sparse_cross_entropy_with(const OpKernels *k, Tensor *predictions, Tensor *labels) {
+    (void)k;
+    float *l_scratch;
+    const float *l = sparse_labels(predictions, labels, &l_scratch);
+    if (!l) return NULL;
 
-    slice->ndim = input->ndim; 
-    slice->shape = (size_t*)malloc(input->ndim * sizeof(size_t));
-    if (!slice->shape) {
-        free(slice);
+    Tensor *loss = tensor_create((size_t[]){1}, 1);
+    if (!loss) {
+        free(l_scratch);
         return NULL;
     }
 
-    slice->shape[0] = end - start; 
-    size_t stride = 1;
-    for (size_t i = 1; i < input->ndim; i++) {
-        slice->shape[i] = input->shape[i]; 
-        stride *= input->shape[i]; 
+    size_t num_classes = (predictions->ndim == 2) ? predictions->shape[1] : predictions->size;
+    size_t batch_size = predictions->size / num_classes;
+    float epsilon = 1e-7f;
+
+    float *p_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    float sum_ce_loss = 0.0f;
+    for (size_t r = 0; p && r < batch_size; r++) {
+        float pred = p[r * num_classes + (size_t)l[r]];
+        sum_ce_loss -= logf(pred < epsilon ? epsilon : pred);
     }
+    free(p_scratch);
+    free(l_scratch);
+    loss->data[0] = sum_ce_loss / predictions->size;
 
-    slice->size = (end - start) * stride; 
-    slice->data = input->data + (start * stride); 
+    grad_update_two_vars(predictions, labels, loss, "sparse_cross_entropy", backward_sparse_cross_entropy);
 
-    if (input->grad) {
-        slice->grad = input->grad + (start * stride); 
-    } else {
-        slice->grad = NULL; 
+    return loss;
+}
+
+void backward_sparse_cross_entropy(Tensor *L) {
+    Tensor *predictions = L->inputs[0];
+    Tensor *labels = L->inputs[1];
+    if (!predictions->requires_grad) return;
+
+    float *p_scratch, *l_scratch;
+    const float *p = ops_dense(predictions, &p_scratch);
+    const float *l = ops_dense(labels, &l_scratch);
+    size_t num_classes = (predictions->ndim == 2) ? predictions->shape[1] : predictions->size;
+    float epsilon = 1e-7f;
+
+    // Only the labelled entry of each row has a nonzero target
+    tensor_ensure_grad(predictions);
+    for (size_t r = 0; p && l && r < labels->size; r++) {
+        size_t i = r * num_classes + (size_t)l[r];
+        float pred = p[i];
+        pred = pred < epsilon ? epsilon : (pred > 1.0f - epsilon ? 1.0f - epsilon : pred);
+        predictions->grad[i] += (-1.0f / pred) * L->grad[0];
     }
 
-    slice->owns_data = 0; 
-    
-    slice->requires_grad = input->requires_grad; 
+    free(p_scratch);
+    free(l_scratch);
+}
 
-    slice->op_name = NULL; 
-    slice->inputs = NULL; 
-    slice->num_inputs = 0; 
-    slice->backward_fn = NULL; 
-    slice->extra_data = NULL; 
+Tensor* ops_sparse_softmax_cross_entropy_with(const OpKernels *k, Tensor *logits, Tensor *labels) {
+    float *l_scratch;
+    const float *l = sparse_labels(logits, labels, &l_scratch);
+    if (!l) return NULL;
 
-    return slice;
+    Tensor *loss = softmax_cross_entropy_forward(k, logits, labels, NULL, l,
+                                                 "sparse_softmax_cross_entropy", backward_sparse_softmax_cross_entropy);
+    free(l_scratch);
+    return loss;
+}
+
+void backward_sparse_softmax_cross_entropy(Tensor *L) {
+    Tensor *logits = L->inputs[0];
+    Tensor *labels = L->inputs[1];
+    const float *p = (const float *)L->extra_data;
+    if (!p || !logits->requires_grad) return;
+
+    float *l_scratch;
+    const float *l = ops_dense(labels, &l_scratch);
+    if (!l) return;
+
+    size_t num_classes = (logits->ndim == 2) ? logits->shape[1] : logits->size;
+
+    // p - onehot(label) per row
+    tensor_ensure_grad(logits);
+    for (size_t i = 0; i < logits->size; i++) logits->grad[i] += L->grad[0] * p[i];
+    for (size_t r = 0; r < labels->size; r++) {
+        logits->grad[r * num_classes + (size_t)l[r]] -= L->grad[0];
+    }
+
+    free(l_scratch);
+}
+
+// ====================================================
+// Slice
+// ====================================================
+
+Tensor* tensor_slice(Tensor *input, size_t start, size_t end) {
+    if (!input || input->ndim == 0 || start >= end || end > input->shape[0]) return NULL; 
+
+    size_t shape[input->ndim];
+    size_t steps[input->ndim];
+    size_t stride = 1;
+    for (size_t i = input->ndim; i > 0; i--) {
+        shape[i - 1] = input->shape[i - 1];
+        steps[i - 1] = stride;
+        stride *= input->shape[i - 1];
+    }
+    shape[0] = end - start; 
+
+    return view_create(input, shape, steps, input->ndim, start * steps[0], "slice", backward_view);
 }
 
+// ====================================================
+// Backend Dispatch
+// ====================================================
+
+OPS_DEFINE_BACKEND(scalar, kernels_scalar)
+
+// The public ops call the best kernel table directly. The registry serves
+// lookups by name (losses in network_train, get_operation_fn), so an entry
+// point registered under its own name, register_loss("mse", tensor_mse), is
+// not dispatched back to itself
+Tensor* tensor_add(Tensor *A, Tensor *B) { return ops_add_with(active_kernels, A, B); }
+Tensor* tensor_sub(Tensor *A, Tensor *B) { return ops_sub_with(active_kernels, A, B); }
+Tensor* tensor_mul(Tensor *A, Tensor *B) { return ops_mul_with(active_kernels, A, B); }
+Tensor* tensor_div(Tensor *A, Tensor *B) { return ops_div_with(active_kernels, A, B); }
+Tensor* tensor_matmul(Tensor *A, Tensor *B) { return ops_matmul_with(active_kernels, A, B); }
+Tensor* tensor_relu(Tensor *Z) { return ops_relu_with(active_kernels, Z); }
+Tensor* tensor_sigmoid(Tensor *Z) { return ops_sigmoid_with(active_kernels, Z); }
+Tensor* tensor_tanh(Tensor *Z) { return ops_tanh_with(active_kernels, Z); }
+Tensor* tensor_softmax(Tensor *Z) { return ops_softmax_with(active_kernels, Z); }
+Tensor* tensor_mse(Tensor *predictions, Tensor *targets) { return ops_mse_with(active_kernels, predictions, targets); }
+Tensor* tensor_cross_entropy(Tensor *predictions, Tensor *targets) { return ops_cross_entropy_with(active_kernels, predictions, targets); }
+Tensor* tensor_binary_cross_entropy(Tensor *predictions, Tensor *targets) { return ops_binary_cross_entropy_with(active_kernels, predictions, targets); }
+Tensor* tensor_softmax_cross_entropy(Tensor *logits, Tensor *targets) { return ops_softmax_cross_entropy_with(active_kernels, logits, targets); }
+Tensor* tensor_sparse_cross_entropy(Tensor *predictions, Tensor *labels) { return ops_sparse_cross_entropy_with(active_kernels, predictions, labels); }
+Tensor* tensor_sparse_softmax_cross_entropy(Tensor *logits, Tensor *labels) { return ops_sparse_softmax_cross_entropy_with(active_kernels, logits, labels); }
+
 // ====================================================
 // Operation Registration
 // ====================================================
 
 void ops_register_builtins(void) {
-    register_loss("mse", tensor_mse);
-    register_loss("cross_entropy", tensor_cross_entropy);
-    register_loss("binary_cross_entropy", tensor_binary_cross_entropy);
+    cpu_detect();
+
+    // Scalar kernels are always registered as the fallback; SIMD tables
+    // supported by the host override them at a higher priority
+    ops_register_scalar();
+    const OpKernels *best = &kernels_scalar;
+    if (kernels_avx2()) {
+        ops_register_avx2();
+        best = kernels_avx2();
+    }
+    if (kernels_avx512()) {
+        ops_register_avx512();
+        best = kernels_avx512();
+    }
+    if (kernels_neon()) {
+        ops_register_neon();
+        best = kernels_neon();
+    }
+    gemm_set_microkernel(best->gemm);
+    fastmath_use(best->fast_math);
+    optimizer_use(best);
+    active_kernels = best;
+
     register_tensor_op("add", backward_add);
     register_tensor_op("sub", backward_sub);
     register_tensor_op("mul", backward_mul);
+    register_tensor_op("div", backward_div);
     register_tensor_op("matmul", backward_matmul);
     register_tensor_op("transpose2d", backward_transpose2d);
+    register_tensor_op("linear", backward_linear);
+    register_tensor_op("linear_relu", backward_linear_relu);
+    register_tensor_op("linear_sigmoid", backward_linear_sigmoid);
+    register_tensor_op("linear_tanh", backward_linear_tanh);
+    register_tensor_op("view", backward_view);
+    register_tensor_op("slice", backward_view);
+    register_tensor_op("contiguous", backward_contiguous);
     register_tensor_op("relu", backward_relu);
     register_tensor_op("sigmoid", backward_sigmoid);
     register_tensor_op("tanh", backward_tanh);
@@ -766,4 +1756,7 @@ void ops_register_builtins(void) {
     register_tensor_op("mse", backward_mse);
     register_tensor_op("cross_entropy", backward_cross_entropy);
     register_tensor_op("binary_cross_entropy", backward_binary_cross_entropy);
-}
\ No newline at end of file
+    register_tensor_op("softmax_cross_entropy", backward_softmax_cross_entropy);
+    register_tensor_op("sparse_cross_entropy", backward_sparse_cross_entropy);
+    register_tensor_op("sparse_softmax_cross_entropy", backward_sparse_softmax_cross_entropy);
+}
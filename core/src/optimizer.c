@@ -1,36 +1,186 @@
 #include "optimizer.h"
 #include "registry.h"
+#include "threadpool.h"
+#include "kernels.h"
+#include "serialize.h"
 #include <stdlib.h>
 #include <string.h> 
+#include <stdint.h>
 #include <math.h>
 
 // ====================================================
 // Optimizer States
 // ====================================================
 
+// Elements per task; one step sweeps every parameter as a single range, so
+// small tensors share tasks instead of each paying for a dispatch. A multiple
+// of ADAM_MOMENT_BLOCK so tasks never split a quantization block
+#define OPTIMIZER_PARALLEL_GRAIN 16384
+
+// Low-precision moments are expanded to float this many elements at a time;
+// in 8-bit storage each such block shares one scale
+#define ADAM_MOMENT_BLOCK 256
+
+// Kernel table the update sweeps run on, set by ops_register_builtins
+static const OpKernels *optimizer_kernels = &kernels_scalar;
+
+void optimizer_use(const OpKernels *kernels) {
+    optimizer_kernels = kernels ? kernels : &kernels_scalar;
+}
+
+// Elements [start, start + size) of a step's sweep: a run of parameter data and
+// gradient with its state at offset in the optimizer's flat buffers
+typedef struct {
+    float *data;
+    float *grad;
+    size_t offset;
+    size_t start;
+    size_t size;
+} OptimizerSegment;
+
+typedef struct {
+    OptimizerSegment *segments;
+    size_t num_segments;
+    size_t total;
+} OptimizerSweep;
+
 typedef struct {
     float learning_rate;
     float momentum;
-    Tensor **velocity;
+    float *velocity;
+    size_t *offsets;
+    size_t total;       // Elements in velocity
+    OptimizerSweep sweep;
 } SGDState;
 
+// Storage of Adam's moment estimates. The low-precision forms are expanded
+// to float one block at a time around the float update kernel
+typedef enum {
+    ADAM_MOMENTS_FP32,
+    ADAM_MOMENTS_BF16,
+    ADAM_MOMENTS_8BIT
+} AdamMoments;
+
 typedef struct {
     float learning_rate;
     float beta1;
     float beta2;
     float epsilon;
+    float weight_decay;
     int t;
-    Tensor **m;
-    Tensor **v;
+    AdamMoments moments;
+    void *m;            // float, bf16 (uint16_t) or int8_t per element
+    void *v;            // float, bf16 (uint16_t) or uint8_t per element
+    float *m_scale;     // Per-block absolute maxima, 8-bit only
+    float *v_scale;
+    size_t *offsets;
+    size_t total;       // Elements in m and v, block padding included
+    OptimizerSweep sweep;
 } AdamState;
 
 static void* sgd_init_state(Tensor **parameters, size_t num_parameters, void *params);
 static void sgd_step(Optimizer *opt);
 static void sgd_free_state(void *state, size_t num_parameters);
+static int sgd_save_state(void *state, size_t num_parameters, FILE *file);
+static int sgd_load_state(void *state, size_t num_parameters, FILE *file);
 
 static void* adam_init_state(Tensor **parameters, size_t num_parameters, void *params);
+static void* adamw_init_state(Tensor **parameters, size_t num_parameters, void *params);
+static void* adam_bf16_init_state(Tensor **parameters, size_t num_parameters, void *params);
+static void* adamw_bf16_init_state(Tensor **parameters, size_t num_parameters, void *params);
+static void* adam_8bit_init_state(Tensor **parameters, size_t num_parameters, void *params);
+static void* adamw_8bit_init_state(Tensor **parameters, size_t num_parameters, void *params);
 static void adam_step(Optimizer *opt);
 static void adam_free_state(void *state, size_t num_parameters);
+static int adam_save_state(void *state, size_t num_parameters, FILE *file);
+static int adam_load_state(void *state, size_t num_parameters, FILE *file);
+
+// ====================================================
+// Parameter Sweeps
+// ====================================================
+
+static size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+// Offsets of each parameter's state in one flat buffer, each a multiple of
+// align; total receives the buffer's length, also a multiple of align
+static size_t* state_offsets(Tensor **parameters, size_t num_parameters, size_t align, size_t *total) {
+    size_t *offsets = malloc(num_parameters * sizeof(size_t));
+    if (!offsets) return NULL;
+
+    *total = 0;
+    for (size_t i = 0; i < num_parameters; i++) {
+        offsets[i] = *total;
+        *total = round_up(*total + parameters[i]->size, align);
+    }
+    return offsets;
+}
+
+static int sweep_init(OptimizerSweep *sweep, size_t num_parameters) {
+    sweep->segments = malloc(num_parameters * sizeof(OptimizerSegment));
+    sweep->num_segments = 0;
+    sweep->total = 0;
+    return sweep->segments != NULL;
+}
+
+// Lists the parameters that have gradients, merging neighbours whose data,
+// gradient and state are all adjacent. Gradients can be allocated or replaced
+// between steps, so this runs every step; a network's flat buffers collapse
+// into a single segment. Segments start at multiples of align within the
+// sweep, leaving unused positions between them
+static void sweep_build(OptimizerSweep *sweep, Tensor **parameters, size_t num_parameters,
+                        const size_t *offsets, size_t align) {
+    sweep->num_segments = 0;
+    sweep->total = 0;
+
+    for (size_t i = 0; i < num_parameters; i++) {
+        Tensor *param = parameters[i];
+        if (!param->grad || param->size == 0) continue;
+
+        size_t offset = offsets ? offsets[i] : 0;
+        if (sweep->num_segments > 0) {
+            OptimizerSegment *last = &sweep->segments[sweep->num_segments - 1];
+            if (param->data == last->data + last->size && param->grad == last->grad + last->size &&
+                (!offsets || offset == last->offset + last->size) && last->size % align == 0) {
+                last->size += param->size;
+                sweep->total += param->size;
+                continue;
+            }
+        }
+
+        sweep->total = round_up(sweep->total, align);
+        sweep->segments[sweep->num_segments++] = (OptimizerSegment){param->data, param->grad, offset, sweep->total, param->size};
+        sweep->total += param->size;
+    }
+}
+
+// Index of the segment holding element pos of the sweep
+static size_t sweep_find(const OptimizerSweep *sweep, size_t pos) {
+    size_t lo = 0, hi = sweep->num_segments - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (sweep->segments[mid].start <= pos) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+// Calls body for each piece of [begin, end) within one segment, with seg the
+// segment, lo the first element within it and n the piece's length
+#define SWEEP_FOR(sweep, begin, end, body) \
+    for (size_t s_ = sweep_find(sweep, begin); s_ < (sweep)->num_segments && (sweep)->segments[s_].start < (end); s_++) { \
+        const OptimizerSegment *seg = &(sweep)->segments[s_]; \
+        size_t lo = (begin) > seg->start ? (begin) - seg->start : 0; \
+        size_t hi = (end) - seg->start < seg->size ? (end) - seg->start : seg->size; \
+        if (lo >= hi) continue; \
+        size_t n = hi - lo; \
+        body; \
+    }
+
+static void sweep_free(OptimizerSweep *sweep) {
+    free(sweep->segments);
+}
 
 // ====================================================
 // SGD
@@ -38,117 +188,367 @@ static void adam_free_state(void *state, size_t num_parameters);
 
 static void* sgd_init_state(Tensor **parameters, size_t num_parameters, void *params) {
     SGDParams *p = (SGDParams*)params;
-    SGDState *state = malloc(sizeof(SGDState));
+    SGDState *state = calloc(1, sizeof(SGDState));
+    if (!state) return NULL;
     state->learning_rate = p->learning_rate;
     state->momentum = p->momentum;
-    state->velocity = NULL;
-    
-    if (state->momentum > 0.0f) {
-        state->velocity = malloc(num_parameters * sizeof(Tensor*));
-        for (size_t i = 0; i < num_parameters; i++) {
-            state->velocity[i] = tensor_create(parameters[i]->shape, parameters[i]->ndim);
-            tensor_fill(state->velocity[i], 0.0f);
-        }
+
+    int ok = sweep_init(&state->sweep, num_parameters);
+    if (ok && state->momentum > 0.0f) {
+        state->offsets = state_offsets(parameters, num_parameters, 1, &state->total);
+        state->velocity = calloc(state->total ? state->total : 1, sizeof(float));
+        ok = state->offsets && state->velocity;
+    }
+    if (!ok) {
+        sgd_free_state(state, num_parameters);
+        return NULL;
     }
     return state;
 }
 
+static void sgd_update(size_t begin, size_t end, void *arg) {
+    SGDState *state = (SGDState *)arg;
+    const OpKernels *k = optimizer_kernels;
+
+    SWEEP_FOR(&state->sweep, begin, end,
+        k->sgd(seg->data + lo, seg->grad + lo, state->velocity ? state->velocity + seg->offset + lo : NULL,
+               n, state->learning_rate, state->momentum))
+}
+
 static void sgd_step(Optimizer *opt) {
     SGDState *state = (SGDState*)opt->state;
-    for (size_t i = 0; i < opt->num_parameters; i++) {
-        Tensor *param = opt->parameters[i];
-        if (!param->grad) continue;
-        
-        if (state->momentum > 0.0f) {
-            for (size_t j = 0; j < param->size; j++) {
-                state->velocity[i]->data[j] = state->momentum * state->velocity[i]->data[j] 
-                                             - state->learning_rate * param->grad[j];
-                param->data[j] += state->velocity[i]->data[j];
-            }
-        } else {
-            for (size_t j = 0; j < param->size; j++) {
-                param->data[j] -= state->learning_rate * param->grad[j];
-            }
-        }
-    }
+    sweep_build(&state->sweep, opt->parameters, opt->num_parameters, state->offsets, 1);
+    if (state->sweep.total == 0) return;
+
+    parallel_for(0, state->sweep.total, OPTIMIZER_PARALLEL_GRAIN, sgd_update, state);
 }
 
 static void sgd_free_state(void *state, size_t num_parameters) {
+    (void)num_parameters;
     SGDState *s = (SGDState*)state;
-    if (s->velocity) {
-        for (size_t i = 0; i < num_parameters; i++) {
-            tensor_free(s->velocity[i]);
-        }
-        free(s->velocity);
-    }
+    free(s->velocity);
+    free(s->offsets);
+    sweep_free(&s->sweep);
     free(s);
 }
 
+// Velocity only; the learning rate and momentum come from the new config
+static int sgd_save_state(void *state, size_t num_parameters, FILE *file) {
+    (void)num_parameters;
+    SGDState *s = (SGDState*)state;
+    return le_write_u64(file, s->total) && le_write_floats(file, s->velocity, s->total);
+}
+
+static int sgd_load_state(void *state, size_t num_parameters, FILE *file) {
+    (void)num_parameters;
+    SGDState *s = (SGDState*)state;
+    uint64_t total;
+    if (!le_read_u64(file, &total)) return 0;
+    if (total != s->total) {
+        fprintf(stderr, "Error: SGD state holds %llu velocities, expected %zu\n",
+                (unsigned long long)total, s->total);
+        return 0;
+    }
+    return le_read_floats(file, s->velocity, s->total);
+}
+
 // ====================================================
 // ADAM
 // ====================================================
 
-static void* adam_init_state(Tensor **parameters, size_t num_parameters, void *params) {
-    AdamParams *p = (AdamParams*)params;
-    AdamState *state = malloc(sizeof(AdamState));
-    state->learning_rate = p->learning_rate;
-    state->beta1 = p->beta1;
-    state->beta2 = p->beta2;
-    state->epsilon = p->epsilon;
+static AdamState* adam_state_create(Tensor **parameters, size_t num_parameters, AdamMoments moments,
+                                    float learning_rate, float beta1, float beta2, float epsilon, float weight_decay) {
+    AdamState *state = calloc(1, sizeof(AdamState));
+    if (!state) return NULL;
+    state->learning_rate = learning_rate;
+    state->beta1 = beta1;
+    state->beta2 = beta2;
+    state->epsilon = epsilon;
+    state->weight_decay = weight_decay;
     state->t = 0;
-    
-    state->m = malloc(num_parameters * sizeof(Tensor*));
-    state->v = malloc(num_parameters * sizeof(Tensor*));
-    
-    for (size_t i = 0; i < num_parameters; i++) {
-        state->m[i] = tensor_create(parameters[i]->shape, parameters[i]->ndim);
-        state->v[i] = tensor_create(parameters[i]->shape, parameters[i]->ndim);
-        tensor_fill(state->m[i], 0.0f);
-        tensor_fill(state->v[i], 0.0f);
+    state->moments = moments;
+
+    size_t align = moments == ADAM_MOMENTS_8BIT ? ADAM_MOMENT_BLOCK : 1;
+    size_t element = moments == ADAM_MOMENTS_FP32 ? sizeof(float) : moments == ADAM_MOMENTS_BF16 ? sizeof(uint16_t) : 1;
+    size_t total = 0;
+    state->offsets = state_offsets(parameters, num_parameters, align, &total);
+    state->total = total;
+    state->m = calloc(total ? total : 1, element);
+    state->v = calloc(total ? total : 1, element);
+    int ok = sweep_init(&state->sweep, num_parameters) && state->offsets && state->m && state->v;
+    if (ok && moments == ADAM_MOMENTS_8BIT) {
+        state->m_scale = calloc(total / ADAM_MOMENT_BLOCK + 1, sizeof(float));
+        state->v_scale = calloc(total / ADAM_MOMENT_BLOCK + 1, sizeof(float));
+        ok = state->m_scale && state->v_scale;
+    }
+    if (!ok) {
+        adam_free_state(state, num_parameters);
+        return NULL;
     }
     return state;
 }
 
+#define ADAM_INIT(fn, moments) \
+    static void* fn(Tensor **parameters, size_t num_parameters, void *params) { \
+        AdamParams *p = (AdamParams*)params; \
+        return adam_state_create(parameters, num_parameters, moments, p->learning_rate, p->beta1, p->beta2, p->epsilon, 0.0f); \
+    }
+
+#define ADAMW_INIT(fn, moments) \
+    static void* fn(Tensor **parameters, size_t num_parameters, void *params) { \
+        AdamWParams *p = (AdamWParams*)params; \
+        return adam_state_create(parameters, num_parameters, moments, p->learning_rate, p->beta1, p->beta2, p->epsilon, p->weight_decay); \
+    }
+
+ADAM_INIT(adam_init_state, ADAM_MOMENTS_FP32)
+ADAMW_INIT(adamw_init_state, ADAM_MOMENTS_FP32)
+ADAM_INIT(adam_bf16_init_state, ADAM_MOMENTS_BF16)
+ADAMW_INIT(adamw_bf16_init_state, ADAM_MOMENTS_BF16)
+ADAM_INIT(adam_8bit_init_state, ADAM_MOMENTS_8BIT)
+ADAMW_INIT(adamw_8bit_init_state, ADAM_MOMENTS_8BIT)
+
+// Round to nearest even; the moments are always finite
+static inline uint16_t bf16_from_float(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return (uint16_t)(bits >> 16);
+}
+
+static inline float bf16_to_float(uint16_t h) {
+    uint32_t bits = (uint32_t)h << 16;
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Updates n elements whose moments are stored as bf16, a block at a time
+static void adam_update_bf16(const OpKernels *k, float *p, const float *g, uint16_t *m, uint16_t *v,
+                             size_t n, const AdamCoeffs *c) {
+    float mf[ADAM_MOMENT_BLOCK], vf[ADAM_MOMENT_BLOCK];
+    for (size_t b = 0; b < n; b += ADAM_MOMENT_BLOCK) {
+        size_t len = n - b < ADAM_MOMENT_BLOCK ? n - b : ADAM_MOMENT_BLOCK;
+        for (size_t j = 0; j < len; j++) {
+            mf[j] = bf16_to_float(m[b + j]);
+            vf[j] = bf16_to_float(v[b + j]);
+        }
+        k->adam(p + b, g + b, mf, vf, len, c);
+        for (size_t j = 0; j < len; j++) {
+            m[b + j] = bf16_from_float(mf[j]);
+            v[b + j] = bf16_from_float(vf[j]);
+        }
+    }
+}
+
+// 8-bit moments store each element's magnitude relative to its block's
+// maximum as a tiny float: code 0 is zero, code 1 the maximum itself and code
+// c > 1 is (1 + f / 8) * 2^-e with e = 1 + (c - 2) / 8 and f = (c - 2) % 8.
+// m spends a bit on the sign, leaving codes down to 2^-16 of the maximum; v
+// is non-negative and uses all 255, down to 2^-32. Either way every value in
+// range is kept within 6.25%, however small it is next to the maximum
+static float moment_codes[256];
+
+static void moment_codes_init(void) {
+    moment_codes[0] = 0.0f;
+    moment_codes[1] = 1.0f;
+    for (int c = 2; c < 256; c++) {
+        moment_codes[c] = ldexpf(1.0f + (float)((c - 2) % 8) / 8.0f, -(1 + (c - 2) / 8));
+    }
+}
+
+// Nearest code to x in [0, 1], no higher than max_code
+static int moment_encode(float x, int max_code) {
+    if (!(x > 0.0f)) return 0;
+
+    int e;
+    float fraction = frexpf(x, &e);     // x = fraction * 2^e, fraction in [0.5, 1)
+    int exponent = 1 - e;
+    int f = (int)lrintf((2.0f * fraction - 1.0f) * 8.0f);
+    if (f == 8) {
+        f = 0;
+        exponent--;
+    }
+    if (exponent <= 0) return 1;
+
+    int c = 2 + (exponent - 1) * 8 + f;
+    if (c <= max_code) return c;
+
+    // Past the last code: within its octave, round down to it; below that
+    // octave, round to the octave's first code or to zero
+    int last = 2 + (max_code - 2) / 8 * 8;
+    if (c < last + 8) return max_code;
+    return x >= 0.5f * moment_codes[last] ? last : 0;
+}
+
+// Updates n elements whose moments are stored in 8-bit blocks. The update
+// runs on the dequantized floats and each block is requantized against its
+// new maxima; n need not fill the last block
+static void adam_update_8bit(const OpKernels *k, float *p, const float *g, int8_t *m, uint8_t *v,
+                             float *m_scale, float *v_scale, size_t n, const AdamCoeffs *c) {
+    float mf[ADAM_MOMENT_BLOCK], vf[ADAM_MOMENT_BLOCK];
+    for (size_t b = 0; b < n; b += ADAM_MOMENT_BLOCK) {
+        size_t len = n - b < ADAM_MOMENT_BLOCK ? n - b : ADAM_MOMENT_BLOCK;
+        size_t block = b / ADAM_MOMENT_BLOCK;
+
+        float ms = m_scale[block], vs = v_scale[block];
+        for (size_t j = 0; j < len; j++) {
+            int q = m[b + j];
+            mf[j] = q < 0 ? -ms * moment_codes[-q] : ms * moment_codes[q];
+            vf[j] = vs * moment_codes[v[b + j]];
+        }
+
+        k->adam(p + b, g + b, mf, vf, len, c);
+
+        float m_max = 0.0f, v_max = 0.0f;
+        for (size_t j = 0; j < len; j++) {
+            m_max = fmaxf(m_max, fabsf(mf[j]));
+            v_max = fmaxf(v_max, vf[j]);
+        }
+        float m_inv = m_max > 0.0f ? 1.0f / m_max : 0.0f;
+        float v_inv = v_max > 0.0f ? 1.0f / v_max : 0.0f;
+        for (size_t j = 0; j < len; j++) {
+            int q = moment_encode(fabsf(mf[j]) * m_inv, 127);
+            m[b + j] = (int8_t)(mf[j] < 0.0f ? -q : q);
+            v[b + j] = (uint8_t)moment_encode(vf[j] * v_inv, 255);
+        }
+        m_scale[block] = m_max;
+        v_scale[block] = v_max;
+    }
+}
+
+typedef struct {
+    AdamState *state;
+    AdamCoeffs coeffs;
+} AdamTask;
+
+static void adam_update(size_t begin, size_t end, void *arg) {
+    AdamTask *t = (AdamTask *)arg;
+    AdamState *state = t->state;
+    const OpKernels *k = optimizer_kernels;
+
+    // For 8-bit moments, begin and each segment's offset are block-aligned
+    SWEEP_FOR(&state->sweep, begin, end, {
+        float *p = seg->data + lo;
+        const float *g = seg->grad + lo;
+        size_t offset = seg->offset + lo;
+        switch (state->moments) {
+            case ADAM_MOMENTS_FP32:
+                k->adam(p, g, (float *)state->m + offset, (float *)state->v + offset, n, &t->coeffs);
+                break;
+            case ADAM_MOMENTS_BF16:
+                adam_update_bf16(k, p, g, (uint16_t *)state->m + offset, (uint16_t *)state->v + offset, n, &t->coeffs);
+                break;
+            case ADAM_MOMENTS_8BIT:
+                adam_update_8bit(k, p, g, (int8_t *)state->m + offset, (uint8_t *)state->v + offset,
+                                 state->m_scale + offset / ADAM_MOMENT_BLOCK, state->v_scale + offset / ADAM_MOMENT_BLOCK,
+                                 n, &t->coeffs);
+                break;
+        }
+    })
+}
+
 static void adam_step(Optimizer *opt) {
     AdamState *state = (AdamState*)opt->state;
     state->t += 1;
-    
+
+    size_t align = state->moments == ADAM_MOMENTS_8BIT ? ADAM_MOMENT_BLOCK : 1;
+    sweep_build(&state->sweep, opt->parameters, opt->num_parameters, state->offsets, align);
+    if (state->sweep.total == 0) return;
+
     float bias_correction1 = 1.0f - powf(state->beta1, state->t);
     float bias_correction2 = 1.0f - powf(state->beta2, state->t);
-    
-    for (size_t i = 0; i < opt->num_parameters; i++) {
-        Tensor *param = opt->parameters[i];
-        if (!param->grad) continue;
-        
-        for (size_t j = 0; j < param->size; j++) {
-            state->m[i]->data[j] = state->beta1 * state->m[i]->data[j] + (1.0f - state->beta1) * param->grad[j];
-            state->v[i]->data[j] = state->beta2 * state->v[i]->data[j] + (1.0f - state->beta2) * param->grad[j] * param->grad[j];
-            
-            float m_hat = state->m[i]->data[j] / bias_correction1;
-            float v_hat = state->v[i]->data[j] / bias_correction2;
-            param->data[j] -= state->learning_rate * m_hat / (sqrtf(v_hat) + state->epsilon);
-        }
-    }
+
+    AdamTask task = {state, {
+        .beta1 = state->beta1,
+        .beta2 = state->beta2,
+        .one_minus_beta1 = 1.0f - state->beta1,
+        .one_minus_beta2 = 1.0f - state->beta2,
+        .step_size = state->learning_rate / bias_correction1,
+        .inv_sqrt_bc2 = 1.0f / sqrtf(bias_correction2),
+        .epsilon = state->epsilon,
+        .decay = 1.0f - state->learning_rate * state->weight_decay,
+    }};
+    parallel_for(0, state->sweep.total, OPTIMIZER_PARALLEL_GRAIN, adam_update, &task);
 }
 
 static void adam_free_state(void *state, size_t num_parameters) {
+    (void)num_parameters;
     AdamState *s = (AdamState*)state;
-    for (size_t i = 0; i < num_parameters; i++) {
-        tensor_free(s->m[i]);
-        tensor_free(s->v[i]);
-    }
     free(s->m);
     free(s->v);
+    free(s->m_scale);
+    free(s->v_scale);
+    free(s->offsets);
+    sweep_free(&s->sweep);
     free(s);
 }
 
+// Step count and moments in their stored precision, so a resumed run continues
+// bit for bit. The hyperparameters come from the new config
+static int adam_save_state(void *state, size_t num_parameters, FILE *file) {
+    (void)num_parameters;
+    AdamState *s = (AdamState*)state;
+    if (!le_write_u32(file, (uint32_t)s->moments) || !le_write_u64(file, (uint64_t)s->t) ||
+        !le_write_u64(file, s->total)) return 0;
+
+    switch (s->moments) {
+        case ADAM_MOMENTS_FP32:
+            return le_write_floats(file, s->m, s->total) && le_write_floats(file, s->v, s->total);
+        case ADAM_MOMENTS_BF16:
+            return le_write_u16s(file, s->m, s->total) && le_write_u16s(file, s->v, s->total);
+        case ADAM_MOMENTS_8BIT: {
+            size_t blocks = s->total / ADAM_MOMENT_BLOCK;
+            return fwrite(s->m, 1, s->total, file) == s->total && fwrite(s->v, 1, s->total, file) == s->total &&
+                   le_write_floats(file, s->m_scale, blocks) && le_write_floats(file, s->v_scale, blocks);
+        }
+    }
+    return 0;
+}
+
+static int adam_load_state(void *state, size_t num_parameters, FILE *file) {
+    (void)num_parameters;
+    AdamState *s = (AdamState*)state;
+    uint32_t moments;
+    uint64_t t, total;
+    if (!le_read_u32(file, &moments) || !le_read_u64(file, &t) || !le_read_u64(file, &total)) return 0;
+    if (moments != (uint32_t)s->moments || total != s->total || t > INT32_MAX) {
+        fprintf(stderr, "Error: Adam state does not match the optimizer's moment storage or parameters\n");
+        return 0;
+    }
+    s->t = (int)t;
+
+    switch (s->moments) {
+        case ADAM_MOMENTS_FP32:
+            return le_read_floats(file, s->m, s->total) && le_read_floats(file, s->v, s->total);
+        case ADAM_MOMENTS_BF16:
+            return le_read_u16s(file, s->m, s->total) && le_read_u16s(file, s->v, s->total);
+        case ADAM_MOMENTS_8BIT: {
+            size_t blocks = s->total / ADAM_MOMENT_BLOCK;
+            return fread(s->m, 1, s->total, file) == s->total && fread(s->v, 1, s->total, file) == s->total &&
+                   le_read_floats(file, s->m_scale, blocks) && le_read_floats(file, s->v_scale, blocks);
+        }
+    }
+    return 0;
+}
+
 // ====================================================
 // Optimizer Registration
 // ====================================================
 
 void optimizer_register_builtins(void) {
+    moment_codes_init();
     register_optimizer("sgd", sgd_init_state, sgd_step, sgd_free_state);
     register_optimizer("adam", adam_init_state, adam_step, adam_free_state);
+    register_optimizer("adamw", adamw_init_state, adam_step, adam_free_state);
+    register_optimizer("adam_bf16", adam_bf16_init_state, adam_step, adam_free_state);
+    register_optimizer("adamw_bf16", adamw_bf16_init_state, adam_step, adam_free_state);
+    register_optimizer("adam_8bit", adam_8bit_init_state, adam_step, adam_free_state);
+    register_optimizer("adamw_8bit", adamw_8bit_init_state, adam_step, adam_free_state);
+
+    register_optimizer_serializer("sgd", sgd_save_state, sgd_load_state);
+    const char *adams[] = {"adam", "adamw", "adam_bf16", "adamw_bf16", "adam_8bit", "adamw_8bit"};
+    for (size_t i = 0; i < sizeof(adams) / sizeof(adams[0]); i++)
+        register_optimizer_serializer(adams[i], adam_save_state, adam_load_state);
 }
 
 // ====================================================
@@ -173,6 +573,8 @@ Optimizer* optimizer_create(Tensor **parameters, size_t num_parameters, Optimize
     opt->step = step_fn;
     opt->zero_grad = optimizer_zero_grad;
     opt->free_state = free_fn;
+    opt->save_state = get_optimizer_save_state_fn(config.name);
+    opt->load_state = get_optimizer_load_state_fn(config.name);
     opt->state = init_fn(parameters, num_parameters, config.params);
 
     if (!opt->state) {
@@ -184,11 +586,12 @@ Optimizer* optimizer_create(Tensor **parameters, size_t num_parameters, Optimize
     return opt;
 }
 
-
-
 void optimizer_step(Optimizer *opt) {
     if (!opt || !opt->step) return;
     opt->step(opt);
+
+    // Parameters changed in place: stale any copy derived from them
+    for (size_t i = 0; i < opt->num_parameters; i++) opt->parameters[i]->version++;
 }
 
 void optimizer_zero_grad(Optimizer *opt) {
@@ -211,4 +614,82 @@ void optimizer_free(Optimizer *opt) {
     
     if (opt->name) free(opt->name);
     free(opt);
-}
\ No newline at end of file
+}
+
+// ====================================================
+// Optimizer Serialization
+// ====================================================
+
+#define OPTIMIZER_MAGIC 0x504F4462u    // "bDOP" read as little-endian
+#define OPTIMIZER_VERSION 1
+
+int optimizer_write(Optimizer *opt, FILE *file) {
+    if (!opt || !file) return 0;
+    if (!opt->save_state) {
+        fprintf(stderr, "Error: Optimizer %s has no registered serializer\n", opt->name);
+        return 0;
+    }
+
+    uint32_t name_length = (uint32_t)strlen(opt->name);
+    if (!le_write_u32(file, name_length) || fwrite(opt->name, 1, name_length, file) != name_length) return 0;
+    return opt->save_state(opt->state, opt->num_parameters, file);
+}
+
+int optimizer_read(Optimizer *opt, FILE *file) {
+    if (!opt || !file) return 0;
+    if (!opt->load_state) {
+        fprintf(stderr, "Error: Optimizer %s has no registered serializer\n", opt->name);
+        return 0;
+    }
+
+    uint32_t name_length;
+    if (!le_read_u32(file, &name_length)) return 0;
+    if (name_length != strlen(opt->name)) {
+        fprintf(stderr, "Error: Saved optimizer state is not for %s\n", opt->name);
+        return 0;
+    }
+    char name[name_length + 1];
+    if (fread(name, 1, name_length, file) != name_length) return 0;
+    name[name_length] = '\0';
+    if (strcmp(name, opt->name) != 0) {
+        fprintf(stderr, "Error: Saved optimizer state is for %s, not %s\n", name, opt->name);
+        return 0;
+    }
+    return opt->load_state(opt->state, opt->num_parameters, file);
+}
+
+int optimizer_save(Optimizer *opt, const char *path) {
+    if (!opt || !path) return 0;
+
+    char *tmp_path;
+    FILE *file = atomic_file_open(path, &tmp_path);
+    if (!file) {
+        fprintf(stderr, "Error: Could not open file %s for writing\n", path);
+        return 0;
+    }
+    int ok = le_write_u32(file, OPTIMIZER_MAGIC) && le_write_u32(file, OPTIMIZER_VERSION) &&
+             optimizer_write(opt, file);
+    ok = atomic_file_commit(file, tmp_path, path, ok);
+    if (!ok) fprintf(stderr, "Error: Could not write %s\n", path);
+    return ok;
+}
+
+int optimizer_load(Optimizer *opt, const char *path) {
+    if (!opt || !path) return 0;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Could not open file %s for reading\n", path);
+        return 0;
+    }
+    uint32_t magic, version;
+    int ok = le_read_u32(file, &magic) && le_read_u32(file, &version);
+    if (ok && (magic != OPTIMIZER_MAGIC || version != OPTIMIZER_VERSION)) {
+        fprintf(stderr, "Error: %s is not an optimizer state file\n", path);
+        ok = 0;
+    } else if (ok) {
+        ok = optimizer_read(opt, file);
+    }
+    fclose(file);
+    return ok;
+}
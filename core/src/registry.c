@@ -115,18 +115,24 @@ typedef struct {
 static Registry operation_registry = {{NULL}};
 
 void register_operation(const char *name, OpFn op_fn) {
-    register_operation_backend(name, op_fn, 0);
+    register_operation_backend(name, op_fn, BACKEND_PRIORITY_USER);
 }
 
 void register_operation_backend(const char *name, OpFn op_fn, int priority) {
     OperationRegistryEntry *existing = (OperationRegistryEntry*)registry_get(&operation_registry, name);
     
-    if (!existing || priority > existing->priority) {
-        OperationRegistryEntry *entry = malloc(sizeof(OperationRegistryEntry));
-        entry->op_fn = op_fn;
-        entry->priority = priority;
-        registry_set(&operation_registry, name, entry);
+    if (existing) {
+        if (priority >= existing->priority) {
+            existing->op_fn = op_fn;
+            existing->priority = priority;
+        }
+        return;
     }
+
+    OperationRegistryEntry *entry = malloc(sizeof(OperationRegistryEntry));
+    entry->op_fn = op_fn;
+    entry->priority = priority;
+    registry_set(&operation_registry, name, entry);
 }
 
 OpFn get_operation_fn(const char *name) {
@@ -156,6 +162,8 @@ typedef struct {
     OptimizerInitStateFn init_state_fn;
     OptimizerStepFn step_fn;
     OptimizerFreeStateFn free_state_fn;
+    OptimizerSaveStateFn save_state_fn;
+    OptimizerLoadStateFn load_state_fn;
 } OptimizerRegistryEntry;
 
 static Registry optimizer_registry = {{NULL}};
@@ -168,9 +176,23 @@ void register_optimizer(const char *name,
     entry->init_state_fn = init_state_fn;
     entry->step_fn = step_fn;
     entry->free_state_fn = free_state_fn;
+    entry->save_state_fn = NULL;
+    entry->load_state_fn = NULL;
     registry_set(&optimizer_registry, name, entry);
 }
 
+void register_optimizer_serializer(const char *name,
+                                   OptimizerSaveStateFn save_state_fn,
+                                   OptimizerLoadStateFn load_state_fn) {
+    OptimizerRegistryEntry *entry = registry_get(&optimizer_registry, name);
+    if (!entry) {
+        fprintf(stderr, "Error: No optimizer %s to register a serializer for\n", name);
+        return;
+    }
+    entry->save_state_fn = save_state_fn;
+    entry->load_state_fn = load_state_fn;
+}
+
 OptimizerInitStateFn get_optimizer_init_state_fn(const char *name) {
     OptimizerRegistryEntry *entry = registry_get(&optimizer_registry, name);
     return entry ? entry->init_state_fn : NULL;
@@ -186,6 +208,16 @@ OptimizerFreeStateFn get_optimizer_free_state_fn(const char *name) {
     return entry ? entry->free_state_fn : NULL;
 }
 
+OptimizerSaveStateFn get_optimizer_save_state_fn(const char *name) {
+    OptimizerRegistryEntry *entry = registry_get(&optimizer_registry, name);
+    return entry ? entry->save_state_fn : NULL;
+}
+
+OptimizerLoadStateFn get_optimizer_load_state_fn(const char *name) {
+    OptimizerRegistryEntry *entry = registry_get(&optimizer_registry, name);
+    return entry ? entry->load_state_fn : NULL;
+}
+
 // ====================================================
 // Registry Initialization
 // ====================================================
@@ -194,9 +226,12 @@ void registry_init() {
     layer_register_builtins();
     ops_register_builtins();
     optimizer_register_builtins();
+    threadpool_init(0);
 }
 
 void registry_cleanup() {
+    threadpool_shutdown();
+
     for (int i = 0; i < REGISTRY_SIZE; i++) {
         RegistryEntry *entry = layer_registry.buckets[i];
         while (entry) {
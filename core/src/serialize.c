@@ -0,0 +1,201 @@
+#include "serialize.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+// ====================================================
+// Streams
+// ====================================================
+
+#define SWAP_CHUNK 1024
+
+static uint32_t float_bits(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+int le_write_floats(FILE *file, const float *data, size_t n) {
+    if (host_is_little_endian()) return fwrite(data, sizeof(float), n, file) == n;
+
+    unsigned char buf[SWAP_CHUNK * 4];
+    for (size_t i = 0; i < n; i += SWAP_CHUNK) {
+        size_t len = n - i < SWAP_CHUNK ? n - i : SWAP_CHUNK;
+        for (size_t j = 0; j < len; j++) le_put_u32(buf + 4 * j, float_bits(data[i + j]));
+        if (fwrite(buf, 4, len, file) != len) return 0;
+    }
+    return 1;
+}
+
+int le_read_floats(FILE *file, float *data, size_t n) {
+    if (host_is_little_endian()) return fread(data, sizeof(float), n, file) == n;
+
+    unsigned char buf[SWAP_CHUNK * 4];
+    for (size_t i = 0; i < n; i += SWAP_CHUNK) {
+        size_t len = n - i < SWAP_CHUNK ? n - i : SWAP_CHUNK;
+        if (fread(buf, 4, len, file) != len) return 0;
+        for (size_t j = 0; j < len; j++) {
+            uint32_t bits = le_get_u32(buf + 4 * j);
+            memcpy(&data[i + j], &bits, sizeof(float));
+        }
+    }
+    return 1;
+}
+
+void le_store_floats(unsigned char *dst, const float *src, size_t n) {
+    if (host_is_little_endian()) {
+        memcpy(dst, src, n * sizeof(float));
+        return;
+    }
+    for (size_t i = 0; i < n; i++) le_put_u32(dst + 4 * i, float_bits(src[i]));
+}
+
+int le_write_u16s(FILE *file, const uint16_t *data, size_t n) {
+    if (host_is_little_endian()) return fwrite(data, sizeof(uint16_t), n, file) == n;
+
+    unsigned char buf[SWAP_CHUNK * 2];
+    for (size_t i = 0; i < n; i += SWAP_CHUNK) {
+        size_t len = n - i < SWAP_CHUNK ? n - i : SWAP_CHUNK;
+        for (size_t j = 0; j < len; j++) {
+            buf[2 * j] = (unsigned char)data[i + j];
+            buf[2 * j + 1] = (unsigned char)(data[i + j] >> 8);
+        }
+        if (fwrite(buf, 2, len, file) != len) return 0;
+    }
+    return 1;
+}
+
+int le_read_u16s(FILE *file, uint16_t *data, size_t n) {
+    if (host_is_little_endian()) return fread(data, sizeof(uint16_t), n, file) == n;
+
+    unsigned char buf[SWAP_CHUNK * 2];
+    for (size_t i = 0; i < n; i += SWAP_CHUNK) {
+        size_t len = n - i < SWAP_CHUNK ? n - i : SWAP_CHUNK;
+        if (fread(buf, 2, len, file) != len) return 0;
+        for (size_t j = 0; j < len; j++) data[i + j] = (uint16_t)(buf[2 * j] | (buf[2 * j + 1] << 8));
+    }
+    return 1;
+}
+
+int le_write_u32(FILE *file, uint32_t v) {
+    unsigned char buf[4];
+    le_put_u32(buf, v);
+    return fwrite(buf, 1, 4, file) == 4;
+}
+
+int le_write_u64(FILE *file, uint64_t v) {
+    unsigned char buf[8];
+    le_put_u64(buf, v);
+    return fwrite(buf, 1, 8, file) == 8;
+}
+
+int le_read_u32(FILE *file, uint32_t *v) {
+    unsigned char buf[4];
+    if (fread(buf, 1, 4, file) != 4) return 0;
+    *v = le_get_u32(buf);
+    return 1;
+}
+
+int le_read_u64(FILE *file, uint64_t *v) {
+    unsigned char buf[8];
+    if (fread(buf, 1, 8, file) != 8) return 0;
+    *v = le_get_u64(buf);
+    return 1;
+}
+
+int write_padding(FILE *file, uint64_t align) {
+    static const unsigned char zeros[64] = {0};
+    long pos = ftell(file);
+    if (pos < 0) return 0;
+
+    uint64_t pad = align_up((uint64_t)pos, align) - (uint64_t)pos;
+    while (pad > 0) {
+        size_t len = pad < sizeof(zeros) ? (size_t)pad : sizeof(zeros);
+        if (fwrite(zeros, 1, len, file) != len) return 0;
+        pad -= len;
+    }
+    return 1;
+}
+
+// ====================================================
+// Atomic Files
+// ====================================================
+
+// umask can only be read by setting it, which races with files other threads
+// create meanwhile, so it is read once
+static mode_t process_umask;
+static pthread_once_t umask_once = PTHREAD_ONCE_INIT;
+
+static void read_umask(void) {
+    process_umask = umask(0);
+    umask(process_umask);
+}
+
+// Mode for the new file at path: that of the file it replaces, if any,
+// otherwise what fopen would create
+static mode_t atomic_file_mode(const char *path) {
+    struct stat st;
+    if (stat(path, &st) == 0) return st.st_mode & 07777;
+    pthread_once(&umask_once, read_umask);
+    return 0666 & ~process_umask;
+}
+
+FILE* atomic_file_open(const char *path, char **tmp_path) {
+    size_t len = strlen(path);
+    char *tmp = malloc(len + 8);
+    if (!tmp) return NULL;
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".XXXXXX", 8);
+
+    // A fresh name per call, so overlapping saves to one path never share a
+    // temporary. mkstemp creates it 0600
+    int fd = mkstemp(tmp);
+    if (fd < 0) {
+        free(tmp);
+        return NULL;
+    }
+    FILE *file = fchmod(fd, atomic_file_mode(path)) == 0 ? fdopen(fd, "wb") : NULL;
+    if (!file) {
+        close(fd);
+        remove(tmp);
+        free(tmp);
+        return NULL;
+    }
+    *tmp_path = tmp;
+    return file;
+}
+
+// Makes the rename itself durable; best effort, as some filesystems refuse
+// to open directories
+static void sync_parent_directory(const char *path) {
+    const char *slash = strrchr(path, '/');
+    char dir[slash ? (size_t)(slash - path) + 2 : 2];
+    if (!slash) {
+        strcpy(dir, ".");
+    } else {
+        size_t len = slash == path ? 1 : (size_t)(slash - path);
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+int atomic_file_commit(FILE *file, char *tmp_path, const char *path, int ok) {
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (fclose(file) == 0) && ok;
+    if (ok) ok = rename(tmp_path, path) == 0;
+    if (ok) {
+        sync_parent_directory(path);
+    } else {
+        remove(tmp_path);
+    }
+    free(tmp_path);
+    return ok;
+}
@@ -0,0 +1,81 @@
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stddef.h>
+
+// ====================================================
+// Little-Endian Encoding
+// ====================================================
+
+// Checkpoint fields are fixed-width and little-endian whatever the host
+static inline void le_put_u32(unsigned char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline void le_put_u64(unsigned char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline uint32_t le_get_u32(const unsigned char *p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static inline uint64_t le_get_u64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static inline int host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char *)&probe == 1;
+}
+
+static inline uint64_t align_up(uint64_t n, uint64_t align) {
+    return (n + align - 1) / align * align;
+}
+
+// ====================================================
+// Streams
+// ====================================================
+
+// n floats as little-endian IEEE 754; 0 on a short read or write. Little-endian
+// hosts move them in one call, others byte-swap through a small buffer
+int le_write_floats(FILE *file, const float *data, size_t n);
+int le_read_floats(FILE *file, float *data, size_t n);
+
+// The same for 16-bit values (bf16 payloads)
+int le_write_u16s(FILE *file, const uint16_t *data, size_t n);
+int le_read_u16s(FILE *file, uint16_t *data, size_t n);
+
+// n floats into a little-endian byte image, for payloads staged in memory
+void le_store_floats(unsigned char *dst, const float *src, size_t n);
+
+// Single fixed-width fields
+int le_write_u32(FILE *file, uint32_t v);
+int le_write_u64(FILE *file, uint64_t v);
+int le_read_u32(FILE *file, uint32_t *v);
+int le_read_u64(FILE *file, uint64_t *v);
+
+// Writes zero bytes until the file position is a multiple of align
+int write_padding(FILE *file, uint64_t align);
+
+// ====================================================
+// Atomic Files
+// ====================================================
+
+// Writes go to a temporary named path + ".XXXXXX", unique per call so that
+// overlapping saves to one path never share it. atomic_file_commit flushes
+// and fsyncs it, then renames it over path, so a crash at any point leaves
+// either the previous file or one complete new one. Pass ok = 0 after a
+// failed write to discard the temporary instead. Commit closes file, frees
+// tmp_path and returns 1 once path holds the new contents. The new file keeps
+// the mode of the one it replaces, or gets fopen's (0666 less the umask)
+FILE* atomic_file_open(const char *path, char **tmp_path);
+int atomic_file_commit(FILE *file, char *tmp_path, const char *path, int ok);
+
+#endif
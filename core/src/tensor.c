@@ -1,72 +1,258 @@
 #include "../include/tensor.h"
+#include "../include/arena.h"
 #include <stdlib.h> 
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 
 // ====================================================
-// TopoSort
+// Gradient Tape
 // ====================================================
 
-static void topological_sort_util(Tensor *T, Tensor **visited, size_t *visited_count, Tensor **stack, size_t *stack_count, size_t max_size) {
-    for (size_t i = 0; i < *visited_count; i++) {
-        if (visited[i] == T) return; 
+#define TAPE_NONE ((size_t)-1)
+#define TAPE_INITIAL_CAPACITY 1024
+
+// saved_versions entry for an output its producer released (see tensor_release_output)
+#define VERSION_UNSAVED ((size_t)-1)
+
+// Recorded ops in execution order. Any op's inputs were recorded before it,
+// so walking the tape backwards visits the graph in reverse topological order.
+// Entries of freed tensors are set to NULL; marks hold the epoch of the last
+// backward pass that reached each entry.
+static Tensor **tape_nodes = NULL;
+static size_t *tape_marks = NULL;
+static size_t tape_len = 0;
+static size_t tape_live = 0;
+static size_t tape_cap = 0;
+static size_t tape_epoch = 0;
+
+static int grad_enabled = 1;
+
+static int tape_contains(Tensor *T) {
+    return T->tape_index < tape_len && tape_nodes[T->tape_index] == T;
+}
+
+static void tape_compact(void) {
+    size_t j = 0;
+    for (size_t i = 0; i < tape_len; i++) {
+        if (!tape_nodes[i]) continue;
+        tape_nodes[j] = tape_nodes[i];
+        tape_marks[j] = tape_marks[i];
+        tape_nodes[j]->tape_index = j;
+        j++;
     }
+    tape_len = j;
+}
 
-    visited[(*visited_count)++] = T; 
+static void tape_push(Tensor *T) {
+    if (tape_len == tape_cap && tape_live <= tape_len / 2) tape_compact();
+
+    if (tape_len == tape_cap) {
+        size_t cap = tape_cap ? tape_cap * 2 : TAPE_INITIAL_CAPACITY;
+        Tensor **nodes = (Tensor **)realloc(tape_nodes, cap * sizeof(Tensor *));
+        if (!nodes) return;
+        tape_nodes = nodes;
+        size_t *marks = (size_t *)realloc(tape_marks, cap * sizeof(size_t));
+        if (!marks) return;
+        tape_marks = marks;
+        tape_cap = cap;
+    }
 
-    if (T->inputs) {
-        for (size_t i = 0; i < T->num_inputs; i++) {
-            if (T->inputs[i] && T->inputs[i]->requires_grad) {
-                topological_sort_util(T->inputs[i], visited, visited_count, stack, stack_count, max_size); 
+    T->tape_index = tape_len;
+    tape_nodes[tape_len] = T;
+    tape_marks[tape_len] = 0;
+    tape_len++;
+    tape_live++;
+}
+
+static void tape_remove(Tensor *T) {
+    if (!tape_contains(T)) return;
+
+    tape_nodes[T->tape_index] = NULL;
+    tape_live--;
+    while (tape_len > 0 && !tape_nodes[tape_len - 1]) tape_len--;
+}
+
+void tensor_tape_clear(void) {
+    tape_len = 0;
+    tape_live = 0;
+}
+
+size_t tensor_tape_size(void) {
+    return tape_live;
+}
+
+void tensor_tape_free(void) {
+    free(tape_nodes);
+    free(tape_marks);
+    tape_nodes = NULL;
+    tape_marks = NULL;
+    tape_len = tape_live = tape_cap = 0;
+}
+
+// ====================================================
+// Graph Traversal
+// ====================================================
+
+// 0 (with a message) if an in-place op has overwritten an input T's backward
+// pass reads, or T's own output when its op saved it
+static int versions_intact(Tensor *T) {
+    if (!T->saved_versions || !T->backward_fn) return 1;
+
+    for (size_t i = 0; i < T->num_inputs; i++) {
+        if (T->inputs[i] && T->inputs[i]->version != T->saved_versions[i]) {
+            fprintf(stderr, "tensor_backward: input %zu of '%s' was modified in place after it was saved\n",
+                    i, T->op_name ? T->op_name : "?");
+            return 0;
+        }
+    }
+
+    size_t own = T->saved_versions[T->num_inputs];
+    if (own != VERSION_UNSAVED && own != T->version) {
+        fprintf(stderr, "tensor_backward: output of '%s' was modified in place after it was saved\n",
+                T->op_name ? T->op_name : "?");
+        return 0;
+    }
+    return 1;
+}
+
+// Fallback for graphs containing nodes that were wired up by hand instead of
+// through tensor_record_op: iterative DFS producing a post-order of the graph
+static void backward_graph(Tensor *root, size_t epoch) {
+    size_t cap = 256, stack_len = 0, order_len = 0;
+    Tensor **stack = (Tensor **)malloc(cap * sizeof(Tensor *));
+    size_t *next = (size_t *)malloc(cap * sizeof(size_t));
+    Tensor **order = (Tensor **)malloc(cap * sizeof(Tensor *));
+    size_t order_cap = cap;
+    if (!stack || !next || !order) goto cleanup;
+
+    root->backward_mark = epoch;
+    stack[stack_len] = root;
+    next[stack_len++] = 0;
+
+    while (stack_len > 0) {
+        Tensor *node = stack[stack_len - 1];
+        size_t i = next[stack_len - 1]++;
+
+        if (node->inputs && i < node->num_inputs) {
+            Tensor *input = node->inputs[i];
+            if (!input || !input->requires_grad || input->backward_mark == epoch) continue;
+            input->backward_mark = epoch;
+
+            if (stack_len == cap) {
+                cap *= 2;
+                Tensor **s = (Tensor **)realloc(stack, cap * sizeof(Tensor *));
+                if (s) stack = s;
+                size_t *n = (size_t *)realloc(next, cap * sizeof(size_t));
+                if (n) next = n;
+                if (!s || !n) goto cleanup;
             }
+            stack[stack_len] = input;
+            next[stack_len++] = 0;
+            continue;
+        }
+
+        if (order_len == order_cap) {
+            order_cap *= 2;
+            Tensor **o = (Tensor **)realloc(order, order_cap * sizeof(Tensor *));
+            if (!o) goto cleanup;
+            order = o;
         }
+        order[order_len++] = node;
+        stack_len--;
+    }
+
+    for (size_t i = 0; i < order_len; i++) {
+        if (!versions_intact(order[i])) goto cleanup;
     }
 
-    if (*stack_count < max_size) {
-        stack[(*stack_count)++] = T;
+    for (size_t i = order_len; i > 0; i--) {
+        if (order[i - 1]->backward_fn) order[i - 1]->backward_fn(order[i - 1]);
     }
+
+cleanup:
+    free(stack);
+    free(next);
+    free(order);
 }
 
 // ====================================================
 // Tensor Creation and Destruction
 // ====================================================
 
-Tensor* tensor_create(size_t *shape, size_t ndim) {
-    Tensor *T = (Tensor *)malloc(sizeof(Tensor)); 
+// Allocates from the active arena when there is one, otherwise from the heap
+static void* tensor_alloc(size_t size) {
+    Arena *arena = arena_get_active();
+    return arena ? arena_alloc(arena, size) : malloc(size);
+}
+
+static void tensor_init_fields(Tensor *T) {
+    T->grad = NULL; 
+    T->requires_grad = 0;
+    T->owns_data = 1;
+    T->op_name = NULL;
+    T->inputs = NULL;
+    T->num_inputs = 0;
+    T->backward_fn = NULL;
+    T->extra_data = NULL;
+    T->arena = arena_get_active();
+    T->tape_index = TAPE_NONE;
+    T->backward_mark = 0;
+    T->version = 0;
+    T->saved_versions = NULL;
+    T->replaced = NULL;
+}
+
+static Tensor* tensor_alloc_header(size_t *shape, size_t ndim) {
+    Tensor *T = (Tensor *)tensor_alloc(sizeof(Tensor)); 
     if (!T) return NULL; 
 
+    // Shape and strides share one allocation
     T->ndim = ndim; 
-    T->shape = (size_t *)malloc(ndim * sizeof(size_t)); 
+    T->shape = (size_t *)tensor_alloc(2 * ndim * sizeof(size_t)); 
     if (!T->shape) {
-        free(T);
+        if (!arena_get_active()) free(T);
         return NULL;
     }
+    T->strides = T->shape + ndim;
 
     T->size = 1; 
-    for (size_t i = 0; i < ndim; i++) {
-        T->shape[i] = shape[i]; 
-        T->size *= shape[i]; 
+    for (size_t i = ndim; i > 0; i--) {
+        T->shape[i - 1] = shape[i - 1]; 
+        T->strides[i - 1] = T->size;
+        T->size *= shape[i - 1]; 
     }
 
-    T->data = (float *)malloc(T->size * sizeof(float)); 
+    T->data = NULL;
+    tensor_init_fields(T);
+    return T;
+}
+
+Tensor* tensor_create(size_t *shape, size_t ndim) {
+    Tensor *T = tensor_alloc_header(shape, ndim);
+    if (!T) return NULL; 
+
+    T->data = (float *)tensor_alloc(T->size * sizeof(float)); 
     if (!T->data) {
-        free(T->shape);
-        free(T);
+        if (!T->arena) {
+            free(T->shape);
+            free(T);
+        }
         return NULL;
     }
 
-    T->grad = NULL; 
-    T->requires_grad = 0;
-    T->owns_data = 1;
-    T->op_name = NULL;
-    T->inputs = NULL;
-    T->num_inputs = 0;
-    T->backward_fn = NULL;
-    T->extra_data = NULL;
     return T; 
 }
 
+Tensor* tensor_wrap(size_t *shape, size_t ndim, float *data) {
+    Tensor *T = tensor_alloc_header(shape, ndim);
+    if (!T) return NULL;
+
+    T->data = data;
+    T->owns_data = 0;
+    return T;
+}
+
 Tensor* tensor_zeroes(size_t *shape, size_t ndim) {
     Tensor *T = tensor_create(shape, ndim); 
     if (!T) return NULL; 
@@ -101,13 +287,18 @@ Tensor* tensor_randn(size_t *shape, size_t ndim, int seed) {
 void tensor_free(Tensor *T) {
     if (!T) return; 
 
-    if (T->owns_data) {
-        if (T->data) free(T->data); 
-        if (T->grad) free(T->grad); 
-    }
+    tape_remove(T);
+    tensor_free(T->replaced);
+
+    // Arena tensors are reclaimed together by arena_reset
+    if (T->arena) return;
+
+    if (T->owns_data && T->data) free(T->data); 
+    if (T->grad) free(T->grad); 
 
     if (T->shape) free(T->shape); 
     if (T->inputs) free(T->inputs); 
+    if (T->saved_versions) free(T->saved_versions);
     if (T->extra_data) free(T->extra_data);
     if (T->op_name) free(T->op_name);
 
@@ -126,33 +317,207 @@ void tensor_set_requires_grad(Tensor *T, int requires_grad) {
     }
 }
 
+int tensor_set_grad_enabled(int enabled) {
+    int previous = grad_enabled;
+    grad_enabled = enabled;
+    return previous;
+}
+
+int tensor_is_grad_enabled(void) {
+    return grad_enabled;
+}
+
+float* tensor_ensure_grad(Tensor *T) {
+    if (!T) return NULL;
+    if (T->grad) return T->grad;
+
+    if (T->arena) {
+        T->grad = (float *)arena_alloc(T->arena, T->size * sizeof(float));
+        if (T->grad) memset(T->grad, 0, T->size * sizeof(float));
+    } else {
+        T->grad = (float *)calloc(T->size, sizeof(float));
+    }
+    return T->grad;
+}
+
+void tensor_record_op(Tensor *T, Tensor **inputs, size_t num_inputs, const char *op_name, void (*backward_fn)(Tensor *)) {
+    if (!T || !grad_enabled) return;
+
+    int requires_grad = 0;
+    for (size_t i = 0; i < num_inputs; i++) {
+        if (inputs[i] && inputs[i]->requires_grad) requires_grad = 1;
+    }
+    if (!requires_grad) return;
+
+    T->requires_grad = 1;
+    T->num_inputs = num_inputs;
+    T->backward_fn = backward_fn;
+
+    if (T->arena) {
+        T->inputs = (Tensor **)arena_alloc(T->arena, num_inputs * sizeof(Tensor *));
+        T->saved_versions = (size_t *)arena_alloc(T->arena, (num_inputs + 1) * sizeof(size_t));
+        if (op_name) {
+            size_t len = strlen(op_name) + 1;
+            T->op_name = (char *)arena_alloc(T->arena, len);
+            if (T->op_name) memcpy(T->op_name, op_name, len);
+        }
+    } else {
+        T->inputs = (Tensor **)malloc(num_inputs * sizeof(Tensor *));
+        T->saved_versions = (size_t *)malloc((num_inputs + 1) * sizeof(size_t));
+        T->op_name = op_name ? strdup(op_name) : NULL;
+    }
+
+    if (T->inputs) {
+        memcpy(T->inputs, inputs, num_inputs * sizeof(Tensor *));
+    } else {
+        T->num_inputs = 0;
+    }
+
+    if (T->saved_versions) {
+        for (size_t i = 0; i < T->num_inputs; i++) {
+            T->saved_versions[i] = inputs[i] ? inputs[i]->version : 0;
+        }
+        // Until the producer releases it, assume backward reads the output
+        T->saved_versions[T->num_inputs] = T->version;
+    }
+
+    tape_push(T);
+}
+
 void tensor_backward(Tensor *T) {
     if (!T || !T->requires_grad) return; 
 
     if (!T->grad) {
-        T->grad = (float *)malloc(T->size * sizeof(float)); 
+        tensor_ensure_grad(T);
+        if (!T->grad) return;
         for (size_t i = 0; i < T->size; i++) {
             T->grad[i] = 1.0f; 
         }
     }
 
-    size_t max_size = 1000; 
-    Tensor **visited = (Tensor **)malloc(max_size * sizeof(Tensor *)); 
-    Tensor **stack = (Tensor **)malloc(max_size * sizeof(Tensor *));
-    size_t visited_count = 0;
-    size_t stack_count = 0;
+    size_t epoch = ++tape_epoch;
+    if (!tape_contains(T)) {
+        backward_graph(T, epoch);
+        return;
+    }
 
-    topological_sort_util(T, visited, &visited_count, stack, &stack_count, max_size); 
+    // Mark everything reachable from T. Inputs always sit earlier on the tape,
+    // so one reverse sweep settles every mark before it is read.
+    tape_marks[T->tape_index] = epoch;
+    for (size_t i = T->tape_index + 1; i > 0; i--) {
+        if (tape_marks[i - 1] != epoch) continue;
+        Tensor *node = tape_nodes[i - 1];
+        if (!node || !node->inputs) continue;
+
+        for (size_t j = 0; j < node->num_inputs; j++) {
+            Tensor *input = node->inputs[j];
+            if (!input || !input->requires_grad) continue;
+
+            if (tape_contains(input)) {
+                tape_marks[input->tape_index] = epoch;
+            } else if (input->backward_fn) {
+                backward_graph(T, ++tape_epoch);
+                return;
+            }
+        }
+    }
+
+    // Nothing runs unless every pass has the values it needs
+    for (size_t i = T->tape_index + 1; i > 0; i--) {
+        Tensor *node = tape_nodes[i - 1];
+        if (tape_marks[i - 1] == epoch && node && !versions_intact(node)) return;
+    }
 
-    for (size_t i = stack_count; i > 0; i--) {
-        Tensor *node = stack[i - 1]; 
-        if (node->backward_fn) {
+    for (size_t i = T->tape_index + 1; i > 0; i--) {
+        Tensor *node = tape_nodes[i - 1];
+        if (tape_marks[i - 1] == epoch && node && node->backward_fn) {
             node->backward_fn(node);
         }
     }
+}
+
+// ====================================================
+// In-Place Operations
+// ====================================================
+
+void tensor_save_output(Tensor *T) {
+    if (T && T->saved_versions) T->saved_versions[T->num_inputs] = T->version;
+}
+
+void tensor_release_output(Tensor *T) {
+    if (T && T->saved_versions) T->saved_versions[T->num_inputs] = VERSION_UNSAVED;
+}
+
+static void* tensor_alloc_like(Tensor *T, size_t size) {
+    return T->arena ? arena_alloc(T->arena, size) : malloc(size);
+}
+
+Tensor* tensor_begin_inplace(Tensor *T, Tensor *other, int keep_value) {
+    if (!T) return NULL;
+
+    int is_leaf = !T->backward_fn && T->num_inputs == 0;
+    if (T->requires_grad && (is_leaf || !T->owns_data)) {
+        fprintf(stderr, "tensor_begin_inplace: %s that requires grad cannot be modified in place\n",
+                is_leaf ? "a leaf tensor" : "a view");
+        return NULL;
+    }
+
+    int track = grad_enabled && (T->requires_grad || (other && other->requires_grad));
+    if (!track) {
+        T->version++;
+        return T;
+    }
+
+    Tensor *prev = (Tensor *)tensor_alloc_like(T, sizeof(Tensor));
+    if (!prev) return NULL;
+    *prev = *T;
+
+    prev->shape = (size_t *)tensor_alloc_like(T, 2 * T->ndim * sizeof(size_t));
+    if (prev->shape) memcpy(prev->shape, T->shape, 2 * T->ndim * sizeof(size_t));
+    prev->strides = prev->shape ? prev->shape + T->ndim : NULL;
+
+    prev->owns_data = 0;
+    if (keep_value) {
+        prev->data = (float *)tensor_alloc_like(T, T->size * sizeof(float));
+        prev->owns_data = 1;
+        if (prev->data) memcpy(prev->data, T->data, T->size * sizeof(float));
+    }
+
+    if (!prev->shape || !prev->data) {
+        if (!T->arena) {
+            free(prev->shape);
+            if (keep_value) free(prev->data);
+            free(prev);
+        }
+        return NULL;
+    }
+
+    // prev takes T's place in the graph and on the tape; T starts over as the
+    // output of the in-place op
+    if (tape_contains(T)) tape_nodes[T->tape_index] = prev;
+    T->grad = NULL;
+    T->requires_grad = 0;
+    T->op_name = NULL;
+    T->inputs = NULL;
+    T->num_inputs = 0;
+    T->backward_fn = NULL;
+    T->extra_data = NULL;
+    T->tape_index = TAPE_NONE;
+    T->saved_versions = NULL;
+    T->replaced = prev;
 
-    free(visited); 
-    free(stack); 
+    // An alias sees the overwrite, so its version moves with T's
+    T->version++;
+    if (!keep_value) prev->version = T->version;
+
+    return prev;
+}
+
+int tensor_inplace_safe(Tensor *T) {
+    if (!T || !T->owns_data) return 0;
+    if (T->requires_grad && !T->backward_fn && T->num_inputs == 0) return 0;
+    if (!T->backward_fn) return 1;
+    return T->saved_versions && T->saved_versions[T->num_inputs] == VERSION_UNSAVED;
 }
 
 void tensor_zero_grad(Tensor *T) {
@@ -167,6 +532,53 @@ void tensor_fill(Tensor *T, float value) {
     }
 }
 
+// ====================================================
+// Memory Layout
+// ====================================================
+
+int tensor_is_contiguous(Tensor *T) {
+    if (!T) return 0;
+
+    size_t expected = 1;
+    for (size_t i = T->ndim; i > 0; i--) {
+        if (T->shape[i - 1] != 1 && T->strides[i - 1] != expected) return 0;
+        expected *= T->shape[i - 1];
+    }
+    return 1;
+}
+
+void tensor_gather(Tensor *T, float *out) {
+    if (!T || !out) return;
+
+    if (tensor_is_contiguous(T)) {
+        memcpy(out, T->data, T->size * sizeof(float));
+        return;
+    }
+    if (T->size == 0) return;
+
+    // Walk the logical index like an odometer over the innermost dimension
+    size_t ndim = T->ndim;
+    size_t inner = T->shape[ndim - 1];
+    size_t inner_stride = T->strides[ndim - 1];
+    size_t index[ndim];
+    memset(index, 0, sizeof(index));
+
+    size_t offset = 0;
+    for (size_t n = 0; n < T->size; n += inner) {
+        const float *src = T->data + offset;
+        for (size_t j = 0; j < inner; j++) {
+            out[n + j] = src[j * inner_stride];
+        }
+
+        for (size_t d = ndim - 1; d > 0; d--) {
+            offset += T->strides[d - 1];
+            if (++index[d - 1] < T->shape[d - 1]) break;
+            offset -= index[d - 1] * T->strides[d - 1];
+            index[d - 1] = 0;
+        }
+    }
+}
+
 // ====================================================
 // Utilities
 // ====================================================
@@ -174,6 +586,13 @@ void tensor_fill(Tensor *T, float value) {
 void tensor_print(Tensor *T) {
     if (!T) return;
 
+    if (!tensor_is_contiguous(T)) {
+        Tensor *C = tensor_copy(T);
+        tensor_print(C);
+        tensor_free(C);
+        return;
+    }
+
     printf("Tensor(shape=[");
     for (size_t i = 0; i < T->ndim; i++) {
         printf("%zu", T->shape[i]);
@@ -213,16 +632,7 @@ Tensor* tensor_copy(Tensor *T) {
     Tensor *C = tensor_create(T->shape, T->ndim);
     if (!C) return NULL;
 
-    memcpy(C->data, T->data, T->size * sizeof(float));
-
-    C->grad = NULL; 
-    C->requires_grad = 0;
-    C->owns_data = 1; 
-    C->op_name = NULL;
-    C->inputs = NULL;
-    C->num_inputs = 0;
-    C->backward_fn = NULL;
-    C->extra_data = NULL;
+    tensor_gather(T, C->data);
 
     return C;
 }
\ No newline at end of file
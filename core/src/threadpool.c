@@ -0,0 +1,349 @@
+#include "../include/threadpool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define DEQUE_INITIAL_CAPACITY 64
+
+// ====================================================
+// Work-Stealing Deques
+// ====================================================
+
+typedef struct {
+    TaskFn fn;
+    void *arg;
+    TaskGroup *group;
+} Task;
+
+// The owning thread pushes and pops at the bottom; other threads steal from
+// the top, so thieves take the oldest (usually largest) pieces of work
+typedef struct {
+    pthread_mutex_t lock;
+    Task *tasks;
+    size_t capacity;
+    size_t top;
+    size_t bottom;
+} Deque;
+
+struct TaskGroup {
+    size_t pending;
+};
+
+static int deque_init(Deque *dq) {
+    dq->tasks = (Task *)malloc(DEQUE_INITIAL_CAPACITY * sizeof(Task));
+    if (!dq->tasks) return 0;
+    dq->capacity = DEQUE_INITIAL_CAPACITY;
+    dq->top = 0;
+    dq->bottom = 0;
+    pthread_mutex_init(&dq->lock, NULL);
+    return 1;
+}
+
+static void deque_destroy(Deque *dq) {
+    pthread_mutex_destroy(&dq->lock);
+    free(dq->tasks);
+}
+
+static int deque_push(Deque *dq, Task task) {
+    pthread_mutex_lock(&dq->lock);
+
+    if (dq->bottom == dq->capacity) {
+        size_t count = dq->bottom - dq->top;
+        if (dq->top > 0) {
+            memmove(dq->tasks, dq->tasks + dq->top, count * sizeof(Task));
+        }
+        if (count == dq->capacity) {
+            Task *tasks = (Task *)realloc(dq->tasks, 2 * dq->capacity * sizeof(Task));
+            if (!tasks) {
+                dq->top = 0;
+                dq->bottom = count;
+                pthread_mutex_unlock(&dq->lock);
+                return 0;
+            }
+            dq->tasks = tasks;
+            dq->capacity *= 2;
+        }
+        dq->top = 0;
+        dq->bottom = count;
+    }
+
+    dq->tasks[dq->bottom++] = task;
+    pthread_mutex_unlock(&dq->lock);
+    return 1;
+}
+
+static int deque_pop(Deque *dq, Task *task) {
+    pthread_mutex_lock(&dq->lock);
+    int found = dq->bottom > dq->top;
+    if (found) {
+        *task = dq->tasks[--dq->bottom];
+        if (dq->bottom == dq->top) dq->top = dq->bottom = 0;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+static int deque_steal(Deque *dq, Task *task) {
+    pthread_mutex_lock(&dq->lock);
+    int found = dq->bottom > dq->top;
+    if (found) {
+        *task = dq->tasks[dq->top++];
+        if (dq->bottom == dq->top) dq->top = dq->bottom = 0;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return found;
+}
+
+// ====================================================
+// Pool State
+// ====================================================
+
+typedef struct {
+    size_t num_threads;
+    size_t num_deques;
+    pthread_t *threads;
+    Deque *deques;             // One per thread; slot 0 belongs to outside threads
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake;
+    size_t queued;             // Tasks sitting in any deque
+    int shutdown;
+} ThreadPool;
+
+static ThreadPool *pool = NULL;
+static size_t requested_threads = 0;
+static __thread size_t thread_index = 0;
+
+static size_t default_num_threads(void) {
+    if (requested_threads > 0) return requested_threads;
+
+    const char *env = getenv("BASEDNN_NUM_THREADS");
+    if (env) {
+        long n = strtol(env, NULL, 10);
+        if (n > 0) return (size_t)n;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t)cpus : 1;
+}
+
+static void run_task(Task task) {
+    task.fn(task.arg);
+    __atomic_sub_fetch(&task.group->pending, 1, __ATOMIC_ACQ_REL);
+}
+
+// Own deque first, then steal round-robin starting after ourselves
+static int find_task(size_t self, Task *task) {
+    int found = deque_pop(&pool->deques[self], task);
+
+    for (size_t i = 1; !found && i < pool->num_threads; i++) {
+        size_t victim = (self + i) % pool->num_threads;
+        found = deque_steal(&pool->deques[victim], task);
+    }
+
+    if (found) __atomic_sub_fetch(&pool->queued, 1, __ATOMIC_ACQ_REL);
+    return found;
+}
+
+static void* worker_main(void *arg) {
+    thread_index = (size_t)arg;
+
+    for (;;) {
+        Task task;
+        if (find_task(thread_index, &task)) {
+            run_task(task);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->sleep_lock);
+        while (!pool->shutdown && __atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE) == 0) {
+            pthread_cond_wait(&pool->wake, &pool->sleep_lock);
+        }
+        int done = pool->shutdown;
+        pthread_mutex_unlock(&pool->sleep_lock);
+        if (done) break;
+    }
+    return NULL;
+}
+
+// ====================================================
+// Pool Management
+// ====================================================
+
+int threadpool_init(size_t num_threads) {
+    if (num_threads == 0) num_threads = default_num_threads();
+    if (pool) {
+        if (pool->num_threads == num_threads) return 1;
+        threadpool_shutdown();
+    }
+    if (num_threads <= 1) return 1;
+
+    ThreadPool *p = (ThreadPool *)calloc(1, sizeof(ThreadPool));
+    if (!p) return 0;
+    p->threads = (pthread_t *)calloc(num_threads, sizeof(pthread_t));
+    p->deques = (Deque *)calloc(num_threads, sizeof(Deque));
+    if (!p->threads || !p->deques) {
+        free(p->threads);
+        free(p->deques);
+        free(p);
+        return 0;
+    }
+
+    for (size_t i = 0; i < num_threads; i++) {
+        if (!deque_init(&p->deques[i])) {
+            for (size_t j = 0; j < i; j++) deque_destroy(&p->deques[j]);
+            free(p->threads);
+            free(p->deques);
+            free(p);
+            return 0;
+        }
+    }
+    pthread_mutex_init(&p->sleep_lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    p->num_threads = num_threads;
+    p->num_deques = num_threads;
+    pool = p;
+
+    // Workers that fail to start just shrink the pool
+    size_t started = 1;
+    for (size_t i = 1; i < num_threads; i++) {
+        if (pthread_create(&p->threads[started], NULL, worker_main, (void *)started) != 0) break;
+        started++;
+    }
+    p->num_threads = started;
+    if (started == 1) threadpool_shutdown();
+
+    return 1;
+}
+
+void threadpool_shutdown(void) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->sleep_lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->sleep_lock);
+
+    for (size_t i = 1; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < pool->num_deques; i++) deque_destroy(&pool->deques[i]);
+    pthread_mutex_destroy(&pool->sleep_lock);
+    pthread_cond_destroy(&pool->wake);
+    free(pool->threads);
+    free(pool->deques);
+    free(pool);
+    pool = NULL;
+}
+
+void threadpool_set_num_threads(size_t num_threads) {
+    requested_threads = num_threads;
+    if (pool || num_threads > 1) threadpool_init(0);
+}
+
+size_t threadpool_num_threads(void) {
+    return pool ? pool->num_threads : 1;
+}
+
+size_t threadpool_thread_index(void) {
+    return thread_index;
+}
+
+// ====================================================
+// Tasks
+// ====================================================
+
+TaskGroup* task_group_create(void) {
+    return (TaskGroup *)calloc(1, sizeof(TaskGroup));
+}
+
+void task_group_run(TaskGroup *group, TaskFn fn, void *arg) {
+    if (!group || !fn) return;
+
+    Task task = {fn, arg, group};
+    __atomic_add_fetch(&group->pending, 1, __ATOMIC_ACQ_REL);
+
+    if (!pool || !deque_push(&pool->deques[thread_index], task)) {
+        run_task(task);
+        return;
+    }
+
+    __atomic_add_fetch(&pool->queued, 1, __ATOMIC_ACQ_REL);
+    pthread_mutex_lock(&pool->sleep_lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->sleep_lock);
+}
+
+void task_group_wait(TaskGroup *group) {
+    if (!group) return;
+
+    while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) > 0) {
+        Task task;
+        if (pool && find_task(thread_index, &task)) {
+            run_task(task);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+void task_group_free(TaskGroup *group) {
+    free(group);
+}
+
+// ====================================================
+// Parallel For
+// ====================================================
+
+typedef struct {
+    ParallelForFn fn;
+    void *arg;
+    size_t begin;
+    size_t end;
+    size_t grain;
+    size_t num_chunks;
+    size_t next_chunk;
+} ParallelFor;
+
+// Each runner claims chunks until none are left, so uneven chunks balance out
+static void parallel_for_runner(void *arg) {
+    ParallelFor *pf = (ParallelFor *)arg;
+
+    for (;;) {
+        size_t chunk = __atomic_fetch_add(&pf->next_chunk, 1, __ATOMIC_RELAXED);
+        if (chunk >= pf->num_chunks) break;
+
+        size_t begin = pf->begin + chunk * pf->grain;
+        size_t end = (pf->end - begin < pf->grain) ? pf->end : begin + pf->grain;
+        pf->fn(begin, end, pf->arg);
+    }
+}
+
+size_t parallel_num_chunks(size_t begin, size_t end, size_t grain) {
+    if (end <= begin) return 0;
+    if (grain == 0) grain = 1;
+    return (end - begin + grain - 1) / grain;
+}
+
+void parallel_for(size_t begin, size_t end, size_t grain, ParallelForFn fn, void *arg) {
+    if (!fn || end <= begin) return;
+    if (grain == 0) grain = 1;
+
+    ParallelFor pf = {fn, arg, begin, end, grain, parallel_num_chunks(begin, end, grain), 0};
+
+    size_t runners = threadpool_num_threads();
+    if (runners > pf.num_chunks) runners = pf.num_chunks;
+    if (runners <= 1) {
+        parallel_for_runner(&pf);
+        return;
+    }
+
+    TaskGroup group = {0};
+    for (size_t i = 1; i < runners; i++) {
+        task_group_run(&group, parallel_for_runner, &pf);
+    }
+    parallel_for_runner(&pf);
+    task_group_wait(&group);
+}
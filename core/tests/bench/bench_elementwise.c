@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "../../include/basednn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Elementwise throughput against memcpy on tensors far larger than the caches.
+// Outputs come from an arena that is reset every iteration, so after warm-up
+// no run pays for page faults on fresh memory.
+//
+//   bench_elementwise [elements] [iterations]
+//
+// Set BASEDNN_NUM_THREADS to compare thread counts.
+
+#define DEFAULT_ELEMENTS (16u << 20)
+#define DEFAULT_ITERATIONS 20
+
+typedef Tensor* (*BinaryOp)(Tensor *, Tensor *);
+typedef Tensor* (*UnaryOp)(Tensor *);
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, size_t bytes, double seconds) {
+    printf("  %-10s %8.2f GB/s  (%.3f ms)\n", name, (double)bytes / seconds * 1e-9, seconds * 1e3);
+}
+
+// Best of iterations; bytes counts every float read and written
+static double time_binary(BinaryOp op, Tensor *a, Tensor *b, Arena *arena, int iterations) {
+    double best = 1e30;
+    for (int i = 0; i <= iterations; i++) {
+        double start = now_seconds();
+        op(a, b);
+        double elapsed = now_seconds() - start;
+        arena_reset(arena);
+        if (i > 0 && elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+static double time_unary(UnaryOp op, Tensor *a, Arena *arena, int iterations) {
+    double best = 1e30;
+    for (int i = 0; i <= iterations; i++) {
+        double start = now_seconds();
+        op(a);
+        double elapsed = now_seconds() - start;
+        arena_reset(arena);
+        if (i > 0 && elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : DEFAULT_ELEMENTS;
+    int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (n == 0 || iterations <= 0) {
+        fprintf(stderr, "usage: %s [elements] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    basednn_init();
+
+    Tensor *a = tensor_randn((size_t[]){n}, 1, 1);
+    Tensor *b = tensor_randn((size_t[]){n}, 1, 2);
+    float *dst = (float *)malloc(n * sizeof(float));
+    if (!a || !b || !dst) {
+        fprintf(stderr, "failed to allocate %zu elements\n", n);
+        return 1;
+    }
+
+    size_t bytes = n * sizeof(float);
+    printf("=== Elementwise Bandwidth: %zu elements, %zu threads ===\n\n", n, threadpool_num_threads());
+
+    double best = 1e30;
+    memcpy(dst, a->data, bytes);
+    for (int i = 0; i < iterations; i++) {
+        double start = now_seconds();
+        memcpy(dst, a->data, bytes);
+        double elapsed = now_seconds() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    report("memcpy", 2 * bytes, best);
+
+    Arena *arena = arena_create(0);
+    Arena *prev = arena_activate(arena);
+
+    report("add", 3 * bytes, time_binary(tensor_add, a, b, arena, iterations));
+    report("sub", 3 * bytes, time_binary(tensor_sub, a, b, arena, iterations));
+    report("mul", 3 * bytes, time_binary(tensor_mul, a, b, arena, iterations));
+    report("div", 3 * bytes, time_binary(tensor_div, a, b, arena, iterations));
+    report("relu", 2 * bytes, time_unary(tensor_relu, a, arena, iterations));
+    report("sigmoid", 2 * bytes, time_unary(tensor_sigmoid, a, arena, iterations));
+    report("tanh", 2 * bytes, time_unary(tensor_tanh, a, arena, iterations));
+
+    arena_activate(prev);
+    arena_free(arena);
+
+    free(dst);
+    tensor_free(a);
+    tensor_free(b);
+    basednn_cleanup();
+
+    return 0;
+}
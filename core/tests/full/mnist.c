@@ -38,14 +38,14 @@ void load_mnist_labels(const char *path, Tensor **labels, int count) {
     read_uint32(f);
     read_uint32(f);
     
-    size_t shape[] = {count, 10};
-    *labels = tensor_create(shape, 2);
-    tensor_fill(*labels, 0.0f);
+    // Class indices rather than one-hot rows: one float per label
+    size_t shape[] = {count};
+    *labels = tensor_create(shape, 1);
     
     for (int i = 0; i < count; i++) {
         uint8_t label;
         fread(&label, 1, 1, f);
-        (*labels)->data[i * 10 + label] = 1.0f;
+        (*labels)->data[i] = (float)label;
     }
     fclose(f);
 }
@@ -86,10 +86,10 @@ int main() {
     test_labels->shape[0] = n_test;
     
     printf("\nTraining on %d samples...\n", n_train);
-    network_train(net, opt, train_images, train_labels, 3, 64, "cross_entropy", 1);
+    network_train(net, opt, train_images, train_labels, 3, 64, "sparse_cross_entropy", 1);
     
     printf("\nEvaluating...\n");
-    Tensor *predictions = network_forward(net, test_images);
+    Tensor *predictions = network_infer(net, test_images);
     float accuracy = network_accuracy(predictions, test_labels);
     printf("Test Accuracy: %.2f%%\n", accuracy * 100.0f);
     
@@ -28,7 +28,7 @@ int main() {
     
     network_train(net, opt, inputs, targets, 1000, 4, "mse", 1);
     
-    Tensor *predictions = network_forward(net, inputs);
+    Tensor *predictions = network_infer(net, inputs);
     float accuracy = network_accuracy(predictions, targets);
     printf("\nAccuracy: %.2f%%\n", accuracy * 100.0f);
     
@@ -0,0 +1,212 @@
+#include "../../include/basednn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>
+
+#define EPSILON 1e-4f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+// ====================================================
+// Arena Allocation Tests
+// ====================================================
+
+TEST(arena_alloc_aligned) {
+    Arena *arena = arena_create(1024);
+    assert(arena != NULL);
+
+    for (size_t i = 1; i < 40; i += 7) {
+        void *p = arena_alloc(arena, i);
+        assert(p != NULL);
+        assert(((uintptr_t)p % ARENA_ALIGNMENT) == 0);
+    }
+
+    arena_free(arena);
+}
+
+TEST(arena_grows_past_block) {
+    Arena *arena = arena_create(256);
+
+    float *small = (float *)arena_alloc(arena, 64);
+    float *big = (float *)arena_alloc(arena, 4096);
+    assert(small != NULL);
+    assert(big != NULL);
+
+    for (size_t i = 0; i < 1024; i++) big[i] = (float)i;
+    small[0] = 7.0f;
+    ASSERT_FLOAT_EQ(big[1023], 1023.0f);
+    ASSERT_FLOAT_EQ(small[0], 7.0f);
+
+    assert(arena_used(arena) >= 64 + 4096);
+    arena_free(arena);
+}
+
+TEST(arena_reset_reuses_memory) {
+    Arena *arena = arena_create(256);
+
+    for (size_t i = 0; i < 10; i++) arena_alloc(arena, 200);
+    arena_reset(arena);
+    assert(arena_used(arena) == 0);
+
+    // After the first reset the arena is a single block covering the high-water mark
+    size_t capacity = arena_capacity(arena);
+    for (int step = 0; step < 5; step++) {
+        for (size_t i = 0; i < 10; i++) assert(arena_alloc(arena, 200) != NULL);
+        arena_reset(arena);
+        assert(arena_capacity(arena) == capacity);
+    }
+
+    arena_free(arena);
+}
+
+// ====================================================
+// Tensor Integration Tests
+// ====================================================
+
+TEST(tensor_create_in_arena) {
+    Arena *arena = arena_create(0);
+    Arena *prev = arena_activate(arena);
+    assert(arena_get_active() == arena);
+
+    size_t shape[] = {3, 4};
+    Tensor *t = tensor_ones(shape, 2);
+    assert(t != NULL);
+    assert(t->arena == arena);
+    assert(arena_used(arena) > 0);
+    tensor_free(t);  // No-op for arena tensors
+    ASSERT_FLOAT_EQ(t->data[11], 1.0f);
+
+    arena_activate(prev);
+    assert(arena_get_active() == prev);
+
+    Tensor *h = tensor_ones(shape, 2);
+    assert(h->arena == NULL);
+    tensor_free(h);
+
+    arena_free(arena);
+}
+
+TEST(arena_autograd) {
+    size_t shape[] = {2, 3};
+    Tensor *a = tensor_ones(shape, 2);
+    Tensor *b = tensor_ones(shape, 2);
+    tensor_set_requires_grad(a, 1);
+    tensor_set_requires_grad(b, 1);
+
+    Arena *arena = arena_create(0);
+    Arena *prev = arena_activate(arena);
+
+    Tensor *c = tensor_mul(a, b);
+    Tensor *d = tensor_add(c, a);
+    Tensor *loss = tensor_mse(d, b);
+    tensor_backward(loss);
+
+    assert(c->arena == arena);
+    assert(c->inputs[0] == a);
+    assert(a->grad != NULL);
+
+    arena_activate(prev);
+    arena_reset(arena);
+    tensor_tape_clear();
+
+    // d(mean((a*b + a - b)^2))/da = 2/6 * (a*b + a - b) * (b + 1) = 2/3
+    for (size_t i = 0; i < a->size; i++) {
+        ASSERT_FLOAT_EQ(a->grad[i], 2.0f / 3.0f);
+    }
+
+    tensor_free(a);
+    tensor_free(b);
+    arena_free(arena);
+}
+
+// One step through ops that need scratch (the fused linear and loss passes,
+// broadcast and matmul backward); leaves gradients in params
+static void scratch_step(Tensor **params, Tensor *targets) {
+    Tensor *x = tensor_transpose2d(params[0]);
+    Tensor *y = tensor_linear(x, params[1], params[2], LINEAR_ACT_SIGMOID);
+    Tensor *z = tensor_div(y, params[3]);
+    Tensor *logits = tensor_matmul(z, params[4]);
+    Tensor *loss = tensor_softmax_cross_entropy(logits, targets);
+    tensor_backward(loss);
+
+    Tensor *outputs[] = {loss, logits, z, y, x};
+    for (size_t i = 0; i < 5; i++) tensor_free(outputs[i]);
+}
+
+// Op temporaries come from the arena: results match a heap step, and repeated
+// steps stay within the block sized by the first
+TEST(arena_scratch) {
+    size_t shapes[5][2] = {{6, 4}, {6, 5}, {5, 1}, {5, 1}, {5, 3}};
+    Tensor *params[5];
+    for (size_t i = 0; i < 5; i++) {
+        params[i] = tensor_randn(shapes[i], (i == 2 || i == 3) ? 1 : 2, (int)i + 1);
+        tensor_set_requires_grad(params[i], 1);
+    }
+    for (size_t i = 0; i < params[3]->size; i++) params[3]->data[i] = 2.0f + fabsf(params[3]->data[i]);
+    Tensor *targets = tensor_zeroes((size_t[]){4, 3}, 2);
+    for (size_t r = 0; r < 4; r++) targets->data[r * 3 + r % 3] = 1.0f;
+
+    scratch_step(params, targets);
+    float expected[5][30];
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < params[i]->size; j++) expected[i][j] = params[i]->grad[j];
+    }
+    tensor_tape_clear();
+
+    Arena *arena = arena_create(0);
+    size_t capacity = 0;
+    for (int step = 0; step < 3; step++) {
+        for (size_t i = 0; i < 5; i++) tensor_zero_grad(params[i]);
+        Arena *prev = arena_activate(arena);
+        scratch_step(params, targets);
+        arena_activate(prev);
+
+        for (size_t i = 0; i < 5; i++) {
+            for (size_t j = 0; j < params[i]->size; j++) ASSERT_FLOAT_EQ(params[i]->grad[j], expected[i][j]);
+        }
+        arena_reset(arena);
+        tensor_tape_clear();
+        if (step == 0) capacity = arena_capacity(arena);
+        assert(arena_capacity(arena) == capacity);
+    }
+
+    for (size_t i = 0; i < 5; i++) tensor_free(params[i]);
+    tensor_free(targets);
+    arena_free(arena);
+}
+
+TEST(arena_free_deactivates) {
+    Arena *arena = arena_create(0);
+    arena_activate(arena);
+    arena_free(arena);
+    assert(arena_get_active() == NULL);
+}
+
+// ====================================================
+// Main
+// ====================================================
+
+int main() {
+    printf("=== Running Arena Tests ===\n\n");
+
+    basednn_init();
+
+    // Allocation tests
+    RUN_TEST(arena_alloc_aligned);
+    RUN_TEST(arena_grows_past_block);
+    RUN_TEST(arena_reset_reuses_memory);
+
+    // Tensor tests
+    RUN_TEST(tensor_create_in_arena);
+    RUN_TEST(arena_autograd);
+    RUN_TEST(arena_scratch);
+    RUN_TEST(arena_free_deactivates);
+
+    basednn_cleanup();
+
+    printf("\n=== All Arena Tests Passed! ===\n");
+    return 0;
+}
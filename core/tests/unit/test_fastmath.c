@@ -0,0 +1,156 @@
+#include "../../include/basednn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define EPSILON 1e-4f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+// Samples per accuracy sweep; an odd count keeps the vector tails in play
+#define SWEEP_SIZE 200003
+
+// ====================================================
+// Helpers
+// ====================================================
+
+static double ref_sigmoid(double x) { return 1.0 / (1.0 + exp(-x)); }
+static double ref_swish(double x) { return x * ref_sigmoid(x); }
+static double ref_softplus(double x) { return (x > 0.0 ? x : 0.0) + log1p(exp(-fabs(x))); }
+static double ref_gelu(double x) { return x * ref_sigmoid(1.5957691216057308 * (x + 0.044715 * x * x * x)); }
+
+// Distance in units of the float spacing at the reference value
+static double ulp_error(float got, double ref) {
+    float r = (float)ref;
+    double ulp = (double)nextafterf(fabsf(r), INFINITY) - fabsf(r);
+    return fabs((double)got - ref) / ulp;
+}
+
+// Largest error of kernel over n evenly spaced inputs in [lo, hi]
+static double sweep(MathKernelFn kernel, double (*ref)(double), double lo, double hi) {
+    float *x = malloc(SWEEP_SIZE * sizeof(float));
+    float *y = malloc(SWEEP_SIZE * sizeof(float));
+    for (size_t i = 0; i < SWEEP_SIZE; i++) x[i] = (float)(lo + (hi - lo) * i / (SWEEP_SIZE - 1));
+
+    kernel(x, y, SWEEP_SIZE);
+
+    double worst = 0.0;
+    for (size_t i = 0; i < SWEEP_SIZE; i++) {
+        double e = ulp_error(y[i], ref((double)x[i]));
+        if (e > worst) worst = e;
+    }
+
+    free(x);
+    free(y);
+    return worst;
+}
+
+// ====================================================
+// Accuracy Tests
+// ====================================================
+
+// Bounds documented in fastmath.h
+TEST(fast_math_accuracy) {
+    const MathKernels *k = fastmath_kernels();
+    printf("  (%s)\n", k->name);
+
+    assert(sweep(k->exp, exp, -87.0, 88.0) <= 3.0);
+    assert(sweep(k->log, log, 1e-30, 1e30) <= 3.0);
+    assert(sweep(k->log, log, 0.5, 2.0) <= 3.0);
+    assert(sweep(k->sigmoid, ref_sigmoid, -87.0, 87.0) <= 4.0);
+    assert(sweep(k->tanh, tanh, -10.0, 10.0) <= 6.0);
+    assert(sweep(k->tanh, tanh, -0.01, 0.01) <= 6.0);
+    assert(sweep(k->swish, ref_swish, -87.0, 87.0) <= 5.0);
+    assert(sweep(k->softplus, ref_softplus, -87.0, 87.0) <= 4.0);
+    assert(sweep(k->gelu, ref_gelu, -3.0, 10.0) <= 16.0);
+}
+
+TEST(fast_math_saturates) {
+    const MathKernels *k = fastmath_kernels();
+    float x[] = {-200.0f, 200.0f, 0.0f};
+    float y[3];
+
+    k->sigmoid(x, y, 3);
+    ASSERT_FLOAT_EQ(y[0], 0.0f);
+    ASSERT_FLOAT_EQ(y[1], 1.0f);
+    ASSERT_FLOAT_EQ(y[2], 0.5f);
+
+    k->tanh(x, y, 3);
+    ASSERT_FLOAT_EQ(y[0], -1.0f);
+    ASSERT_FLOAT_EQ(y[1], 1.0f);
+    assert(y[2] == 0.0f);
+
+    k->softplus(x, y, 3);
+    ASSERT_FLOAT_EQ(y[0], 0.0f);
+    ASSERT_FLOAT_EQ(y[1], 200.0f);
+    ASSERT_FLOAT_EQ(y[2], logf(2.0f));
+}
+
+// ====================================================
+// Mode Tests
+// ====================================================
+
+TEST(fast_math_mode_switches_ops) {
+    Tensor *z = tensor_randn((size_t[]){37, 11}, 2, 9);
+    for (size_t i = 0; i < z->size; i++) z->data[i] *= 4.0f;
+
+    fastmath_set_enabled(0);
+    assert(!fastmath_enabled());
+    Tensor *precise = tensor_sigmoid(z);
+    Tensor *precise_tanh = tensor_tanh(z);
+
+    fastmath_set_enabled(1);
+    assert(fastmath_enabled());
+    Tensor *fast = tensor_sigmoid(z);
+    Tensor *fast_tanh = tensor_tanh(z);
+    fastmath_set_enabled(0);
+
+    for (size_t i = 0; i < z->size; i++) {
+        ASSERT_FLOAT_EQ(fast->data[i], precise->data[i]);
+        ASSERT_FLOAT_EQ(fast_tanh->data[i], precise_tanh->data[i]);
+    }
+
+    Tensor *outputs[] = {z, precise, precise_tanh, fast, fast_tanh};
+    for (size_t i = 0; i < 5; i++) tensor_free(outputs[i]);
+}
+
+TEST(fast_math_linear_sigmoid) {
+    Tensor *X = tensor_randn((size_t[]){5, 7}, 2, 1);
+    Tensor *W = tensor_randn((size_t[]){7, 3}, 2, 2);
+    Tensor *b = tensor_randn((size_t[]){3}, 1, 3);
+
+    Tensor *precise = tensor_linear(X, W, b, LINEAR_ACT_SIGMOID);
+    fastmath_set_enabled(1);
+    Tensor *fast = tensor_linear(X, W, b, LINEAR_ACT_SIGMOID);
+    fastmath_set_enabled(0);
+
+    for (size_t i = 0; i < precise->size; i++) ASSERT_FLOAT_EQ(fast->data[i], precise->data[i]);
+
+    Tensor *tensors[] = {X, W, b, precise, fast};
+    for (size_t i = 0; i < 5; i++) tensor_free(tensors[i]);
+}
+
+// ====================================================
+// Main
+// ====================================================
+
+int main() {
+    printf("=== Running Fast Math Tests ===\n\n");
+
+    basednn_init();
+
+    // Accuracy tests
+    RUN_TEST(fast_math_accuracy);
+    RUN_TEST(fast_math_saturates);
+
+    // Mode tests
+    RUN_TEST(fast_math_mode_switches_ops);
+    RUN_TEST(fast_math_linear_sigmoid);
+
+    basednn_cleanup();
+
+    printf("\n=== All Fast Math Tests Passed! ===\n");
+    return 0;
+}
@@ -0,0 +1,390 @@
+#include "../../include/basednn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+
+#define EPSILON 1e-3f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+// ====================================================
+// Helpers
+// ====================================================
+
+static void fill_random(float *x, size_t n, unsigned int seed) {
+    srand(seed);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+static void naive_gemm(size_t M, size_t N, size_t K, const float *A, const float *B, float *C) {
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            float acc = 0.0f;
+            for (size_t k = 0; k < K; k++) {
+                acc += A[i * K + k] * B[k * N + j];
+            }
+            C[i * N + j] = acc;
+        }
+    }
+}
+
+static void check_sgemm(size_t M, size_t N, size_t K) {
+    float *A = malloc(M * K * sizeof(float));
+    float *B = malloc(K * N * sizeof(float));
+    float *C = malloc(M * N * sizeof(float));
+    float *ref = malloc(M * N * sizeof(float));
+
+    fill_random(A, M * K, 1);
+    fill_random(B, K * N, 2);
+    for (size_t i = 0; i < M * N; i++) C[i] = 123.0f;
+
+    sgemm(M, N, K, A, K, B, N, C, N);
+    naive_gemm(M, N, K, A, B, ref);
+
+    for (size_t i = 0; i < M * N; i++) {
+        ASSERT_FLOAT_EQ(C[i], ref[i]);
+    }
+
+    free(A);
+    free(B);
+    free(C);
+    free(ref);
+}
+
+// ====================================================
+// GEMM Tests
+// ====================================================
+
+TEST(sgemm_single_tile) {
+    check_sgemm(GEMM_MR, GEMM_NR, 8);
+}
+
+TEST(sgemm_edge_tiles) {
+    check_sgemm(7, 19, 5);
+    check_sgemm(1, 1, 1);
+    check_sgemm(13, 3, 33);
+}
+
+TEST(sgemm_multiple_blocks) {
+    // Crosses the MC and KC block boundaries
+    check_sgemm(GEMM_MC + 5, 37, GEMM_KC + 9);
+}
+
+TEST(sgemm_wide) {
+    // Crosses the NC block boundary
+    check_sgemm(3, GEMM_NC + 17, 4);
+}
+
+TEST(sgemm_leading_dimension) {
+    // Multiply the top-left 3x4 and 4x5 corners of larger matrices into a strided C
+    size_t lda = 10, ldb = 12, ldc = 9;
+    float A[3 * 10], B[4 * 12], C[3 * 9], ref[3 * 5];
+    float a[3 * 4], b[4 * 5];
+
+    fill_random(A, 3 * lda, 3);
+    fill_random(B, 4 * ldb, 4);
+    for (size_t i = 0; i < 3; i++) for (size_t k = 0; k < 4; k++) a[i * 4 + k] = A[i * lda + k];
+    for (size_t k = 0; k < 4; k++) for (size_t j = 0; j < 5; j++) b[k * 5 + j] = B[k * ldb + j];
+    for (size_t i = 0; i < 3 * ldc; i++) C[i] = -1.0f;
+
+    sgemm(3, 5, 4, A, lda, B, ldb, C, ldc);
+    naive_gemm(3, 5, 4, a, b, ref);
+
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            ASSERT_FLOAT_EQ(C[i * ldc + j], ref[i * 5 + j]);
+        }
+        // Columns past N are untouched
+        ASSERT_FLOAT_EQ(C[i * ldc + 5], -1.0f);
+    }
+}
+
+// All four transpose combinations with alpha and beta, K spanning two KC blocks
+TEST(sgemm_ex_transposed) {
+    size_t M = 13, N = 35, K = 300;
+    float *A = malloc(M * K * sizeof(float));
+    float *B = malloc(K * N * sizeof(float));
+    float *At = malloc(K * M * sizeof(float));
+    float *Bt = malloc(N * K * sizeof(float));
+    float *C = malloc(M * N * sizeof(float));
+    float *ref = malloc(M * N * sizeof(float));
+
+    fill_random(A, M * K, 9);
+    fill_random(B, K * N, 10);
+    for (size_t i = 0; i < M; i++)
+        for (size_t k = 0; k < K; k++) At[k * M + i] = A[i * K + k];
+    for (size_t k = 0; k < K; k++)
+        for (size_t j = 0; j < N; j++) Bt[j * K + k] = B[k * N + j];
+    naive_gemm(M, N, K, A, B, ref);
+
+    for (int ta = 0; ta < 2; ta++) {
+        for (int tb = 0; tb < 2; tb++) {
+            for (size_t i = 0; i < M * N; i++) C[i] = 1.0f;
+            sgemm_ex(NULL, ta ? GEMM_TRANS : GEMM_NO_TRANS, tb ? GEMM_TRANS : GEMM_NO_TRANS, M, N, K,
+                     0.5f, ta ? At : A, ta ? M : K, tb ? Bt : B, tb ? K : N, 2.0f, C, N);
+
+            for (size_t i = 0; i < M * N; i++) {
+                ASSERT_FLOAT_EQ(C[i], 0.5f * ref[i] + 2.0f);
+            }
+        }
+    }
+
+    // beta = 1 accumulates, beta = 0 ignores what C held
+    for (size_t i = 0; i < M * N; i++) C[i] = NAN;
+    sgemm_ex(NULL, GEMM_NO_TRANS, GEMM_NO_TRANS, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N);
+    sgemm_ex(NULL, GEMM_TRANS, GEMM_TRANS, M, N, K, 1.0f, At, M, Bt, K, 1.0f, C, N);
+    for (size_t i = 0; i < M * N; i++) {
+        ASSERT_FLOAT_EQ(C[i], 2.0f * ref[i]);
+    }
+
+    free(A);
+    free(B);
+    free(At);
+    free(Bt);
+    free(C);
+    free(ref);
+}
+
+// C += Aᵀ·B and b_sums += column sums of B, with K over two KC blocks, edge
+// panels in N and B's panels packed by several threads
+TEST(sgemm_strided_ex_column_sums) {
+    size_t M = 10, N = 37, K = 300;
+    float *At = malloc(K * M * sizeof(float));
+    float *B = malloc(K * N * sizeof(float));
+    float *A = malloc(M * K * sizeof(float));
+    float *C = malloc(M * N * sizeof(float));
+    float *ref = malloc(M * N * sizeof(float));
+    float sums[37];
+
+    fill_random(At, K * M, 12);
+    fill_random(B, K * N, 13);
+    for (size_t i = 0; i < M; i++)
+        for (size_t k = 0; k < K; k++) A[i * K + k] = At[k * M + i];
+    naive_gemm(M, N, K, A, B, ref);
+
+    size_t prev = threadpool_num_threads();
+    threadpool_set_num_threads(4);
+    for (size_t i = 0; i < M * N; i++) C[i] = 1.0f;
+    for (size_t j = 0; j < N; j++) sums[j] = 2.0f;
+
+    sgemm_strided_ex(NULL, M, N, K, 1.0f, At, 1, M, B, N, 1, 1.0f, C, N, sums);
+    threadpool_set_num_threads(prev);
+
+    for (size_t i = 0; i < M * N; i++) {
+        ASSERT_FLOAT_EQ(C[i], ref[i] + 1.0f);
+    }
+    for (size_t j = 0; j < N; j++) {
+        float expected = 2.0f;
+        for (size_t k = 0; k < K; k++) expected += B[k * N + j];
+        ASSERT_FLOAT_EQ(sums[j], expected);
+    }
+
+    free(At);
+    free(B);
+    free(A);
+    free(C);
+    free(ref);
+}
+
+// Prepacked B gives the same bits as packing per call, across the KC and NC
+// block boundaries and for a transposed B
+TEST(sgemm_prepacked) {
+    size_t M = 5, N = GEMM_NC + 21, K = GEMM_KC + 44;
+    float *A = malloc(M * K * sizeof(float));
+    float *B = malloc(K * N * sizeof(float));
+    float *bias = malloc(N * sizeof(float));
+    float *C = malloc(M * N * sizeof(float));
+    float *ref = malloc(M * N * sizeof(float));
+    float *packed = malloc(gemm_packed_b_size(K, N) * sizeof(float));
+    assert(gemm_packed_b_size(K, N) >= K * N);
+
+    fill_random(A, M * K, 14);
+    fill_random(B, K * N, 15);
+    fill_random(bias, N, 16);
+    GemmEpilogue epilogue = {bias, NULL};
+
+    sgemm_fused(NULL, M, N, K, A, K, 1, B, N, 1, ref, N, &epilogue);
+    gemm_pack_b(K, N, B, N, 1, packed);
+    sgemm_prepacked(NULL, M, N, K, A, K, 1, packed, C, N, &epilogue);
+    assert(memcmp(C, ref, M * N * sizeof(float)) == 0);
+
+    // Bᵀ stored N x K, packed through swapped strides
+    size_t n = 40;
+    float *Bt = malloc(n * K * sizeof(float));
+    for (size_t k = 0; k < K; k++)
+        for (size_t j = 0; j < n; j++) Bt[j * K + k] = B[k * N + j];
+    sgemm_fused(NULL, M, n, K, A, K, 1, Bt, 1, K, ref, n, NULL);
+    gemm_pack_b(K, n, Bt, 1, K, packed);
+    sgemm_prepacked(NULL, M, n, K, A, K, 1, packed, C, n, NULL);
+    assert(memcmp(C, ref, M * n * sizeof(float)) == 0);
+
+    free(Bt);
+    free(A);
+    free(B);
+    free(bias);
+    free(C);
+    free(ref);
+    free(packed);
+}
+
+// Every row count up to GEMM_SMALL_M gives the blocked GEMM's bits, from B in
+// place or prepacked, over two KC blocks, an edge panel and (prepacked) the NC
+// boundary
+TEST(sgemm_small_m) {
+    size_t K = GEMM_KC + 44, N = GEMM_NC + 21;
+    float *A = malloc(GEMM_SMALL_M * K * sizeof(float));
+    float *B = malloc(K * N * sizeof(float));
+    float *bias = malloc(N * sizeof(float));
+    float *C = malloc(GEMM_SMALL_M * N * sizeof(float));
+    float *ref = malloc(GEMM_SMALL_M * N * sizeof(float));
+    float *packed = malloc(gemm_packed_b_size(K, N) * sizeof(float));
+
+    fill_random(A, GEMM_SMALL_M * K, 17);
+    fill_random(B, K * N, 18);
+    fill_random(bias, N, 19);
+    GemmEpilogue epilogue = {bias, NULL};
+    gemm_pack_b(K, N, B, N, 1, packed);
+
+    for (size_t M = 1; M <= GEMM_SMALL_M; M++) {
+        size_t n = 37;
+        sgemm_fused(gemm_microkernel_scalar, M, n, K, A, K, 1, B, N, 1, ref, n, &epilogue);
+        sgemm_small_m(gemm_small_m_scalar, M, n, K, A, K, 1, B, N, NULL, C, n, &epilogue);
+        assert(memcmp(C, ref, M * n * sizeof(float)) == 0);
+    }
+
+    size_t M = 3;
+    sgemm_fused(gemm_microkernel_scalar, M, N, K, A, K, 1, B, N, 1, ref, N, &epilogue);
+    sgemm_small_m(gemm_small_m_scalar, M, N, K, A, K, 1, NULL, 0, packed, C, N, &epilogue);
+    assert(memcmp(C, ref, M * N * sizeof(float)) == 0);
+    sgemm_small_m(gemm_small_m_scalar, M, N, K, A, K, 1, B, N, NULL, C, N, &epilogue);
+    assert(memcmp(C, ref, M * N * sizeof(float)) == 0);
+
+    free(A);
+    free(B);
+    free(bias);
+    free(C);
+    free(ref);
+    free(packed);
+}
+
+// Eight products of distinct A blocks with two alternating B blocks, on several
+// threads so whole products and split products both run
+TEST(sgemm_batched_shared_operand) {
+    size_t batch = 8, M = 9, N = 21, K = 7;
+    float *A = malloc(batch * M * K * sizeof(float));
+    float *B = malloc(2 * K * N * sizeof(float));
+    float *C = malloc(batch * M * N * sizeof(float));
+    float *ref = malloc(M * N * sizeof(float));
+    size_t a_offsets[8], b_offsets[8];
+
+    fill_random(A, batch * M * K, 7);
+    fill_random(B, 2 * K * N, 8);
+    for (size_t i = 0; i < batch; i++) {
+        a_offsets[i] = i * M * K;
+        b_offsets[i] = (i % 2) * K * N;
+    }
+
+    size_t prev = threadpool_num_threads();
+    size_t counts[] = {1, 3, 16};
+    for (size_t t = 0; t < 3; t++) {
+        threadpool_set_num_threads(counts[t]);
+        for (size_t i = 0; i < batch * M * N; i++) C[i] = 123.0f;
+
+        sgemm_batched(NULL, batch, M, N, K, 1.0f, A, a_offsets, K, 1, B, b_offsets, N, 1, 0.0f, C, N, M * N);
+
+        for (size_t i = 0; i < batch; i++) {
+            naive_gemm(M, N, K, A + a_offsets[i], B + b_offsets[i], ref);
+            for (size_t j = 0; j < M * N; j++) {
+                ASSERT_FLOAT_EQ(C[i * M * N + j], ref[j]);
+            }
+        }
+    }
+    threadpool_set_num_threads(prev);
+
+    free(A);
+    free(B);
+    free(C);
+    free(ref);
+}
+
+TEST(tensor_matmul_large) {
+    size_t M = 70, K = 300, N = 45;
+    Tensor *a = tensor_create((size_t[]){M, K}, 2);
+    Tensor *b = tensor_create((size_t[]){K, N}, 2);
+    fill_random(a->data, a->size, 5);
+    fill_random(b->data, b->size, 6);
+
+    Tensor *c = tensor_matmul(a, b);
+    assert(c != NULL);
+    assert(c->shape[0] == M && c->shape[1] == N);
+
+    float *ref = malloc(M * N * sizeof(float));
+    naive_gemm(M, N, K, a->data, b->data, ref);
+    for (size_t i = 0; i < M * N; i++) {
+        ASSERT_FLOAT_EQ(c->data[i], ref[i]);
+    }
+
+    free(ref);
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(c);
+}
+
+// Vector-matrix and matrix-vector products take the small-M path
+TEST(tensor_matmul_small_m) {
+    size_t K = 300, N = 45;
+    Tensor *v = tensor_create((size_t[]){K}, 1);
+    Tensor *m = tensor_create((size_t[]){K, N}, 2);
+    Tensor *a = tensor_create((size_t[]){3, K}, 2);
+    fill_random(v->data, v->size, 20);
+    fill_random(m->data, m->size, 21);
+    fill_random(a->data, a->size, 22);
+
+    float ref[3 * 45];
+    Tensor *vm = tensor_matmul(v, m);
+    assert(vm != NULL && vm->ndim == 1 && vm->shape[0] == N);
+    naive_gemm(1, N, K, v->data, m->data, ref);
+    for (size_t j = 0; j < N; j++) ASSERT_FLOAT_EQ(vm->data[j], ref[j]);
+
+    Tensor *av = tensor_matmul(a, v);
+    assert(av != NULL && av->ndim == 1 && av->shape[0] == 3);
+    naive_gemm(3, 1, K, a->data, v->data, ref);
+    for (size_t i = 0; i < 3; i++) ASSERT_FLOAT_EQ(av->data[i], ref[i]);
+
+    tensor_free(vm);
+    tensor_free(av);
+    tensor_free(v);
+    tensor_free(m);
+    tensor_free(a);
+}
+
+// ====================================================
+// Main Test Runner
+// ====================================================
+
+int main() {
+    printf("=== Running GEMM Tests ===\n\n");
+
+    RUN_TEST(sgemm_single_tile);
+    RUN_TEST(sgemm_edge_tiles);
+    RUN_TEST(sgemm_multiple_blocks);
+    RUN_TEST(sgemm_wide);
+    RUN_TEST(sgemm_leading_dimension);
+    RUN_TEST(sgemm_ex_transposed);
+    RUN_TEST(sgemm_strided_ex_column_sums);
+    RUN_TEST(sgemm_prepacked);
+    RUN_TEST(sgemm_small_m);
+    RUN_TEST(sgemm_batched_shared_operand);
+    RUN_TEST(tensor_matmul_large);
+    RUN_TEST(tensor_matmul_small_m);
+
+    gemm_cleanup();
+
+    printf("\n=== All GEMM Tests Passed! ===\n");
+    return 0;
+}
@@ -4,6 +4,9 @@
 #include <math.h>
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #define EPSILON 1e-4f
 #define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
@@ -127,10 +130,245 @@ TEST(network_forward_with_activations) {
     network_free(net);
 }
 
+TEST(network_forward_fuses_linear_activation) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(4, 6)));
+    network_add_layer(net, layer_create(TANH()));
+    network_add_layer(net, layer_create(LINEAR(6, 2)));
+    network_add_layer(net, layer_create(SIGMOID()));
+    
+    size_t input_shape[] = {3, 4};
+    Tensor *input = tensor_randn(input_shape, 2, 11);
+    
+    // Layer by layer, without fusion
+    Tensor *h = layer_forward(net->layers[0], input);
+    Tensor *a = layer_forward(net->layers[1], h);
+    Tensor *z = layer_forward(net->layers[2], a);
+    Tensor *expected = layer_forward(net->layers[3], z);
+    
+    Tensor *output = network_forward(net, input);
+    assert(output != NULL);
+    assert(strcmp(output->op_name, "linear_sigmoid") == 0);
+    assert(strcmp(output->inputs[0]->op_name, "linear_tanh") == 0);
+    
+    for (size_t i = 0; i < output->size; i++) {
+        ASSERT_FLOAT_EQ(output->data[i], expected->data[i]);
+    }
+    
+    tensor_free(output);
+    tensor_free(expected);
+    tensor_free(z);
+    tensor_free(a);
+    tensor_free(h);
+    tensor_free(input);
+    network_free(net);
+}
+
+TEST(network_infer_matches_forward) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(4, 8)));
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(8, 3)));
+    network_add_layer(net, layer_create(SOFTMAX()));
+    
+    size_t input_shape[] = {5, 4};
+    Tensor *input = tensor_randn(input_shape, 2, 7);
+    
+    Tensor *expected = network_forward(net, input);
+    assert(expected->requires_grad);
+    
+    size_t tape_before = tensor_tape_size();
+    Tensor *output = network_infer(net, input);
+    
+    assert(output != NULL);
+    assert(output->requires_grad == 0);
+    assert(output->inputs == NULL);
+    assert(tensor_tape_size() == tape_before);
+    assert(tensor_is_grad_enabled());
+    
+    for (size_t i = 0; i < output->size; i++) {
+        ASSERT_FLOAT_EQ(output->data[i], expected->data[i]);
+    }
+    
+    tensor_free(output);
+    tensor_free(expected);
+    tensor_free(input);
+    network_free(net);
+}
+
+TEST(network_infer_empty) {
+    Network *net = network_create();
+    
+    size_t input_shape[] = {1, 2};
+    Tensor *input = tensor_ones(input_shape, 2);
+    
+    assert(network_infer(net, input) == input);
+    assert(network_infer(net, NULL) == NULL);
+    
+    tensor_free(input);
+    network_free(net);
+}
+
+// The SIGMOID overwrites the RELU's output; the caller's input is untouched
+TEST(network_infer_activations_in_place) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(SIGMOID()));
+    
+    size_t input_shape[] = {2, 3};
+    Tensor *input = tensor_randn(input_shape, 2, 3);
+    Tensor *original = tensor_copy(input);
+    
+    Tensor *output = network_infer(net, input);
+    assert(output != NULL && output != input);
+    assert(output->version == 1);
+    
+    for (size_t i = 0; i < input->size; i++) {
+        ASSERT_FLOAT_EQ(input->data[i], original->data[i]);
+        float r = original->data[i] > 0.0f ? original->data[i] : 0.0f;
+        ASSERT_FLOAT_EQ(output->data[i], 1.0f / (1.0f + expf(-r)));
+    }
+    
+    tensor_free(output);
+    tensor_free(original);
+    tensor_free(input);
+    network_free(net);
+}
+
+// exp wired into the graph by hand, without tensor_record_op; its backward
+// pass reads the output
+static void backward_hand_wired_exp(Tensor *output) {
+    Tensor *input = output->inputs[0];
+    tensor_ensure_grad(input);
+    for (size_t i = 0; i < input->size; i++) {
+        input->grad[i] += output->grad[i] * output->data[i];
+    }
+}
+
+static Tensor* hand_wired_exp_forward(Layer *self, Tensor *input) {
+    Tensor *output = tensor_create(input->shape, input->ndim);
+    for (size_t i = 0; i < output->size; i++) output->data[i] = expf(input->data[i]);
+
+    output->requires_grad = 1;
+    output->inputs = (Tensor **)malloc(sizeof(Tensor *));
+    output->inputs[0] = input;
+    output->num_inputs = 1;
+    output->backward_fn = backward_hand_wired_exp;
+    return output;
+}
+
+// TANH may overwrite its input only if the producer released it
+TEST(network_forward_keeps_hand_wired_outputs) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(3, 2)));
+    Layer *plugin = layer_create(RELU());
+    plugin->forward = hand_wired_exp_forward;
+    network_add_layer(net, plugin);
+    network_add_layer(net, layer_create(TANH()));
+
+    Tensor *input = tensor_randn((size_t[]){4, 3}, 2, 5);
+    Tensor *target = tensor_ones((size_t[]){4, 2}, 2);
+    Tensor *W = net->layers[0]->weights;
+    float expected[6];
+
+    // Layer by layer, out of place
+    Tensor *h = layer_forward(net->layers[0], input);
+    Tensor *e = layer_forward(plugin, h);
+    assert(!tensor_inplace_safe(e));
+    Tensor *a = layer_forward(net->layers[2], e);
+    Tensor *loss = tensor_mse(a, target);
+    tensor_backward(loss);
+    memcpy(expected, W->grad, sizeof(expected));
+    tensor_free(loss); tensor_free(a); tensor_free(e); tensor_free(h);
+
+    network_zero_grad(net);
+    Tensor *output = network_forward(net, input);
+    assert(output != NULL && output->inputs[0] != output);
+    loss = tensor_mse(output, target);
+    tensor_backward(loss);
+    for (size_t i = 0; i < W->size; i++) ASSERT_FLOAT_EQ(W->grad[i], expected[i]);
+
+    tensor_free(loss);
+    tensor_free(output->inputs[0]->inputs[0]);
+    tensor_free(output->inputs[0]);
+    tensor_free(output);
+    tensor_free(target);
+    tensor_free(input);
+    network_free(net);
+}
+
 // ====================================================
 // Network Parameter Tests
 // ====================================================
 
+// Batches of up to GEMM_SMALL_M rows run on the small-M kernels, larger ones
+// on the blocked GEMM; each row's output is the same either way
+TEST(network_forward_small_batch) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(300, 70)));
+    network_add_layer(net, layer_create(SIGMOID()));
+    network_add_layer(net, layer_create(LINEAR(70, 5)));
+    Tensor *input = tensor_randn((size_t[]){12, 300}, 2, 9);
+
+    Tensor *full = network_infer(net, input);
+    for (int prepack = 0; prepack <= 1; prepack++) {
+        network_prepack_weights(net, prepack);
+        for (size_t rows = 1; rows <= GEMM_SMALL_M; rows++) {
+            Tensor *slice = tensor_slice(input, 0, rows);
+            Tensor *out = network_infer(net, slice);
+            assert(out->shape[0] == rows && out->shape[1] == 5);
+            assert(memcmp(out->data, full->data, rows * 5 * sizeof(float)) == 0);
+            tensor_free(out);
+            tensor_free(slice);
+        }
+    }
+
+    tensor_free(full);
+    tensor_free(input);
+    network_free(net);
+}
+
+// Forward passes with pre-packed weights give the same bits as without, and
+// stay correct as an optimizer (or a direct write) changes the weights
+TEST(network_prepack_weights) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(20, 33)));
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(33, 4)));
+    Tensor *input = tensor_randn((size_t[]){3, 20}, 2, 7);
+    Tensor *target = tensor_randn((size_t[]){3, 4}, 2, 8);
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, SGD(0.1f, 0.0f));
+
+    Tensor *plain = network_infer(net, input);
+    assert(network_prepack_weights(net, 1) == 2);
+    assert(net->layers[0]->packed_weights != NULL && net->layers[1]->packed_weights == NULL);
+    Tensor *packed = network_infer(net, input);
+    assert(memcmp(plain->data, packed->data, plain->size * sizeof(float)) == 0);
+    tensor_free(plain);
+    tensor_free(packed);
+
+    for (int step = 0; step < 3; step++) {
+        network_train_step(net, input, target, opt, "mse");
+        if (step == 2) {
+            net->layers[2]->weights->data[0] += 1.0f;
+            net->layers[2]->weights->version++;
+        }
+
+        packed = network_infer(net, input);
+        network_prepack_weights(net, 0);
+        plain = network_infer(net, input);
+        network_prepack_weights(net, 1);
+        assert(memcmp(plain->data, packed->data, plain->size * sizeof(float)) == 0);
+        tensor_free(plain);
+        tensor_free(packed);
+    }
+
+    optimizer_free(opt);
+    network_free(net);
+    tensor_free(input);
+    tensor_free(target);
+}
+
 TEST(network_get_parameters) {
     Network *net = network_create();
     network_add_layer(net, layer_create(LINEAR(3, 4)));
@@ -175,6 +413,47 @@ TEST(network_zero_grad) {
     network_free(net);
 }
 
+TEST(network_flat_parameters) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(3, 4)));
+    Layer *first = net->layers[0];
+    float w0 = first->weights->data[5];
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(4, 2)));
+    
+    // Parameters sit back to back in one aligned buffer, values kept across rebuilds
+    assert(net->param_size == 12 + 4 + 8 + 2);
+    assert(((uintptr_t)net->param_data % 64) == 0);
+    size_t offset = 0;
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        Tensor *param = net->parameters[i];
+        assert(param->data == net->param_data + offset);
+        assert(param->grad == net->grad_data + offset);
+        offset += param->size;
+    }
+    ASSERT_FLOAT_EQ(first->weights->data[5], w0);
+    
+    // Gradients are preallocated and zero, and backward fills them in place
+    for (size_t i = 0; i < net->param_size; i++) ASSERT_FLOAT_EQ(net->grad_data[i], 0.0f);
+    Tensor *input = tensor_randn((size_t[]){5, 3}, 2, 4);
+    Tensor *target = tensor_randn((size_t[]){5, 2}, 2, 5);
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, SGD(0.01f, 0.0f));
+    network_train_step(net, input, target, opt, "mse");
+    assert(net->parameters[0]->grad == net->grad_data);
+    
+    float norm = 0.0f;
+    for (size_t i = 0; i < net->param_size; i++) norm += fabsf(net->grad_data[i]);
+    assert(norm > 0.0f);
+    
+    network_zero_grad(net);
+    for (size_t i = 0; i < net->param_size; i++) ASSERT_FLOAT_EQ(net->grad_data[i], 0.0f);
+    
+    optimizer_free(opt);
+    tensor_free(input);
+    tensor_free(target);
+    network_free(net);
+}
+
 // ====================================================
 // Network Training Tests
 // ====================================================
@@ -224,6 +503,36 @@ TEST(network_train_epochs) {
     network_free(net);
 }
 
+TEST(network_train_arena_steady_state) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(4, 8)));
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(8, 2)));
+    
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, SGD(0.01f, 0.0f));
+    
+    size_t shape[] = {16, 4};
+    Tensor *inputs = tensor_ones(shape, 2);
+    
+    size_t target_shape[] = {16, 2};
+    Tensor *targets = tensor_ones(target_shape, 2);
+    
+    network_train(net, opt, inputs, targets, 1, 4, "mse", 0);
+    assert(net->arena != NULL);
+    assert(arena_used(net->arena) == 0);
+    
+    // Intermediates are recycled, so later epochs never grow the arena
+    size_t capacity = arena_capacity(net->arena);
+    network_train(net, opt, inputs, targets, 5, 4, "mse", 0);
+    assert(arena_capacity(net->arena) == capacity);
+    assert(arena_get_active() == NULL);
+    
+    tensor_free(inputs);
+    tensor_free(targets);
+    optimizer_free(opt);
+    network_free(net);
+}
+
 TEST(network_train_with_cross_entropy) {
     Network *net = network_create();
     network_add_layer(net, layer_create(LINEAR(2, 3)));
@@ -256,6 +565,50 @@ TEST(network_train_with_cross_entropy) {
 // Network Accuracy Tests
 // ====================================================
 
+// The trailing SOFTMAX is folded into the fused loss, with the same result
+TEST(network_train_step_fused_cross_entropy) {
+    Network *fused = network_create();
+    network_add_layer(fused, layer_create(LINEAR(3, 4)));
+    network_add_layer(fused, layer_create(SOFTMAX()));
+    Network *plain = network_create();
+    network_add_layer(plain, layer_create(LINEAR(3, 4)));
+    network_add_layer(plain, layer_create(SOFTMAX()));
+    
+    Optimizer *fused_opt = optimizer_create(fused->parameters, fused->num_parameters, SGD(0.5f, 0.0f));
+    Optimizer *plain_opt = optimizer_create(plain->parameters, plain->num_parameters, SGD(0.5f, 0.0f));
+    
+    size_t shape[] = {6, 3};
+    Tensor *inputs = tensor_randn(shape, 2, 9);
+    size_t target_shape[] = {6, 4};
+    Tensor *targets = tensor_zeroes(target_shape, 2);
+    for (size_t i = 0; i < 6; i++) targets->data[i * 4 + i % 4] = 1.0f;
+    
+    for (int step = 0; step < 5; step++) {
+        float fused_loss = network_train_step(fused, inputs, targets, fused_opt, "cross_entropy");
+        
+        // Unfused reference: forward through the softmax, then the plain loss
+        Tensor *predictions = network_forward(plain, inputs);
+        Tensor *loss = tensor_cross_entropy(predictions, targets);
+        network_zero_grad(plain);
+        tensor_backward(loss);
+        optimizer_step(plain_opt);
+        
+        ASSERT_FLOAT_EQ(fused_loss, loss->data[0]);
+        tensor_tape_clear();
+    }
+    
+    for (size_t i = 0; i < fused->layers[0]->weights->size; i++) {
+        ASSERT_FLOAT_EQ(fused->layers[0]->weights->data[i], plain->layers[0]->weights->data[i]);
+    }
+    
+    tensor_free(inputs);
+    tensor_free(targets);
+    optimizer_free(fused_opt);
+    optimizer_free(plain_opt);
+    network_free(fused);
+    network_free(plain);
+}
+
 TEST(network_accuracy_perfect) {
     size_t shape[] = {3, 3};
     Tensor *predictions = tensor_create(shape, 2);
@@ -306,6 +659,54 @@ TEST(network_accuracy_partial) {
 // Network Save/Load Tests
 // ====================================================
 
+TEST(network_accuracy_sparse) {
+    size_t shape[] = {3, 3};
+    size_t label_shape[] = {3};
+    Tensor *predictions = tensor_create(shape, 2);
+    Tensor *labels = tensor_create(label_shape, 1);
+    
+    float probs[] = {0.7f, 0.2f, 0.1f,  0.1f, 0.1f, 0.8f,  0.3f, 0.6f, 0.1f};
+    for (size_t i = 0; i < 9; i++) predictions->data[i] = probs[i];
+    labels->data[0] = 0.0f;
+    labels->data[1] = 2.0f;
+    labels->data[2] = 0.0f;
+    
+    ASSERT_FLOAT_EQ(network_accuracy(predictions, labels), 2.0f / 3.0f);
+    
+    tensor_free(predictions);
+    tensor_free(labels);
+}
+
+TEST(network_train_sparse_labels) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(2, 8)));
+    network_add_layer(net, layer_create(TANH()));
+    network_add_layer(net, layer_create(LINEAR(8, 2)));
+    network_add_layer(net, layer_create(SOFTMAX()));
+    
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, ADAM(0.05f, 0.9f, 0.999f, 1e-8f));
+    
+    // XOR with class-index labels, sliced per batch by network_train
+    size_t shape[] = {4, 2};
+    size_t label_shape[] = {4};
+    Tensor *inputs = tensor_create(shape, 2);
+    Tensor *labels = tensor_create(label_shape, 1);
+    float x[] = {0, 0, 0, 1, 1, 0, 1, 1};
+    for (size_t i = 0; i < 8; i++) inputs->data[i] = x[i];
+    for (size_t i = 0; i < 4; i++) labels->data[i] = (float)((i == 1) || (i == 2));
+    
+    network_train(net, opt, inputs, labels, 300, 2, "sparse_cross_entropy", 0);
+    
+    Tensor *predictions = network_infer(net, inputs);
+    ASSERT_FLOAT_EQ(network_accuracy(predictions, labels), 1.0f);
+    
+    tensor_free(predictions);
+    tensor_free(inputs);
+    tensor_free(labels);
+    optimizer_free(opt);
+    network_free(net);
+}
+
 TEST(network_save_load) {
     Network *net = network_create();
     network_add_layer(net, layer_create(LINEAR(3, 2)));
@@ -329,6 +730,286 @@ TEST(network_save_load) {
     network_free(loaded);
 }
 
+// v2 files are mapped: parameters view aligned payloads, with the same results
+TEST(network_load_mapped) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(5, 7)));
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(7, 3)));
+    for (size_t i = 0; i < net->param_size; i++) net->param_data[i] = sinf((float)i);
+    
+    const char *filepath = "/tmp/test_network_v2.bdnn";
+    network_save(net, filepath);
+    
+    unsigned char header[8];
+    FILE *file = fopen(filepath, "rb");
+    assert(fread(header, 1, 8, file) == 8);
+    fclose(file);
+    assert(header[0] == 'N' && header[1] == 'N' && header[2] == 'D' && header[3] == 'B');
+    assert(header[4] == 2 && header[5] == 0 && header[6] == 0 && header[7] == 0);
+    
+    Network *loaded = network_load(filepath);
+    assert(loaded != NULL);
+    assert(loaded->num_layers == 3 && loaded->num_parameters == 4);
+    assert(loaded->mapping != NULL && loaded->param_data == NULL);
+    for (size_t i = 0; i < loaded->num_parameters; i++) {
+        Tensor *param = loaded->parameters[i];
+        assert(!param->owns_data);
+        assert(((uintptr_t)param->data % 64) == 0);
+        assert((char *)param->data > (char *)loaded->mapping);
+        assert((char *)(param->data + param->size) <= (char *)loaded->mapping + loaded->mapping_size);
+        for (size_t j = 0; j < param->size; j++) ASSERT_FLOAT_EQ(param->data[j], net->parameters[i]->data[j]);
+    }
+    
+    Tensor *input = tensor_randn((size_t[]){4, 5}, 2, 3);
+    Tensor *expected = network_infer(net, input);
+    Tensor *output = network_infer(loaded, input);
+    for (size_t i = 0; i < output->size; i++) ASSERT_FLOAT_EQ(output->data[i], expected->data[i]);
+    
+    // Training updates the mapped pages privately, leaving the file as saved
+    Tensor *target = tensor_randn((size_t[]){4, 3}, 2, 4);
+    Optimizer *opt = optimizer_create(loaded->parameters, loaded->num_parameters, SGD(0.1f, 0.0f));
+    network_train_step(loaded, input, target, opt, "mse");
+    assert(fabsf(loaded->parameters[0]->data[0] - net->parameters[0]->data[0]) > 0.0f);
+    
+    Network *reloaded = network_load(filepath);
+    ASSERT_FLOAT_EQ(reloaded->parameters[0]->data[0], net->parameters[0]->data[0]);
+    
+    optimizer_free(opt);
+    tensor_free(input);
+    tensor_free(target);
+    tensor_free(expected);
+    tensor_free(output);
+    network_free(net);
+    network_free(loaded);
+    network_free(reloaded);
+}
+
+// Files written before v2 still load
+TEST(network_load_v1) {
+    const char *filepath = "/tmp/test_network_v1.bdnn";
+    FILE *file = fopen(filepath, "wb");
+    uint32_t header[2] = {0x42444E4E, 1};
+    size_t num_layers = 2;
+    fwrite(header, sizeof(uint32_t), 2, file);
+    fwrite(&num_layers, sizeof(size_t), 1, file);
+    
+    size_t name_len = strlen("linear") + 1, config_size = sizeof(LinearParams), num_params = 2;
+    LinearParams params = {2, 3};
+    fwrite(&name_len, sizeof(size_t), 1, file);
+    fwrite("linear", 1, name_len, file);
+    fwrite(&config_size, sizeof(size_t), 1, file);
+    fwrite(&params, sizeof(LinearParams), 1, file);
+    fwrite(&num_params, sizeof(size_t), 1, file);
+    
+    size_t ndim = 2, weight_shape[] = {2, 3};
+    float weights[] = {1, 2, 3, 4, 5, 6};
+    fwrite(&ndim, sizeof(size_t), 1, file);
+    fwrite(weight_shape, sizeof(size_t), 2, file);
+    fwrite(weights, sizeof(float), 6, file);
+    
+    size_t bias_ndim = 1, bias_shape[] = {3};
+    float bias[] = {0.5f, -0.5f, 0.25f};
+    fwrite(&bias_ndim, sizeof(size_t), 1, file);
+    fwrite(bias_shape, sizeof(size_t), 1, file);
+    fwrite(bias, sizeof(float), 3, file);
+    
+    size_t relu_len = strlen("relu") + 1, zero = 0;
+    fwrite(&relu_len, sizeof(size_t), 1, file);
+    fwrite("relu", 1, relu_len, file);
+    fwrite(&zero, sizeof(size_t), 1, file);
+    fwrite(&zero, sizeof(size_t), 1, file);
+    fclose(file);
+    
+    Network *loaded = network_load(filepath);
+    assert(loaded != NULL);
+    assert(loaded->num_layers == 2 && loaded->mapping == NULL);
+    for (size_t i = 0; i < 6; i++) ASSERT_FLOAT_EQ(loaded->layers[0]->weights->data[i], weights[i]);
+    for (size_t i = 0; i < 3; i++) ASSERT_FLOAT_EQ(loaded->layers[0]->bias->data[i], bias[i]);
+    
+    network_free(loaded);
+}
+
+// Reads a whole file into a malloc'd buffer
+static unsigned char* read_file(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *data = malloc(*size ? *size : 1);
+    assert(fread(data, 1, *size, file) == *size);
+    fclose(file);
+    return data;
+}
+
+// Trains 3 steps, checkpoints, trains 3 more; a fresh network and optimizer
+// resumed from the checkpoint must end with the same bits
+static void check_checkpoint_resume(OptimizerConfig config) {
+    Tensor *input = tensor_randn((size_t[]){8, 6}, 2, 11);
+    Tensor *target = tensor_randn((size_t[]){8, 3}, 2, 12);
+    const char *filepath = "/tmp/test_network_training.ckpt";
+
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(6, 300)));
+    network_add_layer(net, layer_create(TANH()));
+    network_add_layer(net, layer_create(LINEAR(300, 3)));
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, config);
+
+    for (int i = 0; i < 3; i++) network_train_step(net, input, target, opt, "mse");
+    TrainingCursor cursor = {.epoch = 1, .batch = 2, .step = 3, .rng_state = {5, 6, 7, UINT64_MAX}};
+    assert(network_save_checkpoint(net, opt, &cursor, filepath));
+    for (int i = 0; i < 3; i++) network_train_step(net, input, target, opt, "mse");
+
+    Network *resumed = network_create();
+    network_add_layer(resumed, layer_create(LINEAR(6, 300)));
+    network_add_layer(resumed, layer_create(TANH()));
+    network_add_layer(resumed, layer_create(LINEAR(300, 3)));
+    Optimizer *resumed_opt = optimizer_create(resumed->parameters, resumed->num_parameters, config);
+
+    TrainingCursor loaded = {0};
+    assert(network_load_checkpoint(resumed, resumed_opt, &loaded, filepath));
+    assert(memcmp(&loaded, &cursor, sizeof(cursor)) == 0);
+    for (int i = 0; i < 3; i++) network_train_step(resumed, input, target, resumed_opt, "mse");
+
+    assert(resumed->param_size == net->param_size);
+    assert(memcmp(resumed->param_data, net->param_data, net->param_size * sizeof(float)) == 0);
+
+    // A different architecture is rejected
+    Network *other = network_create();
+    network_add_layer(other, layer_create(LINEAR(6, 3)));
+    Optimizer *other_opt = optimizer_create(other->parameters, other->num_parameters, config);
+    assert(!network_load_checkpoint(other, other_opt, &loaded, filepath));
+
+    // A file cut short in the parameters or in the optimizer state changes nothing
+    size_t size;
+    unsigned char *image = read_file(filepath, &size);
+    size_t cuts[2] = {100, size - 8};
+    float *params = malloc(net->param_size * sizeof(float));
+    memcpy(params, net->param_data, net->param_size * sizeof(float));
+    for (int c = 0; c < 2; c++) {
+        FILE *file = fopen(filepath, "wb");
+        assert(fwrite(image, 1, cuts[c], file) == cuts[c]);
+        fclose(file);
+
+        char *before, *after;
+        size_t before_size, after_size;
+        FILE *stream = open_memstream(&before, &before_size);
+        assert(optimizer_write(opt, stream));
+        fclose(stream);
+        assert(!network_load_checkpoint(net, opt, &loaded, filepath));
+        stream = open_memstream(&after, &after_size);
+        assert(optimizer_write(opt, stream));
+        fclose(stream);
+
+        assert(memcmp(net->param_data, params, net->param_size * sizeof(float)) == 0);
+        assert(before_size == after_size && memcmp(before, after, before_size) == 0);
+        free(before);
+        free(after);
+    }
+    free(params);
+    free(image);
+
+    remove(filepath);
+    optimizer_free(other_opt);
+    network_free(other);
+    optimizer_free(resumed_opt);
+    network_free(resumed);
+    optimizer_free(opt);
+    network_free(net);
+    tensor_free(input);
+    tensor_free(target);
+}
+
+TEST(network_checkpoint_resume) {
+    check_checkpoint_resume(SGD(0.05f, 0.9f));
+    check_checkpoint_resume(ADAM(0.01f, 0.9f, 0.999f, 1e-8f));
+    check_checkpoint_resume(ADAMW_BF16(0.01f, 0.9f, 0.999f, 1e-8f, 0.01f));
+    check_checkpoint_resume(ADAMW_8BIT(0.01f, 0.9f, 0.999f, 1e-8f, 0.01f));
+}
+
+// Entries of dir whose names start with prefix
+static size_t count_files(const char *dir, const char *prefix) {
+    DIR *d = opendir(dir);
+    assert(d != NULL);
+    size_t count = 0;
+    for (struct dirent *entry; (entry = readdir(d)) != NULL;)
+        if (strncmp(entry->d_name, prefix, strlen(prefix)) == 0) count++;
+    closedir(d);
+    return count;
+}
+
+TEST(network_save_async) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(5, 7)));
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(7, 3)));
+    for (size_t i = 0; i < net->param_size; i++) net->param_data[i] = sinf((float)i);
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, ADAM(0.01f, 0.9f, 0.999f, 1e-8f));
+    TrainingCursor cursor = {.epoch = 4, .step = 9};
+
+    const char *sync_path = "/tmp/test_network_sync.bdnn";
+    const char *async_path = "/tmp/test_network_async.bdnn";
+    const char *sync_ckpt = "/tmp/test_network_sync.ckpt";
+    const char *async_ckpt = "/tmp/test_network_async.ckpt";
+    network_save(net, sync_path);
+    assert(network_save_checkpoint(net, opt, &cursor, sync_ckpt));
+
+    // The snapshot is taken before returning: later updates do not reach the file
+    CheckpointHandle *handle = network_save_async(net, async_path);
+    CheckpointHandle *ckpt_handle = network_save_checkpoint_async(net, opt, &cursor, async_ckpt);
+    assert(handle != NULL && ckpt_handle != NULL);
+    for (size_t i = 0; i < net->param_size; i++) net->param_data[i] = -1.0f;
+    assert(checkpoint_wait(handle));
+    assert(checkpoint_wait(ckpt_handle));
+    assert(checkpoint_done(NULL));
+
+    // Byte-identical to the synchronous saves, with no temporary left behind
+    const char *pairs[2][2] = {{sync_path, async_path}, {sync_ckpt, async_ckpt}};
+    for (int k = 0; k < 2; k++) {
+        size_t sync_size, async_size;
+        unsigned char *expected = read_file(pairs[k][0], &sync_size);
+        unsigned char *actual = read_file(pairs[k][1], &async_size);
+        assert(expected && actual && sync_size == async_size);
+        assert(memcmp(expected, actual, sync_size) == 0);
+        free(expected);
+        free(actual);
+    }
+    assert(count_files("/tmp", "test_network_async.bdnn.") == 0);
+
+    // Overlapping saves to one path each commit a whole file: the last rename
+    // wins and no temporary is left
+    CheckpointHandle *first = network_save_async(net, async_path);
+    CheckpointHandle *second = network_save_async(net, async_path);
+    assert(first != NULL && second != NULL);
+    assert(checkpoint_wait(first));
+    assert(checkpoint_wait(second));
+    assert(count_files("/tmp", "test_network_async.bdnn.") == 0);
+    Network *loaded = network_load(async_path);
+    assert(loaded != NULL && loaded->num_parameters == net->num_parameters);
+    for (size_t p = 0; p < loaded->num_parameters; p++)
+        for (size_t i = 0; i < loaded->parameters[p]->size; i++) assert(loaded->parameters[p]->data[i] == -1.0f);
+    network_free(loaded);
+
+    // A replaced file keeps its mode
+    struct stat st;
+    assert(chmod(async_path, 0600) == 0);
+    assert(checkpoint_wait(network_save_async(net, async_path)));
+    assert(stat(async_path, &st) == 0 && (st.st_mode & 0777) == 0600);
+
+    // A failed write reports through the handle
+    handle = network_save_async(net, "/tmp/test_network_missing_dir/net.bdnn");
+    assert(handle != NULL);
+    assert(!checkpoint_wait(handle));
+
+    remove(sync_path);
+    remove(async_path);
+    remove(sync_ckpt);
+    remove(async_ckpt);
+    optimizer_free(opt);
+    network_free(net);
+}
+
 // ====================================================
 // Network Print Tests
 // ====================================================
@@ -393,22 +1074,38 @@ int main() {
     RUN_TEST(network_forward_single_layer);
     RUN_TEST(network_forward_multilayer);
     RUN_TEST(network_forward_with_activations);
+    RUN_TEST(network_forward_fuses_linear_activation);
+    RUN_TEST(network_infer_matches_forward);
+    RUN_TEST(network_infer_empty);
+    RUN_TEST(network_infer_activations_in_place);
+    RUN_TEST(network_forward_keeps_hand_wired_outputs);
+    RUN_TEST(network_forward_small_batch);
+    RUN_TEST(network_prepack_weights);
     
     // Parameter tests
     RUN_TEST(network_get_parameters);
     RUN_TEST(network_zero_grad);
+    RUN_TEST(network_flat_parameters);
     
     // Training tests
     RUN_TEST(network_train_step);
     RUN_TEST(network_train_epochs);
+    RUN_TEST(network_train_arena_steady_state);
     RUN_TEST(network_train_with_cross_entropy);
+    RUN_TEST(network_train_step_fused_cross_entropy);
     
     // Accuracy tests
     RUN_TEST(network_accuracy_perfect);
     RUN_TEST(network_accuracy_partial);
+    RUN_TEST(network_accuracy_sparse);
+    RUN_TEST(network_train_sparse_labels);
     
     // Save/load tests
     RUN_TEST(network_save_load);
+    RUN_TEST(network_load_mapped);
+    RUN_TEST(network_load_v1);
+    RUN_TEST(network_checkpoint_resume);
+    RUN_TEST(network_save_async);
     
     // Print test
     RUN_TEST(network_print);
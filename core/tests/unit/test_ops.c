@@ -108,6 +108,95 @@ TEST(tensor_mul) {
     tensor_free(c);
 }
 
+TEST(tensor_div) {
+    size_t shape[] = {2, 2};
+    Tensor *a = tensor_create(shape, 2);
+    Tensor *b = tensor_create(shape, 2);
+    
+    a->data[0] = 3.0f; a->data[1] = 6.0f;
+    a->data[2] = 1.0f; a->data[3] = -8.0f;
+    
+    b->data[0] = 1.5f; b->data[1] = 2.0f;
+    b->data[2] = 0.5f; b->data[3] = 4.0f;
+    
+    Tensor *c = tensor_div(a, b);
+    
+    assert(c != NULL);
+    ASSERT_FLOAT_EQ(c->data[0], 2.0f);
+    ASSERT_FLOAT_EQ(c->data[1], 3.0f);
+    ASSERT_FLOAT_EQ(c->data[2], 2.0f);
+    ASSERT_FLOAT_EQ(c->data[3], -2.0f);
+    
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(c);
+}
+
+TEST(tensor_broadcast_column_and_scalar) {
+    size_t shape_a[] = {2, 3};
+    size_t shape_col[] = {2, 1};
+    size_t shape_scalar[] = {1};
+    
+    Tensor *a = tensor_create(shape_a, 2);
+    Tensor *col = tensor_create(shape_col, 2);
+    Tensor *s = tensor_create(shape_scalar, 1);
+    
+    for (size_t i = 0; i < 6; i++) a->data[i] = (float)i;
+    col->data[0] = 10.0f; col->data[1] = 20.0f;
+    s->data[0] = 2.0f;
+    
+    Tensor *c = tensor_sub(a, col);
+    assert(c != NULL && c->ndim == 2 && c->shape[0] == 2 && c->shape[1] == 3);
+    for (size_t i = 0; i < 6; i++) ASSERT_FLOAT_EQ(c->data[i], (float)i - (i < 3 ? 10.0f : 20.0f));
+    
+    // Scalar on the left, and {2, 1} against {3} expanding both sides
+    Tensor *d = tensor_mul(s, a);
+    for (size_t i = 0; i < 6; i++) ASSERT_FLOAT_EQ(d->data[i], 2.0f * (float)i);
+    
+    size_t shape_row[] = {3};
+    Tensor *row = tensor_create(shape_row, 1);
+    for (size_t i = 0; i < 3; i++) row->data[i] = (float)i;
+    Tensor *e = tensor_add(col, row);
+    assert(e != NULL && e->shape[0] == 2 && e->shape[1] == 3);
+    ASSERT_FLOAT_EQ(e->data[2], 12.0f);
+    ASSERT_FLOAT_EQ(e->data[3], 20.0f);
+    
+    Tensor *outputs[] = {a, col, s, row, c, d, e};
+    for (size_t i = 0; i < 7; i++) tensor_free(outputs[i]);
+}
+
+TEST(tensor_broadcast_large_matches_loop) {
+    size_t shape_a[] = {4, 3, 5000};
+    size_t shape_b[] = {3, 1};
+    
+    Tensor *a = tensor_randn(shape_a, 3, 1);
+    Tensor *b = tensor_randn(shape_b, 2, 2);
+    Tensor *c = tensor_add(a, b);
+    
+    assert(c != NULL && c->ndim == 3);
+    for (size_t i = 0; i < c->size; i++) {
+        ASSERT_FLOAT_EQ(c->data[i], a->data[i] + b->data[(i / 5000) % 3]);
+    }
+    
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(c);
+}
+
+TEST(tensor_broadcast_incompatible) {
+    size_t shape_a[] = {2, 3};
+    size_t shape_b[] = {2};
+    
+    Tensor *a = tensor_create(shape_a, 2);
+    Tensor *b = tensor_create(shape_b, 1);
+    
+    assert(tensor_add(a, b) == NULL);
+    assert(tensor_mul(b, a) == NULL);
+    
+    tensor_free(a);
+    tensor_free(b);
+}
+
 // ====================================================
 // Linear Algebra Tests
 // ====================================================
@@ -198,6 +287,74 @@ TEST(tensor_matmul_1d_1d) {
     tensor_free(c);
 }
 
+// C[i][j] of the product of row-major A [M x K] and B [K x N]
+static float matmul_entry(const float *A, const float *B, size_t i, size_t j, size_t K, size_t N) {
+    float acc = 0.0f;
+    for (size_t k = 0; k < K; k++) acc += A[i * K + k] * B[k * N + j];
+    return acc;
+}
+
+TEST(tensor_matmul_batched_broadcast) {
+    Tensor *a = tensor_randn((size_t[]){2, 1, 3, 4}, 4, 1);
+    Tensor *b = tensor_randn((size_t[]){3, 4, 5}, 3, 2);
+    
+    Tensor *c = tensor_matmul(a, b);
+    
+    assert(c != NULL);
+    assert(c->ndim == 4);
+    assert(c->shape[0] == 2 && c->shape[1] == 3 && c->shape[2] == 3 && c->shape[3] == 5);
+    
+    for (size_t n = 0; n < 2; n++) {
+        for (size_t h = 0; h < 3; h++) {
+            const float *ab = a->data + n * 12;
+            const float *bb = b->data + h * 20;
+            const float *cb = c->data + (n * 3 + h) * 15;
+            for (size_t i = 0; i < 3; i++) {
+                for (size_t j = 0; j < 5; j++) {
+                    ASSERT_FLOAT_EQ(cb[i * 5 + j], matmul_entry(ab, bb, i, j, 4, 5));
+                }
+            }
+        }
+    }
+    
+    // Leading dims must broadcast and inner dims agree
+    Tensor *bad = tensor_randn((size_t[]){2, 4, 5}, 3, 3);
+    assert(tensor_matmul(b, bad) == NULL);
+    assert(tensor_matmul(a, a) == NULL);
+    
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(c);
+    tensor_free(bad);
+}
+
+// Q·Kᵀ per batch entry, with Kᵀ a strided view
+TEST(tensor_matmul_batched_transposed_view) {
+    Tensor *q = tensor_randn((size_t[]){2, 3, 4}, 3, 4);
+    Tensor *k = tensor_randn((size_t[]){2, 3, 4}, 3, 5);
+    Tensor *kt = tensor_view(k, (size_t[]){2, 4, 3}, 3, (size_t[]){12, 1, 4}, 0);
+    assert(kt != NULL && !tensor_is_contiguous(kt));
+    
+    Tensor *s = tensor_matmul(q, kt);
+    assert(s != NULL);
+    assert(s->shape[0] == 2 && s->shape[1] == 3 && s->shape[2] == 3);
+    
+    for (size_t n = 0; n < 2; n++) {
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                float dot = 0.0f;
+                for (size_t d = 0; d < 4; d++) dot += q->data[n * 12 + i * 4 + d] * k->data[n * 12 + j * 4 + d];
+                ASSERT_FLOAT_EQ(s->data[n * 9 + i * 3 + j], dot);
+            }
+        }
+    }
+    
+    tensor_free(s);
+    tensor_free(kt);
+    tensor_free(k);
+    tensor_free(q);
+}
+
 TEST(tensor_transpose2d) {
     size_t shape[] = {2, 3};
     Tensor *a = tensor_create(shape, 2);
@@ -212,12 +369,215 @@ TEST(tensor_transpose2d) {
     assert(b->shape[0] == 3);
     assert(b->shape[1] == 2);
     
-    ASSERT_FLOAT_EQ(b->data[0], 1.0f); ASSERT_FLOAT_EQ(b->data[1], 4.0f);
-    ASSERT_FLOAT_EQ(b->data[2], 2.0f); ASSERT_FLOAT_EQ(b->data[3], 5.0f);
-    ASSERT_FLOAT_EQ(b->data[4], 3.0f); ASSERT_FLOAT_EQ(b->data[5], 6.0f);
+    // Zero-copy: b shares a's storage and is not row-major
+    assert(b->data == a->data);
+    assert(!tensor_is_contiguous(b));
     
+    Tensor *c = tensor_contiguous(b);
+    assert(c != b);
+    assert(tensor_is_contiguous(c));
+    
+    ASSERT_FLOAT_EQ(c->data[0], 1.0f); ASSERT_FLOAT_EQ(c->data[1], 4.0f);
+    ASSERT_FLOAT_EQ(c->data[2], 2.0f); ASSERT_FLOAT_EQ(c->data[3], 5.0f);
+    ASSERT_FLOAT_EQ(c->data[4], 3.0f); ASSERT_FLOAT_EQ(c->data[5], 6.0f);
+    
+    tensor_free(c);
+    tensor_free(b);
     tensor_free(a);
+}
+
+// Fused linear against matmul + add + activation, values and gradients. With
+// W frozen, db comes from its own column-sum pass instead of the dW GEMM
+static void check_linear_fused(LinearActivation activation, Tensor* (*act)(Tensor *), size_t batch, int freeze_w) {
+    size_t x_shape[] = {batch, 20};
+    size_t w_shape[] = {20, 19};
+    size_t b_shape[] = {19};
+    Tensor *x = tensor_randn(x_shape, 2, 1);
+    Tensor *w = tensor_randn(w_shape, 2, 2);
+    Tensor *b = tensor_randn(b_shape, 1, 3);
+    tensor_set_requires_grad(x, 1);
+    tensor_set_requires_grad(w, !freeze_w);
+    tensor_set_requires_grad(b, 1);
+
+    Tensor *z0 = tensor_matmul(x, w);
+    Tensor *z = tensor_add(z0, b);
+    Tensor *ref = act ? act(z) : z;
+    Tensor *zero = tensor_zeroes(ref->shape, 2);
+    Tensor *ref_loss = tensor_mse(ref, zero);
+    tensor_backward(ref_loss);
+
+    float *ref_grads[3] = {NULL, NULL, NULL};
+    Tensor *params[] = {x, w, b};
+    for (size_t p = 0; p < 3; p++) {
+        if (!params[p]->requires_grad) continue;
+        ref_grads[p] = malloc(params[p]->size * sizeof(float));
+        for (size_t i = 0; i < params[p]->size; i++) ref_grads[p][i] = params[p]->grad[i];
+        tensor_zero_grad(params[p]);
+    }
+
+    Tensor *y = tensor_linear(x, w, b, activation);
+    assert(y != NULL);
+    assert(y->num_inputs == 3);
+    for (size_t i = 0; i < y->size; i++) {
+        ASSERT_FLOAT_EQ(y->data[i], ref->data[i]);
+    }
+
+    Tensor *loss = tensor_mse(y, zero);
+    tensor_backward(loss);
+    for (size_t p = 0; p < 3; p++) {
+        if (!params[p]->requires_grad) continue;
+        for (size_t i = 0; i < params[p]->size; i++) {
+            ASSERT_FLOAT_EQ(params[p]->grad[i], ref_grads[p][i]);
+        }
+        free(ref_grads[p]);
+    }
+    assert(!freeze_w || w->grad == NULL);
+
+    tensor_free(loss);
+    tensor_free(y);
+    tensor_free(ref_loss);
+    tensor_free(zero);
+    if (ref != z) tensor_free(ref);
+    tensor_free(z);
+    tensor_free(z0);
+    tensor_free(b);
+    tensor_free(w);
+    tensor_free(x);
+}
+
+TEST(tensor_linear_fused) {
+    check_linear_fused(LINEAR_ACT_NONE, NULL, 7, 0);
+    check_linear_fused(LINEAR_ACT_RELU, tensor_relu, 7, 0);
+    check_linear_fused(LINEAR_ACT_SIGMOID, tensor_sigmoid, 7, 0);
+    check_linear_fused(LINEAR_ACT_TANH, tensor_tanh, 7, 0);
+
+    // Enough rows for the dZ and bias passes to split across tasks
+    check_linear_fused(LINEAR_ACT_RELU, tensor_relu, 1000, 0);
+    check_linear_fused(LINEAR_ACT_SIGMOID, tensor_sigmoid, 1000, 1);
+    check_linear_fused(LINEAR_ACT_TANH, tensor_tanh, 7, 1);
+}
+
+TEST(tensor_linear_1d) {
+    size_t w_shape[] = {3, 2};
+    size_t v_shape[] = {3};
+    size_t b_shape[] = {2};
+    Tensor *x = tensor_create(v_shape, 1);
+    Tensor *w = tensor_create(w_shape, 2);
+    Tensor *b = tensor_create(b_shape, 1);
+    for (size_t i = 0; i < 3; i++) x->data[i] = (float)(i + 1);
+    for (size_t i = 0; i < 6; i++) w->data[i] = (float)i - 3.0f;
+    b->data[0] = 1.0f;
+    b->data[1] = -20.0f;
+
+    // x·w = [1*-3 + 2*-1 + 3*1, 1*-2 + 2*0 + 3*2] = [-2, 4]
+    Tensor *y = tensor_linear(x, w, b, LINEAR_ACT_RELU);
+    assert(y != NULL);
+    assert(y->ndim == 1 && y->shape[0] == 2);
+    ASSERT_FLOAT_EQ(y->data[0], 0.0f);
+    ASSERT_FLOAT_EQ(y->data[1], 0.0f);
+
+    b->data[1] = 1.0f;
+    Tensor *y2 = tensor_linear(x, w, b, LINEAR_ACT_NONE);
+    ASSERT_FLOAT_EQ(y2->data[0], -1.0f);
+    ASSERT_FLOAT_EQ(y2->data[1], 5.0f);
+
+    assert(tensor_linear(w, w, b, LINEAR_ACT_NONE) == NULL);
+
+    tensor_free(y2);
+    tensor_free(y);
     tensor_free(b);
+    tensor_free(w);
+    tensor_free(x);
+}
+
+// ====================================================
+// View Tests
+// ====================================================
+
+TEST(tensor_view_of_view) {
+    size_t shape[] = {2, 3, 4};
+    Tensor *a = tensor_create(shape, 3);
+    for (size_t i = 0; i < 24; i++) a->data[i] = (float)i;
+    
+    // Swap the last two dimensions: [2, 4, 3]
+    Tensor *t = tensor_view(a, (size_t[]){2, 4, 3}, 3, (size_t[]){12, 1, 4}, 0);
+    assert(t != NULL);
+    assert(!tensor_is_contiguous(t));
+    
+    // Second batch, row 1 of the transposed view: a[1, :, 1]
+    Tensor *r = tensor_view(t, (size_t[]){3}, 1, (size_t[]){1}, 12 + 3);
+    assert(r != NULL);
+    assert(r->data == a->data + 13);
+    
+    float dense[3];
+    tensor_gather(r, dense);
+    ASSERT_FLOAT_EQ(dense[0], 13.0f);
+    ASSERT_FLOAT_EQ(dense[1], 17.0f);
+    ASSERT_FLOAT_EQ(dense[2], 21.0f);
+    
+    // Row-major reshape of a non-contiguous view needs a copy
+    assert(tensor_view(t, (size_t[]){24}, 1, (size_t[]){1}, 0) == NULL);
+    
+    tensor_free(r);
+    tensor_free(t);
+    tensor_free(a);
+}
+
+TEST(matmul_transposed_view) {
+    size_t a_shape[] = {5, 7};
+    size_t w_shape[] = {9, 7};
+    Tensor *a = tensor_randn(a_shape, 2, 3);
+    Tensor *w = tensor_randn(w_shape, 2, 4);
+    
+    Tensor *wt_view = tensor_transpose2d(w);
+    Tensor *wt_copy = tensor_contiguous(wt_view);
+    
+    Tensor *c_view = tensor_matmul(a, wt_view);
+    Tensor *c_copy = tensor_matmul(a, wt_copy);
+    assert(c_view != NULL && c_copy != NULL);
+    for (size_t i = 0; i < c_view->size; i++) {
+        ASSERT_FLOAT_EQ(c_view->data[i], c_copy->data[i]);
+    }
+    
+    tensor_free(c_view);
+    tensor_free(c_copy);
+    tensor_free(wt_copy);
+    tensor_free(wt_view);
+    tensor_free(w);
+    tensor_free(a);
+}
+
+TEST(backward_transpose_view) {
+    size_t shape[] = {2, 3};
+    Tensor *a = tensor_create(shape, 2);
+    for (size_t i = 0; i < 6; i++) a->data[i] = (float)i;
+    tensor_set_requires_grad(a, 1);
+    
+    // loss = mean((a^T * m)^2)
+    Tensor *t = tensor_transpose2d(a);
+    size_t t_shape[] = {3, 2};
+    Tensor *m = tensor_create(t_shape, 2);
+    for (size_t i = 0; i < 6; i++) m->data[i] = (float)(i + 1);
+    Tensor *y = tensor_mul(t, m);
+    Tensor *zero = tensor_zeroes(t_shape, 2);
+    Tensor *loss = tensor_mse(y, zero);
+    
+    tensor_backward(loss);
+    
+    // dL/da[i][j] = 2/6 * a[i][j] * m[j][i]^2
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            float mji = m->data[j * 2 + i];
+            ASSERT_FLOAT_EQ(a->grad[i * 3 + j], (2.0f / 6.0f) * a->data[i * 3 + j] * mji * mji);
+        }
+    }
+    
+    tensor_free(loss);
+    tensor_free(zero);
+    tensor_free(y);
+    tensor_free(m);
+    tensor_free(t);
+    tensor_free(a);
 }
 
 // ====================================================
@@ -407,6 +767,109 @@ TEST(tensor_binary_cross_entropy) {
     tensor_free(loss);
 }
 
+TEST(tensor_softmax_cross_entropy) {
+    size_t shape[] = {3, 5};
+    Tensor *logits = tensor_randn(shape, 2, 5);
+    Tensor *target = tensor_zeroes(shape, 2);
+    for (size_t r = 0; r < 3; r++) target->data[r * 5 + (r * 2) % 5] = 1.0f;
+    tensor_set_requires_grad(logits, 1);
+    
+    // Unfused reference
+    Tensor *probs = tensor_softmax(logits);
+    Tensor *ref = tensor_cross_entropy(probs, target);
+    tensor_backward(ref);
+    float ref_grad[15];
+    for (size_t i = 0; i < 15; i++) ref_grad[i] = logits->grad[i];
+    tensor_zero_grad(logits);
+    
+    Tensor *loss = tensor_softmax_cross_entropy(logits, target);
+    assert(loss != NULL);
+    ASSERT_FLOAT_EQ(loss->data[0], ref->data[0]);
+    
+    // d/dz = p - t
+    tensor_backward(loss);
+    for (size_t i = 0; i < 15; i++) {
+        ASSERT_FLOAT_EQ(logits->grad[i], probs->data[i] - target->data[i]);
+        ASSERT_FLOAT_EQ(logits->grad[i], ref_grad[i]);
+    }
+    
+    tensor_free(loss);
+    tensor_free(ref);
+    tensor_free(probs);
+    tensor_free(target);
+    tensor_free(logits);
+}
+
+TEST(tensor_softmax_cross_entropy_large_logits) {
+    size_t shape[] = {1, 3};
+    Tensor *logits = tensor_create(shape, 2);
+    Tensor *target = tensor_zeroes(shape, 2);
+    logits->data[0] = 1000.0f;
+    logits->data[1] = 0.0f;
+    logits->data[2] = -1000.0f;
+    target->data[2] = 1.0f;
+    
+    // softmax underflows to 0 for the target class; log-sum-exp does not
+    Tensor *loss = tensor_softmax_cross_entropy(logits, target);
+    assert(loss != NULL);
+    assert(isfinite(loss->data[0]));
+    ASSERT_FLOAT_EQ(loss->data[0] / 2000.0f, 1.0f / 3.0f);
+    
+    tensor_free(loss);
+    tensor_free(target);
+    tensor_free(logits);
+}
+
+TEST(tensor_sparse_cross_entropy) {
+    size_t shape[] = {4, 6};
+    size_t label_shape[] = {4};
+    Tensor *logits = tensor_randn(shape, 2, 8);
+    Tensor *labels = tensor_create(label_shape, 1);
+    Tensor *onehot = tensor_zeroes(shape, 2);
+    for (size_t r = 0; r < 4; r++) {
+        labels->data[r] = (float)((r * 5) % 6);
+        onehot->data[r * 6 + (r * 5) % 6] = 1.0f;
+    }
+    tensor_set_requires_grad(logits, 1);
+    Tensor *probs = tensor_softmax(logits);
+    
+    // Each sparse loss against its dense counterpart, values and gradients
+    Tensor* (*dense_fns[])(Tensor *, Tensor *) = {tensor_cross_entropy, tensor_softmax_cross_entropy};
+    Tensor* (*sparse_fns[])(Tensor *, Tensor *) = {tensor_sparse_cross_entropy, tensor_sparse_softmax_cross_entropy};
+    Tensor *inputs[] = {probs, logits};
+    
+    for (size_t f = 0; f < 2; f++) {
+        tensor_zero_grad(logits);
+        Tensor *dense = dense_fns[f](inputs[f], onehot);
+        tensor_backward(dense);
+        float dense_grad[24];
+        for (size_t i = 0; i < 24; i++) dense_grad[i] = logits->grad[i];
+        
+        tensor_zero_grad(logits);
+        if (probs->grad) tensor_zero_grad(probs);
+        Tensor *sparse = sparse_fns[f](inputs[f], labels);
+        assert(sparse != NULL);
+        ASSERT_FLOAT_EQ(sparse->data[0], dense->data[0]);
+        tensor_backward(sparse);
+        for (size_t i = 0; i < 24; i++) ASSERT_FLOAT_EQ(logits->grad[i], dense_grad[i]);
+        
+        tensor_free(sparse);
+        tensor_free(dense);
+        if (probs->grad) tensor_zero_grad(probs);
+    }
+    
+    // Out-of-range and fractional labels are rejected
+    labels->data[2] = 6.0f;
+    assert(tensor_sparse_cross_entropy(probs, labels) == NULL);
+    labels->data[2] = 1.5f;
+    assert(tensor_sparse_softmax_cross_entropy(logits, labels) == NULL);
+    
+    tensor_free(probs);
+    tensor_free(onehot);
+    tensor_free(labels);
+    tensor_free(logits);
+}
+
 // ====================================================
 // Slice Tests
 // ====================================================
@@ -434,6 +897,28 @@ TEST(tensor_slice) {
     tensor_free(a);
 }
 
+TEST(backward_slice) {
+    size_t shape[] = {4, 2};
+    Tensor *a = tensor_ones(shape, 2);
+    tensor_set_requires_grad(a, 1);
+    
+    Tensor *slice = tensor_slice(a, 1, 3);
+    Tensor *zero = tensor_zeroes((size_t[]){2, 2}, 2);
+    Tensor *loss = tensor_mse(slice, zero);
+    tensor_backward(loss);
+    
+    // Only rows 1 and 2 receive gradient: 2/4 * 1
+    for (size_t i = 0; i < 8; i++) {
+        float expected = (i >= 2 && i < 6) ? 0.5f : 0.0f;
+        ASSERT_FLOAT_EQ(a->grad[i], expected);
+    }
+    
+    tensor_free(loss);
+    tensor_free(zero);
+    tensor_free(slice);
+    tensor_free(a);
+}
+
 // ====================================================
 // Gradient Tests
 // ====================================================
@@ -497,6 +982,62 @@ TEST(backward_mul) {
     tensor_free(c);
 }
 
+TEST(backward_broadcast) {
+    size_t shape_a[] = {2, 2, 3};
+    size_t shape_b[] = {2, 1};
+    Tensor *a = tensor_ones(shape_a, 3);
+    Tensor *b = tensor_create(shape_b, 2);
+    
+    b->data[0] = 2.0f; b->data[1] = 3.0f;
+    
+    tensor_set_requires_grad(a, 1);
+    tensor_set_requires_grad(b, 1);
+    
+    Tensor *c = tensor_mul(a, b);
+    Tensor *d = tensor_sub(c, b);
+    assert(d->shape[0] == 2 && d->shape[1] == 2 && d->shape[2] == 3);
+    tensor_backward(d);
+    
+    // dA = B broadcast; dB sums (A - 1) over the 6 elements each b[i] touched
+    for (size_t i = 0; i < 12; i++) ASSERT_FLOAT_EQ(a->grad[i], (i / 3) % 2 ? 3.0f : 2.0f);
+    ASSERT_FLOAT_EQ(b->grad[0], 0.0f);
+    ASSERT_FLOAT_EQ(b->grad[1], 0.0f);
+    
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(c);
+    tensor_free(d);
+}
+
+TEST(backward_div) {
+    size_t shape_a[] = {2, 2};
+    size_t shape_b[] = {2};
+    Tensor *a = tensor_create(shape_a, 2);
+    Tensor *b = tensor_create(shape_b, 1);
+    
+    a->data[0] = 1.0f; a->data[1] = 2.0f;
+    a->data[2] = 3.0f; a->data[3] = 4.0f;
+    b->data[0] = 2.0f; b->data[1] = 4.0f;
+    
+    tensor_set_requires_grad(a, 1);
+    tensor_set_requires_grad(b, 1);
+    
+    Tensor *c = tensor_div(a, b);
+    tensor_backward(c);
+    
+    // dA = 1/b, dB = -sum(a) / b^2 over the column
+    ASSERT_FLOAT_EQ(a->grad[0], 0.5f);
+    ASSERT_FLOAT_EQ(a->grad[1], 0.25f);
+    ASSERT_FLOAT_EQ(a->grad[2], 0.5f);
+    ASSERT_FLOAT_EQ(a->grad[3], 0.25f);
+    ASSERT_FLOAT_EQ(b->grad[0], -4.0f / 4.0f);
+    ASSERT_FLOAT_EQ(b->grad[1], -6.0f / 16.0f);
+    
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(c);
+}
+
 TEST(backward_relu) {
     size_t shape[] = {4};
     Tensor *a = tensor_create(shape, 1);
@@ -522,6 +1063,242 @@ TEST(backward_relu) {
     tensor_free(b);
 }
 
+// [2, 3, 4]·[4, 5]: the weight is shared, so its gradient sums over the batch
+TEST(backward_matmul_batched) {
+    Tensor *a = tensor_randn((size_t[]){2, 3, 4}, 3, 6);
+    Tensor *w = tensor_randn((size_t[]){4, 5}, 2, 7);
+    tensor_set_requires_grad(a, 1);
+    tensor_set_requires_grad(w, 1);
+    
+    Tensor *c = tensor_matmul(a, w);
+    Tensor *zero = tensor_zeroes(c->shape, c->ndim);
+    Tensor *loss = tensor_mse(c, zero);
+    tensor_backward(loss);
+    
+    // dC = 2C / size
+    float scale = 2.0f / c->size;
+    for (size_t n = 0; n < 2; n++) {
+        for (size_t i = 0; i < 3; i++) {
+            for (size_t k = 0; k < 4; k++) {
+                float expected = 0.0f;
+                for (size_t j = 0; j < 5; j++) expected += scale * c->data[n * 15 + i * 5 + j] * w->data[k * 5 + j];
+                ASSERT_FLOAT_EQ(a->grad[n * 12 + i * 4 + k], expected);
+            }
+        }
+    }
+    for (size_t k = 0; k < 4; k++) {
+        for (size_t j = 0; j < 5; j++) {
+            float expected = 0.0f;
+            for (size_t r = 0; r < 6; r++) expected += a->data[r * 4 + k] * scale * c->data[r * 5 + j];
+            ASSERT_FLOAT_EQ(w->grad[k * 5 + j], expected);
+        }
+    }
+    
+    tensor_free(loss);
+    tensor_free(zero);
+    tensor_free(c);
+    tensor_free(w);
+    tensor_free(a);
+}
+
+// Row-major copy of the transpose of a [rows, cols] tensor
+static Tensor* transposed_copy(Tensor *t) {
+    size_t rows = t->shape[0], cols = t->shape[1];
+    Tensor *out = tensor_create((size_t[]){cols, rows}, 2);
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < cols; j++) out->data[j * rows + i] = t->data[i * cols + j];
+    return out;
+}
+
+// alpha * Aᵀ·Bᵀ and x·Bᵀ against plain matmuls of explicit transposes
+TEST(backward_matmul_ex_transposed) {
+    Tensor *at = tensor_randn((size_t[]){4, 3}, 2, 8);
+    Tensor *bt = tensor_randn((size_t[]){5, 4}, 2, 9);
+    Tensor *x = tensor_randn((size_t[]){4}, 1, 10);
+    Tensor *a = transposed_copy(at);
+    Tensor *b = transposed_copy(bt);
+    Tensor *x2 = tensor_create(x->shape, 1);
+    for (size_t i = 0; i < 4; i++) x2->data[i] = x->data[i];
+    Tensor *leaves[] = {at, bt, x, a, b, x2};
+    for (size_t i = 0; i < 6; i++) tensor_set_requires_grad(leaves[i], 1);
+    Tensor *w = tensor_randn((size_t[]){3, 5}, 2, 11);
+    Tensor *v = tensor_randn((size_t[]){5}, 1, 12);
+    
+    Tensor *c = tensor_matmul_ex(at, bt, 1, 1, 0.5f);
+    Tensor *y = tensor_matmul_ex(x, bt, 1, 1, 1.0f);
+    assert(c != NULL && c->shape[0] == 3 && c->shape[1] == 5);
+    assert(y != NULL && y->ndim == 1 && y->shape[0] == 5);
+    Tensor *lc = tensor_mul(c, w);
+    Tensor *ly = tensor_mul(y, v);
+    tensor_backward(lc);
+    tensor_backward(ly);
+    
+    Tensor *c2 = tensor_matmul(a, b);
+    Tensor *y2 = tensor_matmul(x2, b);
+    Tensor *lc2 = tensor_mul(c2, w);
+    Tensor *ly2 = tensor_mul(y2, v);
+    tensor_backward(lc2);
+    tensor_backward(ly2);
+    
+    for (size_t i = 0; i < 15; i++) ASSERT_FLOAT_EQ(c->data[i], 0.5f * c2->data[i]);
+    for (size_t i = 0; i < 5; i++) ASSERT_FLOAT_EQ(y->data[i], y2->data[i]);
+    for (size_t i = 0; i < 3; i++)
+        for (size_t k = 0; k < 4; k++) ASSERT_FLOAT_EQ(at->grad[k * 3 + i], 0.5f * a->grad[i * 4 + k]);
+    for (size_t i = 0; i < 4; i++) ASSERT_FLOAT_EQ(x->grad[i], x2->grad[i]);
+    
+    // bt's grad mixes both products, with alpha on the first only
+    for (size_t k = 0; k < 4; k++) {
+        for (size_t j = 0; j < 5; j++) {
+            float expected = 0.0f;
+            for (size_t i = 0; i < 3; i++) expected += 0.5f * a->data[i * 4 + k] * w->data[i * 5 + j];
+            expected += x->data[k] * v->data[j];
+            ASSERT_FLOAT_EQ(bt->grad[j * 4 + k], expected);
+        }
+    }
+    
+    tensor_free(lc);
+    tensor_free(ly);
+    tensor_free(lc2);
+    tensor_free(ly2);
+    tensor_free(c);
+    tensor_free(y);
+    tensor_free(c2);
+    tensor_free(y2);
+    tensor_free(w);
+    tensor_free(v);
+    for (size_t i = 0; i < 6; i++) tensor_free(leaves[i]);
+}
+
+// ====================================================
+// In-Place Operation Tests
+// ====================================================
+
+TEST(tensor_inplace_ops) {
+    size_t shape[] = {2, 2};
+    size_t row_shape[] = {2};
+    Tensor *a = tensor_create(shape, 2);
+    Tensor *b = tensor_create(row_shape, 1);
+    
+    a->data[0] = -1.0f; a->data[1] = 2.0f;
+    a->data[2] = -3.0f; a->data[3] = 4.0f;
+    b->data[0] = 1.0f; b->data[1] = 2.0f;
+    
+    assert(tensor_add_(a, b) == a);
+    ASSERT_FLOAT_EQ(a->data[0], 0.0f);
+    ASSERT_FLOAT_EQ(a->data[3], 6.0f);
+    
+    assert(tensor_mul_(a, b) == a);
+    ASSERT_FLOAT_EQ(a->data[1], 8.0f);
+    ASSERT_FLOAT_EQ(a->data[2], -2.0f);
+    
+    assert(tensor_relu_(a) == a);
+    ASSERT_FLOAT_EQ(a->data[2], 0.0f);
+    ASSERT_FLOAT_EQ(a->data[3], 12.0f);
+    
+    assert(tensor_sigmoid_(a) == a);
+    ASSERT_FLOAT_EQ(a->data[0], 0.5f);
+    assert(a->version == 4);
+    assert(a->inputs == NULL);
+    
+    // B may not grow A
+    Tensor *wide = tensor_create((size_t[]){3}, 1);
+    assert(tensor_add_(a, wide) == NULL);
+    assert(tensor_add_(b, a) == NULL);
+    assert(a->version == 4);
+    
+    tensor_free(a);
+    tensor_free(b);
+    tensor_free(wide);
+}
+
+// relu(matmul(X, W) * m) computed out of place and in place
+static void inplace_chain(int in_place, Tensor **x, Tensor **w, Tensor **m) {
+    *x = tensor_randn((size_t[]){3, 4}, 2, 11);
+    *w = tensor_randn((size_t[]){4, 2}, 2, 12);
+    *m = tensor_randn((size_t[]){2}, 1, 13);
+    tensor_set_requires_grad(*x, 1);
+    tensor_set_requires_grad(*w, 1);
+    tensor_set_requires_grad(*m, 1);
+    
+    Tensor *target = tensor_ones((size_t[]){3, 2}, 2);
+    Tensor *y = tensor_matmul(*x, *w);
+    Tensor *z = y;
+    Tensor *r;
+    if (in_place) {
+        assert(tensor_mul_(y, *m) == y);
+        assert(tensor_relu_(y) == y);
+        r = y;
+    } else {
+        z = tensor_mul(y, *m);
+        r = tensor_relu(z);
+    }
+    
+    Tensor *loss = tensor_mse(r, target);
+    tensor_backward(loss);
+    
+    tensor_free(loss);
+    if (!in_place) {
+        tensor_free(r);
+        tensor_free(z);
+    }
+    tensor_free(y);
+    tensor_free(target);
+}
+
+TEST(backward_inplace_matches_out_of_place) {
+    Tensor *x, *w, *m, *x2, *w2, *m2;
+    inplace_chain(0, &x, &w, &m);
+    inplace_chain(1, &x2, &w2, &m2);
+    
+    for (size_t i = 0; i < x->size; i++) ASSERT_FLOAT_EQ(x2->grad[i], x->grad[i]);
+    for (size_t i = 0; i < w->size; i++) ASSERT_FLOAT_EQ(w2->grad[i], w->grad[i]);
+    for (size_t i = 0; i < m->size; i++) ASSERT_FLOAT_EQ(m2->grad[i], m->grad[i]);
+    
+    tensor_free(x); tensor_free(w); tensor_free(m);
+    tensor_free(x2); tensor_free(w2); tensor_free(m2);
+}
+
+TEST(inplace_version_checks) {
+    size_t shape[] = {3};
+    Tensor *x = tensor_ones(shape, 1);
+    Tensor *one = tensor_ones(shape, 1);
+    tensor_set_requires_grad(x, 1);
+    
+    // Leaves that require grad are never overwritten
+    assert(!tensor_inplace_safe(x));
+    assert(tensor_relu_(x) == NULL);
+    assert(x->version == 0);
+    
+    // sigmoid's backward reads its output, so overwriting it fails the pass
+    Tensor *s = tensor_sigmoid(x);
+    assert(!tensor_inplace_safe(s));
+    assert(tensor_relu_(s) == s);
+    tensor_backward(s);
+    assert(x->grad == NULL);
+    
+    // mul saved z as an input before z was overwritten
+    Tensor *z = tensor_add(x, x);
+    assert(tensor_inplace_safe(z));
+    Tensor *p = tensor_mul(z, z);
+    assert(tensor_add_(z, one) == z);
+    tensor_backward(p);
+    assert(x->grad == NULL);
+    
+    // Without a later reader the same update is fine
+    Tensor *q = tensor_add(x, x);
+    assert(tensor_add_(q, one) == q);
+    tensor_backward(q);
+    assert(x->grad != NULL);
+    ASSERT_FLOAT_EQ(x->grad[0], 2.0f);
+    
+    tensor_free(p);
+    tensor_free(q);
+    tensor_free(z);
+    tensor_free(s);
+    tensor_free(one);
+    tensor_free(x);
+}
+
 // ====================================================
 // Main Test Runner
 // ====================================================
@@ -534,12 +1311,25 @@ int main() {
     RUN_TEST(tensor_add_with_broadcast);
     RUN_TEST(tensor_sub);
     RUN_TEST(tensor_mul);
+    RUN_TEST(tensor_div);
+    RUN_TEST(tensor_broadcast_column_and_scalar);
+    RUN_TEST(tensor_broadcast_large_matches_loop);
+    RUN_TEST(tensor_broadcast_incompatible);
     
     // Linear algebra
     RUN_TEST(tensor_matmul_2d_2d);
     RUN_TEST(tensor_matmul_2d_1d);
     RUN_TEST(tensor_matmul_1d_1d);
+    RUN_TEST(tensor_matmul_batched_broadcast);
+    RUN_TEST(tensor_matmul_batched_transposed_view);
     RUN_TEST(tensor_transpose2d);
+    RUN_TEST(tensor_linear_fused);
+    RUN_TEST(tensor_linear_1d);
+    
+    // View tests
+    RUN_TEST(tensor_view_of_view);
+    RUN_TEST(matmul_transposed_view);
+    RUN_TEST(backward_transpose_view);
     
     // Activation functions
     RUN_TEST(tensor_relu);
@@ -552,14 +1342,27 @@ int main() {
     RUN_TEST(tensor_mse);
     RUN_TEST(tensor_cross_entropy);
     RUN_TEST(tensor_binary_cross_entropy);
+    RUN_TEST(tensor_softmax_cross_entropy);
+    RUN_TEST(tensor_softmax_cross_entropy_large_logits);
+    RUN_TEST(tensor_sparse_cross_entropy);
     
     // Slice
     RUN_TEST(tensor_slice);
+    RUN_TEST(backward_slice);
     
     // Gradients
     RUN_TEST(backward_add);
     RUN_TEST(backward_mul);
+    RUN_TEST(backward_broadcast);
+    RUN_TEST(backward_div);
     RUN_TEST(backward_relu);
+    RUN_TEST(backward_matmul_batched);
+    RUN_TEST(backward_matmul_ex_transposed);
+    
+    // In-place operations
+    RUN_TEST(tensor_inplace_ops);
+    RUN_TEST(backward_inplace_matches_out_of_place);
+    RUN_TEST(inplace_version_checks);
     
     printf("\n=== All Ops Tests Passed! ===\n");
     return 0;
@@ -1,6 +1,7 @@
 #include "../../include/basednn.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <assert.h>
 
@@ -169,6 +170,282 @@ TEST(adam_multiple_steps) {
     network_free(net);
 }
 
+// Element-by-element Adam as originally written, with decoupled weight decay
+static void reference_adam(float *p, const float *g, float *m, float *v, size_t n, int t,
+                           float lr, float beta1, float beta2, float eps, float weight_decay) {
+    float bias_correction1 = 1.0f - powf(beta1, t);
+    float bias_correction2 = 1.0f - powf(beta2, t);
+    for (size_t j = 0; j < n; j++) {
+        p[j] -= lr * weight_decay * p[j];
+        m[j] = beta1 * m[j] + (1.0f - beta1) * g[j];
+        v[j] = beta2 * v[j] + (1.0f - beta2) * g[j] * g[j];
+        p[j] -= lr * (m[j] / bias_correction1) / (sqrtf(v[j] / bias_correction2) + eps);
+    }
+}
+
+// Runs steps of config over a network large enough to split across tasks and
+// compares every parameter against reference_adam
+static void check_adam_sweep(OptimizerConfig config, float weight_decay, int separate_grads) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(96, 130)));
+    network_add_layer(net, layer_create(LINEAR(130, 37)));
+
+    size_t total = net->param_size;
+    float *expected = malloc(total * sizeof(float));
+    float *m = calloc(total, sizeof(float));
+    float *v = calloc(total, sizeof(float));
+    memcpy(expected, net->param_data, total * sizeof(float));
+
+    // Gradients outside the flat buffer split the sweep into one segment per parameter
+    if (separate_grads) {
+        for (size_t i = 0; i < net->num_parameters; i++) {
+            net->parameters[i]->grad = malloc(net->parameters[i]->size * sizeof(float));
+        }
+    }
+
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, config);
+    assert(opt != NULL);
+
+    for (int t = 1; t <= 3; t++) {
+        size_t offset = 0;
+        for (size_t i = 0; i < net->num_parameters; i++) {
+            Tensor *param = net->parameters[i];
+            for (size_t j = 0; j < param->size; j++) {
+                param->grad[j] = sinf(0.37f * (float)(offset + j) + (float)t) * 0.1f;
+            }
+            reference_adam(expected + offset, param->grad, m + offset, v + offset, param->size, t,
+                           0.01f, 0.9f, 0.999f, 1e-8f, weight_decay);
+            offset += param->size;
+        }
+        optimizer_step(opt);
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < net->num_parameters; i++) {
+        Tensor *param = net->parameters[i];
+        for (size_t j = 0; j < param->size; j++) ASSERT_FLOAT_EQ(param->data[j], expected[offset + j]);
+        if (separate_grads) {
+            free(param->grad);
+            param->grad = NULL;
+        }
+        offset += param->size;
+    }
+
+    optimizer_free(opt);
+    network_free(net);
+    free(expected);
+    free(m);
+    free(v);
+}
+
+TEST(adam_matches_reference) {
+    check_adam_sweep(ADAM(0.01f, 0.9f, 0.999f, 1e-8f), 0.0f, 0);
+    check_adam_sweep(ADAM(0.01f, 0.9f, 0.999f, 1e-8f), 0.0f, 1);
+}
+
+TEST(adamw_matches_reference) {
+    check_adam_sweep(ADAMW(0.01f, 0.9f, 0.999f, 1e-8f, 0.1f), 0.1f, 0);
+    check_adam_sweep(ADAMW(0.01f, 0.9f, 0.999f, 1e-8f, 0.1f), 0.1f, 1);
+}
+
+TEST(sgd_momentum_sweep) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(96, 130)));
+    network_add_layer(net, layer_create(LINEAR(130, 37)));
+
+    size_t total = net->param_size;
+    float *expected = malloc(total * sizeof(float));
+    float *velocity = calloc(total, sizeof(float));
+    memcpy(expected, net->param_data, total * sizeof(float));
+
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, SGD(0.05f, 0.9f));
+    for (int t = 1; t <= 3; t++) {
+        for (size_t j = 0; j < total; j++) {
+            net->grad_data[j] = cosf(0.11f * (float)j * (float)t);
+            velocity[j] = 0.9f * velocity[j] - 0.05f * net->grad_data[j];
+            expected[j] += velocity[j];
+        }
+        optimizer_step(opt);
+    }
+
+    for (size_t j = 0; j < total; j++) ASSERT_FLOAT_EQ(net->param_data[j], expected[j]);
+
+    optimizer_free(opt);
+    network_free(net);
+    free(expected);
+    free(velocity);
+}
+
+// Steps a copy of a network with config on the same gradients as fp32 Adam and
+// returns the largest parameter difference. Large enough to split across tasks
+static float low_precision_drift(OptimizerConfig config) {
+    Network *nets[2];
+    Optimizer *opts[2];
+    for (int i = 0; i < 2; i++) {
+        nets[i] = network_create();
+        network_add_layer(nets[i], layer_create(LINEAR(130, 150)));
+        network_add_layer(nets[i], layer_create(LINEAR(150, 3)));
+    }
+    memcpy(nets[1]->param_data, nets[0]->param_data, nets[0]->param_size * sizeof(float));
+    opts[0] = optimizer_create(nets[0]->parameters, nets[0]->num_parameters, ADAM(0.01f, 0.9f, 0.999f, 1e-8f));
+    opts[1] = optimizer_create(nets[1]->parameters, nets[1]->num_parameters, config);
+    assert(opts[1] != NULL);
+
+    for (int t = 1; t <= 20; t++) {
+        for (int i = 0; i < 2; i++) {
+            // Gradients spanning two orders of magnitude within each block
+            for (size_t j = 0; j < nets[i]->param_size; j++) {
+                nets[i]->grad_data[j] = sinf(0.7f * (float)j + 0.3f * (float)t) * powf(10.0f, -(float)(j % 3));
+            }
+            optimizer_step(opts[i]);
+        }
+    }
+
+    float drift = 0.0f;
+    for (size_t j = 0; j < nets[0]->param_size; j++) {
+        drift = fmaxf(drift, fabsf(nets[0]->param_data[j] - nets[1]->param_data[j]));
+    }
+
+    for (int i = 0; i < 2; i++) {
+        optimizer_free(opts[i]);
+        network_free(nets[i]);
+    }
+    return drift;
+}
+
+// Each step moves a parameter by up to the learning rate, 0.2 over 20 steps
+TEST(adam_low_precision_moments) {
+    assert(low_precision_drift(ADAM_BF16(0.01f, 0.9f, 0.999f, 1e-8f)) < 2e-3f);
+    assert(low_precision_drift(ADAM_8BIT(0.01f, 0.9f, 0.999f, 1e-8f)) < 2e-2f);
+    assert(low_precision_drift(ADAMW_BF16(0.01f, 0.9f, 0.999f, 1e-8f, 0.0f)) < 2e-3f);
+    assert(low_precision_drift(ADAMW_8BIT(0.01f, 0.9f, 0.999f, 1e-8f, 0.0f)) < 2e-2f);
+}
+
+// Values just below the smallest 8-bit code round to it or to zero, never up
+// to the larger codes of the last octave
+TEST(adam_8bit_moment_range) {
+    Tensor *p = tensor_zeroes((size_t[]){4}, 1);
+    tensor_set_requires_grad(p, 1);
+    tensor_ensure_grad(p);
+    float g[4] = {1.0f, ldexpf(0.85f, -16), ldexpf(0.95f, -16), ldexpf(0.3f, -16)};
+    memcpy(p->grad, g, sizeof(g));
+
+    Optimizer *opt = optimizer_create(&p, 1, ADAM_8BIT(0.01f, 0.9f, 0.999f, 1e-8f));
+    optimizer_step(opt);
+
+    char *buffer;
+    size_t size;
+    FILE *stream = open_memstream(&buffer, &size);
+    assert(optimizer_write(opt, stream));
+    fclose(stream);
+
+    // Name length and name, moment kind, t and total, then the m and v codes
+    uint32_t name_length;
+    uint64_t total;
+    memcpy(&name_length, buffer, 4);
+    memcpy(&total, buffer + 4 + name_length + 12, 8);
+    const int8_t *m = (const int8_t *)(buffer + 4 + name_length + 20);
+    const uint8_t *v = (const uint8_t *)(m + total);
+
+    // m (ratios g) reaches 2^-16, code 122; v (ratios g^2) reaches 2^-32, code 250
+    int8_t m_expected[4] = {1, 122, 122, 0};
+    uint8_t v_expected[4] = {1, 250, 250, 0};
+    for (int i = 0; i < 4; i++) {
+        assert(m[i] == m_expected[i]);
+        assert(v[i] == v_expected[i]);
+    }
+
+    free(buffer);
+    optimizer_free(opt);
+    tensor_free(p);
+}
+
+// Final MSE of a small regression trained with config from a fixed initialization
+static float regression_loss(OptimizerConfig config) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(8, 32)));
+    network_add_layer(net, layer_create(TANH()));
+    network_add_layer(net, layer_create(LINEAR(32, 1)));
+    for (size_t j = 0; j < net->param_size; j++) net->param_data[j] = 0.3f * sinf(1.3f * (float)j);
+
+    Tensor *inputs = tensor_randn((size_t[]){64, 8}, 2, 7);
+    Tensor *targets = tensor_create((size_t[]){64, 1}, 2);
+    for (size_t i = 0; i < 64; i++) {
+        float *x = inputs->data + i * 8;
+        targets->data[i] = sinf(x[0]) + 0.5f * x[1] * x[2] - 0.25f * x[3];
+    }
+
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, config);
+    float loss = 0.0f;
+    for (int step = 0; step < 300; step++) {
+        loss = network_train_step(net, inputs, targets, opt, "mse");
+        tensor_tape_clear();
+    }
+
+    tensor_free(inputs);
+    tensor_free(targets);
+    optimizer_free(opt);
+    network_free(net);
+    return loss;
+}
+
+TEST(adam_low_precision_training) {
+    float reference = regression_loss(ADAM(0.01f, 0.9f, 0.999f, 1e-8f));
+    float bf16 = regression_loss(ADAM_BF16(0.01f, 0.9f, 0.999f, 1e-8f));
+    float q8 = regression_loss(ADAM_8BIT(0.01f, 0.9f, 0.999f, 1e-8f));
+
+    assert(reference < 0.1f);
+    assert(bf16 < reference * 1.25f);
+    assert(q8 < reference * 1.25f);
+}
+
+// ====================================================
+// Optimizer Serialization Tests
+// ====================================================
+
+TEST(optimizer_save_load) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(20, 30)));
+    network_add_layer(net, layer_create(LINEAR(30, 4)));
+    const char *filepath = "/tmp/test_optimizer_state.bdop";
+
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, ADAM_8BIT(0.01f, 0.9f, 0.999f, 1e-8f));
+    for (int t = 0; t < 2; t++) {
+        for (size_t i = 0; i < net->param_size; i++) net->grad_data[i] = cosf((float)(i + t));
+        optimizer_step(opt);
+    }
+    assert(optimizer_save(opt, filepath));
+
+    // Same kind over the same parameter sizes: the next step matches exactly
+    float *saved = malloc(net->param_size * sizeof(float));
+    memcpy(saved, net->param_data, net->param_size * sizeof(float));
+    optimizer_step(opt);
+    float *expected = malloc(net->param_size * sizeof(float));
+    memcpy(expected, net->param_data, net->param_size * sizeof(float));
+
+    memcpy(net->param_data, saved, net->param_size * sizeof(float));
+    Optimizer *restored = optimizer_create(net->parameters, net->num_parameters, ADAM_8BIT(0.01f, 0.9f, 0.999f, 1e-8f));
+    assert(optimizer_load(restored, filepath));
+    optimizer_step(restored);
+    assert(memcmp(net->param_data, expected, net->param_size * sizeof(float)) == 0);
+
+    // Another optimizer kind or moment storage is rejected
+    Optimizer *sgd = optimizer_create(net->parameters, net->num_parameters, SGD(0.1f, 0.9f));
+    Optimizer *fp32 = optimizer_create(net->parameters, net->num_parameters, ADAM(0.01f, 0.9f, 0.999f, 1e-8f));
+    assert(!optimizer_load(sgd, filepath));
+    assert(!optimizer_load(fp32, filepath));
+    assert(!optimizer_load(restored, "/tmp/test_optimizer_missing.bdop"));
+
+    remove(filepath);
+    free(saved);
+    free(expected);
+    optimizer_free(fp32);
+    optimizer_free(sgd);
+    optimizer_free(restored);
+    optimizer_free(opt);
+    network_free(net);
+}
+
 // ====================================================
 // Optimizer Utility Tests
 // ====================================================
@@ -300,6 +577,13 @@ int main() {
     RUN_TEST(adam_creation);
     RUN_TEST(adam_step);
     RUN_TEST(adam_multiple_steps);
+    RUN_TEST(adam_matches_reference);
+    RUN_TEST(adamw_matches_reference);
+    RUN_TEST(sgd_momentum_sweep);
+    RUN_TEST(adam_low_precision_moments);
+    RUN_TEST(adam_8bit_moment_range);
+    RUN_TEST(adam_low_precision_training);
+    RUN_TEST(optimizer_save_load);
     
     // Utility tests
     RUN_TEST(optimizer_zero_grad);
@@ -239,6 +239,103 @@ TEST(training_with_registry_loss) {
     network_free(net);
 }
 
+// ====================================================
+// Backend Dispatch Tests
+// ====================================================
+
+static Tensor* backend_low(Tensor *a, Tensor *b) { (void)b; return a; }
+static Tensor* backend_high(Tensor *a, Tensor *b) { (void)a; return b; }
+
+TEST(backend_priority) {
+    register_operation_backend("test_backend_op", backend_high, 10);
+    register_operation_backend("test_backend_op", backend_low, 5);
+    assert(get_operation_fn("test_backend_op") == backend_high);
+
+    // User registrations override any built-in backend
+    register_operation("test_backend_op", backend_low);
+    assert(get_operation_fn("test_backend_op") == backend_low);
+}
+
+// A public op registered under its own name, as plugins register losses for
+// network_train, runs its kernels instead of dispatching back to itself
+TEST(register_builtin_under_own_name) {
+    register_loss("mse", tensor_mse);
+
+    Tensor *p = tensor_ones((size_t[]){2, 3}, 2);
+    Tensor *t = tensor_zeroes((size_t[]){2, 3}, 2);
+    Tensor *loss = get_loss_fn("mse")(p, t);
+    assert(loss != NULL);
+    ASSERT_FLOAT_EQ(loss->data[0], 1.0f);
+
+    tensor_free(loss);
+    tensor_free(p);
+    tensor_free(t);
+    registry_cleanup();
+    registry_init();
+}
+
+static void run_backend_ops(Tensor *x, Tensor *y, Tensor *w, Tensor *p, Tensor *t, Tensor **out) {
+    out[0] = tensor_add(x, y);
+    out[1] = tensor_sub(x, y);
+    out[2] = tensor_mul(x, y);
+    out[3] = tensor_relu(x);
+    out[4] = tensor_sigmoid(x);
+    out[5] = tensor_tanh(x);
+    out[6] = tensor_softmax(x);
+    out[7] = tensor_matmul(x, w);
+    out[8] = tensor_mse(p, t);
+    out[9] = tensor_cross_entropy(p, t);
+    out[10] = tensor_binary_cross_entropy(p, t);
+}
+
+TEST(simd_backends_match_scalar) {
+    // Odd sizes exercise the vector tails
+    size_t shape[] = {7, 37};
+    Tensor *x = tensor_create(shape, 2);
+    Tensor *y = tensor_create(shape, 2);
+    Tensor *p = tensor_create(shape, 2);
+    Tensor *t = tensor_create(shape, 2);
+    Tensor *w = tensor_create((size_t[]){37, 19}, 2);
+    srand(7);
+    for (size_t i = 0; i < x->size; i++) {
+        x->data[i] = 8.0f * ((float)rand() / RAND_MAX - 0.5f);
+        y->data[i] = 8.0f * ((float)rand() / RAND_MAX - 0.5f);
+        p->data[i] = (float)rand() / RAND_MAX;
+        t->data[i] = (float)(rand() % 2);
+    }
+    for (size_t i = 0; i < w->size; i++) {
+        w->data[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    Tensor *simd[11], *scalar[11];
+    run_backend_ops(x, y, w, p, t, simd);
+
+    setenv("BASEDNN_CPU", "scalar", 1);
+    registry_cleanup();
+    registry_init();
+    run_backend_ops(x, y, w, p, t, scalar);
+    unsetenv("BASEDNN_CPU");
+    registry_cleanup();
+    registry_init();
+
+    for (int k = 0; k < 11; k++) {
+        assert(simd[k] != NULL && scalar[k] != NULL);
+        assert(simd[k]->size == scalar[k]->size);
+        for (size_t i = 0; i < simd[k]->size; i++) {
+            float tol = 1e-4f * fmaxf(1.0f, fabsf(scalar[k]->data[i]));
+            assert(fabsf(simd[k]->data[i] - scalar[k]->data[i]) < tol);
+        }
+        tensor_free(simd[k]);
+        tensor_free(scalar[k]);
+    }
+
+    tensor_free(x);
+    tensor_free(y);
+    tensor_free(p);
+    tensor_free(t);
+    tensor_free(w);
+}
+
 // ====================================================
 // Main Test Runner
 // ====================================================
@@ -276,6 +373,11 @@ int main() {
     RUN_TEST(full_network_via_registry);
     RUN_TEST(training_with_registry_loss);
     
+    // Backend dispatch tests
+    RUN_TEST(backend_priority);
+    RUN_TEST(register_builtin_under_own_name);
+    RUN_TEST(simd_backends_match_scalar);
+    
     basednn_cleanup();
     
     printf("\n=== All Registry Tests Passed! ===\n");
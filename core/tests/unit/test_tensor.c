@@ -165,6 +165,120 @@ TEST(tensor_backward_simple) {
     tensor_free(t);
 }
 
+// ====================================================
+// Gradient Tape Tests
+// ====================================================
+
+// Sums all inputs elementwise, so every edge carries the output gradient
+static void backward_sum_inputs(Tensor *T) {
+    for (size_t i = 0; i < T->num_inputs; i++) {
+        Tensor *in = T->inputs[i];
+        if (!in->requires_grad) continue;
+        tensor_ensure_grad(in);
+        for (size_t j = 0; j < in->size; j++) in->grad[j] += T->grad[j];
+    }
+}
+
+static Tensor* sum_inputs(Tensor **inputs, size_t n) {
+    Tensor *out = tensor_zeroes(inputs[0]->shape, inputs[0]->ndim);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < out->size; j++) out->data[j] += inputs[i]->data[j];
+    }
+    tensor_record_op(out, inputs, n, "sum", backward_sum_inputs);
+    return out;
+}
+
+TEST(tensor_backward_deep_chain) {
+    size_t depth = 100000;
+    size_t shape[] = {2};
+    Tensor *x = tensor_ones(shape, 1);
+    tensor_set_requires_grad(x, 1);
+
+    Tensor **chain = malloc(depth * sizeof(Tensor *));
+    Tensor *prev = x;
+    for (size_t i = 0; i < depth; i++) {
+        chain[i] = sum_inputs(&prev, 1);
+        prev = chain[i];
+    }
+    assert(tensor_tape_size() == depth);
+
+    tensor_backward(prev);
+    ASSERT_FLOAT_EQ(x->grad[0], 1.0f);
+    ASSERT_FLOAT_EQ(x->grad[1], 1.0f);
+
+    for (size_t i = depth; i > 0; i--) tensor_free(chain[i - 1]);
+    assert(tensor_tape_size() == 0);
+    free(chain);
+    tensor_free(x);
+}
+
+TEST(tensor_backward_shared_node) {
+    size_t shape[] = {1};
+    Tensor *x = tensor_ones(shape, 1);
+    tensor_set_requires_grad(x, 1);
+
+    // y = x; z = y + y + x; w is recorded but not reachable from z
+    Tensor *y = sum_inputs(&x, 1);
+    Tensor *w = sum_inputs(&y, 1);
+    Tensor *z = sum_inputs((Tensor *[]){y, y, x}, 3);
+
+    tensor_backward(z);
+    ASSERT_FLOAT_EQ(x->grad[0], 3.0f);
+    ASSERT_FLOAT_EQ(y->grad[0], 2.0f);
+    assert(w->grad == NULL);
+
+    tensor_free(z);
+    tensor_free(w);
+    tensor_free(y);
+    tensor_free(x);
+}
+
+TEST(tensor_backward_unrecorded_node) {
+    size_t shape[] = {1};
+    Tensor *x = tensor_ones(shape, 1);
+    tensor_set_requires_grad(x, 1);
+
+    // Wired by hand, as older plugins do, so it never reaches the tape
+    Tensor *y = tensor_ones(shape, 1);
+    y->requires_grad = 1;
+    y->num_inputs = 1;
+    y->inputs = malloc(sizeof(Tensor *));
+    y->inputs[0] = x;
+    y->backward_fn = backward_sum_inputs;
+
+    Tensor *z = sum_inputs((Tensor *[]){y, x}, 2);
+    tensor_backward(z);
+    ASSERT_FLOAT_EQ(x->grad[0], 2.0f);
+
+    tensor_free(z);
+    tensor_free(y);
+    tensor_free(x);
+}
+
+TEST(tensor_no_grad_mode) {
+    size_t shape[] = {1};
+    Tensor *x = tensor_ones(shape, 1);
+    tensor_set_requires_grad(x, 1);
+
+    int prev = tensor_set_grad_enabled(0);
+    assert(prev == 1);
+    assert(!tensor_is_grad_enabled());
+
+    size_t tape_before = tensor_tape_size();
+    Tensor *y = sum_inputs(&x, 1);
+    assert(y->requires_grad == 0);
+    assert(y->inputs == NULL);
+    assert(tensor_tape_size() == tape_before);
+
+    tensor_set_grad_enabled(prev);
+    Tensor *z = sum_inputs(&x, 1);
+    assert(z->requires_grad == 1);
+
+    tensor_free(z);
+    tensor_free(y);
+    tensor_free(x);
+}
+
 // ====================================================
 // Shape Tests
 // ====================================================
@@ -246,6 +360,12 @@ int main() {
     RUN_TEST(tensor_zero_grad);
     RUN_TEST(tensor_backward_simple);
     
+    // Gradient tape tests
+    RUN_TEST(tensor_backward_deep_chain);
+    RUN_TEST(tensor_backward_shared_node);
+    RUN_TEST(tensor_backward_unrecorded_node);
+    RUN_TEST(tensor_no_grad_mode);
+    
     // Shape tests
     RUN_TEST(tensor_different_shapes);
     
@@ -0,0 +1,192 @@
+#include "../../include/basednn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#define EPSILON 1e-4f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+// ====================================================
+// Helpers
+// ====================================================
+
+static void mark_range(size_t begin, size_t end, void *arg) {
+    int *hits = (int *)arg;
+    for (size_t i = begin; i < end; i++) __atomic_add_fetch(&hits[i], 1, __ATOMIC_RELAXED);
+}
+
+static void increment(void *arg) {
+    __atomic_add_fetch((int *)arg, 1, __ATOMIC_RELAXED);
+}
+
+typedef struct {
+    int *hits;
+    size_t n;
+} NestedArgs;
+
+static void nested_range(size_t begin, size_t end, void *arg) {
+    NestedArgs *args = (NestedArgs *)arg;
+    for (size_t i = begin; i < end; i++) {
+        parallel_for(0, args->n, 3, mark_range, args->hits + i * args->n);
+    }
+}
+
+static Tensor* random_matrix(size_t rows, size_t cols) {
+    Tensor *t = tensor_randn((size_t[]){rows, cols}, 2, 7);
+    return t;
+}
+
+// ====================================================
+// Pool Tests
+// ====================================================
+
+TEST(set_num_threads) {
+    threadpool_set_num_threads(4);
+    assert(threadpool_num_threads() == 4);
+    assert(threadpool_thread_index() == 0);
+
+    threadpool_set_num_threads(1);
+    assert(threadpool_num_threads() == 1);
+
+    threadpool_set_num_threads(4);
+}
+
+TEST(parallel_for_covers_range) {
+    size_t n = 1001;
+    int *hits = calloc(n, sizeof(int));
+
+    parallel_for(0, n, 7, mark_range, hits);
+    for (size_t i = 0; i < n; i++) assert(hits[i] == 1);
+
+    // Empty range and a grain larger than the range
+    parallel_for(5, 5, 7, mark_range, hits);
+    parallel_for(0, n, 5000, mark_range, hits);
+    for (size_t i = 0; i < n; i++) assert(hits[i] == 2);
+
+    assert(parallel_num_chunks(0, 1001, 7) == 143);
+    assert(parallel_num_chunks(3, 3, 7) == 0);
+
+    free(hits);
+}
+
+TEST(nested_parallel_for) {
+    size_t n = 50;
+    int *hits = calloc(n * n, sizeof(int));
+    NestedArgs args = {hits, n};
+
+    parallel_for(0, n, 1, nested_range, &args);
+    for (size_t i = 0; i < n * n; i++) assert(hits[i] == 1);
+
+    free(hits);
+}
+
+TEST(task_group) {
+    int count = 0;
+    TaskGroup *group = task_group_create();
+    assert(group != NULL);
+
+    for (int i = 0; i < 100; i++) task_group_run(group, increment, &count);
+    task_group_wait(group);
+    assert(count == 100);
+
+    task_group_free(group);
+}
+
+// ====================================================
+// Kernel Tests
+// ====================================================
+
+// Results must not depend on how many threads ran the kernel
+TEST(matmul_matches_single_thread) {
+    Tensor *A = random_matrix(300, 200);
+    Tensor *B = random_matrix(200, 500);
+
+    threadpool_set_num_threads(1);
+    Tensor *serial = tensor_matmul(A, B);
+    threadpool_set_num_threads(4);
+    Tensor *parallel = tensor_matmul(A, B);
+
+    assert(serial != NULL && parallel != NULL);
+    assert(memcmp(serial->data, parallel->data, serial->size * sizeof(float)) == 0);
+
+    tensor_free(serial);
+    tensor_free(parallel);
+    tensor_free(A);
+    tensor_free(B);
+}
+
+TEST(ops_match_single_thread) {
+    Tensor *A = random_matrix(100, 1000);
+    Tensor *B = random_matrix(100, 1000);
+
+    threadpool_set_num_threads(1);
+    Tensor *sum1 = tensor_add(A, B);
+    Tensor *soft1 = tensor_softmax(A);
+    Tensor *mse1 = tensor_mse(A, B);
+    threadpool_set_num_threads(4);
+    Tensor *sum4 = tensor_add(A, B);
+    Tensor *soft4 = tensor_softmax(A);
+    Tensor *mse4 = tensor_mse(A, B);
+
+    assert(memcmp(sum1->data, sum4->data, sum1->size * sizeof(float)) == 0);
+    assert(memcmp(soft1->data, soft4->data, soft1->size * sizeof(float)) == 0);
+    assert(mse1->data[0] == mse4->data[0]);
+
+    // Chunked sums still match a plain sum closely
+    double expected = 0.0;
+    for (size_t i = 0; i < A->size; i++) {
+        double d = A->data[i] - B->data[i];
+        expected += d * d;
+    }
+    ASSERT_FLOAT_EQ(mse4->data[0], (float)(expected / A->size));
+
+    Tensor *outputs[] = {sum1, soft1, mse1, sum4, soft4, mse4, A, B};
+    for (size_t i = 0; i < 8; i++) tensor_free(outputs[i]);
+}
+
+TEST(adam_step_parallel) {
+    Tensor *w = tensor_ones((size_t[]){200, 200}, 2);
+    tensor_set_requires_grad(w, 1);
+    tensor_ensure_grad(w);
+    for (size_t i = 0; i < w->size; i++) w->grad[i] = 1.0f;
+
+    Optimizer *opt = optimizer_create(&w, 1, ADAM(0.1f, 0.9f, 0.999f, 1e-8f));
+    optimizer_step(opt);
+
+    // First Adam step moves every weight by about the learning rate
+    for (size_t i = 0; i < w->size; i++) ASSERT_FLOAT_EQ(w->data[i], 0.9f);
+
+    optimizer_free(opt);
+    tensor_free(w);
+}
+
+// ====================================================
+// Main
+// ====================================================
+
+int main() {
+    printf("=== Running Thread Pool Tests ===\n\n");
+
+    basednn_init();
+    threadpool_set_num_threads(4);
+
+    // Pool tests
+    RUN_TEST(set_num_threads);
+    RUN_TEST(parallel_for_covers_range);
+    RUN_TEST(nested_parallel_for);
+    RUN_TEST(task_group);
+
+    // Kernel tests
+    RUN_TEST(matmul_matches_single_thread);
+    RUN_TEST(ops_match_single_thread);
+    RUN_TEST(adam_step_parallel);
+
+    basednn_cleanup();
+
+    printf("\n=== All Thread Pool Tests Passed! ===\n");
+    return 0;
+}
@@ -2,6 +2,7 @@
 #define ACTIVATIONS_H
 
 #include "../../core/include/tensor.h"
+#include "../../core/include/layer.h"
 
 // ====================================================
 // Activations
@@ -10,6 +11,7 @@
 Tensor* tensor_leaky_relu(Tensor *input, float alpha);
 void backward_leaky_relu(Tensor *output);
 
+// Tanh approximation: 0.5x(1 + tanh(sqrt(2/pi)(x + 0.044715x^3)))
 Tensor* tensor_gelu(Tensor *input); 
 void backward_gelu(Tensor *output);
 
@@ -19,5 +21,20 @@ void backward_swish(Tensor *output);
 Tensor* tensor_softplus(Tensor *input);
 void backward_softplus(Tensor *output);
 
+// ====================================================
+// Activation Layers
+// ====================================================
+
+typedef struct LeakyReLUParams {
+    float alpha;
+} LeakyReLUParams;
+
+#define LEAKY_RELU(slope) (LayerConfig){ .name = "leaky_relu", .params = &(LeakyReLUParams){ slope } }
+#define GELU() (LayerConfig){ .name = "gelu", .params = NULL }
+#define SWISH() (LayerConfig){ .name = "swish", .params = NULL }
+#define SOFTPLUS() (LayerConfig){ .name = "softplus", .params = NULL }
+
+// Registers the activation layers and backward functions (call after basednn_init)
+void activations_register_builtins(void);
 
-#endif
\ No newline at end of file
+#endif
@@ -7,9 +7,14 @@
 // Attention Operations
 // ====================================================
 
+// Softmax over the last dimension, for any number of dimensions
 Tensor* tensor_softmax_row(Tensor *input);
 void backward_softmax_row(Tensor *output);
 
+// softmax(Q·Kᵀ / sqrt(D) + mask)·V for Q [..., Sq, D], K [..., Sk, D] and
+// V [..., Sk, Dv] with identical leading dimensions; the output is [..., Sq, Dv].
+// mask is optional and additive (use -INFINITY to hide a key), either [Sq, Sk]
+// shared by every batch or one [Sq, Sk] block per batch; it gets no gradient
 Tensor* tensor_scaled_dot_product_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *mask);
 void backward_scaled_dot_product_attention(Tensor *output);
 
@@ -64,4 +69,7 @@ typedef struct EmbeddingParams {
 
 #define EMBEDDING(num_emb, emb_dim)(LayerConfig){.name="embedding", .params=&(EmbeddingParams){num_emb, emb_dim}}
 
+// Registers the softmax_row and attention backward functions (call after basednn_init)
+void attention_register_builtins(void);
+
 #endif
\ No newline at end of file
@@ -2,11 +2,14 @@
 #define SHAPE_H
 
 #include "../../core/include/tensor.h"
+#include "../../core/include/layer.h"
 
 // ====================================================
 // Shape Operations
 // ====================================================
 
+// reshape, transpose and squeeze return views sharing input's storage; reshape
+// falls back to a copy only when input's layout cannot be reinterpreted
 Tensor* tensor_reshape(Tensor *input, size_t *new_shape, size_t new_ndim);
 void backward_reshape(Tensor *output);
 
@@ -26,6 +29,10 @@ void backward_squeeze(Tensor *output);
 // Shape Layers
 // ====================================================
 
+// Both layers leave the batch dimension alone: FLATTEN merges dims
+// start_dim..end_dim (inclusive, clamped to the last dim) and RESHAPE maps
+// each sample to new_shape.
+
 typedef struct FlattenParams {
     size_t start_dim;
     size_t end_dim;
@@ -39,4 +46,8 @@ typedef struct ReshapeParams {
 } ReshapeParams;
 
 #define RESHAPE(new_shape, new_ndim)(LayerConfig){.name="reshape", .params=&(ReshapeParams){new_shape, new_ndim}}
+
+// Registers the shape layers and backward functions (call after basednn_init)
+void shape_register_builtins(void);
+
 #endif
\ No newline at end of file
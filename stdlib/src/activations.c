@@ -0,0 +1,293 @@
+#include "../include/activations.h"
+#include "../../core/include/elementwise.h"
+#include "../../core/include/fastmath.h"
+#include "../../core/include/arena.h"
+#include "../../core/include/registry.h"
+#include "../../core/include/threadpool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Elements per thread pool task, matching the core elementwise ops
+#define ACTIVATION_PARALLEL_GRAIN 16384
+
+// Fast-math backward passes handle this many elements per stack buffer
+#define ACTIVATION_BLOCK 256
+
+#define GELU_SQRT_2_OVER_PI 0.7978845608028654f
+#define GELU_CUBIC 0.044715f
+
+// ====================================================
+// Kernels
+// ====================================================
+
+static inline float sigmoidf(float x) {
+    return 1.0f / (1.0f + expf(-x));
+}
+
+// Tanh approximation of GELU and its derivative
+static inline float gelu(float x) {
+    return 0.5f * x * (1.0f + tanhf(GELU_SQRT_2_OVER_PI * (x + GELU_CUBIC * x * x * x)));
+}
+
+static inline float gelu_derivative(float x) {
+    float t = tanhf(GELU_SQRT_2_OVER_PI * (x + GELU_CUBIC * x * x * x));
+    float du = GELU_SQRT_2_OVER_PI * (1.0f + 3.0f * GELU_CUBIC * x * x);
+    return 0.5f * (1.0f + t) + 0.5f * x * (1.0f - t * t) * du;
+}
+
+// log(1 + e^x) without overflow for large x
+static inline float softplus(float x) {
+    return (x > 0.0f ? x : 0.0f) + log1pf(expf(-fabsf(x)));
+}
+
+ELEMENTWISE_UNARY(gelu_kernel, gelu(x))
+ELEMENTWISE_GRAD(gelu_grad_kernel, gelu_derivative(x))
+
+// swish(x) = x * sigmoid(x), swish'(x) = s + y * (1 - s)
+ELEMENTWISE_UNARY(swish_kernel, x * sigmoidf(x))
+ELEMENTWISE_GRAD(swish_grad_kernel, sigmoidf(x) + y * (1.0f - sigmoidf(x)))
+
+ELEMENTWISE_UNARY(softplus_kernel, softplus(x))
+ELEMENTWISE_GRAD(softplus_grad_kernel, sigmoidf(x))
+
+// Fast-math derivatives only need s = sigmoid(arg), which the fast kernels
+// compute a block at a time: swish' = s + y(1 - s), softplus' = s, and with
+// 0.5(1 + tanh(u)) = sigmoid(2u), gelu' = s + x s(1 - s) 2u'
+static void swish_grad_fast(const float *x, const float *y, const float *dy, float *dx, size_t n) {
+    float s[ACTIVATION_BLOCK];
+    for (size_t i = 0; i < n; i += ACTIVATION_BLOCK) {
+        size_t m = (n - i < ACTIVATION_BLOCK) ? n - i : ACTIVATION_BLOCK;
+        fastmath_kernels()->sigmoid(x + i, s, m);
+        for (size_t j = 0; j < m; j++) dx[i + j] += dy[i + j] * (s[j] + y[i + j] * (1.0f - s[j]));
+    }
+}
+
+static void softplus_grad_fast(const float *x, const float *y, const float *dy, float *dx, size_t n) {
+    (void)y;
+    float s[ACTIVATION_BLOCK];
+    for (size_t i = 0; i < n; i += ACTIVATION_BLOCK) {
+        size_t m = (n - i < ACTIVATION_BLOCK) ? n - i : ACTIVATION_BLOCK;
+        fastmath_kernels()->sigmoid(x + i, s, m);
+        for (size_t j = 0; j < m; j++) dx[i + j] += dy[i + j] * s[j];
+    }
+}
+
+static void gelu_grad_fast(const float *x, const float *y, const float *dy, float *dx, size_t n) {
+    (void)y;
+    float s[ACTIVATION_BLOCK];
+    for (size_t i = 0; i < n; i += ACTIVATION_BLOCK) {
+        size_t m = (n - i < ACTIVATION_BLOCK) ? n - i : ACTIVATION_BLOCK;
+        for (size_t j = 0; j < m; j++) {
+            float v = x[i + j];
+            s[j] = 2.0f * GELU_SQRT_2_OVER_PI * (v + GELU_CUBIC * v * v * v);
+        }
+        fastmath_kernels()->sigmoid(s, s, m);
+        for (size_t j = 0; j < m; j++) {
+            float v = x[i + j];
+            float du = 2.0f * GELU_SQRT_2_OVER_PI * (1.0f + 3.0f * GELU_CUBIC * v * v);
+            dx[i + j] += dy[i + j] * (s[j] + v * s[j] * (1.0f - s[j]) * du);
+        }
+    }
+}
+
+static void leaky_relu_kernel(const float *x, float *y, size_t n, float alpha) {
+    for (size_t i = 0; i < n; i++) y[i] = x[i] > 0.0f ? x[i] : alpha * x[i];
+}
+
+static void leaky_relu_grad_kernel(const float *x, const float *dy, float *dx, size_t n, float alpha) {
+    for (size_t i = 0; i < n; i++) dx[i] += dy[i] * (x[i] > 0.0f ? 1.0f : alpha);
+}
+
+// ====================================================
+// Parallel Helpers
+// ====================================================
+
+typedef void (*ActivationKernelFn)(const float *x, float *y, size_t n);
+typedef void (*ActivationGradFn)(const float *x, const float *y, const float *dy, float *dx, size_t n);
+
+typedef struct {
+    ActivationKernelFn forward;
+    ActivationGradFn grad;
+    const float *x;
+    const float *y;
+    const float *dy;
+    float *out;
+    float alpha;            // LeakyReLU slope; forward/grad are NULL for it
+} ActivationTask;
+
+static void activation_forward_task(size_t begin, size_t end, void *arg) {
+    ActivationTask *t = (ActivationTask *)arg;
+    if (t->forward) t->forward(t->x + begin, t->out + begin, end - begin);
+    else leaky_relu_kernel(t->x + begin, t->out + begin, end - begin, t->alpha);
+}
+
+static void activation_grad_task(size_t begin, size_t end, void *arg) {
+    ActivationTask *t = (ActivationTask *)arg;
+    if (t->grad) t->grad(t->x + begin, t->y + begin, t->dy + begin, t->out + begin, end - begin);
+    else leaky_relu_grad_kernel(t->x + begin, t->dy + begin, t->out + begin, end - begin, t->alpha);
+}
+
+// Input values in row-major order; views are gathered into *scratch, which the caller frees
+static const float* dense_input(Tensor *input, float **scratch) {
+    *scratch = NULL;
+    if (tensor_is_contiguous(input)) return input->data;
+
+    *scratch = (float *)malloc(input->size * sizeof(float));
+    if (!*scratch) return NULL;
+    tensor_gather(input, *scratch);
+    return *scratch;
+}
+
+static Tensor* activation_forward(Tensor *input, ActivationKernelFn kernel, float alpha,
+                                  const char *op_name, void (*backward_fn)(Tensor *)) {
+    if (!input) return NULL;
+
+    Tensor *output = tensor_create(input->shape, input->ndim);
+    if (!output) return NULL;
+
+    float *scratch;
+    const float *x = dense_input(input, &scratch);
+    if (x) {
+        ActivationTask task = {kernel, NULL, x, NULL, NULL, output->data, alpha};
+        parallel_for(0, input->size, ACTIVATION_PARALLEL_GRAIN, activation_forward_task, &task);
+    }
+    free(scratch);
+
+    tensor_record_op(output, &input, 1, op_name, backward_fn);
+    tensor_release_output(output);
+
+    return output;
+}
+
+static void activation_backward(Tensor *output, ActivationGradFn grad, float alpha) {
+    Tensor *input = output->inputs[0];
+    if (!input->requires_grad) return;
+
+    tensor_ensure_grad(input);
+
+    float *scratch;
+    const float *x = dense_input(input, &scratch);
+    if (x) {
+        ActivationTask task = {NULL, grad, x, output->data, output->grad, input->grad, alpha};
+        parallel_for(0, input->size, ACTIVATION_PARALLEL_GRAIN, activation_grad_task, &task);
+    }
+    free(scratch);
+}
+
+// ====================================================
+// Activations
+// ====================================================
+
+Tensor* tensor_leaky_relu(Tensor *input, float alpha) {
+    Tensor *output = activation_forward(input, NULL, alpha, "leaky_relu", backward_leaky_relu);
+    if (!output || !output->requires_grad) return output;
+
+    // Backward needs the slope
+    float *slope = (float *)(output->arena ? arena_alloc(output->arena, sizeof(float)) : malloc(sizeof(float)));
+    if (slope) *slope = alpha;
+    output->extra_data = slope;
+
+    return output;
+}
+
+void backward_leaky_relu(Tensor *output) {
+    if (!output->extra_data) return;
+    activation_backward(output, NULL, *(float *)output->extra_data);
+}
+
+Tensor* tensor_gelu(Tensor *input) {
+    return activation_forward(input, fastmath_enabled() ? fastmath_kernels()->gelu : gelu_kernel, 0.0f, "gelu", backward_gelu);
+}
+
+void backward_gelu(Tensor *output) {
+    activation_backward(output, fastmath_enabled() ? gelu_grad_fast : gelu_grad_kernel, 0.0f);
+}
+
+Tensor* tensor_swish(Tensor *input) {
+    Tensor *output = activation_forward(input, fastmath_enabled() ? fastmath_kernels()->swish : swish_kernel, 0.0f, "swish", backward_swish);
+
+    // Backward reads the output
+    tensor_save_output(output);
+    return output;
+}
+
+void backward_swish(Tensor *output) {
+    activation_backward(output, fastmath_enabled() ? swish_grad_fast : swish_grad_kernel, 0.0f);
+}
+
+Tensor* tensor_softplus(Tensor *input) {
+    return activation_forward(input, fastmath_enabled() ? fastmath_kernels()->softplus : softplus_kernel, 0.0f, "softplus", backward_softplus);
+}
+
+void backward_softplus(Tensor *output) {
+    activation_backward(output, fastmath_enabled() ? softplus_grad_fast : softplus_grad_kernel, 0.0f);
+}
+
+// ====================================================
+// Activation Layers
+// ====================================================
+
+static Layer* activation_layer_create(LayerConfig *config) {
+    Layer *layer = malloc(sizeof(Layer));
+    if (!layer) return NULL;
+
+    layer->name = strdup(config->name);
+    layer->weights = NULL;
+    layer->bias = NULL;
+    layer->output = NULL;
+    layer->parameters = NULL;
+    layer->num_parameters = 0;
+    layer->forward = get_layer_forward_fn(config->name);
+    layer->config_data = NULL;
+    layer->config_data_size = 0;
+
+    if (config->params) {
+        layer->config_data = malloc(sizeof(LeakyReLUParams));
+        if (!layer->config_data) {
+            free(layer->name);
+            free(layer);
+            return NULL;
+        }
+        memcpy(layer->config_data, config->params, sizeof(LeakyReLUParams));
+        layer->config_data_size = sizeof(LeakyReLUParams);
+    }
+
+    return layer;
+}
+
+static Tensor* leaky_relu_forward(Layer *self, Tensor *input) {
+    LeakyReLUParams *params = (LeakyReLUParams *)self->config_data;
+    return tensor_leaky_relu(input, params ? params->alpha : 0.01f);
+}
+
+static Tensor* gelu_forward(Layer *self, Tensor *input) {
+    (void)self;
+    return tensor_gelu(input);
+}
+
+static Tensor* swish_forward(Layer *self, Tensor *input) {
+    (void)self;
+    return tensor_swish(input);
+}
+
+static Tensor* softplus_forward(Layer *self, Tensor *input) {
+    (void)self;
+    return tensor_softplus(input);
+}
+
+// ====================================================
+// Registration
+// ====================================================
+
+void activations_register_builtins(void) {
+    register_tensor_op("leaky_relu", backward_leaky_relu);
+    register_tensor_op("gelu", backward_gelu);
+    register_tensor_op("swish", backward_swish);
+    register_tensor_op("softplus", backward_softplus);
+
+    register_layer("leaky_relu", activation_layer_create, leaky_relu_forward);
+    register_layer("gelu", activation_layer_create, gelu_forward);
+    register_layer("swish", activation_layer_create, swish_forward);
+    register_layer("softplus", activation_layer_create, softplus_forward);
+}
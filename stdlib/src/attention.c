@@ -0,0 +1,322 @@
+#include "../include/attention.h"
+#include "../../core/include/arena.h"
+#include "../../core/include/gemm.h"
+#include "../../core/include/registry.h"
+#include "../../core/include/threadpool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Elements per thread pool task, matching the core ops
+#define ATTENTION_PARALLEL_GRAIN 16384
+
+// ====================================================
+// Helpers
+// ====================================================
+
+// Buffers of a pass come from the arena of owner, one of its tensors, when it
+// has one, so steps under an arena do no heap traffic. Otherwise they are heap
+// buffers, released by scratch_free
+static void* scratch_alloc(Tensor *owner, size_t size) {
+    return owner->arena ? arena_alloc(owner->arena, size) : malloc(size);
+}
+
+static void scratch_free(Tensor *owner, void *ptr) {
+    if (!owner->arena) free(ptr);
+}
+
+// Input values in row-major order; views are gathered into scratch of input,
+// and *scratch is set to it when it is on the heap, for the caller to free
+static const float* dense_input(Tensor *input, float **scratch) {
+    *scratch = NULL;
+    if (tensor_is_contiguous(input)) return input->data;
+
+    float *dense = (float *)scratch_alloc(input, input->size * sizeof(float));
+    if (!dense) return NULL;
+    tensor_gather(input, dense);
+    if (!input->arena) *scratch = dense;
+    return dense;
+}
+
+// offsets[i] = i * stride, as scratch of output
+static size_t* batch_offsets(Tensor *output, size_t batch, size_t stride) {
+    size_t *offsets = (size_t *)scratch_alloc(output, batch * sizeof(size_t));
+    for (size_t i = 0; offsets && i < batch; i++) offsets[i] = i * stride;
+    return offsets;
+}
+
+// ====================================================
+// Row Softmax
+// ====================================================
+
+typedef struct {
+    const float *x;
+    float *y;
+    const float *mask;      // Added to each row; row r uses row r % mask_rows
+    size_t mask_rows;
+    size_t cols;
+    const float *dy;        // Backward: dx += y * (dy - sum(dy * y))
+    float *dx;
+} SoftmaxRowTask;
+
+static void softmax_row_task(size_t begin, size_t end, void *arg) {
+    SoftmaxRowTask *t = (SoftmaxRowTask *)arg;
+    size_t C = t->cols;
+
+    for (size_t r = begin; r < end; r++) {
+        const float *x = t->x + r * C;
+        const float *m = t->mask ? t->mask + (r % t->mask_rows) * C : NULL;
+        float *y = t->y + r * C;
+
+        float max = -INFINITY;
+        for (size_t c = 0; c < C; c++) {
+            y[c] = x[c] + (m ? m[c] : 0.0f);
+            if (y[c] > max) max = y[c];
+        }
+        float sum = 0.0f;
+        for (size_t c = 0; c < C; c++) {
+            y[c] = expf(y[c] - max);
+            sum += y[c];
+        }
+        float inv = 1.0f / sum;
+        for (size_t c = 0; c < C; c++) y[c] *= inv;
+    }
+}
+
+static void softmax_row_grad_task(size_t begin, size_t end, void *arg) {
+    SoftmaxRowTask *t = (SoftmaxRowTask *)arg;
+    size_t C = t->cols;
+
+    for (size_t r = begin; r < end; r++) {
+        const float *y = t->y + r * C;
+        const float *dy = t->dy + r * C;
+        float *dx = t->dx + r * C;
+
+        float dot = 0.0f;
+        for (size_t c = 0; c < C; c++) dot += dy[c] * y[c];
+        for (size_t c = 0; c < C; c++) dx[c] += y[c] * (dy[c] - dot);
+    }
+}
+
+static void softmax_rows(SoftmaxRowTask *task, size_t rows, void (*fn)(size_t, size_t, void *)) {
+    size_t grain = (task->cols < ATTENTION_PARALLEL_GRAIN) ? ATTENTION_PARALLEL_GRAIN / task->cols : 1;
+    parallel_for(0, rows, grain, fn, task);
+}
+
+Tensor* tensor_softmax_row(Tensor *input) {
+    if (!input || input->ndim == 0 || input->size == 0) return NULL;
+
+    Tensor *output = tensor_create(input->shape, input->ndim);
+    if (!output) return NULL;
+
+    size_t cols = input->shape[input->ndim - 1];
+    float *scratch;
+    const float *x = dense_input(input, &scratch);
+    if (x) {
+        SoftmaxRowTask task = {x, output->data, NULL, 1, cols, NULL, NULL};
+        softmax_rows(&task, input->size / cols, softmax_row_task);
+    }
+    free(scratch);
+
+    tensor_record_op(output, &input, 1, "softmax_row", backward_softmax_row);
+    tensor_save_output(output);
+
+    return output;
+}
+
+void backward_softmax_row(Tensor *output) {
+    Tensor *input = output->inputs[0];
+    if (!input->requires_grad) return;
+
+    tensor_ensure_grad(input);
+    size_t cols = output->shape[output->ndim - 1];
+    SoftmaxRowTask task = {NULL, output->data, NULL, 1, cols, output->grad, input->grad};
+    softmax_rows(&task, output->size / cols, softmax_row_grad_task);
+}
+
+// ====================================================
+// Scaled Dot-Product Attention
+// ====================================================
+
+// Shapes of one attention call: batch products of [Sq, D] queries against
+// [Sk, D] keys and [Sk, Dv] values
+typedef struct {
+    size_t batch, Sq, Sk, D, Dv;
+    size_t mask_rows;       // Rows of mask before it repeats: Sq, or batch * Sq
+} AttentionShape;
+
+static int attention_shape(Tensor *Q, Tensor *K, Tensor *V, Tensor *mask, AttentionShape *s) {
+    if (!Q || !K || !V) return 0;
+    size_t n = Q->ndim;
+    if (n < 2 || K->ndim != n || V->ndim != n) return 0;
+
+    s->batch = 1;
+    for (size_t d = 0; d + 2 < n; d++) {
+        if (K->shape[d] != Q->shape[d] || V->shape[d] != Q->shape[d]) return 0;
+        s->batch *= Q->shape[d];
+    }
+
+    s->Sq = Q->shape[n - 2];
+    s->D = Q->shape[n - 1];
+    s->Sk = K->shape[n - 2];
+    s->Dv = V->shape[n - 1];
+    if (K->shape[n - 1] != s->D || V->shape[n - 2] != s->Sk) return 0;
+    if (s->Sq == 0 || s->Sk == 0 || s->D == 0) return 0;
+
+    s->mask_rows = s->Sq;
+    if (mask) {
+        if (mask->ndim < 2 || mask->shape[mask->ndim - 2] != s->Sq || mask->shape[mask->ndim - 1] != s->Sk) return 0;
+        if (mask->size == s->batch * s->Sq * s->Sk) s->mask_rows = s->batch * s->Sq;
+        else if (mask->size != s->Sq * s->Sk) return 0;
+    }
+    return 1;
+}
+
+static float attention_scale(const AttentionShape *s) {
+    return 1.0f / sqrtf((float)s->D);
+}
+
+Tensor* tensor_scaled_dot_product_attention(Tensor *Q, Tensor *K, Tensor *V, Tensor *mask) {
+    AttentionShape s;
+    if (!attention_shape(Q, K, V, mask, &s)) return NULL;
+
+    size_t out_shape[Q->ndim];
+    memcpy(out_shape, Q->shape, Q->ndim * sizeof(size_t));
+    out_shape[Q->ndim - 1] = s.Dv;
+    Tensor *output = tensor_create(out_shape, Q->ndim);
+    if (!output) return NULL;
+
+    Tensor *inputs[] = {Q, K, V, mask};
+    tensor_record_op(output, inputs, mask ? 4 : 3, "scaled_dot_product_attention", backward_scaled_dot_product_attention);
+    tensor_release_output(output);
+
+    // Backward reuses the attention weights, kept in extra_data
+    size_t p_size = s.batch * s.Sq * s.Sk;
+    float *p = (float *)scratch_alloc(output, p_size * sizeof(float));
+    float *scores = (float *)scratch_alloc(output, p_size * sizeof(float));
+
+    float *q_scratch, *k_scratch, *v_scratch, *m_scratch = NULL;
+    const float *q = dense_input(Q, &q_scratch);
+    const float *k = dense_input(K, &k_scratch);
+    const float *v = dense_input(V, &v_scratch);
+    const float *m = mask ? dense_input(mask, &m_scratch) : NULL;
+
+    size_t *q_off = batch_offsets(output, s.batch, s.Sq * s.D);
+    size_t *k_off = batch_offsets(output, s.batch, s.Sk * s.D);
+    size_t *v_off = batch_offsets(output, s.batch, s.Sk * s.Dv);
+    size_t *p_off = batch_offsets(output, s.batch, s.Sq * s.Sk);
+
+    int ok = p && scores && q && k && v && (!mask || m) && q_off && k_off && v_off && p_off;
+    if (ok) {
+        // scores = Q·Kᵀ / sqrt(D), reading K transposed through its strides
+        sgemm_batched(NULL, s.batch, s.Sq, s.Sk, s.D, attention_scale(&s), q, q_off, s.D, 1,
+                      k, k_off, 1, s.D, 0.0f, scores, s.Sk, s.Sq * s.Sk);
+
+        SoftmaxRowTask task = {scores, p, m, s.mask_rows, s.Sk, NULL, NULL};
+        softmax_rows(&task, s.batch * s.Sq, softmax_row_task);
+
+        sgemm_batched(NULL, s.batch, s.Sq, s.Dv, s.Sk, 1.0f, p, p_off, s.Sk, 1,
+                      v, v_off, s.Dv, 1, 0.0f, output->data, s.Dv, s.Sq * s.Dv);
+    }
+
+    scratch_free(output, scores);
+    free(q_scratch);
+    free(k_scratch);
+    free(v_scratch);
+    free(m_scratch);
+    scratch_free(output, q_off);
+    scratch_free(output, k_off);
+    scratch_free(output, v_off);
+    scratch_free(output, p_off);
+
+    if (output->requires_grad && ok) {
+        output->extra_data = p;
+    } else {
+        scratch_free(output, p);
+    }
+
+    return output;
+}
+
+// With P the attention weights and dO the output gradient: dV = Pᵀ·dO,
+// dP = dO·Vᵀ, dS = P ∘ (dP - rowsum(dP ∘ P)), dQ = dS·K / sqrt(D) and
+// dK = dSᵀ·Q / sqrt(D). Transposes are read through the strides and the
+// gradients accumulate straight into grad. The mask gets no gradient
+void backward_scaled_dot_product_attention(Tensor *output) {
+    Tensor *Q = output->inputs[0];
+    Tensor *K = output->inputs[1];
+    Tensor *V = output->inputs[2];
+    Tensor *mask = (output->num_inputs > 3) ? output->inputs[3] : NULL;
+    const float *p = (const float *)output->extra_data;
+
+    AttentionShape s;
+    if (!p || !attention_shape(Q, K, V, mask, &s)) return;
+    if (!Q->requires_grad && !K->requires_grad && !V->requires_grad) return;
+
+    size_t p_size = s.batch * s.Sq * s.Sk;
+    float *dp = (float *)scratch_alloc(output, p_size * sizeof(float));
+    float *ds = (float *)scratch_alloc(output, p_size * sizeof(float));
+    if (ds) memset(ds, 0, p_size * sizeof(float));
+
+    float *q_scratch, *k_scratch, *v_scratch;
+    const float *q = dense_input(Q, &q_scratch);
+    const float *k = dense_input(K, &k_scratch);
+    const float *v = dense_input(V, &v_scratch);
+
+    size_t *q_off = batch_offsets(output, s.batch, s.Sq * s.D);
+    size_t *k_off = batch_offsets(output, s.batch, s.Sk * s.D);
+    size_t *v_off = batch_offsets(output, s.batch, s.Sk * s.Dv);
+    size_t *p_off = batch_offsets(output, s.batch, s.Sq * s.Sk);
+    size_t *o_off = batch_offsets(output, s.batch, s.Sq * s.Dv);
+
+    if (dp && ds && q && k && v && q_off && k_off && v_off && p_off && o_off) {
+        const float *dout = output->grad;
+        float scale = attention_scale(&s);
+
+        if (V->requires_grad) {
+            tensor_ensure_grad(V);
+            sgemm_batched(NULL, s.batch, s.Sk, s.Dv, s.Sq, 1.0f, p, p_off, 1, s.Sk,
+                          dout, o_off, s.Dv, 1, 1.0f, V->grad, s.Dv, s.Sk * s.Dv);
+        }
+
+        if (Q->requires_grad || K->requires_grad) {
+            sgemm_batched(NULL, s.batch, s.Sq, s.Sk, s.Dv, 1.0f, dout, o_off, s.Dv, 1,
+                          v, v_off, 1, s.Dv, 0.0f, dp, s.Sk, s.Sq * s.Sk);
+
+            SoftmaxRowTask task = {NULL, (float *)p, NULL, 1, s.Sk, dp, ds};
+            softmax_rows(&task, s.batch * s.Sq, softmax_row_grad_task);
+        }
+
+        if (Q->requires_grad) {
+            tensor_ensure_grad(Q);
+            sgemm_batched(NULL, s.batch, s.Sq, s.D, s.Sk, scale, ds, p_off, s.Sk, 1,
+                          k, k_off, s.D, 1, 1.0f, Q->grad, s.D, s.Sq * s.D);
+        }
+
+        if (K->requires_grad) {
+            tensor_ensure_grad(K);
+            sgemm_batched(NULL, s.batch, s.Sk, s.D, s.Sq, scale, ds, p_off, 1, s.Sk,
+                          q, q_off, s.D, 1, 1.0f, K->grad, s.D, s.Sk * s.D);
+        }
+    }
+
+    scratch_free(output, dp);
+    scratch_free(output, ds);
+    free(q_scratch);
+    free(k_scratch);
+    free(v_scratch);
+    scratch_free(output, q_off);
+    scratch_free(output, k_off);
+    scratch_free(output, v_off);
+    scratch_free(output, p_off);
+    scratch_free(output, o_off);
+}
+
+// ====================================================
+// Registration
+// ====================================================
+
+void attention_register_builtins(void) {
+    register_tensor_op("softmax_row", backward_softmax_row);
+    register_tensor_op("scaled_dot_product_attention", backward_scaled_dot_product_attention);
+}
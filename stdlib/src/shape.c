@@ -0,0 +1,190 @@
+#include "../include/shape.h"
+#include "../../core/include/ops.h"
+#include "../../core/include/registry.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ====================================================
+// Shape Operations
+// ====================================================
+
+// Row-major element strides for shape
+static void dense_steps(size_t *shape, size_t ndim, size_t *steps) {
+    size_t stride = 1;
+    for (size_t i = ndim; i > 0; i--) {
+        steps[i - 1] = stride;
+        stride *= shape[i - 1];
+    }
+}
+
+Tensor* tensor_reshape(Tensor *input, size_t *new_shape, size_t new_ndim) {
+    if (!input || !new_shape) return NULL;
+
+    size_t size = 1;
+    for (size_t i = 0; i < new_ndim; i++) size *= new_shape[i];
+    if (size != input->size || size == 0) return NULL;
+
+    size_t steps[new_ndim];
+    dense_steps(new_shape, new_ndim, steps);
+
+    Tensor *output = tensor_view(input, new_shape, new_ndim, steps, 0);
+    if (output) return output;
+
+    // Strides cannot express the new shape over input's storage: copy
+    output = tensor_create(new_shape, new_ndim);
+    if (!output) return NULL;
+
+    tensor_gather(input, output->data);
+    tensor_record_op(output, &input, 1, "reshape", backward_reshape);
+    tensor_release_output(output);
+
+    return output;
+}
+
+void backward_reshape(Tensor *output) {
+    Tensor *input = output->inputs[0];
+
+    // Reshaping keeps row-major order, so gradients line up element for element
+    if (input->requires_grad) {
+        tensor_ensure_grad(input);
+        for (size_t i = 0; i < input->size; i++) {
+            input->grad[i] += output->grad[i];
+        }
+    }
+}
+
+Tensor* tensor_transpose(Tensor *input, size_t dim0, size_t dim1) {
+    if (!input || dim0 >= input->ndim || dim1 >= input->ndim) return NULL;
+
+    size_t ndim = input->ndim;
+    size_t shape[ndim];
+    size_t steps[ndim];
+    memcpy(shape, input->shape, ndim * sizeof(size_t));
+    dense_steps(shape, ndim, steps);
+
+    size_t tmp = shape[dim0];
+    shape[dim0] = shape[dim1];
+    shape[dim1] = tmp;
+    tmp = steps[dim0];
+    steps[dim0] = steps[dim1];
+    steps[dim1] = tmp;
+
+    return tensor_view(input, shape, ndim, steps, 0);
+}
+
+void backward_transpose(Tensor *output) {
+    backward_view(output);
+}
+
+Tensor* tensor_squeeze(Tensor *input, size_t dim) {
+    if (!input || dim >= input->ndim || input->shape[dim] != 1) return NULL;
+
+    size_t ndim = input->ndim;
+    size_t shape[ndim];
+    size_t steps[ndim];
+    dense_steps(input->shape, ndim, steps);
+    memcpy(shape, input->shape, ndim * sizeof(size_t));
+
+    for (size_t i = dim; i + 1 < ndim; i++) {
+        shape[i] = shape[i + 1];
+        steps[i] = steps[i + 1];
+    }
+
+    return tensor_view(input, shape, ndim - 1, steps, 0);
+}
+
+void backward_squeeze(Tensor *output) {
+    backward_view(output);
+}
+
+// ====================================================
+// Shape Layers
+// ====================================================
+
+static Layer* shape_layer_create(LayerConfig *config, void *config_data, size_t config_data_size) {
+    Layer *layer = malloc(sizeof(Layer));
+    if (!layer) return NULL;
+
+    layer->name = strdup(config->name);
+    layer->weights = NULL;
+    layer->bias = NULL;
+    layer->output = NULL;
+    layer->parameters = NULL;
+    layer->num_parameters = 0;
+    layer->forward = get_layer_forward_fn(config->name);
+    layer->config_data = config_data;
+    layer->config_data_size = config_data_size;
+
+    return layer;
+}
+
+static Layer* flatten_create(LayerConfig *config) {
+    FlattenParams *params = (FlattenParams *)config->params;
+    if (!params || params->start_dim > params->end_dim) return NULL;
+
+    FlattenParams *copy = malloc(sizeof(FlattenParams));
+    if (!copy) return NULL;
+    *copy = *params;
+
+    return shape_layer_create(config, copy, sizeof(FlattenParams));
+}
+
+static Tensor* flatten_forward(Layer *self, Tensor *input) {
+    if (!self || !input) return NULL;
+    FlattenParams *params = (FlattenParams *)self->config_data;
+
+    size_t start = params->start_dim;
+    size_t end = params->end_dim < input->ndim ? params->end_dim : input->ndim - 1;
+    if (start >= end) return tensor_reshape(input, input->shape, input->ndim);
+
+    size_t new_ndim = input->ndim - (end - start);
+    size_t new_shape[new_ndim];
+    size_t j = 0;
+    for (size_t i = 0; i < input->ndim; i++) {
+        if (i <= start || i > end) {
+            new_shape[j++] = input->shape[i];
+        } else {
+            new_shape[j - 1] *= input->shape[i];
+        }
+    }
+
+    return tensor_reshape(input, new_shape, new_ndim);
+}
+
+// Stored as a ReshapeParams followed by the dims it points at
+static Layer* reshape_create(LayerConfig *config) {
+    ReshapeParams *params = (ReshapeParams *)config->params;
+    if (!params || !params->new_shape) return NULL;
+
+    size_t size = sizeof(ReshapeParams) + params->new_ndim * sizeof(size_t);
+    ReshapeParams *copy = malloc(size);
+    if (!copy) return NULL;
+
+    copy->new_ndim = params->new_ndim;
+    copy->new_shape = (size_t *)(copy + 1);
+    memcpy(copy->new_shape, params->new_shape, params->new_ndim * sizeof(size_t));
+
+    return shape_layer_create(config, copy, size);
+}
+
+static Tensor* reshape_forward(Layer *self, Tensor *input) {
+    if (!self || !input || input->ndim == 0) return NULL;
+    ReshapeParams *params = (ReshapeParams *)self->config_data;
+
+    size_t new_shape[params->new_ndim + 1];
+    new_shape[0] = input->shape[0];
+    memcpy(new_shape + 1, params->new_shape, params->new_ndim * sizeof(size_t));
+
+    return tensor_reshape(input, new_shape, params->new_ndim + 1);
+}
+
+// ====================================================
+// Registration
+// ====================================================
+
+void shape_register_builtins(void) {
+    register_tensor_op("reshape", backward_reshape);
+
+    register_layer("flatten", flatten_create, flatten_forward);
+    register_layer("reshape", reshape_create, reshape_forward);
+}
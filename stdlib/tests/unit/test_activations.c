@@ -0,0 +1,247 @@
+#include "../../../core/include/basednn.h"
+#include "../../include/activations.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define EPSILON 1e-4f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+static Tensor* from_values(const float *values, size_t n) {
+    Tensor *t = tensor_create((size_t[]){n}, 1);
+    for (size_t i = 0; i < n; i++) t->data[i] = values[i];
+    return t;
+}
+
+// Checks input->grad against central differences of sum(f(input))
+static void check_gradient(Tensor* (*f)(Tensor *), const float *values, size_t n) {
+    Tensor *x = from_values(values, n);
+    tensor_set_requires_grad(x, 1);
+
+    Tensor *y = f(x);
+    tensor_backward(y);
+
+    float h = 1e-3f;
+    for (size_t i = 0; i < n; i++) {
+        Tensor *p = from_values(values, n);
+        Tensor *m = from_values(values, n);
+        p->data[i] += h;
+        m->data[i] -= h;
+
+        Tensor *yp = f(p);
+        Tensor *ym = f(m);
+        float numeric = (yp->data[i] - ym->data[i]) / (2.0f * h);
+        assert(fabsf(x->grad[i] - numeric) < 1e-2f);
+
+        tensor_free(yp);
+        tensor_free(ym);
+        tensor_free(p);
+        tensor_free(m);
+    }
+
+    tensor_free(y);
+    tensor_free(x);
+}
+
+static const float sample[] = {-4.0f, -1.5f, -0.25f, 0.0f, 0.5f, 2.0f, 30.0f};
+#define SAMPLE_SIZE (sizeof(sample) / sizeof(sample[0]))
+
+// ====================================================
+// Activation Tests
+// ====================================================
+
+TEST(tensor_gelu) {
+    Tensor *x = from_values(sample, SAMPLE_SIZE);
+    Tensor *y = tensor_gelu(x);
+
+    assert(y != NULL);
+    ASSERT_FLOAT_EQ(y->data[3], 0.0f);
+    ASSERT_FLOAT_EQ(y->data[4], 0.345714f);
+    ASSERT_FLOAT_EQ(y->data[5], 1.954598f);
+    ASSERT_FLOAT_EQ(y->data[6], 30.0f);
+
+    tensor_free(y);
+    tensor_free(x);
+
+    check_gradient(tensor_gelu, sample, SAMPLE_SIZE - 1);
+}
+
+TEST(tensor_swish) {
+    Tensor *x = from_values(sample, SAMPLE_SIZE);
+    Tensor *y = tensor_swish(x);
+
+    for (size_t i = 0; i < SAMPLE_SIZE; i++) {
+        float v = sample[i];
+        ASSERT_FLOAT_EQ(y->data[i], v / (1.0f + expf(-v)));
+    }
+
+    tensor_free(y);
+    tensor_free(x);
+
+    check_gradient(tensor_swish, sample, SAMPLE_SIZE - 1);
+}
+
+TEST(tensor_softplus) {
+    Tensor *x = from_values(sample, SAMPLE_SIZE);
+    Tensor *y = tensor_softplus(x);
+
+    for (size_t i = 0; i + 1 < SAMPLE_SIZE; i++) {
+        ASSERT_FLOAT_EQ(y->data[i], logf(1.0f + expf(sample[i])));
+    }
+    // No overflow for large inputs
+    ASSERT_FLOAT_EQ(y->data[6], 30.0f);
+
+    tensor_free(y);
+    tensor_free(x);
+
+    check_gradient(tensor_softplus, sample, SAMPLE_SIZE);
+}
+
+TEST(tensor_leaky_relu) {
+    Tensor *x = from_values(sample, SAMPLE_SIZE);
+    tensor_set_requires_grad(x, 1);
+
+    Tensor *y = tensor_leaky_relu(x, 0.1f);
+    tensor_backward(y);
+
+    for (size_t i = 0; i < SAMPLE_SIZE; i++) {
+        float v = sample[i];
+        ASSERT_FLOAT_EQ(y->data[i], v > 0.0f ? v : 0.1f * v);
+        ASSERT_FLOAT_EQ(x->grad[i], v > 0.0f ? 1.0f : 0.1f);
+    }
+
+    tensor_free(y);
+    tensor_free(x);
+}
+
+// Large enough to be split across the thread pool
+TEST(activation_large_matches_elementwise) {
+    Tensor *x = tensor_randn((size_t[]){100, 1000}, 2, 3);
+    Tensor *y = tensor_gelu(x);
+
+    for (size_t i = 0; i < x->size; i += 97) {
+        float v = x->data[i];
+        float expected = 0.5f * v * (1.0f + tanhf(0.7978845608f * (v + 0.044715f * v * v * v)));
+        ASSERT_FLOAT_EQ(y->data[i], expected);
+    }
+
+    tensor_free(y);
+    tensor_free(x);
+}
+
+// Runs f and its backward pass on a copy of src, returning the input gradient
+static Tensor* activation_grad(Tensor* (*f)(Tensor *), Tensor *src, Tensor **grad) {
+    Tensor *x = tensor_create(src->shape, src->ndim);
+    for (size_t i = 0; i < src->size; i++) x->data[i] = src->data[i];
+    tensor_set_requires_grad(x, 1);
+
+    Tensor *y = f(x);
+    tensor_backward(y);
+    *grad = x;
+    return y;
+}
+
+TEST(activation_fast_math_matches_precise) {
+    Tensor* (*fns[])(Tensor *) = {tensor_gelu, tensor_swish, tensor_softplus};
+    Tensor *src = tensor_randn((size_t[]){50, 1000}, 2, 11);
+    for (size_t i = 0; i < src->size; i++) src->data[i] *= 4.0f;
+
+    for (size_t f = 0; f < 3; f++) {
+        Tensor *gp, *gf;
+        fastmath_set_enabled(0);
+        Tensor *precise = activation_grad(fns[f], src, &gp);
+        fastmath_set_enabled(1);
+        Tensor *fast = activation_grad(fns[f], src, &gf);
+        fastmath_set_enabled(0);
+
+        for (size_t i = 0; i < src->size; i++) {
+            ASSERT_FLOAT_EQ(fast->data[i], precise->data[i]);
+            ASSERT_FLOAT_EQ(gf->grad[i], gp->grad[i]);
+        }
+
+        tensor_free(precise);
+        tensor_free(fast);
+        tensor_free(gp);
+        tensor_free(gf);
+    }
+
+    tensor_free(src);
+}
+
+// ====================================================
+// Layer Tests
+// ====================================================
+
+TEST(activation_layers_in_network) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(2, 4)));
+    network_add_layer(net, layer_create(GELU()));
+    network_add_layer(net, layer_create(LINEAR(4, 4)));
+    network_add_layer(net, layer_create(LEAKY_RELU(0.2f)));
+    network_add_layer(net, layer_create(LINEAR(4, 1)));
+    network_add_layer(net, layer_create(SOFTPLUS()));
+
+    Tensor *input = tensor_randn((size_t[]){3, 2}, 2, 5);
+    Tensor *output = network_forward(net, input);
+    assert(output != NULL);
+    assert(output->shape[0] == 3 && output->shape[1] == 1);
+    for (size_t i = 0; i < output->size; i++) assert(output->data[i] > 0.0f);
+
+    tensor_free(input);
+    network_free(net);
+}
+
+// The RELU after GELU runs in place during training
+TEST(activation_layers_train_in_place) {
+    Network *net = network_create();
+    network_add_layer(net, layer_create(LINEAR(2, 8)));
+    network_add_layer(net, layer_create(GELU()));
+    network_add_layer(net, layer_create(RELU()));
+    network_add_layer(net, layer_create(LINEAR(8, 1)));
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, SGD(0.05f, 0.0f));
+
+    Tensor *input = tensor_randn((size_t[]){16, 2}, 2, 9);
+    Tensor *target = tensor_create((size_t[]){16, 1}, 2);
+    for (size_t i = 0; i < 16; i++) target->data[i] = input->data[2 * i] - input->data[2 * i + 1];
+
+    float first = network_train_step(net, input, target, opt, "mse");
+    float last = first;
+    for (int step = 0; step < 50; step++) last = network_train_step(net, input, target, opt, "mse");
+    assert(last < 0.5f * first);
+
+    tensor_free(input);
+    tensor_free(target);
+    optimizer_free(opt);
+    network_free(net);
+}
+
+// ====================================================
+// Main
+// ====================================================
+
+int main() {
+    printf("=== Running Activation Tests ===\n\n");
+
+    basednn_init();
+    activations_register_builtins();
+
+    // Operation tests
+    RUN_TEST(tensor_gelu);
+    RUN_TEST(tensor_swish);
+    RUN_TEST(tensor_softplus);
+    RUN_TEST(tensor_leaky_relu);
+    RUN_TEST(activation_large_matches_elementwise);
+    RUN_TEST(activation_fast_math_matches_precise);
+
+    // Layer tests
+    RUN_TEST(activation_layers_in_network);
+    RUN_TEST(activation_layers_train_in_place);
+
+    basednn_cleanup();
+
+    printf("\n=== All Activation Tests Passed! ===\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "../../../core/include/basednn.h"
+#include "../../include/attention.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define EPSILON 1e-4f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+// ====================================================
+// Softmax Tests
+// ====================================================
+
+TEST(tensor_softmax_row) {
+    Tensor *x = tensor_create((size_t[]){2, 3}, 2);
+    float values[] = {1.0f, 2.0f, 3.0f, 1000.0f, 1000.0f, 1000.0f};
+    for (size_t i = 0; i < 6; i++) x->data[i] = values[i];
+
+    Tensor *y = tensor_softmax_row(x);
+    assert(y != NULL);
+
+    float sum = expf(1.0f) + expf(2.0f) + expf(3.0f);
+    ASSERT_FLOAT_EQ(y->data[0], expf(1.0f) / sum);
+    ASSERT_FLOAT_EQ(y->data[2], expf(3.0f) / sum);
+    // Large inputs do not overflow
+    for (size_t i = 3; i < 6; i++) ASSERT_FLOAT_EQ(y->data[i], 1.0f / 3.0f);
+
+    tensor_free(y);
+    tensor_free(x);
+}
+
+TEST(backward_softmax_row) {
+    Tensor *x = tensor_randn((size_t[]){3, 4}, 2, 4);
+    tensor_set_requires_grad(x, 1);
+
+    // Weight the outputs so the gradient is not trivially zero (backward seeds ones)
+    Tensor *y = tensor_softmax_row(x);
+    Tensor *w = tensor_randn((size_t[]){3, 4}, 2, 5);
+    Tensor *loss = tensor_mul(y, w);
+    tensor_backward(loss);
+
+    float h = 1e-2f;
+    for (size_t i = 0; i < x->size; i++) {
+        float numeric = 0.0f;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            Tensor *p = tensor_create(x->shape, x->ndim);
+            for (size_t j = 0; j < x->size; j++) p->data[j] = x->data[j];
+            p->data[i] += sign * h;
+
+            Tensor *py = tensor_softmax_row(p);
+            for (size_t j = 0; j < x->size; j++) numeric += sign * py->data[j] * w->data[j];
+
+            tensor_free(py);
+            tensor_free(p);
+        }
+        assert(fabsf(x->grad[i] - numeric / (2.0f * h)) < 1e-2f);
+    }
+
+    tensor_free(loss);
+    tensor_free(w);
+    tensor_free(x);
+}
+
+// ====================================================
+// Attention Tests
+// ====================================================
+
+// softmax(q·kᵀ / sqrt(D) + mask)·v for one batch entry, computed directly
+static void naive_attention(const float *q, const float *k, const float *v, const float *mask,
+                            size_t Sq, size_t Sk, size_t D, size_t Dv, float *out) {
+    float scores[Sk];
+    for (size_t i = 0; i < Sq; i++) {
+        float max = -INFINITY;
+        for (size_t j = 0; j < Sk; j++) {
+            float s = 0.0f;
+            for (size_t d = 0; d < D; d++) s += q[i * D + d] * k[j * D + d];
+            scores[j] = s / sqrtf((float)D) + (mask ? mask[i * Sk + j] : 0.0f);
+            if (scores[j] > max) max = scores[j];
+        }
+        float sum = 0.0f;
+        for (size_t j = 0; j < Sk; j++) {
+            scores[j] = expf(scores[j] - max);
+            sum += scores[j];
+        }
+        for (size_t c = 0; c < Dv; c++) {
+            float acc = 0.0f;
+            for (size_t j = 0; j < Sk; j++) acc += scores[j] / sum * v[j * Dv + c];
+            out[i * Dv + c] = acc;
+        }
+    }
+}
+
+TEST(tensor_scaled_dot_product_attention) {
+    size_t B = 2, H = 3, Sq = 5, Sk = 7, D = 4, Dv = 6;
+    Tensor *Q = tensor_randn((size_t[]){B, H, Sq, D}, 4, 1);
+    Tensor *K = tensor_randn((size_t[]){B, H, Sk, D}, 4, 2);
+    Tensor *V = tensor_randn((size_t[]){B, H, Sk, Dv}, 4, 3);
+
+    // Causal-style mask shared by every batch entry
+    Tensor *mask = tensor_create((size_t[]){Sq, Sk}, 2);
+    for (size_t i = 0; i < Sq; i++)
+        for (size_t j = 0; j < Sk; j++) mask->data[i * Sk + j] = (j > i + 2) ? -INFINITY : 0.0f;
+
+    Tensor *out = tensor_scaled_dot_product_attention(Q, K, V, mask);
+    assert(out != NULL);
+    assert(out->ndim == 4 && out->shape[2] == Sq && out->shape[3] == Dv);
+
+    float expected[Sq * Dv];
+    for (size_t b = 0; b < B * H; b++) {
+        naive_attention(Q->data + b * Sq * D, K->data + b * Sk * D, V->data + b * Sk * Dv,
+                        mask->data, Sq, Sk, D, Dv, expected);
+        for (size_t i = 0; i < Sq * Dv; i++) ASSERT_FLOAT_EQ(out->data[b * Sq * Dv + i], expected[i]);
+    }
+
+    // Mismatched shapes are rejected
+    assert(tensor_scaled_dot_product_attention(Q, V, V, NULL) == NULL);
+    assert(tensor_scaled_dot_product_attention(Q, K, V, Q) == NULL);
+
+    tensor_free(out);
+    tensor_free(mask);
+    tensor_free(Q);
+    tensor_free(K);
+    tensor_free(V);
+}
+
+// Gradients match the same computation built from batched matmul and softmax_row
+TEST(backward_scaled_dot_product_attention) {
+    size_t B = 2, S = 4, D = 3;
+    Tensor *inputs[6];
+    for (size_t i = 0; i < 6; i++) {
+        inputs[i] = tensor_randn((size_t[]){B, S, D}, 3, 10 + (i % 3));
+        tensor_set_requires_grad(inputs[i], 1);
+    }
+    Tensor *w = tensor_randn((size_t[]){B, S, D}, 3, 20);
+
+    Tensor *fused = tensor_mul(tensor_scaled_dot_product_attention(inputs[0], inputs[1], inputs[2], NULL), w);
+    tensor_backward(fused);
+
+    Tensor *p = tensor_softmax_row(tensor_matmul_ex(inputs[3], inputs[4], 0, 1, 1.0f / sqrtf((float)D)));
+    Tensor *composite = tensor_mul(tensor_matmul(p, inputs[5]), w);
+    tensor_backward(composite);
+
+    for (size_t j = 0; j < fused->size; j++) ASSERT_FLOAT_EQ(fused->data[j], composite->data[j]);
+    for (size_t i = 0; i < 3; i++)
+        for (size_t j = 0; j < B * S * D; j++) ASSERT_FLOAT_EQ(inputs[i]->grad[j], inputs[i + 3]->grad[j]);
+
+    tensor_free(fused);
+    tensor_free(composite);
+    tensor_free(w);
+    for (size_t i = 0; i < 6; i++) tensor_free(inputs[i]);
+}
+
+// ====================================================
+// Main
+// ====================================================
+
+int main() {
+    printf("=== Running Attention Tests ===\n\n");
+
+    basednn_init();
+    attention_register_builtins();
+
+    RUN_TEST(tensor_softmax_row);
+    RUN_TEST(backward_softmax_row);
+    RUN_TEST(tensor_scaled_dot_product_attention);
+    RUN_TEST(backward_scaled_dot_product_attention);
+
+    basednn_cleanup();
+
+    printf("\n=== All Attention Tests Passed! ===\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "../../../core/include/basednn.h"
+#include "../../include/shape.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define EPSILON 1e-4f
+#define ASSERT_FLOAT_EQ(a, b) assert(fabsf((a) - (b)) < EPSILON)
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { printf("Running %s...\n", #name); test_##name(); printf("  PASSED\n"); } while(0)
+
+static Tensor* arange(size_t *shape, size_t ndim) {
+    Tensor *t = tensor_create(shape, ndim);
+    for (size_t i = 0; i < t->size; i++) t->data[i] = (float)i;
+    return t;
+}
+
+// ====================================================
+// Shape Operation Tests
+// ====================================================
+
+TEST(tensor_reshape_view) {
+    Tensor *a = arange((size_t[]){2, 6}, 2);
+
+    Tensor *b = tensor_reshape(a, (size_t[]){3, 4}, 2);
+    assert(b != NULL);
+    assert(b->data == a->data);
+    assert(b->owns_data == 0);
+    assert(b->shape[0] == 3 && b->shape[1] == 4);
+    assert(tensor_is_contiguous(b));
+
+    assert(tensor_reshape(a, (size_t[]){5, 2}, 2) == NULL);
+
+    tensor_free(b);
+    tensor_free(a);
+}
+
+TEST(tensor_transpose_view) {
+    Tensor *a = arange((size_t[]){2, 3, 4}, 3);
+
+    Tensor *t = tensor_transpose(a, 0, 2);
+    assert(t != NULL);
+    assert(t->data == a->data);
+    assert(t->shape[0] == 4 && t->shape[1] == 3 && t->shape[2] == 2);
+    assert(!tensor_is_contiguous(t));
+
+    // t[i][j][k] == a[k][j][i]
+    float dense[24];
+    tensor_gather(t, dense);
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            for (size_t k = 0; k < 2; k++) {
+                ASSERT_FLOAT_EQ(dense[(i * 3 + j) * 2 + k], a->data[(k * 3 + j) * 4 + i]);
+            }
+        }
+    }
+
+    tensor_free(t);
+    tensor_free(a);
+}
+
+TEST(tensor_reshape_transposed_copies) {
+    Tensor *a = arange((size_t[]){2, 3}, 2);
+    Tensor *t = tensor_transpose(a, 0, 1);
+
+    Tensor *r = tensor_reshape(t, (size_t[]){6}, 1);
+    assert(r != NULL);
+    assert(r->data != a->data);
+
+    float expected[] = {0, 3, 1, 4, 2, 5};
+    for (size_t i = 0; i < 6; i++) ASSERT_FLOAT_EQ(r->data[i], expected[i]);
+
+    tensor_free(r);
+    tensor_free(t);
+    tensor_free(a);
+}
+
+TEST(tensor_squeeze_view) {
+    Tensor *a = arange((size_t[]){3, 1, 2}, 3);
+
+    Tensor *s = tensor_squeeze(a, 1);
+    assert(s != NULL);
+    assert(s->ndim == 2);
+    assert(s->shape[0] == 3 && s->shape[1] == 2);
+    assert(s->data == a->data);
+    assert(tensor_squeeze(a, 0) == NULL);
+
+    tensor_free(s);
+    tensor_free(a);
+}
+
+TEST(backward_through_views) {
+    Tensor *a = arange((size_t[]){2, 3}, 2);
+    tensor_set_requires_grad(a, 1);
+
+    // loss = mean(reshape(transpose(a))^2)
+    Tensor *t = tensor_transpose(a, 0, 1);
+    Tensor *r = tensor_reshape(t, (size_t[]){6}, 1);
+    Tensor *zero = tensor_zeroes((size_t[]){6}, 1);
+    Tensor *loss = tensor_mse(r, zero);
+    tensor_backward(loss);
+
+    for (size_t i = 0; i < 6; i++) {
+        ASSERT_FLOAT_EQ(a->grad[i], (2.0f / 6.0f) * a->data[i]);
+    }
+
+    tensor_free(loss);
+    tensor_free(zero);
+    tensor_free(r);
+    tensor_free(t);
+    tensor_free(a);
+}
+
+// ====================================================
+// Shape Layer Tests
+// ====================================================
+
+TEST(flatten_layer) {
+    Layer *layer = layer_create(FLATTEN(1, 3));
+    assert(layer != NULL);
+
+    Tensor *x = arange((size_t[]){2, 3, 2, 2}, 4);
+    Tensor *y = layer_forward(layer, x);
+    assert(y != NULL);
+    assert(y->ndim == 2);
+    assert(y->shape[0] == 2 && y->shape[1] == 12);
+    assert(y->data == x->data);
+
+    tensor_free(y);
+    tensor_free(x);
+    layer_free(layer);
+}
+
+TEST(reshape_layer_in_network) {
+    size_t sample_shape[] = {4};
+    Network *net = network_create();
+    network_add_layer(net, layer_create(RESHAPE(sample_shape, 1)));
+    network_add_layer(net, layer_create(LINEAR(4, 1)));
+
+    Optimizer *opt = optimizer_create(net->parameters, net->num_parameters, SGD(0.01f, 0.0f));
+
+    Tensor *inputs = tensor_ones((size_t[]){8, 2, 2}, 3);
+    Tensor *targets = tensor_ones((size_t[]){8, 1}, 2);
+    float first = network_train_step(net, inputs, targets, opt, "mse");
+    float loss = first;
+    for (int i = 0; i < 20; i++) loss = network_train_step(net, inputs, targets, opt, "mse");
+    assert(loss < first);
+
+    tensor_free(inputs);
+    tensor_free(targets);
+    optimizer_free(opt);
+    network_free(net);
+}
+
+// ====================================================
+// Main
+// ====================================================
+
+int main() {
+    printf("=== Running Shape Tests ===\n\n");
+
+    basednn_init();
+    shape_register_builtins();
+
+    // Operation tests
+    RUN_TEST(tensor_reshape_view);
+    RUN_TEST(tensor_transpose_view);
+    RUN_TEST(tensor_reshape_transposed_copies);
+    RUN_TEST(tensor_squeeze_view);
+    RUN_TEST(backward_through_views);
+
+    // Layer tests
+    RUN_TEST(flatten_layer);
+    RUN_TEST(reshape_layer_in_network);
+
+    basednn_cleanup();
+
+    printf("\n=== All Shape Tests Passed! ===\n");
+    return 0;
+}